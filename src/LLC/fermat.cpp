@@ -0,0 +1,438 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/include/fermat.h>
+#include <LLC/prime/fermat.h>
+#include <LLC/types/bignum.h>
+
+#include <openssl/bn.h>
+
+#include <algorithm>
+
+/* The IFMA kernels are compiled per function, so the rest of the build doesn't need -mavx512ifma. */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FERMAT_IFMA
+#include <immintrin.h>
+#endif
+
+namespace LLC
+{
+    /* The primes used for the small divisor tests. */
+    const uint16_t SMALL_PRIMES[11] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31 };
+
+
+    /* The total numbers tested at once by the IFMA kernels. */
+    const uint32_t FERMAT_LANES = 8;
+
+
+    /* Check if a number can use montgomery arithmetic, which needs it to be odd and above one. */
+    static bool montgomery(const uint1024_t& hashTest)
+    {
+        return (hashTest.get(0) & 1) && hashTest.bits() > 1;
+    }
+
+
+    /* Calculate 2^(p - 1) mod p with the big number library. */
+    static uint1024_t fermat_bignum(const uint1024_t& hashTest)
+    {
+        LLC::CAutoBN_CTX pctx;
+
+        LLC::CBigNum bnPrime(hashTest);
+        LLC::CBigNum bnBase(2);
+        LLC::CBigNum bnExp = bnPrime - 1;
+
+        LLC::CBigNum bnResult;
+        BN_mod_exp(bnResult.getBN(), bnBase.getBN(), bnExp.getBN(), bnPrime.getBN(), pctx);
+
+        return bnResult.getuint1024();
+    }
+
+
+#ifdef FERMAT_IFMA
+
+    /* The 52-bit limbs of each lane, giving R = 2^1040 which is above 4p for any 1024-bit p. */
+    const uint32_t LIMBS = 20;
+
+
+    /* The bits in each limb, which is the width of the IFMA multipliers. */
+    const uint32_t LIMB_BITS = 52;
+
+
+    /* The mask for the bits of one limb. */
+    const uint64_t LIMB_MASK = (uint64_t(1) << LIMB_BITS) - 1;
+
+
+    /* Split a number held in 33 words into 52-bit limbs. */
+    static void to_limbs(const uint32_t* pWords, uint64_t* pLimbs)
+    {
+        for(uint32_t j = 0; j < LIMBS; ++j)
+        {
+            const uint32_t nBit   = j * LIMB_BITS;
+            const uint32_t nWord  = nBit >> 5;
+            const uint32_t nShift = nBit & 31;
+
+            uint64_t nLimb = (uint64_t(pWords[nWord]) | (uint64_t(pWords[nWord + 1]) << 32)) >> nShift;
+            if(nShift > 12)
+                nLimb |= uint64_t(pWords[nWord + 2]) << (64 - nShift);
+
+            pLimbs[j] = nLimb & LIMB_MASK;
+        }
+    }
+
+
+    /* Join 52-bit limbs holding a number below 2^1024 back into 32 words. */
+    static void from_limbs(const uint64_t* pLimbs, uint32_t* pWords)
+    {
+        std::fill(pWords, pWords + 32, 0);
+        for(uint32_t j = 0; j < LIMBS; ++j)
+        {
+            const uint32_t nBit   = j * LIMB_BITS;
+            const uint32_t nWord  = nBit >> 5;
+            const uint32_t nShift = nBit & 31;
+
+            pWords[nWord] |= static_cast<uint32_t>(pLimbs[j] << nShift);
+            if(nWord + 1 < 32)
+                pWords[nWord + 1] |= static_cast<uint32_t>(pLimbs[j] >> (32 - nShift));
+            if(nWord + 2 < 32 && nShift > 12)
+                pWords[nWord + 2] |= static_cast<uint32_t>(pLimbs[j] >> (64 - nShift));
+        }
+    }
+
+
+    /* Get 2^1040 mod p, which is one in montgomery form, by doubling the top bit of p. */
+    static void montgomery_one(uint32_t* pPrime, uint32_t* pOne)
+    {
+        assign_zero<33>(pOne);
+
+        const uint16_t nBits = bit_count<33>(pPrime);
+        pOne[(nBits - 1) >> 5] = 1u << ((nBits - 1) & 31);
+
+        for(uint32_t i = nBits - 1; i < LIMBS * LIMB_BITS; ++i)
+        {
+            lshift1<33>(pOne, pOne);
+            if(cmp_ge_n<33>(pOne, pPrime))
+                sub_n<33>(pOne, pOne, pPrime);
+        }
+    }
+
+
+    /* Almost montgomery product of eight lanes, z = x * y / R mod p with z below 2p while x and y are below 2p.
+     * The accumulator is shifted down one limb per row so it stays in registers, adding the high halves as it goes,
+     * which needs the loops over limbs unrolled. */
+    __attribute__((target("avx512f,avx512ifma")))
+    static inline void amm_x8(__m512i z[LIMBS], const __m512i x[LIMBS], const __m512i y[LIMBS], const __m512i n[LIMBS],
+                       const __m512i d)
+    {
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i mask = _mm512_set1_epi64(LIMB_MASK);
+
+        __m512i t[LIMBS + 1];
+        #pragma GCC unroll 21
+        for(uint32_t j = 0; j <= LIMBS; ++j)
+            t[j] = zero;
+
+        for(uint32_t i = 0; i < LIMBS; ++i)
+        {
+            /* Add the low halves of x * y[i]. */
+            const __m512i yi = y[i];
+            #pragma GCC unroll 20
+            for(uint32_t j = 0; j < LIMBS; ++j)
+                t[j] = _mm512_madd52lo_epu64(t[j], x[j], yi);
+
+            /* Add the low halves of m * n, clearing the bottom limb. */
+            const __m512i m = _mm512_madd52lo_epu64(zero, t[0], d);
+            #pragma GCC unroll 20
+            for(uint32_t j = 0; j < LIMBS; ++j)
+                t[j] = _mm512_madd52lo_epu64(t[j], m, n[j]);
+
+            /* Shift down one limb, adding the high halves and the carry from the bottom limb. */
+            const __m512i c = _mm512_srli_epi64(t[0], LIMB_BITS);
+            #pragma GCC unroll 20
+            for(uint32_t j = 0; j < LIMBS; ++j)
+            {
+                __m512i v = _mm512_madd52hi_epu64(t[j + 1], x[j], yi);
+                t[j] = _mm512_madd52hi_epu64(v, m, n[j]);
+            }
+
+            t[0]     = _mm512_add_epi64(t[0], c);
+            t[LIMBS] = zero;
+        }
+
+        /* Carry back down to 52-bit limbs, which the multipliers need for their next inputs. */
+        __m512i c = zero;
+        #pragma GCC unroll 20
+        for(uint32_t j = 0; j < LIMBS; ++j)
+        {
+            const __m512i v = _mm512_add_epi64(t[j], c);
+            z[j] = _mm512_and_si512(v, mask);
+            c    = _mm512_srli_epi64(v, LIMB_BITS);
+        }
+    }
+
+
+    /* Calculate 2^(p - 1) mod p for eight odd numbers above one at once. */
+    __attribute__((target("avx512f,avx512ifma")))
+    static void fermat_x8(const uint1024_t* pTest[FERMAT_LANES], uint1024_t* pResult[FERMAT_LANES])
+    {
+        alignas(64) uint64_t vPrime[LIMBS][FERMAT_LANES];
+        alignas(64) uint64_t vOne[LIMBS][FERMAT_LANES];
+        alignas(64) uint64_t vInverse[FERMAT_LANES];
+
+        /* Set up each lane, its limbs, montgomery one, and -1/p mod 2^52. */
+        uint16_t nBits = 0;
+        for(uint32_t k = 0; k < FERMAT_LANES; ++k)
+        {
+            uint32_t p[33];
+            uint32_t one[33];
+
+            const uint32_t* pWords = reinterpret_cast<const uint32_t*>(pTest[k]->begin());
+            std::copy(pWords, pWords + 32, p);
+            p[32] = 0;
+
+            montgomery_one(p, one);
+            nBits = std::max(nBits, bit_count<33>(p));
+
+            uint64_t nLimbs[LIMBS];
+            to_limbs(p, nLimbs);
+            for(uint32_t j = 0; j < LIMBS; ++j)
+                vPrime[j][k] = nLimbs[j];
+
+            to_limbs(one, nLimbs);
+            for(uint32_t j = 0; j < LIMBS; ++j)
+                vOne[j][k] = nLimbs[j];
+
+            /* Newton's method doubles the correct low bits of the inverse each step, starting from three. */
+            uint64_t nInverse = vPrime[0][k];
+            for(uint32_t i = 0; i < 5; ++i)
+                nInverse *= 2 - vPrime[0][k] * nInverse;
+
+            vInverse[k] = (0 - nInverse) & LIMB_MASK;
+        }
+
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i mask = _mm512_set1_epi64(LIMB_MASK);
+        const __m512i bit  = _mm512_set1_epi64(1);
+        const __m512i d    = _mm512_load_si512(vInverse);
+
+        __m512i n[LIMBS];
+        __m512i x[LIMBS];
+        for(uint32_t j = 0; j < LIMBS; ++j)
+        {
+            n[j] = _mm512_load_si512(vPrime[j]);
+            x[j] = _mm512_load_si512(vOne[j]);
+        }
+
+        /* Square for each bit of p - 1 from the top, doubling the lanes that have the bit set. Bit zero of p - 1 is
+         * always clear, so the bits of p can be used as the exponent from bit one. */
+        for(int32_t i = nBits - 1; i >= 1; --i)
+        {
+            amm_x8(x, x, x, n, d);
+
+            const __m512i s = _mm512_and_si512(_mm512_srl_epi64(n[i / LIMB_BITS], _mm_cvtsi32_si128(i % LIMB_BITS)), bit);
+            if(_mm512_test_epi64_mask(s, s) == 0)
+                continue;
+
+            __m512i c = zero;
+            for(uint32_t j = 0; j < LIMBS; ++j)
+            {
+                const __m512i v = _mm512_add_epi64(_mm512_sllv_epi64(x[j], s), c);
+                x[j] = _mm512_and_si512(v, mask);
+                c    = _mm512_srli_epi64(v, LIMB_BITS);
+            }
+        }
+
+        /* Square for bit zero, then multiply by one to leave montgomery form, which fully reduces below p. */
+        amm_x8(x, x, x, n, d);
+
+        __m512i y[LIMBS];
+        y[0] = bit;
+        for(uint32_t j = 1; j < LIMBS; ++j)
+            y[j] = zero;
+
+        amm_x8(x, x, y, n, d);
+
+        /* Write out each lane. */
+        for(uint32_t j = 0; j < LIMBS; ++j)
+            _mm512_store_si512(vPrime[j], x[j]);
+
+        for(uint32_t k = 0; k < FERMAT_LANES; ++k)
+        {
+            uint64_t nLimbs[LIMBS];
+            for(uint32_t j = 0; j < LIMBS; ++j)
+                nLimbs[j] = vPrime[j][k];
+
+            from_limbs(nLimbs, reinterpret_cast<uint32_t*>(pResult[k]->begin()));
+        }
+    }
+
+#endif
+
+
+    /* Check if our CPU supports the IFMA kernels. */
+    bool SupportsIFMA()
+    {
+    #ifdef FERMAT_IFMA
+        static const bool fIFMA = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+        return fIFMA;
+    #else
+        return false;
+    #endif
+    }
+
+
+    /* Calculate 2^(p - 1) mod p for a batch of numbers. */
+    void FermatTest(const uint1024_t* pTest, const uint32_t nTotal, uint1024_t* pRemainders)
+    {
+    #ifdef FERMAT_IFMA
+        if(SupportsIFMA())
+        {
+            const uint1024_t* pLanes[FERMAT_LANES];
+            uint1024_t* pOut[FERMAT_LANES];
+            uint1024_t vUnused[FERMAT_LANES];
+
+            /* Gather the numbers that have a montgomery form into groups of eight. */
+            uint32_t nLanes = 0;
+            for(uint32_t i = 0; i < nTotal; ++i)
+            {
+                if(!montgomery(pTest[i]))
+                {
+                    pRemainders[i] = fermat_bignum(pTest[i]);
+                    continue;
+                }
+
+                pLanes[nLanes] = &pTest[i];
+                pOut[nLanes]   = &pRemainders[i];
+
+                if(++nLanes == FERMAT_LANES)
+                {
+                    fermat_x8(pLanes, pOut);
+                    nLanes = 0;
+                }
+            }
+
+            /* A single number is quicker with the big number library than with seven empty lanes. */
+            if(nLanes == 1)
+                *pOut[0] = fermat_bignum(*pLanes[0]);
+
+            /* Fill the last group by repeating its first number. */
+            else if(nLanes > 1)
+            {
+                for(uint32_t k = nLanes; k < FERMAT_LANES; ++k)
+                {
+                    pLanes[k] = pLanes[0];
+                    pOut[k]   = &vUnused[k];
+                }
+
+                fermat_x8(pLanes, pOut);
+            }
+
+            return;
+        }
+    #endif
+
+        /* Otherwise test each number in turn. */
+        for(uint32_t i = 0; i < nTotal; ++i)
+            pRemainders[i] = fermat_bignum(pTest[i]);
+    }
+
+
+    /* Calculate 2^(p - 1) mod p for one number. */
+    uint1024_t FermatTest(const uint1024_t& hashTest)
+    {
+        uint1024_t hashRemainder;
+        FermatTest(&hashTest, 1, &hashRemainder);
+
+        return hashRemainder;
+    }
+
+
+    /* Run the fermat tests for a batch of cluster numbers, flagging the ones that pass. */
+    static uint32_t fermat_batch(uint1024_t* pBatch, const uint32_t* pIndex, const uint32_t nBatch, bool* pPrimes)
+    {
+        FermatTest(pBatch, nBatch, pBatch);
+
+        uint32_t nPrimes = 0;
+        for(uint32_t n = 0; n < nBatch; ++n)
+        {
+            if(pBatch[n] != 1)
+                continue;
+
+            if(pPrimes)
+                pPrimes[pIndex[n]] = true;
+
+            ++nPrimes;
+        }
+
+        return nPrimes;
+    }
+
+
+    /* Test the numbers of a prime cluster, stepping from a base number by each offset in turn. */
+    uint32_t FermatCluster(const uint1024_t& hashBase, const uint8_t* pOffsets, const uint32_t nOffsets, bool* pPrimes)
+    {
+        /* Get the residues of our base once. */
+        uint32_t nResidues[11];
+        for(uint32_t n = 0; n < 11; ++n)
+            nResidues[n] = hashBase % SMALL_PRIMES[n];
+
+        /* The numbers waiting for a fermat test, with their positions in the cluster. */
+        uint1024_t vBatch[FERMAT_LANES];
+        uint32_t nIndex[FERMAT_LANES];
+        uint32_t nBatch = 0;
+
+        /* Step through each number in the cluster. */
+        uint32_t nPrimes = 0;
+        uint1024_t hashNext = hashBase;
+        for(uint32_t i = 0; i < nOffsets; ++i)
+        {
+            /* Move to our next number. */
+            const uint1024_t hashLast = hashNext;
+            hashNext += pOffsets[i];
+
+            /* Carry the residues forward, unless we wrapped past 2^1024 and need them again. */
+            bool fDivisor = false;
+            for(uint32_t n = 0; n < 11; ++n)
+            {
+                if(hashNext < hashLast)
+                    nResidues[n] = hashNext % SMALL_PRIMES[n];
+                else
+                    nResidues[n] = (nResidues[n] + pOffsets[i]) % SMALL_PRIMES[n];
+
+                if(nResidues[n] == 0)
+                    fDivisor = true;
+            }
+
+            if(pPrimes)
+                pPrimes[i] = false;
+
+            /* Only numbers with no small divisors need a fermat test. */
+            if(fDivisor)
+                continue;
+
+            vBatch[nBatch] = hashNext;
+            nIndex[nBatch] = i;
+
+            /* Test our batch once it is full. */
+            if(++nBatch == FERMAT_LANES)
+            {
+                nPrimes += fermat_batch(vBatch, nIndex, nBatch, pPrimes);
+                nBatch = 0;
+            }
+        }
+
+        /* Test what's left in our last batch. */
+        nPrimes += fermat_batch(vBatch, nIndex, nBatch, pPrimes);
+
+        return nPrimes;
+    }
+}
@@ -424,6 +424,28 @@ namespace LLC
 
 		return hashKeccak;
 	}
+
+
+    /** SupportsAVX2
+     *
+     *  Check if our CPU supports the AVX2 hashing kernels, checked once at runtime.
+     *
+     **/
+    bool SupportsAVX2();
+
+
+    /** SK512x4
+     *
+     *  512-bit hashing of four messages of the same length at once, used to build merkle trees.
+     *  Runs all four in the lanes of AVX2 registers when the CPU supports it, otherwise hashes each in turn.
+     *  Gives the same hashes as SK512, without going through the cache.
+     *
+     *  @param[in] pData The four messages to hash.
+     *  @param[in] nLength The length in bytes of each message.
+     *  @param[out] pHash The four hashes, in the same order as the messages.
+     *
+     **/
+    void SK512x4(const uint8_t* const pData[4], const uint64_t nLength, uint512_t pHash[4]);
 }
 
 #endif
@@ -21,8 +21,6 @@ http://creativecommons.org/publicdomain/zero/1.0/
 #include <algorithm>
 
 #define USE_MEMSET
-//#define DIVISION_INSTRUCTION    //comment if no division instruction or more compact when not using division
-#define UNROLL_CHILOOP        //comment more compact using for loop
 
 
 typedef uint8_t UINT8;
@@ -53,55 +51,6 @@ typedef uint64_t tKeccakLane;
 
 #define    cKeccakNumberOfRounds    24
 
-const UINT8 KeccakF_RotationConstants[25] =
-{
-     1,  3,  6, 10, 15, 21, 28, 36, 45, 55,  2, 14, 27, 41, 56,  8, 25, 43, 62, 18, 39, 61, 20, 44
-};
-
-const UINT8 KeccakF_PiLane[25] =
-{
-    10,  7, 11, 17, 18,  3,  5, 16,  8, 21, 24,  4, 15, 23, 19, 13, 12,  2, 20, 14, 22,  9,  6,  1
-};
-
-#if    defined(DIVISION_INSTRUCTION)
-#define    MOD5(argValue)    ((argValue) % 5)
-#else
-const UINT8 KeccakF_Mod5[10] =
-{
-    0, 1, 2, 3, 4, 0, 1, 2, 3, 4
-};
-#define    MOD5(argValue)    KeccakF_Mod5[argValue]
-#endif
-
-/* ---------------------------------------------------------------- */
-
-static tKeccakLane KeccakF1600_GetNextRoundConstant(UINT8 *LFSR);
-static tKeccakLane KeccakF1600_GetNextRoundConstant(UINT8 *LFSR)
-{
-    tSmaUtilInt i;
-    tKeccakLane    roundConstant;
-    tSmaUtilInt doXOR;
-    tSmaUtilInt tempLSFR;
-
-    roundConstant = 0;
-    tempLSFR = *LFSR;
-    for(i=1; i<128; i <<= 1)
-    {
-        doXOR = tempLSFR & 1;
-        if((tempLSFR & 0x80) != 0)
-            // Primitive polynomial over GF(2): x^8+x^6+x^5+x^4+1
-            tempLSFR = (tempLSFR << 1) ^ 0x71;
-        else
-            tempLSFR <<= 1;
-
-        if(doXOR != 0)
-            roundConstant ^= (tKeccakLane)1ULL << (i - 1);
-    }
-    *LFSR = (UINT8)tempLSFR;
-    return (roundConstant);
-}
-
-
 /* ---------------------------------------------------------------- */
 
 void KeccakF1600_Initialize(void)
@@ -184,67 +133,124 @@ void KeccakF1600_StateComplementBit(void *state, uint32_t position)
 
 /* ---------------------------------------------------------------- */
 
+/* The round constants for each of our 24 rounds. */
+static const tKeccakLane KeccakF1600_RoundConstants[cKeccakNumberOfRounds] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+/* One unrolled round from state A into state E, on a lane complemented state.
+ * Lanes 1, 2, 8, 12, 17 and 20 are held complemented, which turns most of the NOT operations in chi
+ * into plain AND / OR, leaving one NOT per plane. */
+#define KeccakF1600_Round(A, E, rc)                                                                 \
+{                                                                                                   \
+    const tKeccakLane C0 = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];                                     \
+    const tKeccakLane C1 = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];                                     \
+    const tKeccakLane C2 = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];                                     \
+    const tKeccakLane C3 = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];                                     \
+    const tKeccakLane C4 = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];                                     \
+                                                                                                    \
+    const tKeccakLane D0 = C4 ^ ROL64(C1, 1);                                                       \
+    const tKeccakLane D1 = C0 ^ ROL64(C2, 1);                                                       \
+    const tKeccakLane D2 = C1 ^ ROL64(C3, 1);                                                       \
+    const tKeccakLane D3 = C2 ^ ROL64(C4, 1);                                                       \
+    const tKeccakLane D4 = C3 ^ ROL64(C0, 1);                                                       \
+                                                                                                    \
+    tKeccakLane B0 = A[ 0] ^ D0;                                                                    \
+    tKeccakLane B1 = ROL64(A[ 6] ^ D1, 44);                                                         \
+    tKeccakLane B2 = ROL64(A[12] ^ D2, 43);                                                         \
+    tKeccakLane B3 = ROL64(A[18] ^ D3, 21);                                                         \
+    tKeccakLane B4 = ROL64(A[24] ^ D4, 14);                                                         \
+    E[ 0] =   B0 ^ (  B1 |  B2) ^ (rc);                                                             \
+    E[ 1] =   B1 ^ ((~B2) | B3);                                                                    \
+    E[ 2] =   B2 ^ (  B3 &  B4);                                                                    \
+    E[ 3] =   B3 ^ (  B4 |  B0);                                                                    \
+    E[ 4] =   B4 ^ (  B0 &  B1);                                                                    \
+                                                                                                    \
+    B0 = ROL64(A[ 3] ^ D3, 28);                                                                     \
+    B1 = ROL64(A[ 9] ^ D4, 20);                                                                     \
+    B2 = ROL64(A[10] ^ D0,  3);                                                                     \
+    B3 = ROL64(A[16] ^ D1, 45);                                                                     \
+    B4 = ROL64(A[22] ^ D2, 61);                                                                     \
+    E[ 5] =   B0 ^ (  B1 |  B2);                                                                    \
+    E[ 6] =   B1 ^ (  B2 &  B3);                                                                    \
+    E[ 7] =   B2 ^ (  B3 | (~B4));                                                                  \
+    E[ 8] =   B3 ^ (  B4 |  B0);                                                                    \
+    E[ 9] =   B4 ^ (  B0 &  B1);                                                                    \
+                                                                                                    \
+    B0 = ROL64(A[ 1] ^ D1,  1);                                                                     \
+    B1 = ROL64(A[ 7] ^ D2,  6);                                                                     \
+    B2 = ROL64(A[13] ^ D3, 25);                                                                     \
+    B3 = ROL64(A[19] ^ D4,  8);                                                                     \
+    B4 = ROL64(A[20] ^ D0, 18);                                                                     \
+    E[10] =   B0 ^ (  B1 |  B2);                                                                    \
+    E[11] =   B1 ^ (  B2 &  B3);                                                                    \
+    E[12] =   B2 ^ ((~B3) & B4);                                                                    \
+    E[13] = (~B3)^ (  B4 |  B0);                                                                    \
+    E[14] =   B4 ^ (  B0 &  B1);                                                                    \
+                                                                                                    \
+    B0 = ROL64(A[ 4] ^ D4, 27);                                                                     \
+    B1 = ROL64(A[ 5] ^ D0, 36);                                                                     \
+    B2 = ROL64(A[11] ^ D1, 10);                                                                     \
+    B3 = ROL64(A[17] ^ D2, 15);                                                                     \
+    B4 = ROL64(A[23] ^ D3, 56);                                                                     \
+    E[15] =   B0 ^ (  B1 &  B2);                                                                    \
+    E[16] =   B1 ^ (  B2 |  B3);                                                                    \
+    E[17] =   B2 ^ ((~B3) | B4);                                                                    \
+    E[18] = (~B3)^ (  B4 &  B0);                                                                    \
+    E[19] =   B4 ^ (  B0 |  B1);                                                                    \
+                                                                                                    \
+    B0 = ROL64(A[ 2] ^ D2, 62);                                                                     \
+    B1 = ROL64(A[ 8] ^ D3, 55);                                                                     \
+    B2 = ROL64(A[14] ^ D4, 39);                                                                     \
+    B3 = ROL64(A[15] ^ D0, 41);                                                                     \
+    B4 = ROL64(A[21] ^ D1,  2);                                                                     \
+    E[20] =   B0 ^ ((~B1) & B2);                                                                    \
+    E[21] = (~B1)^ (  B2 |  B3);                                                                    \
+    E[22] =   B2 ^ (  B3 &  B4);                                                                    \
+    E[23] =   B3 ^ (  B4 |  B0);                                                                    \
+    E[24] =   B4 ^ (  B0 &  B1);                                                                    \
+}
+
 void KeccakF1600_StatePermute(void *argState)
 {
-    tSmaUtilInt x, y, round;
-    tKeccakLane        temp;
-    tKeccakLane        BC[5];
-    tKeccakLane     *state;
-    UINT8             LFSRstate;
-
-    state = reinterpret_cast<tKeccakLane *>(argState);
-    LFSRstate = 0x01;
-    round = cKeccakNumberOfRounds;
-    do
+    tKeccakLane *state = reinterpret_cast<tKeccakLane *>(argState);
+
+    /* Work on local copies so the compiler can keep the lanes in registers. */
+    tKeccakLane A[25], E[25];
+    for(tSmaUtilInt i = 0; i < 25; ++i)
+        A[i] = state[i];
+
+    /* Complement our lanes on the way in. */
+    A[ 1] = ~A[ 1];
+    A[ 2] = ~A[ 2];
+    A[ 8] = ~A[ 8];
+    A[12] = ~A[12];
+    A[17] = ~A[17];
+    A[20] = ~A[20];
+
+    /* Two rounds per iteration, switching between our two states. */
+    for(tSmaUtilInt round = 0; round < cKeccakNumberOfRounds; round += 2)
     {
-        // Theta
-        for(x = 0; x < 5; ++x)
-        {
-            BC[x] = state[x] ^ state[5 + x] ^ state[10 + x] ^ state[15 + x] ^ state[20 + x];
-        }
-        for(x = 0; x < 5; ++x)
-        {
-            temp = BC[MOD5(x+4)] ^ ROL64(BC[MOD5(x+1)], 1);
-            for(y = 0; y < 25; y += 5)
-            {
-                state[y + x] ^= temp;
-            }
-        }
-
-        // Rho Pi
-        temp = state[1];
-        for(x = 0; x < 24; ++x)
-        {
-            BC[0] = state[KeccakF_PiLane[x]];
-            state[KeccakF_PiLane[x]] = ROL64(temp, KeccakF_RotationConstants[x]);
-            temp = BC[0];
-        }
+        KeccakF1600_Round(A, E, KeccakF1600_RoundConstants[round]);
+        KeccakF1600_Round(E, A, KeccakF1600_RoundConstants[round + 1]);
+    }
 
-        //    Chi
-        for(y = 0; y < 25; y += 5)
-        {
-#if defined(UNROLL_CHILOOP)
-            BC[0] = state[y + 0];
-            BC[1] = state[y + 1];
-            BC[2] = state[y + 2];
-            BC[3] = state[y + 3];
-            BC[4] = state[y + 4];
-#else
-            for(x = 0; x < 5; ++x)
-            {
-                BC[x] = state[y + x];
-            }
-#endif
-            for(x = 0; x < 5; ++x)
-            {
-                state[y + x] = BC[x] ^((~BC[MOD5(x+1)]) & BC[MOD5(x+2)]);
-            }
-        }
+    /* Complement our lanes on the way out. */
+    A[ 1] = ~A[ 1];
+    A[ 2] = ~A[ 2];
+    A[ 8] = ~A[ 8];
+    A[12] = ~A[12];
+    A[17] = ~A[17];
+    A[20] = ~A[20];
 
-        //    Iota
-        state[0] ^= KeccakF1600_GetNextRoundConstant(&LFSRstate);
-    }
-    while(--round != 0);
+    for(tSmaUtilInt i = 0; i < 25; ++i)
+        state[i] = A[i];
 }
 
 /* ---------------------------------------------------------------- */
@@ -0,0 +1,302 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/hash/SK.h>
+#include <LLC/hash/SK/skein_iv.h>
+
+#include <algorithm>
+#include <cstring>
+
+/* The AVX2 kernels are compiled per function, so the rest of the build doesn't need -mavx2. */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SK_TIMES4_AVX2
+#include <immintrin.h>
+#endif
+
+namespace LLC
+{
+    /* Hash one message with Skein-512 then Keccak-512, for CPUs without AVX2. */
+    static void sk512(const uint8_t* pData, const uint64_t nLength, uint512_t& hash)
+    {
+        uint512_t hashSkein;
+        Skein_512_Ctxt_t ctxSkein;
+        Skein_512_Init  (&ctxSkein, 512);
+        Skein_512_Update(&ctxSkein, (nLength == 0 ? pblank : pData), nLength);
+        Skein_512_Final (&ctxSkein, (uint8_t *)&hashSkein);
+
+        Keccak_HashInstance ctxKeccak;
+        Keccak_HashInitialize_SHA3_512(&ctxKeccak);
+        Keccak_HashUpdate(&ctxKeccak, (uint8_t *)&hashSkein, 512);
+        Keccak_HashFinal(&ctxKeccak, (uint8_t *)&hash);
+    }
+
+
+#ifdef SK_TIMES4_AVX2
+
+    /* Rotate each of the four 64-bit lanes left. */
+    #define ROL64x4(a, n) _mm256_or_si256(_mm256_slli_epi64((a), (n)), _mm256_srli_epi64((a), 64 - (n)))
+
+
+    /* The round constants for Keccak-f[1600]. */
+    const uint64_t KECCAK_ROUND_CONSTANTS[24] =
+    {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+        0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+        0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+    };
+
+
+    /* One plane of chi, where AVX2 gives us ANDN directly. */
+    #define CHIx4(E, n, B0, B1, B2, B3, B4)                                         \
+        E[n + 0] = _mm256_xor_si256(B0, _mm256_andnot_si256(B1, B2));               \
+        E[n + 1] = _mm256_xor_si256(B1, _mm256_andnot_si256(B2, B3));               \
+        E[n + 2] = _mm256_xor_si256(B2, _mm256_andnot_si256(B3, B4));               \
+        E[n + 3] = _mm256_xor_si256(B3, _mm256_andnot_si256(B4, B0));               \
+        E[n + 4] = _mm256_xor_si256(B4, _mm256_andnot_si256(B0, B1));
+
+
+    /* One round of Keccak-f[1600] on four states at once, from state A into state E. */
+    #define KECCAK_ROUNDx4(A, E, rc)                                                                            \
+    {                                                                                                           \
+        const __m256i C0 = _mm256_xor_si256(_mm256_xor_si256(A[0], A[5]), _mm256_xor_si256(A[10], _mm256_xor_si256(A[15], A[20]))); \
+        const __m256i C1 = _mm256_xor_si256(_mm256_xor_si256(A[1], A[6]), _mm256_xor_si256(A[11], _mm256_xor_si256(A[16], A[21]))); \
+        const __m256i C2 = _mm256_xor_si256(_mm256_xor_si256(A[2], A[7]), _mm256_xor_si256(A[12], _mm256_xor_si256(A[17], A[22]))); \
+        const __m256i C3 = _mm256_xor_si256(_mm256_xor_si256(A[3], A[8]), _mm256_xor_si256(A[13], _mm256_xor_si256(A[18], A[23]))); \
+        const __m256i C4 = _mm256_xor_si256(_mm256_xor_si256(A[4], A[9]), _mm256_xor_si256(A[14], _mm256_xor_si256(A[19], A[24]))); \
+                                                                                                                \
+        const __m256i D0 = _mm256_xor_si256(C4, ROL64x4(C1, 1));                                                \
+        const __m256i D1 = _mm256_xor_si256(C0, ROL64x4(C2, 1));                                                \
+        const __m256i D2 = _mm256_xor_si256(C1, ROL64x4(C3, 1));                                                \
+        const __m256i D3 = _mm256_xor_si256(C2, ROL64x4(C4, 1));                                                \
+        const __m256i D4 = _mm256_xor_si256(C3, ROL64x4(C0, 1));                                                \
+                                                                                                                \
+        __m256i B0 = _mm256_xor_si256(A[ 0], D0);                                                               \
+        __m256i B1 = ROL64x4(_mm256_xor_si256(A[ 6], D1), 44);                                                  \
+        __m256i B2 = ROL64x4(_mm256_xor_si256(A[12], D2), 43);                                                  \
+        __m256i B3 = ROL64x4(_mm256_xor_si256(A[18], D3), 21);                                                  \
+        __m256i B4 = ROL64x4(_mm256_xor_si256(A[24], D4), 14);                                                  \
+        CHIx4(E,  0, B0, B1, B2, B3, B4);                                                                       \
+        E[0] = _mm256_xor_si256(E[0], _mm256_set1_epi64x(rc));                                                  \
+                                                                                                                \
+        B0 = ROL64x4(_mm256_xor_si256(A[ 3], D3), 28);                                                          \
+        B1 = ROL64x4(_mm256_xor_si256(A[ 9], D4), 20);                                                          \
+        B2 = ROL64x4(_mm256_xor_si256(A[10], D0),  3);                                                          \
+        B3 = ROL64x4(_mm256_xor_si256(A[16], D1), 45);                                                          \
+        B4 = ROL64x4(_mm256_xor_si256(A[22], D2), 61);                                                          \
+        CHIx4(E,  5, B0, B1, B2, B3, B4);                                                                       \
+                                                                                                                \
+        B0 = ROL64x4(_mm256_xor_si256(A[ 1], D1),  1);                                                          \
+        B1 = ROL64x4(_mm256_xor_si256(A[ 7], D2),  6);                                                          \
+        B2 = ROL64x4(_mm256_xor_si256(A[13], D3), 25);                                                          \
+        B3 = ROL64x4(_mm256_xor_si256(A[19], D4),  8);                                                          \
+        B4 = ROL64x4(_mm256_xor_si256(A[20], D0), 18);                                                          \
+        CHIx4(E, 10, B0, B1, B2, B3, B4);                                                                       \
+                                                                                                                \
+        B0 = ROL64x4(_mm256_xor_si256(A[ 4], D4), 27);                                                          \
+        B1 = ROL64x4(_mm256_xor_si256(A[ 5], D0), 36);                                                          \
+        B2 = ROL64x4(_mm256_xor_si256(A[11], D1), 10);                                                          \
+        B3 = ROL64x4(_mm256_xor_si256(A[17], D2), 15);                                                          \
+        B4 = ROL64x4(_mm256_xor_si256(A[23], D3), 56);                                                          \
+        CHIx4(E, 15, B0, B1, B2, B3, B4);                                                                       \
+                                                                                                                \
+        B0 = ROL64x4(_mm256_xor_si256(A[ 2], D2), 62);                                                          \
+        B1 = ROL64x4(_mm256_xor_si256(A[ 8], D3), 55);                                                          \
+        B2 = ROL64x4(_mm256_xor_si256(A[14], D4), 39);                                                          \
+        B3 = ROL64x4(_mm256_xor_si256(A[15], D0), 41);                                                          \
+        B4 = ROL64x4(_mm256_xor_si256(A[21], D1),  2);                                                          \
+        CHIx4(E, 20, B0, B1, B2, B3, B4);                                                                       \
+    }
+
+
+    /* Run Keccak-f[1600] on four states at once, one state in each 64-bit lane. */
+    __attribute__((target("avx2")))
+    static void keccak_permute_x4(__m256i A[25])
+    {
+        __m256i E[25];
+        for(uint32_t nRound = 0; nRound < 24; nRound += 2)
+        {
+            KECCAK_ROUNDx4(A, E, KECCAK_ROUND_CONSTANTS[nRound]);
+            KECCAK_ROUNDx4(E, A, KECCAK_ROUND_CONSTANTS[nRound + 1]);
+        }
+    }
+
+
+    /* One MIX of Threefish-512 on four blocks at once. */
+    #define MIXx4(X, a, b, r)                                                       \
+        X[a] = _mm256_add_epi64(X[a], X[b]);                                        \
+        X[b] = _mm256_xor_si256(ROL64x4(X[b], r), X[a]);
+
+
+    /* Four rounds of Threefish-512, with the word permutation folded into the word order. */
+    #define ROUNDS512x4(X, R0, R1, R2, R3, R4, R5, R6, R7, R8, R9, R10, R11, R12, R13, R14, R15) \
+        MIXx4(X, 0, 1, R0);  MIXx4(X, 2, 3, R1);  MIXx4(X, 4, 5, R2);  MIXx4(X, 6, 7, R3);     \
+        MIXx4(X, 2, 1, R4);  MIXx4(X, 4, 7, R5);  MIXx4(X, 6, 5, R6);  MIXx4(X, 0, 3, R7);     \
+        MIXx4(X, 4, 1, R8);  MIXx4(X, 6, 3, R9);  MIXx4(X, 0, 5, R10); MIXx4(X, 2, 7, R11);    \
+        MIXx4(X, 6, 1, R12); MIXx4(X, 0, 7, R13); MIXx4(X, 2, 5, R14); MIXx4(X, 4, 3, R15);
+
+
+    /* Process one UBI block of Skein-512 on four chaining values at once, all with the same tweak. */
+    __attribute__((target("avx2")))
+    static void skein512_block_x4(__m256i X[8], const __m256i w[8], const uint64_t T0, const uint64_t T1)
+    {
+        /* Build our key schedule. */
+        __m256i ks[9];
+        ks[8] = _mm256_set1_epi64x(SKEIN_KS_PARITY);
+        for(uint32_t i = 0; i < 8; ++i)
+        {
+            ks[i] = X[i];
+            ks[8] = _mm256_xor_si256(ks[8], ks[i]);
+        }
+
+        const uint64_t ts[3] = { T0, T1, T0 ^ T1 };
+
+        /* Do the first full key injection. */
+        __m256i Y[8];
+        for(uint32_t i = 0; i < 8; ++i)
+            Y[i] = _mm256_add_epi64(w[i], ks[i]);
+
+        Y[5] = _mm256_add_epi64(Y[5], _mm256_set1_epi64x(ts[0]));
+        Y[6] = _mm256_add_epi64(Y[6], _mm256_set1_epi64x(ts[1]));
+
+        /* Run the rounds, eight at a time with a key injection after every four. */
+        for(uint32_t r = 0; r < SKEIN_512_ROUNDS_TOTAL / 4; r += 2)
+        {
+            ROUNDS512x4(Y, R_512_0_0, R_512_0_1, R_512_0_2, R_512_0_3, R_512_1_0, R_512_1_1, R_512_1_2, R_512_1_3,
+                           R_512_2_0, R_512_2_1, R_512_2_2, R_512_2_3, R_512_3_0, R_512_3_1, R_512_3_2, R_512_3_3);
+
+            for(uint32_t i = 0; i < 8; ++i)
+                Y[i] = _mm256_add_epi64(Y[i], ks[(r + 1 + i) % 9]);
+
+            Y[5] = _mm256_add_epi64(Y[5], _mm256_set1_epi64x(ts[(r + 1) % 3]));
+            Y[6] = _mm256_add_epi64(Y[6], _mm256_set1_epi64x(ts[(r + 2) % 3]));
+            Y[7] = _mm256_add_epi64(Y[7], _mm256_set1_epi64x(r + 1));
+
+            ROUNDS512x4(Y, R_512_4_0, R_512_4_1, R_512_4_2, R_512_4_3, R_512_5_0, R_512_5_1, R_512_5_2, R_512_5_3,
+                           R_512_6_0, R_512_6_1, R_512_6_2, R_512_6_3, R_512_7_0, R_512_7_1, R_512_7_2, R_512_7_3);
+
+            for(uint32_t i = 0; i < 8; ++i)
+                Y[i] = _mm256_add_epi64(Y[i], ks[(r + 2 + i) % 9]);
+
+            Y[5] = _mm256_add_epi64(Y[5], _mm256_set1_epi64x(ts[(r + 2) % 3]));
+            Y[6] = _mm256_add_epi64(Y[6], _mm256_set1_epi64x(ts[(r + 3) % 3]));
+            Y[7] = _mm256_add_epi64(Y[7], _mm256_set1_epi64x(r + 2));
+        }
+
+        /* Do the final feedforward into our chaining values. */
+        for(uint32_t i = 0; i < 8; ++i)
+            X[i] = _mm256_xor_si256(Y[i], w[i]);
+    }
+
+
+    /* Hash four messages of the same length with Skein-512 then Keccak-512, one message in each 64-bit lane. */
+    __attribute__((target("avx2")))
+    static void sk512_x4(const uint8_t* const pData[4], const uint64_t nLength, uint512_t pHash[4])
+    {
+        /* Start from the precomputed chaining values for a 512-bit hash. */
+        __m256i X[8];
+        for(uint32_t i = 0; i < 8; ++i)
+            X[i] = _mm256_set1_epi64x(SKEIN_512_IV_512[i]);
+
+        /* Process our message blocks, the last block is always held back for the final flag, even when full. */
+        const uint64_t nBlocks = (nLength == 0 ? 1 : (nLength + SKEIN_512_BLOCK_BYTES - 1) / SKEIN_512_BLOCK_BYTES);
+
+        uint64_t T0 = 0;
+        uint64_t T1 = SKEIN_T1_FLAG_FIRST | SKEIN_T1_BLK_TYPE_MSG;
+        for(uint64_t nBlock = 0; nBlock < nBlocks; ++nBlock)
+        {
+            const uint64_t nOffset = nBlock * SKEIN_512_BLOCK_BYTES;
+            const uint64_t nBytes  = std::min(nLength - nOffset, uint64_t(SKEIN_512_BLOCK_BYTES));
+
+            /* Gather our words from each message, zero padding the final block. */
+            uint64_t vWords[4][8] = { };
+            for(uint32_t j = 0; nBytes > 0 && j < 4; ++j)
+                std::memcpy(vWords[j], pData[j] + nOffset, nBytes);
+
+            __m256i w[8];
+            for(uint32_t i = 0; i < 8; ++i)
+                w[i] = _mm256_set_epi64x(vWords[3][i], vWords[2][i], vWords[1][i], vWords[0][i]);
+
+            /* Set our tweak for this block. */
+            T0 += nBytes;
+            if(nBlock == nBlocks - 1)
+                T1 |= SKEIN_T1_FLAG_FINAL;
+
+            skein512_block_x4(X, w, T0, T1);
+            T1 &= ~SKEIN_T1_FLAG_FIRST;
+        }
+
+        /* Run the output stage with a zero counter, for a single block of output. */
+        const __m256i wOutput[8] = { };
+        skein512_block_x4(X, wOutput, sizeof(uint64_t), SKEIN_T1_FLAG_FIRST | SKEIN_T1_BLK_TYPE_OUT_FINAL);
+
+        /* Absorb our Skein hashes into Keccak, SHA3-512 has a 72 byte rate so this is a single block. */
+        __m256i A[25];
+        for(uint32_t i = 0; i < 8; ++i)
+            A[i] = X[i];
+
+        /* Add the 0x06 domain suffix and the final padding bit at the end of the rate. */
+        A[8] = _mm256_set1_epi64x(0x8000000000000006ULL);
+        for(uint32_t i = 9; i < 25; ++i)
+            A[i] = _mm256_setzero_si256();
+
+        keccak_permute_x4(A);
+
+        /* Scatter our lanes back out to each hash. */
+        uint64_t vLanes[8][4];
+        for(uint32_t i = 0; i < 8; ++i)
+            _mm256_storeu_si256((__m256i*)vLanes[i], A[i]);
+
+        for(uint32_t j = 0; j < 4; ++j)
+        {
+            uint64_t vHash[8];
+            for(uint32_t i = 0; i < 8; ++i)
+                vHash[i] = vLanes[i][j];
+
+            std::memcpy((uint8_t*)&pHash[j], vHash, sizeof(vHash));
+        }
+    }
+
+#endif
+
+
+    /* Check if our CPU supports the AVX2 kernels. */
+    bool SupportsAVX2()
+    {
+    #ifdef SK_TIMES4_AVX2
+        static const bool fAVX2 = __builtin_cpu_supports("avx2");
+        return fAVX2;
+    #else
+        return false;
+    #endif
+    }
+
+
+    /* 512-bit hashing of four messages of the same length at once. */
+    void SK512x4(const uint8_t* const pData[4], const uint64_t nLength, uint512_t pHash[4])
+    {
+    #ifdef SK_TIMES4_AVX2
+        if(SupportsAVX2())
+        {
+            sk512_x4(pData, nLength, pHash);
+            return;
+        }
+    #endif
+
+        /* Otherwise hash each message in turn. */
+        for(uint32_t j = 0; j < 4; ++j)
+            sk512(pData[j], nLength, pHash[j]);
+    }
+}
@@ -0,0 +1,76 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLC_INCLUDE_FERMAT_H
+#define NEXUS_LLC_INCLUDE_FERMAT_H
+
+#include <LLC/types/uint1024.h>
+
+namespace LLC
+{
+
+    /** SupportsIFMA
+     *
+     *  Check if our CPU supports the AVX-512 IFMA fermat kernels, checked once at runtime.
+     *
+     **/
+    bool SupportsIFMA();
+
+
+    /** FermatTest
+     *
+     *  Calculate 2^(p - 1) mod p for a batch of numbers. Odd numbers are tested eight at a time with fixed width
+     *  montgomery arithmetic on the stack when the CPU supports AVX-512 IFMA. Otherwise, or when a number is left
+     *  on its own, it is tested with the big number library.
+     *
+     *  @param[in] pTest The numbers to test.
+     *  @param[in] nTotal The total numbers to test.
+     *  @param[out] pRemainders The remainder of each test, which can be the same array as pTest.
+     *
+     **/
+    void FermatTest(const uint1024_t* pTest, const uint32_t nTotal, uint1024_t* pRemainders);
+
+
+    /** FermatTest
+     *
+     *  Calculate 2^(p - 1) mod p for one number, which uses the big number library since it can't fill a batch.
+     *
+     *  @param[in] hashTest The number to test.
+     *
+     *  @return The remainder of the fermat test, which is one if the number is a probable prime.
+     *
+     **/
+    uint1024_t FermatTest(const uint1024_t& hashTest);
+
+
+    /** FermatCluster
+     *
+     *  Test the numbers of a prime cluster, stepping from a base number by each offset in turn. The residues of the
+     *  base by the first eleven primes are found once and carried forward by the offsets, and the numbers with no
+     *  small divisors are given fermat tests in batches.
+     *
+     *  @param[in] hashBase The number the offsets start from, which isn't tested.
+     *  @param[in] pOffsets The gap from each number to the next.
+     *  @param[in] nOffsets The total offsets to step through.
+     *  @param[out] pPrimes Set for each number that passed, must hold nOffsets flags or be nullptr.
+     *
+     *  @return The total numbers that passed the small divisor and fermat tests.
+     *
+     **/
+    uint32_t FermatCluster(const uint1024_t& hashBase, const uint8_t* pOffsets, const uint32_t nOffsets,
+                           bool* pPrimes = nullptr);
+
+}
+
+#endif
@@ -10,6 +10,13 @@
             "ad vocem populi" - To the Voice of the People
 
 ____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLC_PRIME_FERMAT_H
+#define NEXUS_LLC_PRIME_FERMAT_H
+
+#include <LLC/types/uint1024.h>
+
 #include <cstdint>
 
 
@@ -65,15 +72,16 @@ inline uint32_t cmp_ge_n(uint32_t *x, uint32_t *y)
 template<uint8_t WORD_MAX>
 inline uint8_t sub_n(uint32_t *z, uint32_t *x, uint32_t *y)
 {
-    uint32_t temp;
+    uint64_t temp;
     uint8_t c = 0;
 
     //#pragma unroll
     for(uint8_t i = 0; i < WORD_MAX; ++i)
     {
-        temp = x[i] - y[i] - c;
-        c = (temp > x[i]);
-        z[i] = temp;
+        //borrow in 64 bits, since y[i] + c wraps when y[i] is all ones
+        temp = uint64_t(x[i]) - y[i] - c;
+        c = static_cast<uint8_t>(temp >> 63);
+        z[i] = static_cast<uint32_t>(temp);
     }
     return c;
 }
@@ -103,9 +111,10 @@ inline void add_ui(uint32_t *z, uint32_t *x, const uint64_t &ui)
     uint8_t c = temp < x[0];
     z[0] = temp;
 
-    temp = x[1] + static_cast<uint32_t>(ui >> 32) + c;
-    c = temp < x[1];
-    z[1] = temp;
+    //carry in 64 bits, since the high word of ui plus c wraps when it is all ones
+    const uint64_t temp2 = uint64_t(x[1]) + (ui >> 32) + c;
+    c = static_cast<uint8_t>(temp2 >> 32);
+    z[1] = static_cast<uint32_t>(temp2);
 
     //#pragma unroll
     for(uint8_t i = 2; i < WORD_MAX; ++i)
@@ -143,7 +152,7 @@ inline void sqrredc(uint32_t *z, uint32_t *x, uint32_t *n, const uint32_t d, uin
 {
     uint64_t prod;
     uint32_t m;
-    uint32_t c;
+    uint32_t c = 0;
 
     uint8_t i;
     uint8_t j;
@@ -152,6 +161,7 @@ inline void sqrredc(uint32_t *z, uint32_t *x, uint32_t *n, const uint32_t d, uin
         t[i] = 0;
 
 
+    /* Cross products x[i] * x[j] for i < j, each added once. */
     for(i = 0; i < WORD_MAX; ++i)
     {
         for(j = i + 1; j < WORD_MAX; ++j)
@@ -167,31 +177,25 @@ inline void sqrredc(uint32_t *z, uint32_t *x, uint32_t *n, const uint32_t d, uin
     }
 
 
-    for(i = 0; i < (WORD_MAX<<1); ++i)
-    {
-        prod = (static_cast<uint64_t>(t[i]) << 1) + c;
-        t[i] = prod;
-        c = prod >> 32;
-    }
-
-
+    /* Double the cross products and add the squares in one carry chain. */
+    uint32_t hi = 0;
     for(i = 0; i < WORD_MAX; ++i)
     {
+        const uint32_t lo0 = t[i + i];
+        const uint32_t lo1 = t[i + i + 1];
+
         prod = static_cast<uint64_t>(x[i]) * static_cast<uint64_t>(x[i]) +
-               static_cast<uint64_t>(t[i + i]);
+               static_cast<uint64_t>((lo0 << 1) | hi) + c;
 
         t[i + i] = prod;
         c = prod >> 32;
 
-        for(j = i + 1; j < WORD_MAX; ++j)
-        {
-            prod = static_cast<uint64_t>(t[i + j]) + c;
-            t[i + j] = prod;
-            c = prod >> 32;
-        }
+        prod = static_cast<uint64_t>((lo1 << 1) | (lo0 >> 31)) + c;
 
-        t[WORD_MAX + i] += c;
+        t[i + i + 1] = prod;
+        c = prod >> 32;
 
+        hi = lo1 >> 31;
     }
 
 
@@ -304,7 +308,7 @@ uint16_t bit_count(uint32_t *x)
     //#pragma unroll
     for(uint16_t i = 0; i < (WORD_MAX << 5); ++i)
     {
-        if(x[i>>5] & (1 << (i & 31)))
+        if(x[i>>5] & (1u << (i & 31)))
             msb = i;
     }
 
@@ -474,7 +478,7 @@ void pow2m(uint32_t *X, uint32_t *Exp, uint32_t *N, uint32_t *table)
 
         wval <<= 1;
 
-        if(Exp[i>>5] & (1 << (i & 31)))
+        if(Exp[i>>5] & (1u << (i & 31)))
             wval |= 1;
 
         if(((i % WINDOW_BITS) == 0) && wval)
@@ -507,7 +511,7 @@ void pow2m(uint32_t *X, uint32_t *Exp, uint32_t *N)
         //mulredc<WORD_MAX>(X, X, X, N, d, t);
         sqrredc<WORD_MAX>(X, X, N, d, t);
 
-        if(Exp[i>>5] & (1 << (i & 31)))
+        if(Exp[i>>5] & (1u << (i & 31)))
             mulredc<WORD_MAX>(X, X, A, N, d, t);
     }
 
@@ -521,7 +525,7 @@ bool fermat_prime(uint32_t *p)
 {
     uint32_t e[WORD_MAX];
     uint32_t r[WORD_MAX];
-    uint32_t table[WINDOW_SIZE * 32];
+    uint32_t table[WINDOW_SIZE * WORD_MAX];
 
     sub_ui<WORD_MAX>(e, p, 1);
     pow2m<WORD_MAX>(r, e, p, table);
@@ -543,7 +547,7 @@ bool fermat_prime(uint32_t *p)
 
 
 /* Test if number p passes Fermat Primality Test base 2. */
-uint1024_t fermat_prime(const uint1024_t &p)
+inline uint1024_t fermat_prime(const uint1024_t &p)
 {
     uint1024_t r;
     uint32_t e[32];
@@ -558,3 +562,5 @@ uint1024_t fermat_prime(const uint1024_t &p)
 
     return r;
 }
+
+#endif
@@ -0,0 +1,290 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/cache/binary_clock.h>
+#include <LLD/templates/key.h>
+#include <LLD/hash/xxh3.h>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace LLD
+{
+    /* The total shards that keys are spread over. */
+    const uint32_t CLOCK_CACHE_SHARDS = 32;
+
+
+    /*  Node to hold the binary data of a cache entry. */
+    struct ClockNode
+    {
+    public:
+
+        /** Store the key as 64-bit hash, the same as the LRU cache. **/
+        uint64_t hashKey;
+
+        /** The data in the binary node. **/
+        std::vector<uint8_t> vData;
+
+        /** Set on every hit, cleared by the clock hand as it passes. **/
+        std::atomic<bool> fReferenced;
+
+        /** Default constructor **/
+        ClockNode()
+        : hashKey     (0)
+        , vData       ( )
+        , fReferenced (false)
+        {
+        }
+
+        /** Check if node is in null state. **/
+        bool IsNull() const
+        {
+            return hashKey == 0;
+        }
+
+        /** Set node into null state. **/
+        void SetNull()
+        {
+            hashKey = 0;
+            fReferenced.store(false, std::memory_order_relaxed);
+
+            std::vector<uint8_t>().swap(vData);
+        }
+    };
+
+
+    /*  One independently locked shard of the clock cache. */
+    struct ClockShard
+    {
+    public:
+
+        /** Shared for hits, exclusive for writes. **/
+        mutable std::shared_mutex MUTEX;
+
+        /** Map of key hashes to their node in the clock. **/
+        std::unordered_map<uint64_t, uint32_t> mapIndex;
+
+        /** The nodes that the clock hand sweeps over. **/
+        std::vector<ClockNode*> vNodes;
+
+        /** The nodes that are free to be reused. **/
+        std::vector<uint32_t> vFree;
+
+        /** The position of the clock hand. **/
+        uint32_t nHand;
+
+        /** The current size of this shard. **/
+        uint64_t nCurrentSize;
+
+        /** The maximum size of this shard. **/
+        uint64_t nMaxSize;
+
+        /** Shard Size Constructor **/
+        ClockShard(const uint64_t nMaxSizeIn)
+        : MUTEX        ( )
+        , mapIndex     ( )
+        , vNodes       ( )
+        , vFree        ( )
+        , nHand        (0)
+        , nCurrentSize (0)
+        , nMaxSize     (nMaxSizeIn)
+        {
+        }
+
+        /** Default Destructor **/
+        ~ClockShard()
+        {
+            for(auto& pnode : vNodes)
+                delete pnode;
+        }
+
+        /** Release a node for reuse, caller must hold the exclusive lock. **/
+        void Release(const uint32_t nNode)
+        {
+            ClockNode* pnode = vNodes[nNode];
+
+            nCurrentSize -= pnode->vData.size() + sizeof(ClockNode);
+            mapIndex.erase(pnode->hashKey);
+
+            pnode->SetNull();
+            vFree.push_back(nNode);
+        }
+
+        /** Evict nodes that weren't referenced since the hand last passed, until we are within our size. **/
+        void Evict()
+        {
+            /* Two full sweeps clear every reference bit, so we always find a node to evict by then. */
+            uint64_t nSweep = vNodes.size() * 2;
+            while(nCurrentSize > nMaxSize && nSweep-- > 0)
+            {
+                /* Get the node under our hand and advance it. */
+                const uint32_t nNode = nHand;
+                nHand = (nHand + 1) % vNodes.size();
+
+                /* Skip over free nodes. */
+                ClockNode* pnode = vNodes[nNode];
+                if(pnode->IsNull())
+                    continue;
+
+                /* Give referenced nodes another pass of the hand. */
+                if(pnode->fReferenced.exchange(false, std::memory_order_relaxed))
+                    continue;
+
+                Release(nNode);
+            }
+        }
+    };
+
+
+    /** Cache Size Constructor **/
+    BinaryCLOCK::BinaryCLOCK(const uint32_t nCacheSizeIn)
+    : MAX_CACHE_SIZE (nCacheSizeIn)
+    , vShards        (CLOCK_CACHE_SHARDS, nullptr)
+    {
+        /* Split our size evenly between our shards. */
+        for(auto& pshard : vShards)
+            pshard = new ClockShard(MAX_CACHE_SIZE / CLOCK_CACHE_SHARDS);
+    }
+
+
+    /** Class Destructor. **/
+    BinaryCLOCK::~BinaryCLOCK()
+    {
+        for(auto& pshard : vShards)
+            delete pshard;
+    }
+
+
+    /*  Check if data exists. */
+    bool BinaryCLOCK::Has(const std::vector<uint8_t>& vKey) const
+    {
+        /* Get the shard for this key. */
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        const ClockShard* pshard = shard(hashKey);
+
+        std::shared_lock<std::shared_mutex> lock(pshard->MUTEX);
+        return pshard->mapIndex.count(hashKey) > 0;
+    }
+
+
+    /*  Get the data by index */
+    bool BinaryCLOCK::Get(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData)
+    {
+        /* Get the shard for this key. */
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        const ClockShard* pshard = shard(hashKey);
+
+        std::shared_lock<std::shared_mutex> lock(pshard->MUTEX);
+
+        /* Check for data. */
+        const auto it = pshard->mapIndex.find(hashKey);
+        if(it == pshard->mapIndex.end())
+            return false;
+
+        /* Get the data and mark the node as referenced, this is the only write on a hit. */
+        ClockNode* pnode = pshard->vNodes[it->second];
+        vData = pnode->vData;
+
+        pnode->fReferenced.store(true, std::memory_order_relaxed);
+
+        return true;
+    }
+
+
+    /*  Add data in the Pool. */
+    void BinaryCLOCK::Put(const SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData, bool fReserve)
+    {
+        /* Get the shard for this key. */
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        ClockShard* pshard = shard(hashKey);
+
+        std::unique_lock<std::shared_mutex> lock(pshard->MUTEX);
+
+        /* Check for an existing node to update. */
+        const auto it = pshard->mapIndex.find(hashKey);
+        if(it != pshard->mapIndex.end())
+        {
+            ClockNode* pnode = pshard->vNodes[it->second];
+
+            /* Set the new data. */
+            pshard->nCurrentSize -= pnode->vData.size();
+            pnode->vData = vData;
+            pshard->nCurrentSize += pnode->vData.size();
+
+            pnode->fReferenced.store(true, std::memory_order_relaxed);
+        }
+        else
+        {
+            /* Reuse a free node, or grow our clock. */
+            uint32_t nNode = 0;
+            if(!pshard->vFree.empty())
+            {
+                nNode = pshard->vFree.back();
+                pshard->vFree.pop_back();
+            }
+            else
+            {
+                nNode = static_cast<uint32_t>(pshard->vNodes.size());
+                pshard->vNodes.push_back(new ClockNode());
+            }
+
+            /* Set the new values, new nodes start unreferenced so one time reads are evicted first. */
+            ClockNode* pnode = pshard->vNodes[nNode];
+            pnode->hashKey = hashKey;
+            pnode->vData   = vData;
+
+            pshard->mapIndex[hashKey] = nNode;
+            pshard->nCurrentSize += pnode->vData.size() + sizeof(ClockNode);
+        }
+
+        /* Remove unreferenced nodes if cache too large. */
+        pshard->Evict();
+    }
+
+
+    /*  Reserve this item in the cache permanently if true, unreserve if false. */
+    void BinaryCLOCK::Reserve(const std::vector<uint8_t>& vKey, bool fReserve)
+    {
+    }
+
+
+    /*  Force Remove Object by Index. */
+    bool BinaryCLOCK::Remove(const std::vector<uint8_t>& vKey)
+    {
+        /* Get the shard for this key. */
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        ClockShard* pshard = shard(hashKey);
+
+        std::unique_lock<std::shared_mutex> lock(pshard->MUTEX);
+
+        /* Check for data. */
+        const auto it = pshard->mapIndex.find(hashKey);
+        if(it == pshard->mapIndex.end())
+            return false;
+
+        /* Free the node. */
+        pshard->Release(it->second);
+
+        return true;
+    }
+
+
+    /*  Find the shard that a key hash is assigned to. */
+    ClockShard* BinaryCLOCK::shard(const uint64_t hashKey) const
+    {
+        /* Use the upper bits, the lower bits are used by the shard's map. */
+        return vShards[(hashKey >> 32) % vShards.size()];
+    }
+}
@@ -0,0 +1,280 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/templates/bloom.h>
+#include <LLD/hash/xxh3.h>
+
+#include <Util/include/debug.h>
+#include <Util/include/mutex.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace LLD
+{
+
+    /* The version of our filter file, to reject files in any other format. */
+    static const uint32_t BLOOM_VERSION = 2;
+
+
+    /* The bits reserved in a stage for each key of its capacity. */
+    static const uint64_t BLOOM_BITS_PER_KEY = 16;
+
+
+    /* The smallest capacity of a stage. */
+    static const uint64_t BLOOM_MIN_CAPACITY = 4096;
+
+
+    /* Capacity Constructor */
+    BloomFilter::Stage::Stage(const uint64_t nCapacityIn)
+    : vBits      ((std::max(nCapacityIn, BLOOM_MIN_CAPACITY) * BLOOM_BITS_PER_KEY + 63) / 64)
+    , nTotalBits (vBits.size() * 64)
+    , nCapacity  (std::max(nCapacityIn, BLOOM_MIN_CAPACITY))
+    {
+        for(auto& nWord : vBits)
+            nWord.store(0, std::memory_order_relaxed);
+    }
+
+
+    /* Filter Capacity Constructor */
+    BloomFilter::BloomFilter(const uint64_t nCapacityIn, const uint32_t nHashesIn)
+    : vStages      (MAX_STAGES, nullptr)
+    , nTotalStages (1)
+    , nStageKeys   (0)
+    , nTotalHashes (nHashesIn)
+    , STAGE_MUTEX  ( )
+    {
+        vStages[0] = new Stage(nCapacityIn);
+    }
+
+
+    /* Default Destructor. */
+    BloomFilter::~BloomFilter()
+    {
+        for(auto& pStage : vStages)
+            if(pStage)
+                delete pStage;
+    }
+
+
+    /* Add a key to the filter, growing it by a stage if the newest stage is full. */
+    void BloomFilter::Insert(const uint8_t* pBegin, const uint64_t nSize)
+    {
+        /* Skip keys we may already hold, so that rewriting a key doesn't count towards our capacity. */
+        if(Has(pBegin, nSize))
+            return;
+
+        /* Grow the filter if our newest stage is full. */
+        const Stage* pStage = vStages[nTotalStages.load(std::memory_order_acquire) - 1];
+        if(nStageKeys.fetch_add(1) >= pStage->nCapacity)
+            add_stage(pStage);
+
+        /* Use double hashing to derive all of our bit positions. */
+        const uint64_t nHash1 = XXH64(pBegin, nSize, 0);
+        const uint64_t nHash2 = XXH64(pBegin, nSize, nHash1) | 1;
+
+        /* Set each of the bits for this key in our newest stage. */
+        Stage* pNewest = vStages[nTotalStages.load(std::memory_order_acquire) - 1];
+        for(uint32_t n = 0; n < nTotalHashes; ++n)
+        {
+            const uint64_t nBit = (nHash1 + n * nHash2) % pNewest->nTotalBits;
+            pNewest->vBits[nBit / 64].fetch_or(uint64_t(1) << (nBit % 64), std::memory_order_relaxed);
+        }
+    }
+
+
+    /* Check if a key may be contained in the filter. */
+    bool BloomFilter::Has(const uint8_t* pBegin, const uint64_t nSize) const
+    {
+        /* Use double hashing to derive all of our bit positions. */
+        const uint64_t nHash1 = XXH64(pBegin, nSize, 0);
+        const uint64_t nHash2 = XXH64(pBegin, nSize, nHash1) | 1;
+
+        /* Check each stage for all of the bits for this key. */
+        const uint32_t nStages = nTotalStages.load(std::memory_order_acquire);
+        for(uint32_t nStage = 0; nStage < nStages; ++nStage)
+        {
+            const Stage* pStage = vStages[nStage];
+
+            bool fHas = true;
+            for(uint32_t n = 0; n < nTotalHashes && fHas; ++n)
+            {
+                const uint64_t nBit = (nHash1 + n * nHash2) % pStage->nTotalBits;
+                fHas = (pStage->vBits[nBit / 64].load(std::memory_order_relaxed) & (uint64_t(1) << (nBit % 64)));
+            }
+
+            if(fHas)
+                return true;
+        }
+
+        return false;
+    }
+
+
+    /* Load the filter stages from disk, replacing the current stages. */
+    bool BloomFilter::Load(const std::string& strPath, const uint64_t nStamp)
+    {
+        /* Open our file for reading. */
+        std::ifstream stream(strPath, std::ios::in | std::ios::binary);
+        if(!stream.is_open())
+            return false;
+
+        /* Read the header that describes the filter. */
+        uint32_t nVersion   = 0;
+        uint64_t nStampDisk = 0;
+        uint32_t nHashes    = 0;
+        uint32_t nStages    = 0;
+        uint64_t nKeys      = 0;
+        stream.read((char*)&nVersion,   sizeof(nVersion));
+        stream.read((char*)&nStampDisk, sizeof(nStampDisk));
+        stream.read((char*)&nHashes,    sizeof(nHashes));
+        stream.read((char*)&nStages,    sizeof(nStages));
+        stream.read((char*)&nKeys,      sizeof(nKeys));
+
+        /* Check that the filter on disk was saved by us from the same keychain files. */
+        if(!stream || nVersion != BLOOM_VERSION || nStampDisk != nStamp || nHashes != nTotalHashes
+        || nStages == 0 || nStages > MAX_STAGES)
+            return false;
+
+        /* Read each of the stages. */
+        std::vector<Stage*> vLoaded(MAX_STAGES, nullptr);
+        for(uint32_t nStage = 0; nStage < nStages; ++nStage)
+        {
+            /* Read the capacity, which must be one we could have written. */
+            uint64_t nCapacity = 0;
+            stream.read((char*)&nCapacity, sizeof(nCapacity));
+            if(!stream || nCapacity < BLOOM_MIN_CAPACITY || nCapacity > (uint64_t(1) << 40))
+                break;
+
+            /* Read the stage words. */
+            Stage* pStage = new Stage(nCapacity);
+            std::vector<uint64_t> vWords(pStage->vBits.size(), 0);
+            if(!stream.read((char*)&vWords[0], vWords.size() * sizeof(uint64_t)))
+            {
+                delete pStage;
+                break;
+            }
+
+            /* Set our bits from disk. */
+            for(uint64_t n = 0; n < vWords.size(); ++n)
+                pStage->vBits[n].store(vWords[n], std::memory_order_relaxed);
+
+            vLoaded[nStage] = pStage;
+        }
+
+        /* Discard everything if any stage was missing. */
+        if(!vLoaded[nStages - 1])
+        {
+            for(auto& pStage : vLoaded)
+                if(pStage)
+                    delete pStage;
+
+            return false;
+        }
+
+        /* Swap in our loaded stages. */
+        for(auto& pStage : vStages)
+            if(pStage)
+                delete pStage;
+
+        vStages = vLoaded;
+        nTotalStages.store(nStages);
+        nStageKeys.store(nKeys);
+
+        return true;
+    }
+
+
+    /* Save the filter stages to disk. */
+    bool BloomFilter::Save(const std::string& strPath, const uint64_t nStamp) const
+    {
+        /* Open our file for writing. */
+        std::ofstream stream(strPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!stream.is_open())
+            return false;
+
+        /* Write the header. */
+        const uint32_t nStages = nTotalStages.load();
+        const uint64_t nKeys   = nStageKeys.load();
+        stream.write((char*)&BLOOM_VERSION, sizeof(BLOOM_VERSION));
+        stream.write((char*)&nStamp,        sizeof(nStamp));
+        stream.write((char*)&nTotalHashes,  sizeof(nTotalHashes));
+        stream.write((char*)&nStages,       sizeof(nStages));
+        stream.write((char*)&nKeys,         sizeof(nKeys));
+
+        /* Write each of the stages. */
+        for(uint32_t nStage = 0; nStage < nStages; ++nStage)
+        {
+            const Stage* pStage = vStages[nStage];
+
+            /* Copy our words out of their atomic containers. */
+            std::vector<uint64_t> vWords(pStage->vBits.size(), 0);
+            for(uint64_t n = 0; n < vWords.size(); ++n)
+                vWords[n] = pStage->vBits[n].load(std::memory_order_relaxed);
+
+            stream.write((char*)&pStage->nCapacity, sizeof(pStage->nCapacity));
+            stream.write((char*)&vWords[0], vWords.size() * sizeof(uint64_t));
+        }
+
+        return static_cast<bool>(stream);
+    }
+
+
+    /* Get a stamp of the sizes and modification times of a keychain's files. */
+    uint64_t BloomFilter::Stamp(const std::string& strBaseLocation)
+    {
+        /* Collect the size and modification time of the index and every hashmap file. */
+        std::vector<int64_t> vStats;
+        for(uint32_t nFile = 0; ; ++nFile)
+        {
+            /* The index comes first, followed by hashmap files until one is missing. */
+            const std::string strFile = (nFile == 0 ? debug::safe_printstr(strBaseLocation, "_hashmap.index") :
+                debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile - 1));
+
+            struct stat statbuf;
+            if(stat(strFile.c_str(), &statbuf) != 0)
+                break;
+
+            vStats.push_back(int64_t(statbuf.st_size));
+            vStats.push_back(int64_t(statbuf.st_mtime));
+
+            #if defined(__APPLE__)
+            vStats.push_back(int64_t(statbuf.st_mtimespec.tv_nsec));
+            #elif !defined(WIN32)
+            vStats.push_back(int64_t(statbuf.st_mtim.tv_nsec));
+            #endif
+        }
+
+        return XXH64(vStats.data(), vStats.size() * sizeof(int64_t), BLOOM_VERSION);
+    }
+
+
+    /* Add a new stage of twice the capacity of the newest, if the newest is full. */
+    void BloomFilter::add_stage(const Stage* pStage)
+    {
+        LOCK(STAGE_MUTEX);
+
+        /* Check that no other thread has grown the filter, or that we have run out of stages. */
+        const uint32_t nStages = nTotalStages.load();
+        if(vStages[nStages - 1] != pStage || nStages == MAX_STAGES)
+            return;
+
+        /* Publish the new stage only once it is built, so lookups never see a partial stage. */
+        vStages[nStages] = new Stage(pStage->nCapacity * 2);
+        nStageKeys.store(1);
+        nTotalStages.store(nStages + 1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,162 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLD_CACHE_BINARY_CLOCK_H
+#define NEXUS_LLD_CACHE_BINARY_CLOCK_H
+
+#include <cstdint>
+#include <vector>
+
+
+namespace LLD
+{
+    class SectorKey;
+
+
+    /** ClockShard
+     *
+     *  One independently locked shard of the clock cache.
+     *
+     **/
+    struct ClockShard;
+
+
+    /** BinaryCLOCK
+    *
+    *   CLOCK - Approximate Least Recently Used, split into independently locked shards.
+    *   Cache hits take a shared lock on their shard and only set a reference bit, so concurrent
+    *   readers never block each other. Writers sweep a clock hand over their shard to find entries
+    *   that weren't referenced since the last sweep, rather than relinking a list on every access.
+    *   This class has no types, all objects are in binary forms.
+    *
+    **/
+    class BinaryCLOCK
+    {
+        /* The Maximum Size of the Cache. */
+        uint32_t MAX_CACHE_SIZE;
+
+
+        /* The shards that keys are spread over. */
+        std::vector<ClockShard*> vShards;
+
+
+    public:
+
+
+        /** Default Constructor. **/
+        BinaryCLOCK()                                    = delete;
+
+
+        /** Copy Constructor. **/
+        BinaryCLOCK(const BinaryCLOCK& cache)            = delete;
+
+
+        /** Move Constructor. **/
+        BinaryCLOCK(BinaryCLOCK&& cache)                 = delete;
+
+
+        /** Copy assignment. **/
+        BinaryCLOCK& operator=(const BinaryCLOCK& cache) = delete;
+
+
+        /** Move assignment. **/
+        BinaryCLOCK& operator=(BinaryCLOCK&& cache)      = delete;
+
+
+        /** Class Destructor. **/
+        ~BinaryCLOCK();
+
+
+        /** Cache Size Constructor
+         *
+         *  @param[in] nCacheSizeIn The maximum size of this Cache Pool
+         *
+         **/
+        BinaryCLOCK(const uint32_t nCacheSizeIn);
+
+
+        /** Has
+         *
+         *  Check if data exists.
+         *
+         *  @param[in] vKey The binary data of the key.
+         *
+         *  @return True/False whether pool contains data by index.
+         *
+         **/
+        bool Has(const std::vector<uint8_t>& vKey) const;
+
+
+        /** Get
+         *
+         *  Get the data by index
+         *
+         *  @param[in] vKey The binary data of the key.
+         *  @param[out] vData The binary data of the cached record.
+         *
+         *  @return True if object was found, false if none found by index.
+         *
+         **/
+        bool Get(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData);
+
+
+        /** Put
+         *
+         *  Add data in the Pool
+         *
+         *  @param[in] vKey The key in binary form.
+         *  @param[in] vData The input data in binary form.
+         *  @param[in] fReserve Flag for if item should be saved from cache eviction.
+         *
+         **/
+        void Put(const SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData, bool fReserve = false);
+
+
+        /** Reserve
+         *
+         *  Reserve this item in the cache permanently if true, unreserve if false
+         *
+         *  @param[in] vKey The key to flag as reserved true/false
+         *  @param[in] fReserve If this object is to be reserved for disk.
+         *
+         **/
+        void Reserve(const std::vector<uint8_t>& vKey, bool fReserve = true);
+
+
+        /** Remove
+         *
+         *  Force Remove Object by Index
+         *
+         *  @param[in] vKey Binary Data of the Key
+         *
+         *  @return True on successful removal, false if it fails
+         *
+         **/
+        bool Remove(const std::vector<uint8_t>& vKey);
+
+
+    private:
+
+        /** shard
+         *
+         *  Find the shard that a key hash is assigned to.
+         *
+         *  @param[in] hashKey The 64-bit hash of the key.
+         *
+         **/
+        ClockShard* shard(const uint64_t hashKey) const;
+    };
+}
+
+#endif
@@ -36,24 +36,33 @@ namespace LLD
     {
         debug::log(0, FUNCTION, "Initializing LLD");
 
+        /* Front our most queried keychains with bloom filters if enabled. */
+        const uint8_t nBloom = config::GetBoolArg("-lldbloom", false) ? FLAGS::BLOOM : 0;
+
+        /* Compress new ledger and register records when enabled, this can't be reverted once records are written. */
+        const uint8_t nCompress = config::GetBoolArg("-lldcompress", false) ? FLAGS::COMPRESS : 0;
+
+        /* Compact the sector files of our most overwritten databases in the background when enabled. */
+        const uint8_t nCompact = config::GetBoolArg("-lldcompact", false) ? FLAGS::COMPACT : 0;
+
         /* Create the contract database instance. */
         const uint32_t nContractCacheSize = config::GetArg("-contractcache", 1);
         Contract = new ContractDB(
-                        FLAGS::CREATE | FLAGS::FORCE,
+                        FLAGS::CREATE | FLAGS::FORCE | nBloom,
                         77773,
                         nContractCacheSize * 1024 * 1024);
 
         /* Create the contract database instance. */
         const uint32_t nRegisterCacheSize = config::GetArg("-registercache", 2);
         Register = new RegisterDB(
-                        FLAGS::CREATE | FLAGS::FORCE,
+                        FLAGS::CREATE | FLAGS::FORCE | nBloom | nCompress | nCompact,
                         77773,
                         nRegisterCacheSize * 1024 * 1024);
 
         /* Create the ledger database instance. */
         const uint32_t nLedgerCacheSize = config::GetArg("-ledgercache", 2);
         Ledger    = new LedgerDB(
-                        FLAGS::CREATE | FLAGS::FORCE,
+                        FLAGS::CREATE | FLAGS::FORCE | nBloom | nCompress,
                         config::fClient.load() ? 77773 : (256 * 256 * 64),
                         nLedgerCacheSize * 1024 * 1024);
 
@@ -73,7 +82,7 @@ namespace LLD
 
         /* Create the local database instance. */
         Local    = new LocalDB(
-                        FLAGS::CREATE | FLAGS::FORCE);
+                        FLAGS::CREATE | FLAGS::FORCE | nCompact);
 
 
         /* Create the local database instance. */
@@ -118,6 +127,14 @@ namespace LLD
 
         /* Check for reindexing entries. */
         Ledger->IndexProofs();
+
+
+        /* Check for ordering register proofs. */
+        Sessions->IndexRegisters();
+
+
+        /* Check for ledger metrics buckets. */
+        Ledger->IndexMetrics();
     }
 
 
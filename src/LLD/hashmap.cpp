@@ -12,6 +12,7 @@
 ____________________________________________________________________________________________*/
 
 #include <LLD/keychain/hashmap.h>
+#include <LLD/templates/bloom.h>
 #include <LLD/include/enum.h>
 #include <LLD/include/version.h>
 #include <LLD/hash/xxh3.h>
@@ -23,9 +24,112 @@ ________________________________________________________________________________
 
 #include <iomanip>
 
+#ifdef WIN32
+
+/* Set up defs properly before including windows.h */
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace LLD
 {
 
+    /** KeychainFile
+     *
+     *  Read only handle of a single keychain file, for reads at a given position that don't move a shared
+     *  stream position, so any number of threads can read through the same handle.
+     *
+     **/
+    class KeychainFile
+    {
+    #ifdef WIN32
+
+        /** The windows file handle. **/
+        HANDLE hFile;
+    #else
+
+        /** The file descriptor. **/
+        int32_t nFile;
+    #endif
+
+    public:
+
+        /** Constructor. Opens the file at given path for reading. **/
+        KeychainFile(const std::string& strPath)
+        {
+        #ifdef WIN32
+            hFile = CreateFileA(strPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        #else
+            nFile = open(strPath.c_str(), O_RDONLY);
+        #endif
+        }
+
+
+        /** Default Destructor. Closes the file. **/
+        ~KeychainFile()
+        {
+        #ifdef WIN32
+            if(hFile != INVALID_HANDLE_VALUE)
+                CloseHandle(hFile);
+        #else
+            if(nFile >= 0)
+                close(nFile);
+        #endif
+        }
+
+
+        /** IsNull
+         *
+         *  Determines if the file failed to open.
+         *
+         **/
+        bool IsNull() const
+        {
+        #ifdef WIN32
+            return hFile == INVALID_HANDLE_VALUE;
+        #else
+            return nFile < 0;
+        #endif
+        }
+
+
+        /** Read
+         *
+         *  Read bytes from a given position in the file.
+         *
+         *  @param[in] nPos The binary position to read from.
+         *  @param[out] vData The buffer to fill, which is read in full.
+         *
+         *  @return True if the whole buffer was read.
+         *
+         **/
+        bool Read(const uint64_t nPos, std::vector<uint8_t>& vData) const
+        {
+        #ifdef WIN32
+            OVERLAPPED tOverlapped = { };
+            tOverlapped.Offset     = static_cast<DWORD>(nPos);
+            tOverlapped.OffsetHigh = static_cast<DWORD>(nPos >> 32);
+
+            DWORD nRead = 0;
+            return ReadFile(hFile, &vData[0], static_cast<DWORD>(vData.size()), &nRead, &tOverlapped) && nRead == vData.size();
+        #else
+            return pread(nFile, &vData[0], vData.size(), nPos) == static_cast<ssize_t>(vData.size());
+        #endif
+        }
+    };
+
+
     /* The Database Constructor. To determine file location and the Bytes per Record. */
     BinaryHashMap::BinaryHashMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn, const uint64_t nBucketsIn)
     : KEY_MUTEX              ( )
@@ -38,6 +142,8 @@ namespace LLD
     , HASHMAP_KEY_ALLOCATION (static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
     , nFlags                 (nFlagsIn)
     , RECORD_MUTEX           (1024)
+    , vReaders               ( )
+    , pBloom                 (nullptr)
     {
         Initialize();
     }
@@ -55,6 +161,8 @@ namespace LLD
     , HASHMAP_KEY_ALLOCATION (map.HASHMAP_KEY_ALLOCATION)
     , nFlags                 (map.nFlags)
     , RECORD_MUTEX           (map.RECORD_MUTEX.size())
+    , vReaders               ( )
+    , pBloom                 (nullptr)
     {
         Initialize();
     }
@@ -72,6 +180,8 @@ namespace LLD
     , HASHMAP_KEY_ALLOCATION (std::move(map.HASHMAP_KEY_ALLOCATION))
     , nFlags                 (std::move(map.nFlags))
     , RECORD_MUTEX           (map.RECORD_MUTEX.size())
+    , vReaders               ( )
+    , pBloom                 (nullptr)
     {
         Initialize();
     }
@@ -89,6 +199,9 @@ namespace LLD
         HASHMAP_KEY_ALLOCATION = map.HASHMAP_KEY_ALLOCATION;
         nFlags                 = map.nFlags;
 
+        /* Close our readers, since they may be of another location. */
+        vReaders.Clear();
+
         Initialize();
 
         return *this;
@@ -107,6 +220,9 @@ namespace LLD
         HASHMAP_KEY_ALLOCATION = std::move(map.HASHMAP_KEY_ALLOCATION);
         nFlags                 = std::move(map.nFlags);
 
+        /* Close our readers, since they may be of another location. */
+        vReaders.Clear();
+
         Initialize();
 
         return *this;
@@ -121,6 +237,15 @@ namespace LLD
 
         if(pindex)
             delete pindex;
+
+        /* Persist our bloom filter with the stamp of our closed files, so it doesn't need to be rebuilt on next open. */
+        if(pBloom)
+        {
+            if(!pBloom->Save(debug::safe_printstr(strBaseLocation, "_bloom.filter"), BloomFilter::Stamp(strBaseLocation)))
+                debug::error(FUNCTION, "failed to save bloom filter for ", strBaseLocation);
+
+            delete pBloom;
+        }
     }
 
 
@@ -223,13 +348,23 @@ namespace LLD
 
         /* Load the stream object into the stream LRU cache. */
         fileCache->Put(0, new std::fstream(file, std::ios::in | std::ios::out | std::ios::binary));
+
+        /* Load our bloom filter if enabled. */
+        if(nFlags & FLAGS::BLOOM && !pBloom)
+            load_bloom();
     }
 
 
     /* Read a key index from the disk hashmaps. */
     bool BinaryHashMap::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
     {
-        LOCK(KEY_MUTEX);
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        /* Check our bloom filter to answer keys that were never written without reading any files. */
+        if(pBloom && !pBloom->Has(vKeyCompressed.data(), vKeyCompressed.size()))
+            return false;
 
         /* Get the assigned bucket for the hashmap. */
         uint32_t nBucket = GetBucket(vKey);
@@ -240,41 +375,21 @@ namespace LLD
         /* Set the cKey return value non compressed. */
         cKey.vKey = vKey;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+        /* Lock only our bucket's stripe, so readers of other buckets and writers don't block us. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
 
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
         for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
         {
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), i);
-
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    continue;
-                }
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
-
-            /* Check that file is open. */
-            if(!pstream->is_open())
-                pstream->open(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), i), std::ios::in | std::ios::out | std::ios::binary);
+            /* Get the read only handle of this file. */
+            const KeychainFile* pfile = get_reader(i);
+            if(!pfile)
+                continue;
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
-
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+            /* Read the bucket binary data from the file. */
+            if(!pfile->Read(nFilePos, vBucket))
+                continue;
 
             /* Check if this bucket has the key */
             if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
@@ -318,10 +433,17 @@ namespace LLD
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
+        /* Lock our bucket's stripe, so readers never see a bucket that is half written. */
+        LOCK2(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
         /* Compress any keys larger than max size. */
         std::vector<uint8_t> vKeyCompressed = cKey.vKey;
         CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
+        /* Add to our bloom filter before the key is visible to readers. */
+        if(pBloom)
+            pBloom->Insert(vKeyCompressed.data(), vKeyCompressed.size());
+
         /* Handle if not in append mode which will update the key. */
         if(!(nFlags & FLAGS::APPEND))
         {
@@ -527,6 +649,14 @@ namespace LLD
      *  TODO: This should be optimized further. */
     bool BinaryHashMap::Erase(const std::vector<uint8_t> &vKey)
     {
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        /* Check our bloom filter for keys that were never written. */
+        if(pBloom && !pBloom->Has(vKeyCompressed.data(), vKeyCompressed.size()))
+            return false;
+
         LOCK(KEY_MUTEX);
 
         /* Get the assigned bucket for the hashmap. */
@@ -535,9 +665,8 @@ namespace LLD
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+        /* Lock our bucket's stripe, so readers never see a bucket that is half written. */
+        LOCK2(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
 
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
@@ -609,6 +738,9 @@ namespace LLD
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
+        /* Lock our bucket's stripe, so readers never see a bucket that is half written. */
+        LOCK2(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
         /* Compress any keys larger than max size. */
         std::vector<uint8_t> vKeyCompressed = vKey;
         CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
@@ -674,4 +806,315 @@ namespace LLD
 
         return false;
     }
+
+
+    /* Get the total bytes of sector data that keys point to in each sector file. */
+    void BinaryHashMap::Usage(std::map<uint32_t, uint64_t>& mapUsage)
+    {
+        /* Find the total hashmap files in the keychain. */
+        uint16_t nTotalFiles = 0;
+        {
+            LOCK(KEY_MUTEX);
+            for(const auto& nIndex : hashmap)
+                nTotalFiles = std::max(nTotalFiles, nIndex);
+        }
+
+        /* Check all of our hashmap files, locking each one so writers aren't held for the whole scan. */
+        std::vector<uint8_t> vChunk(uint64_t(HASHMAP_KEY_ALLOCATION) * 4096, 0);
+        for(uint16_t nFile = 0; nFile < nTotalFiles; ++nFile)
+        {
+            LOCK(KEY_MUTEX);
+
+            /* Open the hashmap file for reading. */
+            std::ifstream stream(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile), std::ios::in | std::ios::binary);
+            if(!stream.is_open())
+                continue;
+
+            /* Read the file in chunks of buckets. */
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; nBucket += 4096)
+            {
+                /* Read up to the end of the buckets. */
+                const uint32_t nTotal = std::min(uint32_t(4096), HASHMAP_TOTAL_BUCKETS - nBucket);
+                if(!stream.read((char*)&vChunk[0], uint64_t(nTotal) * HASHMAP_KEY_ALLOCATION))
+                    break;
+
+                /* Check all buckets in this chunk. */
+                for(uint32_t n = 0; n < nTotal; ++n)
+                {
+                    /* Skip over empty buckets. */
+                    const uint8_t* pBucket = &vChunk[uint64_t(n) * HASHMAP_KEY_ALLOCATION];
+                    if(pBucket[0] == STATE::EMPTY)
+                        continue;
+
+                    /* Get the sector file and size from the key header. */
+                    uint16_t nSectorFile = 0;
+                    uint32_t nSectorSize = 0;
+                    std::copy(pBucket + 3, pBucket + 5, (uint8_t*)&nSectorFile);
+                    std::copy(pBucket + 5, pBucket + 9, (uint8_t*)&nSectorSize);
+
+                    mapUsage[nSectorFile] += nSectorSize;
+                }
+            }
+        }
+    }
+
+
+    /* Get the position of every record that keys point to in a sector file. */
+    void BinaryHashMap::Locations(const uint16_t nSectorFile, std::map<uint32_t, uint32_t>& mapLocations)
+    {
+        /* Find the total hashmap files in the keychain. */
+        uint16_t nTotalFiles = 0;
+        {
+            LOCK(KEY_MUTEX);
+            for(const auto& nIndex : hashmap)
+                nTotalFiles = std::max(nTotalFiles, nIndex);
+        }
+
+        /* Check all of our hashmap files, locking each one so writers aren't held for the whole scan. */
+        std::vector<uint8_t> vChunk(uint64_t(HASHMAP_KEY_ALLOCATION) * 4096, 0);
+        for(uint16_t nFile = 0; nFile < nTotalFiles; ++nFile)
+        {
+            LOCK(KEY_MUTEX);
+
+            /* Open the hashmap file for reading. */
+            std::ifstream stream(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile), std::ios::in | std::ios::binary);
+            if(!stream.is_open())
+                continue;
+
+            /* Read the file in chunks of buckets. */
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; nBucket += 4096)
+            {
+                /* Read up to the end of the buckets. */
+                const uint32_t nTotal = std::min(uint32_t(4096), HASHMAP_TOTAL_BUCKETS - nBucket);
+                if(!stream.read((char*)&vChunk[0], uint64_t(nTotal) * HASHMAP_KEY_ALLOCATION))
+                    break;
+
+                /* Check all buckets in this chunk. */
+                for(uint32_t n = 0; n < nTotal; ++n)
+                {
+                    /* Skip over empty buckets. */
+                    const uint8_t* pBucket = &vChunk[uint64_t(n) * HASHMAP_KEY_ALLOCATION];
+                    if(pBucket[0] == STATE::EMPTY)
+                        continue;
+
+                    /* Skip over keys in other sector files. */
+                    uint16_t nFileIn = 0;
+                    std::copy(pBucket + 3, pBucket + 5, (uint8_t*)&nFileIn);
+                    if(nFileIn != nSectorFile)
+                        continue;
+
+                    /* Get the sector size and start from the key header. */
+                    uint32_t nSectorSize  = 0;
+                    uint32_t nSectorStart = 0;
+                    std::copy(pBucket + 5, pBucket + 9,  (uint8_t*)&nSectorSize);
+                    std::copy(pBucket + 9, pBucket + 13, (uint8_t*)&nSectorStart);
+
+                    /* Keys with no sector data don't reference the file. */
+                    if(nSectorSize > 0)
+                        mapLocations[nSectorStart] = nSectorSize;
+                }
+            }
+        }
+    }
+
+
+    /* Point keys to the new position of their records, only if they still point to the old position. */
+    uint32_t BinaryHashMap::Relocate(const uint16_t nSectorFile, const std::map<uint32_t, SectorKey>& mapMoves)
+    {
+        /* Find the total hashmap files in the keychain. */
+        uint16_t nTotalFiles = 0;
+        {
+            LOCK(KEY_MUTEX);
+            for(const auto& nIndex : hashmap)
+                nTotalFiles = std::max(nTotalFiles, nIndex);
+        }
+
+        /* Check all of our hashmap files, without holding any locks while we scan them. */
+        uint32_t nTotalMoved = 0;
+        std::vector<uint8_t> vChunk(uint64_t(HASHMAP_KEY_ALLOCATION) * 4096, 0);
+        for(uint16_t nFile = 0; nFile < nTotalFiles; ++nFile)
+        {
+            /* Open the hashmap file for reading and writing. */
+            std::fstream stream(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile), std::ios::in | std::ios::out | std::ios::binary);
+            if(!stream.is_open())
+                continue;
+
+            /* Collect the buckets that point to moved records, by bucket and old position. */
+            std::vector<std::pair<uint32_t, uint32_t>> vCandidates;
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; nBucket += 4096)
+            {
+                /* Read up to the end of the buckets. */
+                const uint32_t nTotal = std::min(uint32_t(4096), HASHMAP_TOTAL_BUCKETS - nBucket);
+
+                stream.seekg(uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION, std::ios::beg);
+                if(!stream.read((char*)&vChunk[0], uint64_t(nTotal) * HASHMAP_KEY_ALLOCATION))
+                    break;
+
+                /* Check all buckets in this chunk. */
+                for(uint32_t n = 0; n < nTotal; ++n)
+                {
+                    /* Skip over empty buckets. */
+                    const uint8_t* pBucket = &vChunk[uint64_t(n) * HASHMAP_KEY_ALLOCATION];
+                    if(pBucket[0] == STATE::EMPTY)
+                        continue;
+
+                    /* Skip over keys in other sector files. */
+                    uint16_t nFileIn = 0;
+                    std::copy(pBucket + 3, pBucket + 5, (uint8_t*)&nFileIn);
+                    if(nFileIn != nSectorFile)
+                        continue;
+
+                    /* Get the sector size and start from the key header. */
+                    uint32_t nSectorSize  = 0;
+                    uint32_t nSectorStart = 0;
+                    std::copy(pBucket + 5, pBucket + 9,  (uint8_t*)&nSectorSize);
+                    std::copy(pBucket + 9, pBucket + 13, (uint8_t*)&nSectorStart);
+
+                    /* Skip over keys with no sector data, which sit at the start of file zero without referencing a record. */
+                    if(nSectorSize == 0)
+                        continue;
+
+                    /* Skip over keys that were re-written since their record was moved. */
+                    if(!mapMoves.count(nSectorStart))
+                        continue;
+
+                    vCandidates.push_back(std::make_pair(nBucket + n, nSectorStart));
+                }
+            }
+
+            /* Clear any read errors from the end of our scan. */
+            stream.clear();
+
+            /* Re-point each key under its own stripe, only if it still points to the old record. */
+            std::vector<uint8_t> vHeader(13, 0);
+            for(const auto& pairCandidate : vCandidates)
+            {
+                const uint32_t nBucket = pairCandidate.first;
+                const SectorKey& cMoved = mapMoves.at(pairCandidate.second);
+
+                LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
+                /* Read the key header again now that writers to this bucket are blocked. */
+                stream.seekg(uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION, std::ios::beg);
+                if(!stream.read((char*)&vHeader[0], vHeader.size()))
+                {
+                    stream.clear();
+                    continue;
+                }
+
+                /* Check that the key wasn't erased or re-written since our scan. */
+                uint16_t nFileIn      = 0;
+                uint32_t nSectorStart = 0;
+                std::copy(&vHeader[3], &vHeader[5],  (uint8_t*)&nFileIn);
+                std::copy(&vHeader[9], &vHeader[13], (uint8_t*)&nSectorStart);
+                if(vHeader[0] == STATE::EMPTY || nFileIn != nSectorFile || nSectorStart != pairCandidate.second)
+                    continue;
+
+                /* Write the new location into the key header. */
+                std::copy((uint8_t*)&cMoved.nSectorFile,  (uint8_t*)&cMoved.nSectorFile  + 2, &vHeader[3]);
+                std::copy((uint8_t*)&cMoved.nSectorSize,  (uint8_t*)&cMoved.nSectorSize  + 4, &vHeader[5]);
+                std::copy((uint8_t*)&cMoved.nSectorStart, (uint8_t*)&cMoved.nSectorStart + 4, &vHeader[9]);
+
+                /* Write the key header back to the hashmap file, flushing before readers can see it. */
+                stream.seekp(uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION + 3, std::ios::beg);
+                stream.write((char*)&vHeader[3], 10);
+                stream.flush();
+
+                ++nTotalMoved;
+            }
+        }
+
+        return nTotalMoved;
+    }
+
+
+    /* Get the read only handle of a hashmap file, opening it on first use. */
+    KeychainFile* BinaryHashMap::get_reader(const uint16_t nFile)
+    {
+        /* Check for an already opened file. */
+        KeychainFile* pfile = vReaders.Get(nFile);
+        if(pfile)
+            return pfile;
+
+        /* Open the file for reading. */
+        pfile = new KeychainFile(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile));
+        if(pfile->IsNull())
+        {
+            delete pfile;
+            return nullptr;
+        }
+
+        /* Add to our readers, using the handle of another reader that opened it first. */
+        return vReaders.Insert(nFile, pfile);
+    }
+
+
+    /* Load the bloom filter from disk, or rebuild it from the hashmap files if it wasn't saved cleanly. */
+    void BinaryHashMap::load_bloom()
+    {
+        /* Find the total hashmap files and slots in use in the keychain. */
+        uint16_t nTotalFiles = 0;
+        uint64_t nTotalSlots = 0;
+        for(const auto& nIndex : hashmap)
+        {
+            nTotalFiles  = std::max(nTotalFiles, nIndex);
+            nTotalSlots += nIndex;
+        }
+
+        /* Size the filter from our keys with room to double before it grows. */
+        pBloom = new BloomFilter(nTotalSlots * 2);
+
+        /* Remove the filter file once loaded, so that an unclean shutdown forces a rebuild. */
+        const std::string strBloom = debug::safe_printstr(strBaseLocation, "_bloom.filter");
+        if(pBloom->Load(strBloom, BloomFilter::Stamp(strBaseLocation)))
+        {
+            filesystem::remove(strBloom);
+
+            debug::log(0, FUNCTION, "Loaded Bloom Filter of ", nTotalSlots, " keys");
+            return;
+        }
+
+        /* Remove any stale filter, since our files changed after it was saved. */
+        if(filesystem::exists(strBloom))
+            filesystem::remove(strBloom);
+
+        /* Insert every key that is in a non empty slot of the hashmap files. */
+        uint32_t nTotalKeys = 0;
+        for(uint16_t nFile = 0; nFile < nTotalFiles; ++nFile)
+        {
+            /* Open the hashmap file for reading. */
+            std::ifstream stream(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile), std::ios::in | std::ios::binary);
+            if(!stream.is_open())
+                continue;
+
+            /* Read the file in chunks of buckets. */
+            std::vector<uint8_t> vChunk(uint64_t(HASHMAP_KEY_ALLOCATION) * 4096, 0);
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; nBucket += 4096)
+            {
+                /* Read up to the end of the buckets. */
+                const uint32_t nTotal = std::min(uint32_t(4096), HASHMAP_TOTAL_BUCKETS - nBucket);
+                if(!stream.read((char*)&vChunk[0], uint64_t(nTotal) * HASHMAP_KEY_ALLOCATION))
+                    break;
+
+                /* Check all buckets in this chunk. */
+                for(uint32_t n = 0; n < nTotal; ++n)
+                {
+                    /* Skip over empty buckets. */
+                    const uint8_t* pBucket = &vChunk[uint64_t(n) * HASHMAP_KEY_ALLOCATION];
+                    if(pBucket[0] == STATE::EMPTY)
+                        continue;
+
+                    /* Get the length of the key from its header to find the compressed size. */
+                    uint16_t nLength = 0;
+                    std::copy(pBucket + 1, pBucket + 3, (uint8_t*)&nLength);
+
+                    /* Add the compressed key to the filter. */
+                    pBloom->Insert(pBucket + 13, std::min(nLength, HASHMAP_MAX_KEY_SIZE));
+                    ++nTotalKeys;
+                }
+            }
+        }
+
+        debug::log(0, FUNCTION, "Rebuilt Bloom Filter from ", nTotalFiles, " hashmap files and ", nTotalKeys, " keys");
+    }
 }
@@ -12,597 +12,371 @@
 ____________________________________________________________________________________________*/
 
 #include <LLD/keychain/hashtree.h>
-#include <LLD/include/enum.h>
-#include <LLD/include/version.h>
-#include <LLD/hash/xxh3.h>
 
-#include <Util/templates/datastream.h>
 #include <Util/include/filesystem.h>
 #include <Util/include/debug.h>
-#include <Util/include/hex.h>
+
+#include <algorithm>
 
 namespace LLD
 {
 
-    /** Default Constructor **/
-    BinaryHashTree::BinaryHashTree()
-    : KEY_MUTEX()
-    , strBaseLocation()
-    , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
-    , pindex(nullptr)
-    , hashmap(256 * 256 * 24)
-    , HASHMAP_TOTAL_BUCKETS(256 * 256 * 24)
-    , HASHMAP_MAX_CACHE_SIZE(10 * 1024)
-    , HASHMAP_MAX_KEY_SIZE(32)
-    , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
-    , nFlags(FLAGS::APPEND)
-    {
-    }
-
-
-    /** The Database Constructor. To determine file location and the Bytes per Record. **/
-    BinaryHashTree::BinaryHashTree(const std::string& strBaseLocationIn, uint8_t nFlagsIn)
-    : KEY_MUTEX()
-    , strBaseLocation(strBaseLocationIn)
-    , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
-    , pindex(nullptr)
-    , hashmap(256 * 256 * 24)
-    , HASHMAP_TOTAL_BUCKETS(256 * 256 * 24)
-    , HASHMAP_MAX_CACHE_SIZE(10 * 1024)
-    , HASHMAP_MAX_KEY_SIZE(32)
-    , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
-    , nFlags(nFlagsIn)
-    {
-        Initialize();
-    }
-
-
-    /** Default Constructor **/
-    BinaryHashTree::BinaryHashTree(const std::string& strBaseLocationIn, const uint32_t nTotalBuckets, const uint32_t nMaxCacheSize,  const uint8_t nFlagsIn)
-    : KEY_MUTEX()
-    , strBaseLocation(strBaseLocationIn)
-    , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
-    , pindex(nullptr)
-    , hashmap(nTotalBuckets)
-    , HASHMAP_TOTAL_BUCKETS(nTotalBuckets)
-    , HASHMAP_MAX_CACHE_SIZE(nMaxCacheSize)
-    , HASHMAP_MAX_KEY_SIZE(32)
-    , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
-    , nFlags(nFlagsIn)
+    /* The Database Constructor. To determine file location. */
+    BinaryHashTree::BinaryHashTree(const std::string& strBaseLocationIn, const bool fCompleteIn)
+    : KEY_MUTEX       ( )
+    , strBaseLocation (strBaseLocationIn)
+    , setKeys         ( )
+    , pstream         (nullptr)
+    , nLogRecords     (0)
+    , fComplete       (fCompleteIn)
     {
         Initialize();
     }
 
 
-    /** Copy Assignment Operator **/
-    BinaryHashTree& BinaryHashTree::operator=(const BinaryHashTree& map)
-    {
-        strBaseLocation       = map.strBaseLocation;
-        fileCache             = map.fileCache;
-
-        return *this;
-    }
-
-
-    /** Copy Constructor **/
-    BinaryHashTree::BinaryHashTree(const BinaryHashTree& map)
-    {
-        strBaseLocation    = map.strBaseLocation;
-        fileCache          = map.fileCache;
-    }
-
-
-    /** Default Destructor **/
+    /* Default Destructor */
     BinaryHashTree::~BinaryHashTree()
     {
-        delete fileCache;
-        delete pindex;
-    }
-
-
-    /*  Compresses a given key until it matches size criteria.
-     *  This function is one way and efficient for reducing key sizes. */
-    void BinaryHashTree::CompressKey(std::vector<uint8_t>& vData, uint16_t nSize)
-    {
-        /* Loop until key is of desired size. */
-        while(vData.size() > nSize)
+        if(pstream)
         {
-            /* Loop half of the key to XOR elements. */
-            for(uint64_t i = 0; i < vData.size() / 2; ++i)
-                if(i * 2 < vData.size())
-                    vData[i] = vData[i] ^ vData[i * 2];
-
-            /* Resize the container to half its size. */
-            vData.resize(std::max(uint16_t(vData.size() / 2), nSize));
-        }
-    }
-
-
-    /*  Placeholder. */
-    std::vector< std::vector<uint8_t> > BinaryHashTree::GetKeys()
-    {
-        std::vector< std::vector<uint8_t> > vKeys;
-
-        return vKeys;
-    }
-
+            /* Sync our log and mark it as closed cleanly, so our keys are trusted when it is loaded again. */
+            if(pstream->is_open() && fComplete.load())
+            {
+                pstream->close();
 
-    /*  Calculates a bucket to be used for the hashmap allocation. */
-    uint32_t BinaryHashTree::GetBucket(const std::vector<uint8_t>& vKey)
-    {
-        /* Get an xxHash. */
-        uint64_t nBucket = XXH64(&vKey[0], vKey.size(), 0);
+                if(!write_flag(COMPLETE))
+                    debug::error(FUNCTION, "failed to mark tree log as closed");
+            }
 
-        return static_cast<uint32_t>(nBucket % HASHMAP_TOTAL_BUCKETS);
+            delete pstream;
+        }
     }
 
 
-    /*  Read a key index from the disk hashmaps. */
+    /* Load the keys from the tree log, and rewrite the log if it is mostly erased keys. */
     void BinaryHashTree::Initialize()
     {
         /* Create directories if they don't exist yet. */
         if(!filesystem::exists(strBaseLocation) && filesystem::create_directories(strBaseLocation))
             debug::log(0, FUNCTION, "Generated Path ", strBaseLocation);
 
-        /* Build the hashmap indexes. */
-        std::string index = debug::safe_printstr(strBaseLocation, "_hashtree.index");
-        if(!filesystem::exists(index))
+        /* Check for an existing log. */
+        const std::string strLog = debug::safe_printstr(strBaseLocation, "_hashtree.log");
+        bool fRewrite = !filesystem::exists(strLog);
+        if(!fRewrite)
         {
-            /* Generate empty space for new file. */
-            std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * 4, 0);
+            /* Read the whole log into memory. */
+            std::ifstream stream(strLog, std::ios::in | std::ios::binary);
 
-            /* Write the new disk index .*/
-            std::fstream stream(index, std::ios::out | std::ios::binary | std::ios::trunc);
-            stream.write((char*)&vSpace[0], vSpace.size());
+            std::vector<uint8_t> vLog((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
             stream.close();
 
-            /* Debug output showing generation of disk index. */
-            debug::log(0, FUNCTION, "Generated Disk Index of ", vSpace.size(), " bytes");
-        }
+            /* The first byte of the log is our complete flag. */
+            const uint8_t nFlag = (vLog.empty() ? INCOMPLETE : vLog[0]);
+            fComplete.store(nFlag == COMPLETE);
 
-        /* Read the hashmap indexes. */
-        else
-        {
-            /* Build a vector to read the disk index. */
-            std::vector<uint8_t> vIndex(HASHMAP_TOTAL_BUCKETS * 4, 0);
+            /* A log that was open when we shut down may be missing keys that made it into the keychain. */
+            if(nFlag == OPEN)
+            {
+                debug::log(0, FUNCTION, "tree log was not closed cleanly, keys must be backfilled");
 
-            /* Read the disk index bytes. */
-            std::fstream stream(index, std::ios::in | std::ios::binary);
-            stream.read((char*)&vIndex[0], vIndex.size());
-            stream.close();
+                fRewrite = true;
+                vLog.clear();
+            }
 
-            /* Deserialize the values into memory index. */
-            uint32_t nTotalKeys = 0;
-            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+            /* Replay our log records in order. */
+            DataStream ssLog(vLog, SER_LLD, DATABASE_VERSION);
+            ssLog.SetPos(std::min(vLog.size(), size_t(1)));
+            while(!ssLog.End())
             {
-                std::copy((uint8_t *)&vIndex[nBucket * 4], (uint8_t *)&vIndex[nBucket * 4] + 4, (uint8_t *)&hashmap[nBucket]);
+                try
+                {
+                    /* Read the type and key of this record. */
+                    uint8_t nType = 0;
+                    std::vector<uint8_t> vKey;
+                    ssLog >> nType >> vKey;
+
+                    /* Apply the record to our keys. */
+                    if(nType == 1)
+                        setKeys.insert(vKey);
+                    else
+                        setKeys.erase(vKey);
+
+                    ++nLogRecords;
+                }
+                catch(const std::exception& e)
+                {
+                    /* A partial record is left behind by an unclean shutdown, rewrite to discard it. */
+                    debug::log(0, FUNCTION, "discarding partial record at end of ", strLog);
 
-                nTotalKeys += hashmap[nBucket];
+                    fRewrite = true;
+                    break;
+                }
             }
 
-            /* Debug output showing loading of disk index. */
-            debug::log(0, FUNCTION, "Loaded Disk Index of ", vIndex.size(), " bytes and ", nTotalKeys, " keys");
+            /* Rewrite when most of our log is erased or overwritten keys. */
+            if(nLogRecords > 1024 && nLogRecords > setKeys.size() * 2)
+                fRewrite = true;
         }
 
-        /* Build the first hashmap index file if it doesn't exist. */
-        std::string file = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), 1u);
-        if(!filesystem::exists(file))
-        {
-            /* Build a vector with empty bytes to flush to disk. */
-            std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * HASHMAP_KEY_ALLOCATION, 0xff);
-
-            /* Flush the empty keychain file to disk. */
-            std::fstream stream(file, std::ios::out | std::ios::binary | std::ios::trunc);
-            stream.write((char*)&vSpace[0], vSpace.size());
-            stream.close();
+        /* Write a fresh log with only our current keys. */
+        if(fRewrite && !rewrite())
+            debug::error(FUNCTION, "failed to rewrite ", strLog);
 
-            /* Debug output showing generating of the hashmap file. */
-            debug::log(0, FUNCTION, "Generated Disk Hash Map 0 of ", vSpace.size(), " bytes");
+        /* Mark our log as open, so that a crash before it is closed cleanly is detected. */
+        if(fComplete.load() && !write_flag(OPEN))
+        {
+            debug::error(FUNCTION, "failed to mark ", strLog, " as open");
+            fComplete.store(false);
         }
 
-        /* Create the stream index object. */
-        pindex = new std::fstream(index, std::ios::in | std::ios::out | std::ios::binary);
+        /* Open our log for appending. */
+        pstream = new std::ofstream(strLog, std::ios::out | std::ios::binary | std::ios::app);
+        if(!pstream->is_open())
+            debug::error(FUNCTION, "failed to open ", strLog);
 
-        /* Load the stream object into the stream LRU cache. */
-        fileCache->Put(0, new std::fstream(file, std::ios::in | std::ios::out | std::ios::binary));
+        debug::log(0, FUNCTION, "Loaded Hash Tree of ", setKeys.size(), " keys", fComplete.load() ? "" : " (incomplete)");
     }
 
 
-    template< typename Iter1, typename Iter2 >
-    int32_t compare(Iter1 begin1, Iter1 end1, Iter2 begin2, Iter2 end2)
+    /* Check if the tree holds every key since the database was created. */
+    bool BinaryHashTree::Complete() const
     {
-        while(begin1 != end1 && begin2 != end2)
-        {
-            if(*begin1 != *begin2)
-            {
-                return *begin1 - *begin2;
-            }
-            ++begin1;
-            ++begin2;
-        }
-
-        return 0;
+        return fComplete.load();
     }
 
 
-    /*  Read a key index from the disk hashmaps. */
-    bool BinaryHashTree::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
+    /* Mark the tree as holding every key, once a database has backfilled the keys it wrote before the tree existed. */
+    bool BinaryHashTree::SetComplete()
     {
         LOCK(KEY_MUTEX);
 
-        static const std::vector<uint8_t> vBlank(HASHMAP_KEY_ALLOCATION, 0xff);
-
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(vKey);
-
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
-
-        /* Set the cKey return value non compressed. */
-        cKey.vKey = vKey;
+        /* Check that our log is open. */
+        if(!pstream || !pstream->is_open())
+            return debug::error(FUNCTION, "tree log is not open");
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+        /* Make sure our backfilled keys are on disk before the flag that says they are all there. */
+        if(!sync())
+            return false;
 
-        //PrintHex(vKey.begin(), vKey.end());
+        /* We are complete, but open until closed cleanly. */
+        if(!write_flag(OPEN))
+            return false;
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        fComplete.store(true);
 
-        uint32_t i = 1;
-        while(true)
-        {
-            /* Set the new stream pointer. */
-            std::string filename = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i);
-
-            /* Check for file. */
-            if(!filesystem::exists(filename))
-                return false;
-
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
+        return true;
+    }
 
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
+    /* Synchronize the tree log with disk. */
+    bool BinaryHashTree::Flush()
+    {
+        LOCK(KEY_MUTEX);
 
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+        return sync();
+    }
 
-            /* Check if this bucket has the key */
-            //if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            //if(compare(vBucket, vKeyCompressed) == 0)
-            int32_t nCompare = compare(vBucket.begin() + 13, vBucket.end(), vKeyCompressed.begin(), vKeyCompressed.end());
-            if(nCompare == 0)
-            {
-                /* Deserialie key and return if found. */
-                DataStream ssKey(vBucket, SER_LLD, DATABASE_VERSION);
-                ssKey >> cKey;
-
-                /* Check if the key is ready. */
-                if(!cKey.Ready())
-                    return false;
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                        " | Length: ", cKey.nLength,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", hashmap[nBucket] - 1,
-                        " | Sector File: ", cKey.nSectorFile,
-                        " | Sector Size: ", cKey.nSectorSize,
-                        " | Sector Start: ", cKey.nSectorStart, "\n",
-                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
 
-                return true;
-            }
-            else if(compare(vBucket.begin(), vBucket.end(), vBlank.begin(), vBlank.end()) == 0)
-                return false;
+    /* Add a key to the tree. */
+    bool BinaryHashTree::Put(const std::vector<uint8_t>& vKey)
+    {
+        LOCK(KEY_MUTEX);
 
-            //++i;
-            //i += 2;
-            i <<= 1;
-            if(nCompare > 0)
-                i |= 1;
-            //i  |= (nCompare < 0);
-        }
+        /* Only log keys that are new to the tree. */
+        if(!setKeys.insert(vKey).second)
+            return true;
 
-        return false;
+        return append(1, vKey);
     }
 
 
-    /*  Write a key to the disk hashmaps. */
-    bool BinaryHashTree::Put(const SectorKey& cKey)
+    /* Erase a key from the tree. */
+    bool BinaryHashTree::Erase(const std::vector<uint8_t>& vKey)
     {
         LOCK(KEY_MUTEX);
 
-        static const std::vector<uint8_t> vBlank(HASHMAP_KEY_ALLOCATION, 0xff);
+        /* Only log keys that were in the tree. */
+        if(setKeys.erase(vKey) == 0)
+            return false;
 
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(cKey.vKey);
+        return append(0, vKey);
+    }
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = cKey.vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+    /* Get the first key after a given key that begins with a prefix. */
+    bool BinaryHashTree::Next(const std::vector<uint8_t>& vPrefix, const std::vector<uint8_t>& vFrom, const bool fInclusive,
+                              std::vector<uint8_t> &vKey) const
+    {
+        LOCK(KEY_MUTEX);
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        /* Find the first key at or after where we are searching from. */
+        auto it = fInclusive ? setKeys.lower_bound(vFrom) : setKeys.upper_bound(vFrom);
+        if(it == setKeys.end())
+            return false;
 
-        uint32_t i = 1;
-        while(true)
-        {
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i);
+        /* Check that the key begins with our prefix, keys are in order so no later keys will either. */
+        if(it->size() < vPrefix.size() || !std::equal(vPrefix.begin(), vPrefix.end(), it->begin()))
+            return false;
 
-                /* Check for file. */
-                if(!filesystem::exists(filename))
-                {
-                    /* Blank vector to write empty space in new disk file. */
-                    static const std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * HASHMAP_KEY_ALLOCATION, 0xff);
+        vKey = *it;
 
-                    /* Write the blank data to the new file handle. */
-                    std::fstream stream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
-                    if(!stream)
-                        return debug::error(FUNCTION, strerror(errno));
+        return true;
+    }
 
-                    stream.write((char*)&vSpace[0], vSpace.size());
-                    stream.flush();
-                    stream.close();
 
-                    /* Debug output for monitoring new disk maps. */
-                    debug::log(0, FUNCTION, "Generated Disk Hash Map ", i, " of ", vSpace.size(), " bytes");
-                }
+    /* Append a record to the tree log. */
+    bool BinaryHashTree::append(const uint8_t nType, const std::vector<uint8_t>& vKey)
+    {
+        /* Check that our log is open. */
+        if(!pstream || !pstream->is_open())
+            return debug::error(FUNCTION, "tree log is not open");
 
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
+        /* Serialize our record. */
+        DataStream ssRecord(SER_LLD, DATABASE_VERSION);
+        ssRecord << nType << vKey;
 
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
+        /* Write the record to the end of the log. */
+        if(!pstream->write((char*)ssRecord.data(), ssRecord.size()))
+            return debug::error(FUNCTION, "failed to write ", ssRecord.size(), " bytes to tree log");
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
+        pstream->flush();
+        ++nLogRecords;
 
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+        return true;
+    }
 
-            /* Check if this bucket has the key */
-            //if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            //if(compare(vBucket, vKeyCompressed) == 0)
-            int32_t nCompare = compare(vBucket.begin() + 13, vBucket.end(), vKeyCompressed.begin(), vKeyCompressed.end());
-            if(nCompare == 0 || compare(vBucket.begin(), vBucket.end(), vBlank.begin(), vBlank.end()) == 0)
-            {
-                /* Read the State and Size of Sector Header. */
-                DataStream ssKey(SER_LLD, DATABASE_VERSION);
-                ssKey << cKey;
-
-                /* Serialize the key into the end of the vector. */
-                ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
-
-                /* Flush the key file to disk. */
-                pstream->seekp (nFilePos, std::ios::beg);
-                pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
-                pstream->flush();
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                        " | Length: ", cKey.nLength,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", i,
-                        " | Sector File: ", cKey.nSectorFile,
-                        " | Sector Size: ", cKey.nSectorSize,
-                        " | Sector Start: ", cKey.nSectorStart, "\n",
-                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
 
-                return true;
-            }
+    /* Synchronize the tree log with disk. */
+    bool BinaryHashTree::sync()
+    {
+        /* Check that our log is open. */
+        if(!pstream || !pstream->is_open())
+            return debug::error(FUNCTION, "tree log is not open");
 
-            //++i;
-            //i += 2;
-            //i <<= 1;
-            //i  |= (nCompare < 0);
+        /* Push our buffered records to the file before syncing it. */
+        pstream->flush();
 
-            i <<= 1;
-            if(nCompare > 0)
-                i |= 1;
-        }
+        const std::string strLog = debug::safe_printstr(strBaseLocation, "_hashtree.log");
+        if(!filesystem::sync(strLog))
+            return debug::error(FUNCTION, "failed to sync ", strLog);
 
         return true;
     }
 
 
-    /*  Erase a key from the disk hashmaps.
-     *  TODO: This should be optimized further. */
-    bool BinaryHashTree::Erase(const std::vector<uint8_t> &vKey)
+    /* Write the flag at the start of the tree log and synchronize it with disk. */
+    bool BinaryHashTree::write_flag(const uint8_t nFlag)
     {
-        LOCK(KEY_MUTEX);
+        /* Write our flag over the first byte of the log, which our append stream can't seek to. */
+        const std::string strLog = debug::safe_printstr(strBaseLocation, "_hashtree.log");
+        {
+            std::fstream stream(strLog, std::ios::in | std::ios::out | std::ios::binary);
+            if(!stream.seekp(0, std::ios::beg) || !stream.write((char*)&nFlag, 1))
+                return debug::error(FUNCTION, "failed to write flag to ", strLog);
+        }
 
-        static const std::vector<uint8_t> vBlank(HASHMAP_KEY_ALLOCATION, 0xff);
+        /* Make sure the flag is on disk before we rely on it. */
+        if(!filesystem::sync(strLog))
+            return debug::error(FUNCTION, "failed to sync ", strLog);
 
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(vKey);
+        return true;
+    }
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+    /* Rewrite the tree log with only the keys that are in the tree. */
+    bool BinaryHashTree::rewrite()
+    {
+        /* Serialize our complete flag and all of our keys. */
+        DataStream ssLog(SER_LLD, DATABASE_VERSION);
+        ssLog << uint8_t(fComplete.load() ? COMPLETE : INCOMPLETE);
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        for(const auto& vKey : setKeys)
+            ssLog << uint8_t(1) << vKey;
 
-        uint32_t i = 1;
-        while(true)
+        /* Write to a temporary file first so a crash doesn't lose our keys. */
+        const std::string strTemp = debug::safe_printstr(strBaseLocation, "_hashtree.tmp");
         {
-            /* Set the new stream pointer. */
-            std::string filename = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i);
-
-            /* Check for file. */
-            if(!filesystem::exists(filename))
-                return debug::error(filename, " not found");
-
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
-
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
-
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+            std::ofstream stream(strTemp, std::ios::out | std::ios::binary | std::ios::trunc);
+            if(!stream.write((char*)ssLog.data(), ssLog.size()))
+                return false;
+        }
 
+        /* Swap the new log into place. */
+        if(!filesystem::sync(strTemp) || !filesystem::rename(strTemp, debug::safe_printstr(strBaseLocation, "_hashtree.log")))
+            return false;
 
-            /* Check if this bucket has the key */
-            //if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            //if(compare(vBucket, vKeyCompressed) == 0)
-            int32_t nCompare = compare(vBucket.begin() + 13, vBucket.end(), vKeyCompressed.begin(), vKeyCompressed.end());
-            if(nCompare == 0)
-            {
-                /* Set the key state to  empty. */
-                vBucket[0] = STATE::EMPTY;
-
-                /* Flush the key file to disk. */
-                pstream->seekp (nFilePos, std::ios::beg);
-                pstream->write((char*)&vBucket[0], vBucket.size());
-                pstream->flush();
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", i, "\n",
-                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
+        nLogRecords = setKeys.size();
 
-                return true;
-            }
-            else if(compare(vBucket.begin(), vBucket.end(), vBlank.begin(), vBlank.end()) == 0)
-                return false;
+        return true;
+    }
 
-            //++i;
-            //i += 2;
-            i <<= 1;
-            i  |= (nCompare < 0);
-        }
 
-        return false;
+    /* Default Constructor */
+    KeyCursor::KeyCursor()
+    : pTree      (nullptr)
+    , vPrefix    ( )
+    , vKey       ( )
+    , setPending ( )
+    , setErased  ( )
+    , fStarted   (false)
+    {
     }
 
 
-    /*  Restore an index in the hashmap if it is found. */
-    bool BinaryHashTree::Restore(const std::vector<uint8_t> &vKey)
+    /* Position the cursor before the first key that begins with a prefix. */
+    void KeyCursor::Seek(const BinaryHashTree* pTreeIn, const std::vector<uint8_t>& vPrefixIn, const std::vector<uint8_t>& vFrom,
+                         const std::set<std::vector<uint8_t>>& setPendingIn, const std::set<std::vector<uint8_t>>& setErasedIn)
     {
-        LOCK(KEY_MUTEX);
-
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(vKey);
+        pTree      = pTreeIn;
+        vPrefix    = vPrefixIn;
+        vKey       = std::max(vPrefixIn, vFrom);
+        setPending = setPendingIn;
+        setErased  = setErasedIn;
+        fStarted   = false;
+    }
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+    /* Move the cursor to the next key that begins with our prefix. */
+    bool KeyCursor::Next()
+    {
+        /* Check that we have a tree to iterate. */
+        if(!pTree)
+            return false;
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-        for(int i = hashmap[nBucket] - 1; i >= 0; --i)
+        /* Loop until we find a key that isn't erased in an open transaction. */
+        while(true)
         {
-            /* Find the file stream for LRU cache. */
-            std::fstream* pstream;
-            if(!fileCache->Get(i, pstream))
+            /* Search inclusively for our first key, and past our current key after that. */
+            std::vector<uint8_t> vNext;
+            bool fFound = pTree->Next(vPrefix, vKey, !fStarted, vNext);
+
+            /* Use the next pending key if it comes before the next key in the tree. */
+            auto it = fStarted ? setPending.upper_bound(vKey) : setPending.lower_bound(vKey);
+            if(it != setPending.end() && it->size() >= vPrefix.size() && std::equal(vPrefix.begin(), vPrefix.end(), it->begin())
+            && (!fFound || *it < vNext))
             {
-                /* Set the new stream pointer. */
-                pstream = new std::fstream(
-                  debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i),
-                  std::ios::in | std::ios::out | std::ios::binary);
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
+                vNext  = *it;
+                fFound = true;
             }
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg (nFilePos, std::ios::beg);
-
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+            /* Check that we have another key. */
+            if(!fFound)
+                return false;
 
-            /* Check if this bucket has the key */
-            if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            {
-                /* Deserialize key and return if found. */
-                DataStream ssKey(vBucket, SER_LLD, DATABASE_VERSION);
-                SectorKey cKey;
-                ssKey >> cKey;
-
-                /* Skip over keys that are already erased. */
-                if(cKey.Ready())
-                    return true;
-
-                /* Seek to the hashmap index in file. */
-                pstream->seekp (nFilePos, std::ios::beg);
-
-                /* Read the bucket binary data from file stream */
-                std::vector<uint8_t> vReady(STATE::READY);
-                pstream->write((char*) &vReady[0], vReady.size());
-                pstream->flush();
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION, "Restored State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                        " | Length: ", cKey.nLength,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", hashmap[nBucket] - 1,
-                        " | Sector File: ", cKey.nSectorFile,
-                        " | Sector Size: ", cKey.nSectorSize,
-                        " | Sector Start: ", cKey.nSectorStart,
-                        " | Key: ", HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
+            vKey.swap(vNext);
+            fStarted = true;
 
+            /* Skip over keys that are erased in an open transaction. */
+            if(!setErased.count(vKey))
                 return true;
-            }
         }
-
-        return false;
     }
 
 
+    /* Get the binary data of the current key. */
+    const std::vector<uint8_t>& KeyCursor::Key() const
+    {
+        return vKey;
+    }
 }
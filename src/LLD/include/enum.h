@@ -25,11 +25,14 @@ namespace LLD
      **/
     enum FLAGS
     {
+        COMPACT       = (1 << 0),
         APPEND        = (1 << 1),
         READONLY      = (1 << 2),
         CREATE        = (1 << 3),
         WRITE         = (1 << 4),
-        FORCE         = (1 << 5)
+        FORCE         = (1 << 5),
+        BLOOM         = (1 << 6),
+        COMPRESS      = (1 << 7)
     };
 
 
@@ -17,6 +17,7 @@ ________________________________________________________________________________
 
 #include <LLD/keychain/keychain.h>
 #include <LLD/cache/template_lru.h>
+#include <LLD/templates/handles.h>
 #include <LLD/include/enum.h>
 
 #include <cstdint>
@@ -28,6 +29,11 @@ ________________________________________________________________________________
 namespace LLD
 {
 
+    /** Forward declarations **/
+    class BloomFilter;
+    class KeychainFile;
+
+
     /** BinaryHashMap
      *
      *  This class is responsible for managing the keys to the sector database.
@@ -41,7 +47,7 @@ namespace LLD
     {
     protected:
 
-        /** Mutex for Thread Synchronization. **/
+        /** Mutex to serialize writers, which readers never take. **/
         mutable std::mutex KEY_MUTEX;
 
 
@@ -49,7 +55,7 @@ namespace LLD
         std::string strBaseLocation;
 
 
-        /** Keychain stream object. **/
+        /** Keychain stream object, only used by writers. **/
         TemplateLRU<uint16_t, std::fstream*> *fileCache;
 
 
@@ -77,10 +83,18 @@ namespace LLD
         uint8_t nFlags;
 
 
-        /* The key level locking hashmap. */
+        /** Locks of bucket stripes, held by writers while changing a bucket and by readers while reading it. **/
         mutable std::vector<std::mutex> RECORD_MUTEX;
 
 
+        /** Read only handles of hashmap files, so readers don't share stream positions with writers. **/
+        HandleTable<KeychainFile> vReaders;
+
+
+        /** Bloom filter of keys in this keychain, only allocated with FLAGS::BLOOM. **/
+        BloomFilter* pBloom;
+
+
     public:
 
 
@@ -200,6 +214,64 @@ namespace LLD
          *
          **/
         bool Erase(const std::vector<uint8_t> &vKey);
+
+
+        /** Usage
+         *
+         *  Get the total bytes of sector data that keys point to in each sector file.
+         *
+         *  @param[out] mapUsage The bytes referenced by keys, by sector file.
+         *
+         **/
+        void Usage(std::map<uint32_t, uint64_t>& mapUsage);
+
+
+        /** Locations
+         *
+         *  Get the position of every record that keys point to in a sector file.
+         *
+         *  @param[in] nSectorFile The sector file to get records for.
+         *  @param[out] mapLocations The size of each record, by binary position.
+         *
+         **/
+        void Locations(const uint16_t nSectorFile, std::map<uint32_t, uint32_t>& mapLocations);
+
+
+        /** Relocate
+         *
+         *  Point keys to the new position of their records, only if they still point to the old position.
+         *
+         *  @param[in] nSectorFile The sector file records were moved from.
+         *  @param[in] mapMoves The new sector file, position and size of records, by old binary position.
+         *
+         *  @return The total keys that were relocated.
+         *
+         **/
+        uint32_t Relocate(const uint16_t nSectorFile, const std::map<uint32_t, SectorKey>& mapMoves);
+
+
+    private:
+
+
+        /** get_reader
+         *
+         *  Get the read only handle of a hashmap file, opening it on first use.
+         *
+         *  @param[in] nFile The hashmap file number.
+         *
+         *  @return The handle of the file, nullptr if it couldn't be opened.
+         *
+         **/
+        KeychainFile* get_reader(const uint16_t nFile);
+
+
+        /** load_bloom
+         *
+         *  Load the bloom filter from disk, or rebuild it from the hashmap files if it wasn't saved cleanly.
+         *
+         **/
+        void load_bloom();
+
     };
 }
 
@@ -15,31 +15,44 @@ ________________________________________________________________________________
 #ifndef NEXUS_LLD_TEMPLATES_HASHTREE_H
 #define NEXUS_LLD_TEMPLATES_HASHTREE_H
 
-#include <LLD/templates/key.h>
-#include <LLD/cache/template_lru.h>
-#include <LLD/include/enum.h>
+#include <LLD/include/version.h>
+
+#include <Util/templates/datastream.h>
 
 #include <cstdint>
 #include <string>
 #include <fstream>
 #include <vector>
+#include <set>
 #include <mutex>
+#include <atomic>
 
-//TODO: Abstract base class for all keychains
 namespace LLD
 {
 
     /** BinaryHashTree
      *
-     *  This class is responsible for managing the keys to the sector database.
+     *  This class is responsible for keeping the keys of a sector database in binary order.
+     *
+     *  The hashmap keychains can only answer lookups of whole keys, since keys are placed by their hash.
+     *  This tree holds the full binary data of keys in order, so keys sharing a prefix can be iterated
+     *  as a range. It only holds keys, records and their sector keys are still found through the keychain.
      *
-     *  It contains a Binary Hash Map with a minimum complexity of O(1).
-     *  It uses a linked file list based on index to iterate trhough files and binary Positions
-     *  when there is a collision that is found.
+     *  Keys are held in memory and written to an append only log, which is rewritten when it
+     *  holds mostly erased keys. The first byte of the log marks a complete tree as open while it is in
+     *  use, so a log that wasn't closed cleanly is discarded and backfilled rather than trusted.
      *
      **/
     class BinaryHashTree
     {
+        /** The flags held in the first byte of the tree log. **/
+        enum : uint8_t
+        {
+            INCOMPLETE = 0,
+            COMPLETE   = 1,
+            OPEN       = 2,
+        };
+
     protected:
 
         /** Mutex for Thread Synchronization. **/
@@ -50,152 +63,275 @@ namespace LLD
         std::string strBaseLocation;
 
 
-        /** Keychain stream object. **/
-        TemplateLRU<uint32_t, std::fstream*> *fileCache;
+        /** The keys in binary order. **/
+        std::set<std::vector<uint8_t>> setKeys;
 
 
-        /** Keychain index stream. **/
-        std::fstream* pindex;
+        /** The append only log stream. **/
+        std::ofstream* pstream;
 
 
-        /** Total elements in hashmap for quick inserts. **/
-        std::vector<uint32_t> hashmap;
+        /** The total records in the log, used to know when to rewrite it. **/
+        uint64_t nLogRecords;
 
 
-        /** The Maximum buckets allowed in the hashmap. */
-        uint32_t HASHMAP_TOTAL_BUCKETS;
+        /** Flag to show if the tree holds every key since the database was created, or was backfilled. **/
+        std::atomic<bool> fComplete;
 
 
-        /** The Maximum cache size for allocated keys. **/
-        uint32_t HASHMAP_MAX_CACHE_SIZE;
+    public:
 
+        /** Default Constructor **/
+        BinaryHashTree() = delete;
 
-        /** The Maximum key size for static key sectors. **/
-        uint16_t HASHMAP_MAX_KEY_SIZE;
 
+        /** Copy Constructor **/
+        BinaryHashTree(const BinaryHashTree& tree) = delete;
 
-        /** The total space that a key consumes. */
-        uint16_t HASHMAP_KEY_ALLOCATION;
 
+        /** Copy Assignment Operator **/
+        BinaryHashTree& operator=(const BinaryHashTree& tree) = delete;
 
-        /** The keychain flags. **/
-        uint8_t nFlags;
 
+        /** The Database Constructor. To determine file location.
+         *
+         *  @param[in] strBaseLocationIn The directory to keep the tree log in.
+         *  @param[in] fCompleteIn Flag to set if this tree is created along with an empty database.
+         *
+         **/
+        BinaryHashTree(const std::string& strBaseLocationIn, const bool fCompleteIn);
 
-    public:
 
-        /** Default Constructor **/
-        BinaryHashTree();
+        /** Default Destructor **/
+        ~BinaryHashTree();
 
 
-        /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        BinaryHashTree(const std::string& strBaseLocationIn, const uint8_t nFlagsIn = FLAGS::APPEND);
+        /** Initialize
+         *
+         *  Load the keys from the tree log, and rewrite the log if it is mostly erased keys.
+         *
+         **/
+        void Initialize();
 
 
-        /** Default Constructor **/
-        BinaryHashTree(const std::string& strBaseLocationIn, const uint32_t nTotalBuckets, const uint32_t nMaxCacheSize, const uint8_t nFlagsIn = FLAGS::APPEND);
+        /** Complete
+         *
+         *  Check if the tree holds every key since the database was created. Trees added to a database
+         *  that already had records don't know about keys written before them.
+         *
+         *  @return True if the tree is complete.
+         *
+         **/
+        bool Complete() const;
 
 
-        /** Copy Assignment Operator **/
-        BinaryHashTree& operator=(const BinaryHashTree& map);
+        /** SetComplete
+         *
+         *  Mark the tree as holding every key, once a database has backfilled the keys it wrote before the
+         *  tree existed. The flag is persisted in the tree log, so the backfill only runs again after an unclean shutdown.
+         *
+         *  @return True if the flag was written.
+         *
+         **/
+        bool SetComplete();
 
 
-        /** Copy Constructor **/
-        BinaryHashTree(const BinaryHashTree& map);
+        /** Flush
+         *
+         *  Synchronize the tree log with disk, called along with the keychain flush of a sector database.
+         *
+         *  @return True if the log was synchronized.
+         *
+         **/
+        bool Flush();
 
 
-        /** Default Destructor **/
-        ~BinaryHashTree();
+        /** Put
+         *
+         *  Add a key to the tree.
+         *
+         *  @param[in] vKey The binary data of key.
+         *
+         *  @return True if the key was written, false otherwise.
+         *
+         **/
+        bool Put(const std::vector<uint8_t>& vKey);
 
 
-        /** CompressKey
+        /** Erase
          *
-         *  Compresses a given key until it matches size criteria.
-         *  This function is one way and efficient for reducing key sizes.
+         *  Erase a key from the tree.
          *
-         *  @param[out] vData The binary data of key to compress.
-         *  @param[in] nSize The desired size of key after compression.
+         *  @param[in] vKey The binary data of key.
+         *
+         *  @return True if the key was erased, false otherwise.
          *
          **/
-        void CompressKey(std::vector<uint8_t>& vData, uint16_t nSize = 32);
+        bool Erase(const std::vector<uint8_t>& vKey);
 
 
-        /** GetKeys
+        /** Next
          *
-         *  Placeholder.
+         *  Get the first key after a given key that begins with a prefix.
+         *
+         *  @param[in] vPrefix The binary data that keys must begin with.
+         *  @param[in] vFrom The binary data of the key to search from.
+         *  @param[in] fInclusive Flag to include the key we are searching from.
+         *  @param[out] vKey The binary data of the key found.
+         *
+         *  @return True if a key was found.
          *
          **/
-         std::vector< std::vector<uint8_t> > GetKeys();
+        bool Next(const std::vector<uint8_t>& vPrefix, const std::vector<uint8_t>& vFrom, const bool fInclusive,
+                  std::vector<uint8_t> &vKey) const;
+
 
+    private:
 
-        /** GetBucket
+        /** append
          *
-         *  Calculates a bucket to be used for the hashmap allocation.
+         *  Append a record to the tree log.
          *
-         *  @param[in] vKey The key object to calculate with.
+         *  @param[in] nType The type of record, 1 for put or 0 for erase.
+         *  @param[in] vKey The binary data of key.
          *
-         *  @return The bucket assigned to the key.
+         *  @return True if the record was written.
          *
          **/
-        uint32_t GetBucket(const std::vector<uint8_t>& vKey);
+        bool append(const uint8_t nType, const std::vector<uint8_t>& vKey);
 
 
-        /** Initialize
+        /** sync
+         *
+         *  Synchronize the tree log with disk, must be called with KEY_MUTEX held.
          *
-         *  Initialize the binary hash map keychain.
+         *  @return True if the log was synchronized.
          *
          **/
-        void Initialize();
+        bool sync();
 
 
-        /** Get
+        /** write_flag
          *
-         *  Read a key index from the disk hashmaps.
+         *  Write the flag at the start of the tree log and synchronize it with disk.
          *
-         *  @param[in] vKey The binary data of key.
-         *  @param[out] cKey The key object to return.
+         *  @param[in] nFlag The flag to write.
          *
-         *  @return True if the key was found, false otherwise.
+         *  @return True if the flag was written.
          *
          **/
-        bool Get(const std::vector<uint8_t>& vKey, SectorKey &cKey);
+        bool write_flag(const uint8_t nFlag);
 
 
-        /** Put
+        /** rewrite
          *
-         *  Write a key to the disk hashmaps.
+         *  Rewrite the tree log with only the keys that are in the tree.
          *
-         *  @param[in] cKey The key object to write.
+         *  @return True if the log was rewritten.
          *
-         *  @return True if the key was written, false otherwise.
+         **/
+        bool rewrite();
+
+    };
+
+
+    /** KeyCursor
+     *
+     *  Iterates the keys of an ordered sector database that begin with a given prefix.
+     *  The cursor holds its last key rather than a position in the tree, so writes during iteration are safe.
+     *
+     **/
+    class KeyCursor
+    {
+        /** The tree that we are iterating. **/
+        const BinaryHashTree* pTree;
+
+
+        /** The binary data that keys must begin with. **/
+        std::vector<uint8_t> vPrefix;
+
+
+        /** The binary data of our current key. **/
+        std::vector<uint8_t> vKey;
+
+
+        /** Keys with our prefix that are written in an open transaction, but not yet in the tree. **/
+        std::set<std::vector<uint8_t>> setPending;
+
+
+        /** Keys that are erased in an open transaction, but still in the tree. **/
+        std::set<std::vector<uint8_t>> setErased;
+
+
+        /** Flag to show if we have found our first key. **/
+        bool fStarted;
+
+
+    public:
+
+        /** Default Constructor **/
+        KeyCursor();
+
+
+        /** Seek
+         *
+         *  Position the cursor before the first key that begins with a prefix.
+         *
+         *  @param[in] pTreeIn The tree to iterate.
+         *  @param[in] vPrefixIn The binary data that keys must begin with.
+         *  @param[in] vFrom The binary data of the key to start from, inclusive.
+         *  @param[in] setPendingIn Keys written in an open transaction, to iterate along with the tree.
+         *  @param[in] setErasedIn Keys erased in an open transaction, to skip over.
          *
          **/
-        bool Put(const SectorKey& cKey);
+        void Seek(const BinaryHashTree* pTreeIn, const std::vector<uint8_t>& vPrefixIn, const std::vector<uint8_t>& vFrom,
+                  const std::set<std::vector<uint8_t>>& setPendingIn = { }, const std::set<std::vector<uint8_t>>& setErasedIn = { });
 
 
-        /** Restore
+        /** Next
          *
-         *  Restore an erased key from keychain.
+         *  Move the cursor to the next key that begins with our prefix.
          *
-         *  @param[in] vKey the key to restore.
+         *  @return True if there was another key.
          *
-         *  @return True if the key was restored.
+         **/
+        bool Next();
+
+
+        /** Key
+         *
+         *  Get the binary data of the current key.
+         *
+         *  @return The binary data of the key.
          *
          **/
-        bool Restore(const std::vector<uint8_t> &vKey);
+        const std::vector<uint8_t>& Key() const;
 
 
-        /** Erase
+        /** Get
          *
-         *  Erase a key from the disk hashmaps.
-         *  TODO: This should be optimized further.
+         *  Deserialize the current key.
          *
-         *  @param[in] vKey the key to erase.
+         *  @param[out] key The key to deserialize into.
          *
-         *  @return True if the key was erased, false otherwise.
+         *  @return True if the key was deserialized.
          *
          **/
-        bool Erase(const std::vector<uint8_t> &vKey);
+        template<typename Type>
+        bool Get(Type& key) const
+        {
+            try
+            {
+                DataStream ssKey(vKey, SER_LLD, DATABASE_VERSION);
+                ssKey >> key;
+            }
+            catch(const std::exception& e)
+            {
+                return false;
+            }
+
+            return true;
+        }
     };
 }
 
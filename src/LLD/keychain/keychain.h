@@ -17,6 +17,8 @@ ________________________________________________________________________________
 
 #include <LLD/templates/key.h>
 
+#include <map>
+
 namespace LLD
 {
 
@@ -89,6 +91,40 @@ namespace LLD
          *
          **/
         virtual bool Erase(const std::vector<uint8_t>& vKey) = 0;
+
+
+        /** Usage
+         *
+         *  Get the total bytes of sector data that keys point to in each sector file.
+         *
+         *  @param[out] mapUsage The bytes referenced by keys, by sector file.
+         *
+         **/
+        virtual void Usage(std::map<uint32_t, uint64_t>& mapUsage) = 0;
+
+
+        /** Locations
+         *
+         *  Get the position of every record that keys point to in a sector file.
+         *
+         *  @param[in] nSectorFile The sector file to get records for.
+         *  @param[out] mapLocations The size of each record, by binary position.
+         *
+         **/
+        virtual void Locations(const uint16_t nSectorFile, std::map<uint32_t, uint32_t>& mapLocations) = 0;
+
+
+        /** Relocate
+         *
+         *  Point keys to the new position of their records, only if they still point to the old position.
+         *
+         *  @param[in] nSectorFile The sector file records were moved from.
+         *  @param[in] mapMoves The new sector file, position and size of records, by old binary position.
+         *
+         *  @return The total keys that were relocated.
+         *
+         **/
+        virtual uint32_t Relocate(const uint16_t nSectorFile, const std::map<uint32_t, SectorKey>& mapMoves) = 0;
     };
 }
 
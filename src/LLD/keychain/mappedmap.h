@@ -0,0 +1,286 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLD_KEYCHAIN_MAPPEDMAP_H
+#define NEXUS_LLD_KEYCHAIN_MAPPEDMAP_H
+
+#include <LLD/keychain/keychain.h>
+#include <LLD/templates/handles.h>
+#include <LLD/include/enum.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace LLD
+{
+
+    /** Forward declarations **/
+    class MappedFile;
+    class BloomFilter;
+
+
+    /** BinaryMappedMap
+     *
+     *  This class is responsible for managing the keys to the sector database.
+     *
+     *  It uses the same on-disk layout as BinaryHashMap, so existing keychains can be opened with either class.
+     *  The index file and every hashmap file are memory mapped, so that bucket probes are resolved by pointer
+     *  arithmetic into the mapped regions rather than by seek and read calls on a stream cache.
+     *
+     **/
+    class BinaryMappedMap : public Keychain
+    {
+    protected:
+
+        /** Mutex to serialize writers, which readers never take. **/
+        mutable std::mutex KEY_MUTEX;
+
+
+        /** Locks of bucket stripes, held by writers while changing a bucket and by readers while reading it. **/
+        mutable std::vector<std::mutex> RECORD_MUTEX;
+
+
+        /** The string to hold the database location. **/
+        std::string strBaseLocation;
+
+
+        /** Mapped region of the keychain index file. **/
+        MappedFile* pindex;
+
+
+        /** Mapped regions of hashmap files, indexed by their file number. **/
+        HandleTable<MappedFile> vFiles;
+
+
+        /** The Maximum buckets allowed in the hashmap. */
+        uint32_t HASHMAP_TOTAL_BUCKETS;
+
+
+        /** The Maximum key size for static key sectors. **/
+        uint16_t HASHMAP_MAX_KEY_SIZE;
+
+
+        /** The total space that a key consumes. */
+        uint16_t HASHMAP_KEY_ALLOCATION;
+
+
+        /** The keychain flags. **/
+        uint8_t nFlags;
+
+
+        /** Bloom filter of keys in this keychain, only allocated with FLAGS::BLOOM. **/
+        BloomFilter* pBloom;
+
+
+    public:
+
+
+        /** Default Constructor. **/
+        BinaryMappedMap() = delete;
+
+
+        /** The Database Constructor. To determine file location and the Bytes per Record. **/
+        BinaryMappedMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn = FLAGS::APPEND, const uint64_t nBucketsIn = 256 * 256 * 64);
+
+
+        /** Copy Constructor: mapped regions are owned by a single keychain. **/
+        BinaryMappedMap(const BinaryMappedMap& map) = delete;
+
+
+        /** Copy Assignment Operator: mapped regions are owned by a single keychain. **/
+        BinaryMappedMap& operator=(const BinaryMappedMap& map) = delete;
+
+
+        /** Default Destructor **/
+        virtual ~BinaryMappedMap();
+
+
+        /** CompressKey
+         *
+         *  Compresses a given key until it matches size criteria.
+         *  This function is one way and efficient for reducing key sizes.
+         *
+         *  @param[out] vData The binary data of key to compress.
+         *  @param[in] nSize The desired size of key after compression.
+         *
+         **/
+        void CompressKey(std::vector<uint8_t>& vData, uint16_t nSize = 32);
+
+
+        /** GetBucket
+         *
+         *  Calculates a bucket to be used for the hashmap allocation.
+         *
+         *  @param[in] vKey The key object to calculate with.
+         *
+         *  @return The bucket assigned to the key.
+         *
+         **/
+        uint32_t GetBucket(const std::vector<uint8_t>& vKey);
+
+
+        /** Initialize
+         *
+         *  Initialize the binary mapped keychain.
+         *
+         **/
+        void Initialize();
+
+
+        /** Get
+         *
+         *  Read a key index from the mapped hashmaps.
+         *
+         *  @param[in] vKey The binary data of key.
+         *  @param[out] cKey The key object to return.
+         *
+         *  @return True if the key was found, false otherwise.
+         *
+         **/
+        bool Get(const std::vector<uint8_t>& vKey, SectorKey &cKey);
+
+
+        /** Put
+         *
+         *  Write a key to the mapped hashmaps.
+         *
+         *  @param[in] cKey The key object to write.
+         *
+         *  @return True if the key was written, false otherwise.
+         *
+         **/
+        bool Put(const SectorKey& cKey);
+
+
+        /** Flush
+         *
+         *  Synchronize all mapped regions with disk.
+         *
+         **/
+        void Flush();
+
+
+        /** Restore
+         *
+         *  Restore an erased key from keychain.
+         *
+         *  @param[in] vKey the key to restore.
+         *
+         *  @return True if the key was restored.
+         *
+         **/
+        bool Restore(const std::vector<uint8_t> &vKey);
+
+
+        /** Erase
+         *
+         *  Erase a key from the mapped hashmaps.
+         *
+         *  @param[in] vKey the key to erase.
+         *
+         *  @return True if the key was erased, false otherwise.
+         *
+         **/
+        bool Erase(const std::vector<uint8_t> &vKey);
+
+
+        /** Usage
+         *
+         *  Get the total bytes of sector data that keys point to in each sector file.
+         *
+         *  @param[out] mapUsage The bytes referenced by keys, by sector file.
+         *
+         **/
+        void Usage(std::map<uint32_t, uint64_t>& mapUsage);
+
+
+        /** Locations
+         *
+         *  Get the position of every record that keys point to in a sector file.
+         *
+         *  @param[in] nSectorFile The sector file to get records for.
+         *  @param[out] mapLocations The size of each record, by binary position.
+         *
+         **/
+        void Locations(const uint16_t nSectorFile, std::map<uint32_t, uint32_t>& mapLocations);
+
+
+        /** Relocate
+         *
+         *  Point keys to the new position of their records, only if they still point to the old position.
+         *
+         *  @param[in] nSectorFile The sector file records were moved from.
+         *  @param[in] mapMoves The new sector file, position and size of records, by old binary position.
+         *
+         *  @return The total keys that were relocated.
+         *
+         **/
+        uint32_t Relocate(const uint16_t nSectorFile, const std::map<uint32_t, SectorKey>& mapMoves);
+
+
+    private:
+
+
+        /** get_file
+         *
+         *  Get the mapped region of a hashmap file, mapping it on first use.
+         *
+         *  @param[in] nFile The hashmap file number.
+         *  @param[in] fCreate Flag to create the file if it doesn't exist.
+         *
+         *  @return Pointer to the beginning of the mapped file, nullptr on failure.
+         *
+         **/
+        uint8_t* get_file(const uint16_t nFile, const bool fCreate = false);
+
+
+        /** get_index
+         *
+         *  Get the total hashmap files that are allocated for a given bucket.
+         *
+         *  @param[in] nBucket The bucket to read the index for.
+         *
+         *  @return The total files in the linked file list for bucket.
+         *
+         **/
+        uint16_t get_index(const uint32_t nBucket) const;
+
+
+        /** set_index
+         *
+         *  Set the total hashmap files that are allocated for a given bucket.
+         *
+         *  @param[in] nBucket The bucket to write the index for.
+         *  @param[in] nIndex The total files to write.
+         *
+         **/
+        void set_index(const uint32_t nBucket, const uint16_t nIndex);
+
+
+        /** load_bloom
+         *
+         *  Load the bloom filter from disk, or rebuild it from the hashmap files if it wasn't saved cleanly.
+         *
+         *  @param[in] nTotalFiles The total hashmap files in the keychain.
+         *  @param[in] nTotalKeys The total slots in use in the keychain, to size the filter.
+         *
+         **/
+        void load_bloom(const uint16_t nTotalFiles, const uint32_t nTotalKeys);
+
+    };
+}
+
+#endif
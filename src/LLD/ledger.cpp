@@ -25,6 +25,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/types/transaction.h>
 #include <TAO/Ledger/include/chainstate.h>
 #include <TAO/Ledger/include/constants.h>
+#include <TAO/Ledger/include/metrics.h>
 #include <TAO/Ledger/types/state.h>
 #include <TAO/Ledger/types/merkle.h>
 #include <TAO/Ledger/types/mempool.h>
@@ -784,6 +785,20 @@ namespace LLD
     }
 
 
+    /* Writes the ledger metrics of a bucket of block time. */
+    bool LedgerDB::WriteMetrics(const uint32_t nBucket, const TAO::Ledger::Metrics& tMetrics)
+    {
+        return Write(std::make_pair(std::string("metrics"), nBucket), tMetrics);
+    }
+
+
+    /* Reads the ledger metrics of a bucket of block time. */
+    bool LedgerDB::ReadMetrics(const uint32_t nBucket, TAO::Ledger::Metrics &tMetrics)
+    {
+        return Read(std::make_pair(std::string("metrics"), nBucket), tMetrics);
+    }
+
+
     /* Writes a proof to disk. Proofs are used to keep track of spent temporal proofs. */
     bool LedgerDB::WriteProof(const uint256_t& hashProof, const uint512_t& hashTx,
                               const uint32_t nContract, const uint8_t nFlags)
@@ -1183,6 +1198,88 @@ namespace LLD
     }
 
 
+    /* Build the ledger metrics buckets of the last four weeks of blocks. */
+    void LedgerDB::IndexMetrics()
+    {
+        /* Check if our buckets have been built already, after which they are kept by block connect. */
+        if(Exists(std::string("index.metrics.complete")))
+            return;
+
+        /* Start a timer to track. */
+        runtime::timer timer;
+        timer.Start();
+
+        /* Build our buckets in memory, so that any left by an interrupted scan are overwritten. */
+        std::map<uint32_t, TAO::Ledger::Metrics> mapBuckets;
+
+        /* Get our starting block. */
+        TAO::Ledger::BlockState state = TAO::Ledger::ChainState::tStateBest.load();
+        const uint64_t nBestTime = state.GetBlockTime();
+
+        /* Keep track of our total count. */
+        uint32_t nScannedCount = 0;
+
+        /* Walk back until we have covered four weeks. */
+        debug::notice(FUNCTION, "Indexing metrics from block ", state.GetHash().SubString());
+        while(!config::fShutdown.load() && !state.IsNull() && state.GetBlockTime() + 86400 * 7 * 4 > nBestTime)
+        {
+            /* Get the bucket for this block. */
+            TAO::Ledger::Metrics& rBucket =
+                mapBuckets[state.GetBlockTime() / TAO::Ledger::METRICS_BUCKET];
+
+            /* Loop through found transactions. */
+            for(const auto& proof : state.vtx)
+            {
+                /* Handle for Tritium Transactions. */
+                if(proof.first == TAO::Ledger::TRANSACTION::TRITIUM)
+                {
+                    /* Read the transaction from disk. */
+                    TAO::Ledger::Transaction tx;
+                    if(!LLD::Ledger->ReadTx(proof.second, tx))
+                        continue;
+
+                    rBucket.Add(tx);
+                }
+
+                /* Handle for Legacy Transactions. */
+                if(proof.first == TAO::Ledger::TRANSACTION::LEGACY)
+                {
+                    /* Read the transaction from disk. */
+                    Legacy::Transaction tx;
+                    if(!LLD::Legacy->ReadTx(proof.second, tx))
+                        continue;
+
+                    rBucket.Add(tx);
+                }
+
+                ++nScannedCount;
+            }
+
+            /* Iterate to the previous block. */
+            state = state.Prev();
+        }
+
+        /* Don't mark our buckets complete if we were interrupted. */
+        if(config::fShutdown.load())
+            return;
+
+        /* Write our buckets to disk. */
+        for(const auto& pairBucket : mapBuckets)
+        {
+            if(!WriteMetrics(pairBucket.first, pairBucket.second))
+            {
+                debug::warning(FUNCTION, "failed to write metrics bucket ", pairBucket.first);
+                return;
+            }
+        }
+
+        /* Write our last index now. */
+        Write(std::string("index.metrics.complete"));
+
+        debug::notice(FUNCTION, "Complated scanning ", nScannedCount, " tx into ", mapBuckets.size(), " buckets in ", timer.Elapsed(), " seconds");
+    }
+
+
     /* Writes a block state object to disk. */
     bool LedgerDB::WriteBlock(const uint1024_t& hashBlock, const TAO::Ledger::BlockState& state)
     {
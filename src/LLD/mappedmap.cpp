@@ -0,0 +1,897 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/keychain/mappedmap.h>
+#include <LLD/templates/bloom.h>
+#include <LLD/include/enum.h>
+#include <LLD/include/version.h>
+#include <LLD/hash/xxh3.h>
+
+#include <Util/templates/datastream.h>
+#include <Util/include/filesystem.h>
+#include <Util/include/debug.h>
+#include <Util/include/hex.h>
+
+#include <iomanip>
+#include <fstream>
+
+#ifdef WIN32
+
+/* Set up defs properly before including windows.h */
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace LLD
+{
+
+    /** MappedFile
+     *
+     *  Read / write memory mapping of a single keychain file.
+     *
+     **/
+    class MappedFile
+    {
+    public:
+
+        /** Pointer to the beginning of the mapped region. **/
+        uint8_t* pData;
+
+
+        /** The size in bytes of the mapped region. **/
+        uint64_t nSize;
+
+    #ifdef WIN32
+
+        /** The windows file and mapping handles. **/
+        HANDLE hFile;
+        HANDLE hMap;
+    #else
+
+        /** The file descriptor backing the mapping. **/
+        int32_t nFile;
+    #endif
+
+
+        /** Constructor. Maps the whole file at given path. **/
+        MappedFile(const std::string& strPath)
+        : pData (nullptr)
+        , nSize (0)
+    #ifdef WIN32
+        , hFile (INVALID_HANDLE_VALUE)
+        , hMap  (nullptr)
+    #else
+        , nFile (-1)
+    #endif
+        {
+            /* Get the size of the file to map. */
+            const int64_t nFileSize = filesystem::size(strPath);
+            if(nFileSize <= 0)
+                return;
+
+        #ifdef WIN32
+            hFile = CreateFileA(strPath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if(hFile == INVALID_HANDLE_VALUE)
+                return;
+
+            hMap = CreateFileMappingA(hFile, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+            if(hMap == nullptr)
+                return;
+
+            void* pMap = MapViewOfFile(hMap, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+            if(pMap == nullptr)
+                return;
+        #else
+            nFile = open(strPath.c_str(), O_RDWR);
+            if(nFile < 0)
+                return;
+
+            void* pMap = mmap(nullptr, nFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, nFile, 0);
+            if(pMap == MAP_FAILED)
+                return;
+
+            /* Bucket probes are scattered across the whole file. */
+            madvise(pMap, nFileSize, MADV_RANDOM);
+        #endif
+
+            /* Set our mapped region now that all calls succeeded. */
+            pData = static_cast<uint8_t*>(pMap);
+            nSize = static_cast<uint64_t>(nFileSize);
+        }
+
+
+        /** Default Destructor. Unmaps the region and closes the file. **/
+        ~MappedFile()
+        {
+        #ifdef WIN32
+            if(pData)
+                UnmapViewOfFile(pData);
+
+            if(hMap)
+                CloseHandle(hMap);
+
+            if(hFile != INVALID_HANDLE_VALUE)
+                CloseHandle(hFile);
+        #else
+            if(pData)
+                munmap(pData, nSize);
+
+            if(nFile >= 0)
+                close(nFile);
+        #endif
+        }
+
+
+        /** IsNull
+         *
+         *  Determines if the mapping failed.
+         *
+         **/
+        bool IsNull() const
+        {
+            return pData == nullptr;
+        }
+
+
+        /** Sync
+         *
+         *  Synchronize the mapped region with disk.
+         *
+         **/
+        void Sync() const
+        {
+            if(!pData)
+                return;
+
+        #ifdef WIN32
+            FlushViewOfFile(pData, 0);
+            FlushFileBuffers(hFile);
+        #else
+            msync(pData, nSize, MS_SYNC);
+        #endif
+        }
+    };
+
+
+    /* Write a zeroed file of given size to disk. */
+    static bool allocate_file(const std::string& strPath, const uint64_t nSize)
+    {
+        /* Build a vector with empty bytes to flush to disk. */
+        const std::vector<uint8_t> vSpace(nSize, 0);
+
+        /* Flush the empty keychain file to disk. */
+        std::fstream stream(strPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!stream.write((char*)&vSpace[0], vSpace.size()))
+            return false;
+
+        stream.close();
+
+        return true;
+    }
+
+
+    /* The Database Constructor. To determine file location and the Bytes per Record. */
+    BinaryMappedMap::BinaryMappedMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn, const uint64_t nBucketsIn)
+    : KEY_MUTEX              ( )
+    , RECORD_MUTEX           (1024)
+    , strBaseLocation        (strBaseLocationIn)
+    , pindex                 (nullptr)
+    , vFiles                 ( )
+    , HASHMAP_TOTAL_BUCKETS  (nBucketsIn)
+    , HASHMAP_MAX_KEY_SIZE   (32)
+    , HASHMAP_KEY_ALLOCATION (static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
+    , nFlags                 (nFlagsIn)
+    , pBloom                 (nullptr)
+    {
+        Initialize();
+    }
+
+
+    /* Default Destructor */
+    BinaryMappedMap::~BinaryMappedMap()
+    {
+        /* Unmap all of the hashmap files. */
+        vFiles.Clear();
+
+        /* Unmap the index file. */
+        if(pindex)
+            delete pindex;
+
+        /* Persist our bloom filter with the stamp of our closed files, so it doesn't need to be rebuilt on next open. */
+        if(pBloom)
+        {
+            if(!pBloom->Save(debug::safe_printstr(strBaseLocation, "_bloom.filter"), BloomFilter::Stamp(strBaseLocation)))
+                debug::error(FUNCTION, "failed to save bloom filter for ", strBaseLocation);
+
+            delete pBloom;
+        }
+    }
+
+
+    /*  Compresses a given key until it matches size criteria. */
+    void BinaryMappedMap::CompressKey(std::vector<uint8_t>& vData, uint16_t nSize)
+    {
+        /* Loop until key is of desired size. */
+        while(vData.size() > nSize)
+        {
+            /* Loop half of the key to XOR elements. */
+            uint64_t nSize2 = (vData.size() >> 1);
+            for(uint64_t i = 0; i < nSize2; ++i)
+            {
+                uint64_t i2 = (i << 1);
+                if(i2 < (nSize2 << 1))
+                    vData[i] = vData[i] ^ vData[i2];
+            }
+
+            /* Resize the container to half its size. */
+            vData.resize(std::max(uint16_t(nSize2), nSize));
+        }
+    }
+
+
+    /* Calculates a bucket to be used for the hashmap allocation. */
+    uint32_t BinaryMappedMap::GetBucket(const std::vector<uint8_t>& vKey)
+    {
+        /* Get an xxHash. */
+        uint64_t nBucket = XXH64(&vKey[0], vKey.size(), 0) / 7;
+
+        return static_cast<uint32_t>(nBucket % HASHMAP_TOTAL_BUCKETS);
+    }
+
+
+    /* Initialize the binary mapped keychain. */
+    void BinaryMappedMap::Initialize()
+    {
+        /* Create directories if they don't exist yet. */
+        if(!filesystem::exists(strBaseLocation) && filesystem::create_directories(strBaseLocation))
+            debug::log(0, FUNCTION, "Generated Path ", strBaseLocation);
+
+        /* Build the hashmap indexes. */
+        const std::string strIndex = debug::safe_printstr(strBaseLocation, "_hashmap.index");
+        if(!filesystem::exists(strIndex))
+        {
+            /* Use the same allocation as the binary hashmap so keychains stay interchangeable. */
+            if(!allocate_file(strIndex, HASHMAP_TOTAL_BUCKETS * 4))
+                debug::error(FUNCTION, "failed to generate disk index ", strIndex);
+
+            /* Debug output showing generation of disk index. */
+            debug::log(0, FUNCTION, "Generated Disk Index of ", HASHMAP_TOTAL_BUCKETS * 4, " bytes");
+        }
+
+        /* Map the index into memory. */
+        pindex = new MappedFile(strIndex);
+        if(pindex->IsNull() || pindex->nSize < HASHMAP_TOTAL_BUCKETS * 2)
+        {
+            debug::error(FUNCTION, "failed to map disk index ", strIndex, " (", strerror(errno), ")");
+
+            delete pindex;
+            pindex = nullptr;
+
+            return;
+        }
+
+        /* Map all of the existing hashmap files. */
+        uint32_t nTotalKeys  = 0;
+        uint16_t nTotalFiles = 0;
+        for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+        {
+            const uint16_t nIndex = get_index(nBucket);
+
+            nTotalKeys += nIndex;
+            nTotalFiles = std::max(nTotalFiles, nIndex);
+        }
+
+        /* Build the first hashmap file if it doesn't exist. */
+        if(!get_file(0, true))
+            debug::error(FUNCTION, "failed to map disk hash map 0");
+
+        /* Load our bloom filter if enabled. */
+        if(nFlags & FLAGS::BLOOM)
+            load_bloom(nTotalFiles, nTotalKeys);
+
+        /* Debug output showing loading of disk index. */
+        debug::log(0, FUNCTION, "Mapped Disk Index of ", pindex->nSize, " bytes and ", nTotalKeys, " keys");
+    }
+
+
+    /* Read a key index from the mapped hashmaps. */
+    bool BinaryMappedMap::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
+    {
+        /* Get the assigned bucket for the hashmap. */
+        const uint32_t nBucket = GetBucket(vKey);
+
+        /* Get the file binary position. */
+        const uint64_t nFilePos = uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+        /* Set the cKey return value non compressed. */
+        cKey.vKey = vKey;
+
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        /* Check our bloom filter to answer keys that were never written without probing any files. */
+        if(pBloom && !pBloom->Has(vKeyCompressed.data(), vKeyCompressed.size()))
+            return false;
+
+        /* Lock only our bucket's stripe, so readers of other buckets and writers don't block us. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
+        /* Check that our index is mapped. */
+        if(!pindex)
+            return false;
+
+        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        for(int32_t i = get_index(nBucket) - 1; i >= 0; --i)
+        {
+            /* Get the mapped file region. */
+            const uint8_t* pfile = get_file(i);
+            if(!pfile)
+                continue;
+
+            /* Get the bucket from the mapped file. */
+            const uint8_t* pBucket = pfile + nFilePos;
+
+            /* Check if this bucket has the key */
+            if(std::equal(pBucket + 13, pBucket + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
+            {
+                /* Deserialie key and return if found. */
+                DataStream ssKey(std::vector<uint8_t>(pBucket, pBucket + HASHMAP_KEY_ALLOCATION), SER_LLD, DATABASE_VERSION);
+                ssKey >> cKey;
+
+                /* Check if the key is ready. */
+                if(!cKey.Ready())
+                    continue;
+
+                /* Debug Output of Sector Key Information. */
+                if(config::nVerbose >= 4)
+                    debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                        " | Length: ", cKey.nLength,
+                        " | Bucket ", nBucket,
+                        " | Location: ", nFilePos,
+                        " | File: ", i,
+                        " | Sector File: ", cKey.nSectorFile,
+                        " | Sector Size: ", cKey.nSectorSize,
+                        " | Sector Start: ", cKey.nSectorStart, "\n",
+                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    /* Write a key to the mapped hashmaps. */
+    bool BinaryMappedMap::Put(const SectorKey& cKey)
+    {
+        /* Get the assigned bucket for the hashmap. */
+        const uint32_t nBucket = GetBucket(cKey.vKey);
+
+        /* Get the file binary position. */
+        const uint64_t nFilePos = uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = cKey.vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        /* Serialize the key header. */
+        DataStream ssKey(SER_LLD, DATABASE_VERSION);
+        ssKey << cKey;
+
+        /* Serialize the key into the end of the vector. */
+        ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
+
+        /* Get a reference of our serialized bucket. */
+        const std::vector<uint8_t>& vBucket = ssKey.Bytes();
+
+        /* Add to our bloom filter before the key is visible to readers. */
+        if(pBloom)
+            pBloom->Insert(vKeyCompressed.data(), vKeyCompressed.size());
+
+        LOCK(KEY_MUTEX);
+
+        /* Lock our bucket's stripe, so readers never see a bucket that is half written. */
+        LOCK2(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
+        /* Check that our index is mapped. */
+        if(!pindex)
+            return debug::error(FUNCTION, "disk index is not mapped");
+
+        /* Handle if not in append mode which will update the key. */
+        const uint16_t nIndex = get_index(nBucket);
+        if(!(nFlags & FLAGS::APPEND))
+        {
+            /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+            for(int32_t i = nIndex - 1; i >= 0; --i)
+            {
+                /* Get the mapped file region. */
+                uint8_t* pfile = get_file(i);
+                if(!pfile)
+                    return debug::error(FUNCTION, "couldn't map hashmap file ", i, " (", strerror(errno), ")");
+
+                /* Get the bucket from the mapped file. */
+                uint8_t* pBucket = pfile + nFilePos;
+
+                /* Check if this bucket has the key or is in an empty state. */
+                if(pBucket[0] == STATE::EMPTY || std::equal(pBucket + 13, pBucket + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
+                {
+                    /* Write the bucket into the mapped region. */
+                    std::copy(vBucket.begin(), vBucket.end(), pBucket);
+
+                    /* Debug Output of Sector Key Information. */
+                    if(config::nVerbose >= 4)
+                        debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                            " | Length: ", cKey.nLength,
+                            " | Bucket ", nBucket,
+                            " | Location: ", nFilePos,
+                            " | File: ", i,
+                            " | Sector File: ", cKey.nSectorFile,
+                            " | Sector Size: ", cKey.nSectorSize,
+                            " | Sector Start: ", cKey.nSectorStart, "\n",
+                            HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
+
+                    return true;
+                }
+            }
+        }
+
+        /* Check that we don't overflow our linked file list. */
+        if(nIndex == std::numeric_limits<uint16_t>::max())
+            return debug::error(FUNCTION, "bucket ", nBucket, " exceeded maximum hashmap files");
+
+        /* Get the next file in the linked list, creating it if it doesn't exist. */
+        uint8_t* pfile = get_file(nIndex, true);
+        if(!pfile)
+            return debug::error(FUNCTION, "failed to map hashmap file ", nIndex, " (", strerror(errno), ")");
+
+        /* Write the bucket into the mapped region. */
+        std::copy(vBucket.begin(), vBucket.end(), pfile + nFilePos);
+
+        /* Write the index into hashmap. */
+        set_index(nBucket, nIndex + 1);
+
+        /* Debug Output of Sector Key Information. */
+        if(config::nVerbose >= 4)
+            debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                " | Length: ", cKey.nLength,
+                " | Bucket ", nBucket,
+                " | Hashmap ", nIndex + 1,
+                " | Location: ", nFilePos,
+                " | File: ", nIndex,
+                " | Sector File: ", cKey.nSectorFile,
+                " | Sector Size: ", cKey.nSectorSize,
+                " | Sector Start: ", cKey.nSectorStart,
+                " | Key: ",  HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
+
+        return true;
+    }
+
+
+    /* Synchronize all mapped regions with disk. */
+    void BinaryMappedMap::Flush()
+    {
+        LOCK(KEY_MUTEX);
+
+        /* Sync the index file. */
+        if(pindex)
+            pindex->Sync();
+
+        /* Sync all of the hashmap files. */
+        for(uint32_t nFile = 0; nFile < vFiles.Size(); ++nFile)
+        {
+            const MappedFile* pfile = vFiles.Get(nFile);
+            if(pfile)
+                pfile->Sync();
+        }
+    }
+
+
+    /* Erase a key from the mapped hashmaps. */
+    bool BinaryMappedMap::Erase(const std::vector<uint8_t> &vKey)
+    {
+        /* Get the assigned bucket for the hashmap. */
+        const uint32_t nBucket = GetBucket(vKey);
+
+        /* Get the file binary position. */
+        const uint64_t nFilePos = uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        /* Check our bloom filter for keys that were never written. */
+        if(pBloom && !pBloom->Has(vKeyCompressed.data(), vKeyCompressed.size()))
+            return false;
+
+        LOCK(KEY_MUTEX);
+
+        /* Lock our bucket's stripe, so readers never see a bucket that is half written. */
+        LOCK2(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
+        /* Check that our index is mapped. */
+        if(!pindex)
+            return false;
+
+        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        for(int32_t i = get_index(nBucket) - 1; i >= 0; --i)
+        {
+            /* Get the mapped file region. */
+            uint8_t* pfile = get_file(i);
+            if(!pfile)
+                continue;
+
+            /* Get the bucket from the mapped file. */
+            uint8_t* pBucket = pfile + nFilePos;
+
+            /* Check if this bucket has the key */
+            if(std::equal(pBucket + 13, pBucket + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
+            {
+                /* Debug Output of Sector Key Information. */
+                if(config::nVerbose >= 4)
+                {
+                    /* Deserialize key for debug output. */
+                    DataStream ssKey(std::vector<uint8_t>(pBucket, pBucket + HASHMAP_KEY_ALLOCATION), SER_LLD, DATABASE_VERSION);
+
+                    SectorKey cKey;
+                    ssKey >> cKey;
+
+                    debug::log(4, FUNCTION, "Erased State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                        " | Length: ", cKey.nLength,
+                        " | Bucket ", nBucket,
+                        " | Location: ", nFilePos,
+                        " | File: ", i,
+                        " | Sector File: ", cKey.nSectorFile,
+                        " | Sector Size: ", cKey.nSectorSize,
+                        " | Sector Start: ", cKey.nSectorStart,
+                        " | Key: ", HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
+                }
+
+                /* Clear the bucket in the mapped region. */
+                std::fill(pBucket, pBucket + HASHMAP_KEY_ALLOCATION, 0);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    /* Restore an index in the hashmap if it is found. */
+    bool BinaryMappedMap::Restore(const std::vector<uint8_t> &vKey)
+    {
+        /* Get the assigned bucket for the hashmap. */
+        const uint32_t nBucket = GetBucket(vKey);
+
+        /* Get the file binary position. */
+        const uint64_t nFilePos = uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        LOCK(KEY_MUTEX);
+
+        /* Lock our bucket's stripe, so readers never see a bucket that is half written. */
+        LOCK2(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
+        /* Check that our index is mapped. */
+        if(!pindex)
+            return false;
+
+        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        for(int32_t i = get_index(nBucket) - 1; i >= 0; --i)
+        {
+            /* Get the mapped file region. */
+            uint8_t* pfile = get_file(i);
+            if(!pfile)
+                continue;
+
+            /* Get the bucket from the mapped file. */
+            uint8_t* pBucket = pfile + nFilePos;
+
+            /* Check if this bucket has the key */
+            if(std::equal(pBucket + 13, pBucket + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
+            {
+                /* Skip over keys that are already ready. */
+                if(pBucket[0] == STATE::READY)
+                    return true;
+
+                /* Set the state byte of the bucket. */
+                pBucket[0] = STATE::READY;
+
+                /* Debug Output of Sector Key Information. */
+                if(config::nVerbose >= 4)
+                    debug::log(4, FUNCTION, "Restored Bucket ", nBucket,
+                        " | Location: ", nFilePos,
+                        " | File: ", i,
+                        " | Key: ", HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    /* Get the total bytes of sector data that keys point to in each sector file. */
+    void BinaryMappedMap::Usage(std::map<uint32_t, uint64_t>& mapUsage)
+    {
+        /* Check all of our hashmap files, locking each one so writers aren't held for the whole scan. */
+        for(uint16_t nFile = 0; ; ++nFile)
+        {
+            LOCK(KEY_MUTEX);
+
+            /* Get the mapped file region, stopping at the first file that doesn't exist. */
+            const uint8_t* pfile = pindex ? get_file(nFile) : nullptr;
+            if(!pfile)
+                break;
+
+            /* Check all buckets in this file. */
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+            {
+                /* Skip over empty buckets. */
+                const uint8_t* pBucket = pfile + uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+                if(pBucket[0] == STATE::EMPTY)
+                    continue;
+
+                /* Get the sector file and size from the key header. */
+                uint16_t nSectorFile = 0;
+                uint32_t nSectorSize = 0;
+                std::copy(pBucket + 3, pBucket + 5, (uint8_t*)&nSectorFile);
+                std::copy(pBucket + 5, pBucket + 9, (uint8_t*)&nSectorSize);
+
+                mapUsage[nSectorFile] += nSectorSize;
+            }
+        }
+    }
+
+
+    /* Get the position of every record that keys point to in a sector file. */
+    void BinaryMappedMap::Locations(const uint16_t nSectorFile, std::map<uint32_t, uint32_t>& mapLocations)
+    {
+        /* Check all of our hashmap files, locking each one so writers aren't held for the whole scan. */
+        for(uint16_t nFile = 0; ; ++nFile)
+        {
+            LOCK(KEY_MUTEX);
+
+            /* Get the mapped file region, stopping at the first file that doesn't exist. */
+            const uint8_t* pfile = pindex ? get_file(nFile) : nullptr;
+            if(!pfile)
+                break;
+
+            /* Check all buckets in this file. */
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+            {
+                /* Skip over empty buckets. */
+                const uint8_t* pBucket = pfile + uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+                if(pBucket[0] == STATE::EMPTY)
+                    continue;
+
+                /* Skip over keys in other sector files. */
+                uint16_t nFileIn = 0;
+                std::copy(pBucket + 3, pBucket + 5, (uint8_t*)&nFileIn);
+                if(nFileIn != nSectorFile)
+                    continue;
+
+                /* Get the sector size and start from the key header. */
+                uint32_t nSectorSize  = 0;
+                uint32_t nSectorStart = 0;
+                std::copy(pBucket + 5, pBucket + 9,  (uint8_t*)&nSectorSize);
+                std::copy(pBucket + 9, pBucket + 13, (uint8_t*)&nSectorStart);
+
+                /* Keys with no sector data don't reference the file. */
+                if(nSectorSize > 0)
+                    mapLocations[nSectorStart] = nSectorSize;
+            }
+        }
+    }
+
+
+    /* Point keys to the new position of their records, only if they still point to the old position. */
+    uint32_t BinaryMappedMap::Relocate(const uint16_t nSectorFile, const std::map<uint32_t, SectorKey>& mapMoves)
+    {
+        /* Check all of our hashmap files, without holding any locks while we scan them. */
+        uint32_t nTotalMoved = 0;
+        for(uint16_t nFile = 0; ; ++nFile)
+        {
+            /* Get the mapped file region, stopping at the first file that doesn't exist. */
+            uint8_t* pfile = pindex ? get_file(nFile) : nullptr;
+            if(!pfile)
+                break;
+
+            /* Collect the buckets that point to moved records, by bucket and old position. */
+            std::vector<std::pair<uint32_t, uint32_t>> vCandidates;
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+            {
+                /* Skip over empty buckets. */
+                const uint8_t* pBucket = pfile + uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+                if(pBucket[0] == STATE::EMPTY)
+                    continue;
+
+                /* Skip over keys in other sector files. */
+                uint16_t nFileIn = 0;
+                std::copy(pBucket + 3, pBucket + 5, (uint8_t*)&nFileIn);
+                if(nFileIn != nSectorFile)
+                    continue;
+
+                /* Get the sector size and start from the key header. */
+                uint32_t nSectorSize  = 0;
+                uint32_t nSectorStart = 0;
+                std::copy(pBucket + 5, pBucket + 9,  (uint8_t*)&nSectorSize);
+                std::copy(pBucket + 9, pBucket + 13, (uint8_t*)&nSectorStart);
+
+                /* Skip over keys with no sector data, which sit at the start of file zero without referencing a record. */
+                if(nSectorSize == 0)
+                    continue;
+
+                /* Skip over keys that were re-written since their record was moved. */
+                if(!mapMoves.count(nSectorStart))
+                    continue;
+
+                vCandidates.push_back(std::make_pair(nBucket, nSectorStart));
+            }
+
+            /* Re-point each key under its own stripe, only if it still points to the old record. */
+            for(const auto& pairCandidate : vCandidates)
+            {
+                const uint32_t nBucket = pairCandidate.first;
+                const SectorKey& cMoved = mapMoves.at(pairCandidate.second);
+
+                LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
+                /* Check that the key wasn't erased or re-written since our scan. */
+                uint8_t* pBucket = pfile + uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+                uint16_t nFileIn      = 0;
+                uint32_t nSectorStart = 0;
+                std::copy(pBucket + 3, pBucket + 5,  (uint8_t*)&nFileIn);
+                std::copy(pBucket + 9, pBucket + 13, (uint8_t*)&nSectorStart);
+                if(pBucket[0] == STATE::EMPTY || nFileIn != nSectorFile || nSectorStart != pairCandidate.second)
+                    continue;
+
+                /* Write the new location into the key header. */
+                std::copy((uint8_t*)&cMoved.nSectorFile,  (uint8_t*)&cMoved.nSectorFile  + 2, pBucket + 3);
+                std::copy((uint8_t*)&cMoved.nSectorSize,  (uint8_t*)&cMoved.nSectorSize  + 4, pBucket + 5);
+                std::copy((uint8_t*)&cMoved.nSectorStart, (uint8_t*)&cMoved.nSectorStart + 4, pBucket + 9);
+
+                ++nTotalMoved;
+            }
+        }
+
+        return nTotalMoved;
+    }
+
+
+    /* Get the mapped region of a hashmap file, mapping it on first use. */
+    uint8_t* BinaryMappedMap::get_file(const uint16_t nFile, const bool fCreate)
+    {
+        /* Check for an already mapped file. */
+        MappedFile* pfile = vFiles.Get(nFile);
+        if(pfile)
+            return pfile->pData;
+
+        /* Get the path of the hashmap file. */
+        const std::string strFile = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile);
+
+        /* Total size that a hashmap file consumes. */
+        const uint64_t nFileSize = uint64_t(HASHMAP_TOTAL_BUCKETS) * HASHMAP_KEY_ALLOCATION;
+        if(!filesystem::exists(strFile))
+        {
+            /* Only create when requested. */
+            if(!fCreate)
+                return nullptr;
+
+            /* Allocate the new file to disk. */
+            if(!allocate_file(strFile, nFileSize))
+                return nullptr;
+
+            /* Debug output showing generating of the hashmap file. */
+            debug::log(0, FUNCTION, "Generated Disk Hash Map ", nFile, " of ", nFileSize, " bytes");
+        }
+
+        /* Map the file into memory. */
+        pfile = new MappedFile(strFile);
+        if(pfile->IsNull() || pfile->nSize < nFileSize)
+        {
+            delete pfile;
+            return nullptr;
+        }
+
+        /* Add to our mapped files, using the mapping of another reader that mapped it first. */
+        return vFiles.Insert(nFile, pfile)->pData;
+    }
+
+
+    /* Get the total hashmap files that are allocated for a given bucket. */
+    uint16_t BinaryMappedMap::get_index(const uint32_t nBucket) const
+    {
+        uint16_t nIndex = 0;
+        std::copy(pindex->pData + (nBucket * 2), pindex->pData + (nBucket * 2) + 2, (uint8_t*)&nIndex);
+
+        return nIndex;
+    }
+
+
+    /* Set the total hashmap files that are allocated for a given bucket. */
+    void BinaryMappedMap::set_index(const uint32_t nBucket, const uint16_t nIndex)
+    {
+        std::copy((uint8_t*)&nIndex, (uint8_t*)&nIndex + 2, pindex->pData + (nBucket * 2));
+    }
+
+
+    /* Load the bloom filter from disk, or rebuild it from the hashmap files if it wasn't saved cleanly. */
+    void BinaryMappedMap::load_bloom(const uint16_t nTotalFiles, const uint32_t nTotalKeys)
+    {
+        /* Size the filter from our keys with room to double before it grows. */
+        pBloom = new BloomFilter(uint64_t(nTotalKeys) * 2);
+
+        /* Remove the filter file once loaded, so that an unclean shutdown forces a rebuild. */
+        const std::string strBloom = debug::safe_printstr(strBaseLocation, "_bloom.filter");
+        if(pBloom->Load(strBloom, BloomFilter::Stamp(strBaseLocation)))
+        {
+            filesystem::remove(strBloom);
+
+            debug::log(0, FUNCTION, "Loaded Bloom Filter of ", nTotalKeys, " keys");
+            return;
+        }
+
+        /* Remove any stale filter, since our files changed after it was saved. */
+        if(filesystem::exists(strBloom))
+            filesystem::remove(strBloom);
+
+        /* Insert every key that is in a non empty slot of the hashmap files. */
+        uint32_t nInserted = 0;
+        for(uint16_t nFile = 0; nFile < nTotalFiles; ++nFile)
+        {
+            /* Get the mapped file region. */
+            const uint8_t* pfile = get_file(nFile);
+            if(!pfile)
+                continue;
+
+            /* Check all buckets in this file. */
+            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+            {
+                /* Skip over empty buckets. */
+                const uint8_t* pBucket = pfile + uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+                if(pBucket[0] == STATE::EMPTY)
+                    continue;
+
+                /* Get the length of the key from its header to find the compressed size. */
+                uint16_t nLength = 0;
+                std::copy(pBucket + 1, pBucket + 3, (uint8_t*)&nLength);
+
+                /* Add the compressed key to the filter. */
+                pBloom->Insert(pBucket + 13, std::min(nLength, HASHMAP_MAX_KEY_SIZE));
+                ++nInserted;
+            }
+        }
+
+        debug::log(0, FUNCTION, "Rebuilt Bloom Filter from ", nTotalFiles, " hashmap files and ", nInserted, " keys");
+    }
+}
@@ -15,14 +15,21 @@ ________________________________________________________________________________
 
 #include <LLD/cache/binary_lfu.h>
 #include <LLD/cache/binary_lru.h>
+#include <LLD/cache/binary_clock.h>
 
 #include <LLD/keychain/filemap.h>
 #include <LLD/keychain/hashmap.h>
+#include <LLD/keychain/mappedmap.h>
+
+#include <LLD/compress/lz4.h>
 
 #include <Util/include/filesystem.h>
 #include <Util/include/hex.h>
 
 #include <functional>
+#include <limits>
+#include <set>
+#include <tuple>
 
 namespace LLD
 {
@@ -37,22 +44,35 @@ namespace LLD
     , SECTOR_MUTEX()
     , BUFFER_MUTEX()
     , TRANSACTION_MUTEX()
+    , RECORD_MUTEX(SECTOR_LOCK_STRIPES)
+    , READER_MUTEX(SECTOR_READ_LANES)
     , strBaseLocation(config::GetDataDir() + strNameIn + "/datachain/")
     , strName(strNameIn)
     , runtime()
     , pTransaction(nullptr)
     , pSectorKeys(new KeychainType((config::GetDataDir() + strName + "/keychain/"), nFlagsIn, nBucketsIn))
+    , pOrderedKeys(nullptr)
+    , vOrderedPrefixes()
     , cachePool(new CacheType(nCacheIn))
     , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
+    , vReaderCache(SECTOR_READ_LANES, nullptr)
     , nCurrentFile(0)
     , nCurrentFileSize(0)
+    , nCompressedFile(std::numeric_limits<uint32_t>::max())
     , CacheWriterThread()
     , MeterThread()
+    , CompactorThread()
+    , nCompactFile(std::numeric_limits<uint32_t>::max())
+    , setDirtyFiles()
     , vDiskBuffer()
     , nBufferBytes(0)
+    , nBufferSequence(0)
+    , nSyncedSequence(0)
+    , nFailedBatches(0)
     , nBytesRead(0)
     , nBytesWrote(0)
     , nRecordsFlushed(0)
+    , fTransaction(false)
     , fDestruct(false)
     , fInitialized(false)
     , nFlags(nFlagsIn)
@@ -61,6 +81,10 @@ namespace LLD
         if(!(nFlags & FLAGS::FORCE) && !(nFlags & FLAGS::WRITE) && !(nFlags & FLAGS::APPEND))
             nFlags |= FLAGS::READONLY;
 
+        /* Create the file stream caches for our reader lanes. */
+        for(auto& pcache : vReaderCache)
+            pcache = new TemplateLRU<uint32_t, std::fstream*>(4);
+
         /* Initialize the Database. */
         Initialize();
 
@@ -72,6 +96,7 @@ namespace LLD
 
         CacheWriterThread = std::thread(std::bind(&SectorDatabase::CacheWriter, this));
         MeterThread = std::thread(std::bind(&SectorDatabase::Meter, this));
+        CompactorThread = std::thread(std::bind(&SectorDatabase::Compactor, this));
     }
 
 
@@ -88,6 +113,9 @@ namespace LLD
         if(MeterThread.joinable())
             MeterThread.join();
 
+        if(CompactorThread.joinable())
+            CompactorThread.join();
+
         if(pTransaction)
             delete pTransaction;
 
@@ -97,8 +125,15 @@ namespace LLD
         if(fileCache)
             delete fileCache;
 
+        for(auto& pcache : vReaderCache)
+            if(pcache)
+                delete pcache;
+
         if(pSectorKeys)
             delete pSectorKeys;
+
+        if(pOrderedKeys)
+            delete pOrderedKeys;
     }
 
 
@@ -141,6 +176,36 @@ namespace LLD
             ++nCurrentFile;
         }
 
+        /* Find the first compressed sector file, records before it stay in the uncompressed format. */
+        const std::string strCompressed = debug::safe_printstr(strBaseLocation, "_compressed.index");
+        std::ifstream ssCompressed(strCompressed, std::ios::in | std::ios::binary);
+        if(ssCompressed.is_open())
+            ssCompressed.read((char*)&nCompressedFile, sizeof(nCompressedFile));
+
+        /* Start compressing from a fresh sector file when compression is first enabled. */
+        else if(nFlags & FLAGS::COMPRESS && !(nFlags & FLAGS::READONLY))
+        {
+            /* Don't mix formats in the current file if it already has records. */
+            if(nCurrentFileSize > 0)
+            {
+                ++nCurrentFile;
+                nCurrentFileSize = 0;
+
+                std::ofstream stream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile),
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+                stream.close();
+            }
+
+            /* Write our compressed file marker. */
+            nCompressedFile = nCurrentFile;
+
+            std::ofstream stream(strCompressed, std::ios::out | std::ios::binary | std::ios::trunc);
+            stream.write((char*)&nCompressedFile, sizeof(nCompressedFile));
+            stream.close();
+
+            debug::log(0, FUNCTION, "Compressing records from sector file ", nCompressedFile);
+        }
+
         pTransaction = nullptr;
         fInitialized = true;
     }
@@ -157,47 +222,17 @@ namespace LLD
         if(cachePool->Get(vKey, vData))
             return true;
 
+        /* Lock only this key's stripe so readers of other keys can run concurrently. */
+        const uint32_t nStripe = stripe(vKey);
+        LOCK(RECORD_MUTEX[nStripe]);
+
         /* Get the key from the keychain. */
         SectorKey cKey;
         if(pSectorKeys->Get(vKey, cKey))
         {
-            {
-                LOCK(SECTOR_MUTEX);
-
-                /* Find the file stream for LRU cache. */
-                std::fstream* pstream;
-                if(!fileCache->Get(cKey.nSectorFile, pstream))
-                {
-                    /* Set the new stream pointer. */
-                    pstream = new std::fstream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::out | std::ios::binary);
-                    if(!pstream->is_open())
-                    {
-                        delete pstream;
-                        return debug::error(FUNCTION, "couldn't create stream file");
-                    }
-
-                    /* If file not found add to LRU cache. */
-                    fileCache->Put(cKey.nSectorFile, pstream);
-                }
-
-                /* Check stream file is still open. */
-                if(!pstream->is_open())
-                    pstream->open(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::out | std::ios::binary);
-
-                /* Get compact size from record. */
-                uint64_t nSize = GetSizeOfCompactSize(cKey.nSectorSize);
-
-                /* Seek to the Sector Position on Disk. */
-                pstream->seekg(cKey.nSectorStart + nSize, std::ios::beg);
-
-                /* Resize for proper record length. */
-                vData.resize(cKey.nSectorSize - nSize);
-
-                /* Read the State and Size of Sector Header. */
-                if(!pstream->read((char*) &vData[0], vData.size()))
-                    return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes read");
-
-            }
+            /* Read the record through our stripe's reader lane. */
+            if(!read_sector(cKey, nStripe % SECTOR_READ_LANES, vData))
+                return false;
 
             /* Add to cache */
             cachePool->Put(cKey, vKey, vData);
@@ -219,54 +254,35 @@ namespace LLD
     template<class KeychainType, class CacheType>
     bool SectorDatabase<KeychainType, CacheType>::Get(const SectorKey& cKey, std::vector<uint8_t>& vData)
     {
-        {
-            LOCK(SECTOR_MUTEX);
-
-            nBytesRead += static_cast<uint32_t>(cKey.vKey.size() + vData.size());
-
-            /* Check the cache pool for key first. */
-            if(cachePool->Get(cKey.vKey, vData))
-                return true;
-
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(cKey.nSectorFile, pstream))
-            {
-                /* Set the new stream pointer. */
-                pstream = new std::fstream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(cKey.nSectorFile, pstream);
-            }
-
-            /* Check stream file is still open. */
-            if(!pstream->is_open())
-                pstream->open(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::out | std::ios::binary);
-
-            /* Get compact size from record. */
-            uint64_t nSize = GetSizeOfCompactSize(cKey.nSectorSize);
+        nBytesRead += static_cast<uint32_t>(cKey.vKey.size() + vData.size());
 
-            /* Seek to the Sector Position on Disk. */
-            pstream->seekg(cKey.nSectorStart + nSize, std::ios::beg);
-
-            /* Resize for proper record length. */
-            vData.resize(cKey.nSectorSize - nSize);
+        /* Check the cache pool for key first. */
+        if(cachePool->Get(cKey.vKey, vData))
+            return true;
 
-            /* Read the State and Size of Sector Header. */
-            if(!pstream->read((char*) &vData[0], vData.size()))
-                return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes read");
+        /* Lock only this key's stripe so readers of other keys can run concurrently. */
+        const uint32_t nStripe = stripe(cKey.vKey);
+        LOCK(RECORD_MUTEX[nStripe]);
 
-            /* Verboe output. */
-            if(config::nVerbose >= 5)
-                debug::log(5, FUNCTION, "Current File: ", cKey.nSectorFile,
-                    " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
+        /* Read the record through our stripe's reader lane. */
+        if(!read_sector(cKey, nStripe % SECTOR_READ_LANES, vData))
+        {
+            /* Check if compaction moved the record since the caller read its key. */
+            SectorKey cMoved;
+            if(!pSectorKeys->Get(cKey.vKey, cMoved)
+            || (cMoved.nSectorFile == cKey.nSectorFile && cMoved.nSectorStart == cKey.nSectorStart))
+                return false;
+
+            /* Read the record from its new location. */
+            if(!read_sector(cMoved, nStripe % SECTOR_READ_LANES, vData))
+                return false;
         }
 
+        /* Verboe output. */
+        if(config::nVerbose >= 5)
+            debug::log(5, FUNCTION, "Current File: ", cKey.nSectorFile,
+                " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
+
         return true;
     }
 
@@ -275,13 +291,26 @@ namespace LLD
     template<class KeychainType, class CacheType>
     bool SectorDatabase<KeychainType, CacheType>::Update(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
     {
+        /* Lock the stripe for this key, to block readers until the record is consistent. */
+        LOCK(RECORD_MUTEX[stripe(vKey)]);
+
         /* Check the keychain for key. */
         SectorKey key;
         if(!pSectorKeys->Get(vKey, key))
             return false;
 
+        /* Compress the record if it lives in a compressed sector file. */
+        const bool fCompressed = compressed(key.nSectorFile);
+
+        std::vector<uint8_t> vCompressed;
+        if(fCompressed)
+            compress(vData, vCompressed);
+
+        /* Get the bytes that will be written to disk. */
+        const std::vector<uint8_t>& vRecord = (fCompressed ? vCompressed : vData);
+
         /* Get current size */
-        uint64_t nSize = vData.size() + GetSizeOfCompactSize(vData.size());
+        uint64_t nSize = vRecord.size() + GetSizeOfCompactSize(vRecord.size());
 
         /* Check data size constraints. */
         if(nSize != key.nSectorSize)
@@ -293,6 +322,10 @@ namespace LLD
         {
             LOCK(SECTOR_MUTEX);
 
+            /* Records in a file that is being compacted are appended instead, so the compactor doesn't copy stale data. */
+            if(key.nSectorFile == nCompactFile.load())
+                return false;
+
             /* Find the file stream for LRU cache. */
             std::fstream* pstream;
             if(!fileCache->Get(key.nSectorFile, pstream))
@@ -317,17 +350,20 @@ namespace LLD
             pstream->seekp(key.nSectorStart, std::ios::beg);
 
             /* Write the size of record. */
-            WriteCompactSize(*pstream, vData.size());
+            WriteCompactSize(*pstream, vRecord.size());
 
             /* Write the data record. */
-            if(!pstream->write((char*) &vData[0], vData.size()))
-                return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes written");
+            if(!pstream->write((char*) &vRecord[0], vRecord.size()))
+                return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vRecord.size(), " bytes written");
 
             pstream->flush();
 
+            /* Our file needs to be synchronized before this record is durable. */
+            setDirtyFiles.insert(key.nSectorFile);
+
             /* Records flushed indicator. */
             ++nRecordsFlushed;
-            nBytesWrote += static_cast<uint32_t>(vData.size());
+            nBytesWrote += static_cast<uint32_t>(vRecord.size());
 
             /* Verbose output. */
             if(config::nVerbose >= 5)
@@ -345,7 +381,25 @@ namespace LLD
     {
         if(nFlags & FLAGS::APPEND || !Update(vKey, vData))
         {
+            /* Compress the record outside of our locks, new records are only appended to the current file. */
+            const bool fCompressed = compressed(nCurrentFile);
+
+            std::vector<uint8_t> vCompressed;
+            if(fCompressed)
+                compress(vData, vCompressed);
+
+            /* Get the bytes that will be written to disk. */
+            const std::vector<uint8_t>& vRecord = (fCompressed ? vCompressed : vData);
+
+            /* Lock the stripe for this key, to block readers until the keychain points to new record. */
+            LOCK(RECORD_MUTEX[stripe(vKey)]);
 
+            /* Get current size */
+            const uint64_t nSize =
+                (vRecord.size() + GetSizeOfCompactSize(vRecord.size()));
+
+            /* The new sector key that is assigned while appending. */
+            SectorKey key;
             {
                 LOCK(SECTOR_MUTEX);
 
@@ -389,32 +443,28 @@ namespace LLD
                 pstream->seekp(nCurrentFileSize, std::ios::beg);
 
                 /* Write the size of record. */
-                WriteCompactSize(*pstream, vData.size());
+                WriteCompactSize(*pstream, vRecord.size());
 
                 /* Write the data record. */
-                if(!pstream->write((char*) &vData[0], vData.size()))
-                    return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes written");
+                if(!pstream->write((char*) &vRecord[0], vRecord.size()))
+                    return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vRecord.size(), " bytes written");
 
                 pstream->flush();
-            }
-
-            /* Get current size */
-            const uint64_t nSize =
-                (vData.size() + GetSizeOfCompactSize(vData.size()));
 
-            /* Create a new Sector Key. */
-            const SectorKey key(STATE::READY, vKey, static_cast<uint16_t>(nCurrentFile),
-                            nCurrentFileSize, static_cast<uint32_t>(nSize));
+                /* Create a new Sector Key. */
+                key = SectorKey(STATE::READY, vKey, static_cast<uint16_t>(nCurrentFile),
+                                nCurrentFileSize, static_cast<uint32_t>(nSize));
 
-            /* Increment the current filesize */
-            nCurrentFileSize += static_cast<uint32_t>(nSize);
+                /* Increment the current filesize */
+                nCurrentFileSize += static_cast<uint32_t>(nSize);
+            }
 
             /* Records flushed indicator. */
             ++nRecordsFlushed;
             nBytesWrote += static_cast<uint32_t>(nSize);
 
             /* Assign the Key to Keychain. */
-            if(!pSectorKeys->Put(key))
+            if(!put_key(key))
                 return debug::error(FUNCTION, "failed to write key to keychain");
 
             /* Write the data into the memory cache. */
@@ -451,6 +501,8 @@ namespace LLD
 
             vDiskBuffer.push_back(std::make_pair(vKey, vData));
             nBufferBytes += static_cast<uint32_t>(vKey.size() + vData.size());
+
+            ++nBufferSequence;
         }
 
         /* Notify if buffer was added to. */
@@ -464,13 +516,16 @@ namespace LLD
     template<class KeychainType, class CacheType>
     bool SectorDatabase<KeychainType, CacheType>::Delete(const std::vector<uint8_t>& vKey)
     {
+        /* Lock the stripe for this key, to block readers until the record is erased. */
+        LOCK(RECORD_MUTEX[stripe(vKey)]);
+
         /* Check the keychain for key. */
         SectorKey key;
         if(!pSectorKeys->Get(vKey, key))
             return false;
 
         /* Return the Key existance in the Keychain Database. */
-        if(!pSectorKeys->Erase(vKey))
+        if(!erase_key(vKey))
             return false;
 
         /* Check that this key isn't a keychain only entry. */
@@ -503,8 +558,11 @@ namespace LLD
             /* Seek to write at specific location. */
             pstream->seekp(key.nSectorStart + GetSizeOfCompactSize(key.nSectorSize), std::ios::beg);
 
-            /* Update the record with blank data. */
+            /* Update the record with blank data, marked as stored raw in compressed sector files. */
             DataStream ssData(SER_LLD, DATABASE_VERSION);
+            if(compressed(key.nSectorFile))
+                ssData << uint32_t(0);
+
             ssData << std::string("NONE");
             ssData.resize(key.nSectorSize - GetSizeOfCompactSize(key.nSectorSize));
 
@@ -525,6 +583,55 @@ namespace LLD
     }
 
 
+    /*  Wait until all records written before this call are synchronized with disk. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::Sync()
+    {
+        /* Records are written directly in force mode, so we only need to sync the files. */
+        if(nFlags & FLAGS::FORCE || !(nFlags & (FLAGS::WRITE | FLAGS::APPEND)))
+        {
+            {
+                LOCK(SECTOR_MUTEX);
+
+                /* Sync the file that records are being appended to. */
+                if(!filesystem::sync(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile)))
+                    return debug::error(FUNCTION, "failed to sync sector file ", nCurrentFile);
+            }
+
+            /* Sync the files that records were updated in place in. */
+            if(!sync_dirty())
+                return debug::error(FUNCTION, strName, " failed to sync updated records");
+
+            /* Sync our ordered keys and the keychain after the data they point to. */
+            if(pOrderedKeys && !pOrderedKeys->Flush())
+                return debug::error(FUNCTION, strName, " failed to sync ordered keys");
+
+            pSectorKeys->Flush();
+
+            return true;
+        }
+
+        /* Get the sequence of the last record that was buffered before this call, and the failures so far. */
+        const uint64_t nSequence = nBufferSequence.load();
+        const uint64_t nFailed   = nFailedBatches.load();
+
+        /* Wake up the writer and wait for it to commit our records. */
+        CONDITION.notify_all();
+
+        std::unique_lock<std::mutex> CONDITION_LOCK(CONDITION_MUTEX);
+        CONDITION.wait(CONDITION_LOCK, [this, nSequence, nFailed]
+        {
+            return fDestruct.load() || nSyncedSequence.load() >= nSequence || nFailedBatches.load() > nFailed;
+        });
+
+        /* Check that our records were committed, rather than failed and waiting to be retried. */
+        if(nSyncedSequence.load() < nSequence)
+            return debug::error(FUNCTION, strName, " failed to sync records to disk");
+
+        return true;
+    }
+
+
     /*  Flushes periodically data from the cache buffer to disk. */
     template<class KeychainType, class CacheType>
     void SectorDatabase<KeychainType, CacheType>::CacheWriter()
@@ -544,48 +651,71 @@ namespace LLD
             return;
         }
 
-        /* Loop until shutdown. */
-        while(!config::fShutdown.load())
+        /* Loop until destructed, so that buffered records are always written before shutting down. */
+        while(true)
         {
             /* Wait for buffer to empty before shutting down. */
             if((fDestruct.load()) && nBufferBytes.load() == 0)
                 return;
 
-            /* Check for data to be written. */
-            std::unique_lock<std::mutex> CONDITION_LOCK(CONDITION_MUTEX);
-            CONDITION.wait(CONDITION_LOCK, [this]{ return fDestruct.load() || nBufferBytes.load() > 0; });
-
             /* Swap the buffer object to get ready for writes. */
             std::vector< std::pair<std::vector<uint8_t>, std::vector<uint8_t>> > vIndexes;
+            uint64_t nSequence = 0;
             {
+                /* Check for data to be written. */
+                std::unique_lock<std::mutex> CONDITION_LOCK(CONDITION_MUTEX);
+                CONDITION.wait(CONDITION_LOCK, [this]{ return fDestruct.load() || nBufferBytes.load() > 0; });
+
                 LOCK(BUFFER_MUTEX);
 
                 vIndexes.swap(vDiskBuffer);
                 nBufferBytes = 0;
+
+                nSequence = nBufferSequence.load();
             }
 
-            /* Create a new file if the sector file size is over file size limits. */
-            if(nCurrentFileSize > MAX_SECTOR_FILE_SIZE)
+            /* Commit the whole buffer as one group. */
+            std::vector< std::pair<std::vector<uint8_t>, std::vector<uint8_t>> > vFailed;
+            if(!write_batch(vIndexes, vFailed))
             {
-                debug::log(0, FUNCTION, "allocating new sector file ", nCurrentFile + 1);
+                debug::error(FUNCTION, strName, " failed to commit ", vFailed.size(), " of ", vIndexes.size(), " records");
 
-                /* Iterate the current file and reset current file sie. */
-                ++nCurrentFile;
-                nCurrentFileSize = 0;
+                /* Signal durable writers that their records didn't reach disk. */
+                {
+                    LOCK(CONDITION_MUTEX);
+                    ++nFailedBatches;
+                }
+                CONDITION.notify_all();
 
-                /* Create a new file for next writes. */
-                std::fstream stream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile), std::ios::out | std::ios::binary | std::ios::trunc);
-                stream.close();
+                /* Records can't be retried once we are closing, so release them from the cache. */
+                if(fDestruct.load())
+                {
+                    for(const auto& vObj : vFailed)
+                        cachePool->Reserve(vObj.first, false);
+
+                    return;
+                }
+
+                /* Put our failed records back in front of any newer writes, so they are retried in order. */
+                {
+                    LOCK(BUFFER_MUTEX);
+
+                    for(const auto& vObj : vFailed)
+                        nBufferBytes += static_cast<uint32_t>(vObj.first.size() + vObj.second.size());
+
+                    vDiskBuffer.insert(vDiskBuffer.begin(), vFailed.begin(), vFailed.end());
+                }
+
+                /* Give the disk some time before we retry. */
+                runtime::sleep(1000);
+
+                continue;
             }
 
-            /* Iterate through buffer to queue disk writes. */
-            for(const auto& vObj : vIndexes)
+            /* Signal durable writers that their records are on disk. */
             {
-                /* Force write data. */
-                Force(vObj.first, vObj.second);
-
-                /* Set no longer reserved in cache pool. */
-                cachePool->Reserve(vObj.first, false);
+                LOCK(CONDITION_MUTEX);
+                nSyncedSequence.store(nSequence);
             }
 
             /* Notify the condition. */
@@ -645,6 +775,235 @@ namespace LLD
     }
 
 
+    /*  Rewrite the live records of a sector file to the end of the current file and reclaim its space. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::Compact(const uint32_t nFile)
+    {
+        if(nFlags & FLAGS::READONLY)
+            return debug::error(FUNCTION, "Compact called on database in read-only mode");
+
+        /* Stop updates in place for this file, so every record we copy is its latest version. */
+        {
+            LOCK(SECTOR_MUTEX);
+
+            /* Check that the file is sealed, records are still being appended to the current file. */
+            if(nFile >= nCurrentFile)
+                return debug::error(FUNCTION, "can't compact current sector file ", nFile);
+
+            /* Only compact one file at a time. */
+            if(nCompactFile.load() != std::numeric_limits<uint32_t>::max())
+                return debug::error(FUNCTION, "already compacting sector file ", nCompactFile.load());
+
+            nCompactFile.store(nFile);
+        }
+
+        /* Get the records that keys still point to in this file. */
+        std::map<uint32_t, uint32_t> mapLocations;
+        pSectorKeys->Locations(static_cast<uint16_t>(nFile), mapLocations);
+
+        /* Get the path of the file we are compacting. */
+        const std::string strPath = debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile);
+
+        /* Records are converted when the current file doesn't share the format of the compacted file. */
+        const bool fCompressedFrom = compressed(nFile);
+        const bool fCompressedTo   = compressed(nCurrentFile);
+
+        /* Limit our copy rate so that compaction doesn't starve the disk. */
+        const uint64_t nRate = config::GetArg("-lldcompactrate", 4096); //Kb per second
+
+        /* The new locations of records, by their old binary position. */
+        std::map<uint32_t, SectorKey> mapMoves;
+
+        /* The records in our current batch, by old binary position, with their offset in batch and size on disk. */
+        std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> vPending;
+        std::vector<uint8_t> vBatch;
+
+        /* Copy all of our live records in the order they appear in the file. */
+        std::ifstream stream(strPath, std::ios::in | std::ios::binary);
+        bool fSuccess = stream.is_open();
+        for(auto it = mapLocations.begin(); fSuccess; ++it)
+        {
+            /* Append our batch when done, or when the buffer is full. */
+            const bool fEnd = (it == mapLocations.end());
+            if(!vBatch.empty() && (fEnd || vBatch.size() >= MAX_COMPACT_BUFFER_SIZE))
+            {
+                /* Write and sync all the records before any keys point to them. */
+                uint32_t nFileTo = 0, nStart = 0;
+                if(!append_batch(vBatch, nFileTo, nStart))
+                {
+                    fSuccess = debug::error(FUNCTION, "failed to append ", vPending.size(), " records");
+                    break;
+                }
+
+                /* Track the new location of each record. */
+                for(const auto& tPending : vPending)
+                    mapMoves[std::get<0>(tPending)] = SectorKey(STATE::READY, std::vector<uint8_t>(),
+                        static_cast<uint16_t>(nFileTo), nStart + std::get<1>(tPending), std::get<2>(tPending));
+
+                /* Throttle to our maximum copy rate. */
+                if(nRate > 0)
+                    runtime::sleep(static_cast<uint32_t>(vBatch.size() * 1000 / (nRate * 1024)));
+
+                vBatch.clear();
+                vPending.clear();
+
+                /* Stop early on shutdown, the copies we made are left as dead space in the current file. */
+                if(fDestruct.load() || config::fShutdown.load())
+                    fSuccess = false;
+            }
+
+            /* Check if we are finished. */
+            if(fEnd || !fSuccess)
+                break;
+
+            /* Read the whole record including its compact size. */
+            std::vector<uint8_t> vRecord(it->second, 0);
+
+            stream.seekg(it->first, std::ios::beg);
+            if(!stream.read((char*)&vRecord[0], vRecord.size()))
+            {
+                fSuccess = debug::error(FUNCTION, "only ", stream.gcount(), "/", vRecord.size(), " bytes read at ", it->first);
+                break;
+            }
+
+            nBytesRead += static_cast<uint32_t>(vRecord.size());
+
+            /* Convert the record when moving it between formats. */
+            if(fCompressedFrom != fCompressedTo)
+            {
+                /* Get the record data after its compact size. */
+                std::vector<uint8_t> vData(vRecord.begin() + GetSizeOfCompactSize(vRecord.size()), vRecord.end());
+                if(fCompressedFrom && !decompress(vData))
+                {
+                    fSuccess = debug::error(FUNCTION, "failed to decompress record at ", it->first);
+                    break;
+                }
+
+                /* Compress the record if needed. */
+                std::vector<uint8_t> vCompressed;
+                if(fCompressedTo)
+                    compress(vData, vCompressed);
+
+                /* Serialize the record in its new format. */
+                const std::vector<uint8_t>& vConverted = (fCompressedTo ? vCompressed : vData);
+
+                DataStream ssRecord(SER_LLD, DATABASE_VERSION);
+                WriteCompactSize(ssRecord, vConverted.size());
+                ssRecord.write((char*)vConverted.data(), vConverted.size());
+
+                vRecord = ssRecord.Bytes();
+            }
+
+            /* Add the record to our batch. */
+            vPending.push_back(std::make_tuple(it->first, static_cast<uint32_t>(vBatch.size()), static_cast<uint32_t>(vRecord.size())));
+            vBatch.insert(vBatch.end(), vRecord.begin(), vRecord.end());
+        }
+        stream.close();
+
+        /* Point our keys to their new records. */
+        if(fSuccess)
+        {
+            /* Move our keys and sync them before the old records are removed, each key is swapped under its own stripe. */
+            const uint32_t nTotalMoved = pSectorKeys->Relocate(static_cast<uint16_t>(nFile), mapMoves);
+            pSectorKeys->Flush();
+
+            debug::log(2, FUNCTION, strName, " moved ", nTotalMoved, " keys for ", mapMoves.size(), " records from sector file ", nFile);
+        }
+
+        /* Truncate the old file now that no keys point to it. */
+        if(fSuccess)
+        {
+            /* Wait out any readers that got a key pointing into this file before it was moved. */
+            for(auto& RECORD_LOCK : RECORD_MUTEX)
+            {
+                LOCK(RECORD_LOCK);
+            }
+
+            /* Close any streams that are open on this file. */
+            {
+                LOCK(SECTOR_MUTEX);
+                fileCache->Remove(nFile);
+            }
+
+            for(uint32_t nLane = 0; nLane < SECTOR_READ_LANES; ++nLane)
+            {
+                LOCK(READER_MUTEX[nLane]);
+                vReaderCache[nLane]->Remove(nFile);
+            }
+
+            /* Keep the empty file so that sector file numbers stay contiguous. */
+            std::ofstream ssTruncate(strPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            ssTruncate.close();
+
+            debug::log(0, FUNCTION, strName, " compacted sector file ", nFile, " into ", mapMoves.size(), " records");
+        }
+
+        /* Allow updates in place again. */
+        nCompactFile.store(std::numeric_limits<uint32_t>::max());
+
+        return fSuccess;
+    }
+
+
+    /*  Periodically compacts sector files that are mostly dead space. */
+    template<class KeychainType, class CacheType>
+    void SectorDatabase<KeychainType, CacheType>::Compactor()
+    {
+        /* Wait for initialization. */
+        while(!fInitialized)
+            runtime::sleep(100);
+
+        /* Check if compaction is enabled. */
+        if(!(nFlags & FLAGS::COMPACT) || nFlags & FLAGS::READONLY)
+            return;
+
+        /* Get our compaction settings. */
+        const uint64_t nInterval = config::GetArg("-lldcompactinterval", 600); //seconds between passes
+        const uint64_t nRatio    = config::GetArg("-lldcompactratio", 50);     //percent of dead space to compact a file
+
+        runtime::timer TIMER;
+        TIMER.Start();
+
+        /* Loop until shutdown. */
+        while(!config::fShutdown.load() && !fDestruct.load())
+        {
+            runtime::sleep(100);
+            if(TIMER.Elapsed() < nInterval)
+                continue;
+
+            /* Get the bytes that keys point to in each sector file. */
+            std::map<uint32_t, uint64_t> mapUsage;
+            pSectorKeys->Usage(mapUsage);
+
+            /* Check all of our sealed sector files. */
+            for(uint32_t nFile = 0; nFile < nCurrentFile; ++nFile)
+            {
+                /* Stop compacting on shutdown. */
+                if(config::fShutdown.load() || fDestruct.load())
+                    return;
+
+                /* Skip over files that are already empty. */
+                const int64_t nSize = filesystem::size(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile));
+                if(nSize <= 0)
+                    continue;
+
+                /* Skip over files that are still mostly live records. */
+                const uint64_t nLive = mapUsage[nFile];
+                const uint64_t nDead = (uint64_t(nSize) > nLive ? uint64_t(nSize) - nLive : 0);
+                if(nDead * 100 < uint64_t(nSize) * nRatio)
+                    continue;
+
+                debug::log(0, FUNCTION, strName, " compacting sector file ", nFile, " with ", nDead, "/", nSize, " dead bytes");
+
+                /* Compact the file. */
+                Compact(nFile);
+            }
+
+            TIMER.Reset();
+        }
+    }
+
+
     /*  Start a database transaction. */
     template<class KeychainType, class CacheType>
     void SectorDatabase<KeychainType, CacheType>::TxnBegin()
@@ -657,6 +1016,7 @@ namespace LLD
 
         /* Create the new Database Transaction Object. */
         pTransaction = new SectorTransaction();
+        fTransaction = true;
     }
 
 
@@ -699,6 +1059,7 @@ namespace LLD
 
         /** Set the transaction pointer to null also acting like a flag **/
         pTransaction = nullptr;
+        fTransaction = false;
 
         /* Delete the transaction journal file. */
         std::ofstream stream(debug::safe_printstr(config::GetDataDir(), strName, "/journal.dat"), std::ios::trunc);
@@ -718,7 +1079,7 @@ namespace LLD
 
         /* Erase data set to be removed. */
         for(const auto& item : pTransaction->setErasedData)
-            if(!pSectorKeys->Erase(item))
+            if(!erase_key(item))
                 return debug::error(FUNCTION, "failed to erase from keychain");
 
         /* Commit the sector data. */
@@ -730,7 +1091,7 @@ namespace LLD
         for(const auto& item : pTransaction->setKeychain)
         {
             SectorKey cKey(STATE::READY, item, 0, 0, 0);
-            if(!pSectorKeys->Put(cKey))
+            if(!put_key(cKey))
                 return debug::error(FUNCTION, "failed to commit to keychain");
         }
 
@@ -753,13 +1114,14 @@ namespace LLD
 
             /* Write the new sector key. */
             cKey.SetKey(item.first);
-            if(!pSectorKeys->Put(cKey))
+            if(!put_key(cKey))
                 return debug::error(FUNCTION, "failed to write indexing entry");
         }
 
         /* Cleanup the transaction object. */
         delete pTransaction;
         pTransaction = nullptr;
+        fTransaction = false;
 
         return true;
     }
@@ -874,7 +1236,471 @@ namespace LLD
     }
 
 
+    /*  Get the lock stripe that a given key is assigned to. */
+    template<class KeychainType, class CacheType>
+    uint32_t SectorDatabase<KeychainType, CacheType>::stripe(const std::vector<uint8_t>& vKey) const
+    {
+        /* Check for empty keys. */
+        if(vKey.empty())
+            return 0;
+
+        return static_cast<uint32_t>(XXH64(&vKey[0], vKey.size(), 0) % SECTOR_LOCK_STRIPES);
+    }
+
+
+    /*  Read a record from disk through a reader lane's file streams. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::read_sector(const SectorKey& cKey, const uint32_t nLane, std::vector<uint8_t>& vData)
+    {
+        LOCK(READER_MUTEX[nLane]);
+
+        /* Find the file stream for this lane's LRU cache. */
+        std::fstream* pstream;
+        if(!vReaderCache[nLane]->Get(cKey.nSectorFile, pstream))
+        {
+            /* Set the new stream pointer. */
+            pstream = new std::fstream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::binary);
+            if(!pstream->is_open())
+            {
+                delete pstream;
+                return debug::error(FUNCTION, "couldn't create stream file");
+            }
+
+            /* If file not found add to LRU cache. */
+            vReaderCache[nLane]->Put(cKey.nSectorFile, pstream);
+        }
+
+        /* Check stream file is still open. */
+        if(!pstream->is_open())
+            pstream->open(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::binary);
+
+        /* Get compact size from record. */
+        const uint64_t nSize = GetSizeOfCompactSize(cKey.nSectorSize);
+
+        /* Seek to the Sector Position on Disk. */
+        pstream->seekg(cKey.nSectorStart + nSize, std::ios::beg);
+
+        /* Resize for proper record length. */
+        vData.resize(cKey.nSectorSize - nSize);
+
+        /* Read the State and Size of Sector Header. */
+        if(!pstream->read((char*) &vData[0], vData.size()))
+        {
+            /* Reset our stream state so this lane can keep reading after a partial read. */
+            const uint64_t nRead = pstream->gcount();
+            pstream->clear();
+
+            return debug::error(FUNCTION, "only ", nRead, "/", vData.size(), " bytes read");
+        }
+
+        /* Decompress records from compressed sector files. */
+        if(compressed(cKey.nSectorFile))
+            return decompress(vData);
+
+        return true;
+    }
+
+
+    /*  Determine if a key begins with one of our ordered prefixes. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::ordered(const std::vector<uint8_t>& vKey) const
+    {
+        /* Check each of our prefixes, there are only ever a few. */
+        for(const auto& vPrefix : vOrderedPrefixes)
+            if(vKey.size() >= vPrefix.size() && std::equal(vPrefix.begin(), vPrefix.end(), vKey.begin()))
+                return true;
+
+        return false;
+    }
+
+
+    /*  Write a key to the keychain, and to our ordered keys if it has an ordered prefix. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::put_key(const SectorKey& cKey)
+    {
+        /* Write to our keychain first so ordered keys are always in the keychain. */
+        if(!pSectorKeys->Put(cKey))
+            return false;
+
+        /* Add to our ordered keys. */
+        if(pOrderedKeys && ordered(cKey.vKey))
+            pOrderedKeys->Put(cKey.vKey);
+
+        return true;
+    }
+
+
+    /*  Erase a key from the keychain, and from our ordered keys if it has an ordered prefix. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::erase_key(const std::vector<uint8_t>& vKey)
+    {
+        /* Remove from our ordered keys even if the keychain no longer has the key. */
+        if(pOrderedKeys && ordered(vKey))
+            pOrderedKeys->Erase(vKey);
+
+        return pSectorKeys->Erase(vKey);
+    }
+
+
+    /*  Get the keys of an open transaction that begin with a prefix. */
+    template<class KeychainType, class CacheType>
+    void SectorDatabase<KeychainType, CacheType>::pending_keys(const std::vector<uint8_t>& vPrefix,
+        std::set<std::vector<uint8_t>>& setPending, std::set<std::vector<uint8_t>>& setErased)
+    {
+        /* Skip the transaction lock when no transaction is active. */
+        if(!fTransaction.load())
+            return;
+
+        LOCK(TRANSACTION_MUTEX);
+        if(!pTransaction)
+            return;
+
+        /* Check if a key begins with our prefix. */
+        const auto fPrefix = [&vPrefix](const std::vector<uint8_t>& vKey)
+        {
+            return vKey.size() >= vPrefix.size() && std::equal(vPrefix.begin(), vPrefix.end(), vKey.begin());
+        };
+
+        /* Add keys that are written with data, as keychain only keys, or as indexes. */
+        for(const auto& rTx : pTransaction->mapTransactions)
+            if(fPrefix(rTx.first))
+                setPending.insert(rTx.first);
+
+        for(const auto& vKey : pTransaction->setKeychain)
+            if(fPrefix(vKey))
+                setPending.insert(vKey);
+
+        for(const auto& rIndex : pTransaction->mapIndex)
+            if(fPrefix(rIndex.first))
+                setPending.insert(rIndex.first);
+
+        /* Add keys that are erased, which take priority over writes just like in Exists. */
+        for(const auto& vKey : pTransaction->setErasedData)
+            if(fPrefix(vKey))
+                setErased.insert(vKey);
+    }
+
+
+    /*  Determine if a sector file holds compressed records. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::compressed(const uint32_t nFile) const
+    {
+        return nFile >= nCompressedFile;
+    }
+
+
+    /*  Compress a record into its on disk format for compressed sector files. */
+    template<class KeychainType, class CacheType>
+    void SectorDatabase<KeychainType, CacheType>::compress(const std::vector<uint8_t>& vData, std::vector<uint8_t>& vRecord) const
+    {
+        /* Allocate the worst case size after our uncompressed length header. */
+        vRecord.resize(4 + LZ4_compressBound(static_cast<int32_t>(vData.size())));
+
+        /* Compress the record after the header. */
+        const int32_t nCompressed = LZ4_compress_default((const char*)vData.data(), (char*)&vRecord[4],
+            static_cast<int32_t>(vData.size()), static_cast<int32_t>(vRecord.size() - 4));
+
+        /* Store records that don't shrink as raw bytes with a zero length header. */
+        uint32_t nLength = static_cast<uint32_t>(vData.size());
+        if(nCompressed <= 0 || static_cast<uint64_t>(nCompressed) >= vData.size())
+        {
+            nLength = 0;
+
+            vRecord.resize(4);
+            vRecord.insert(vRecord.end(), vData.begin(), vData.end());
+        }
+        else
+            vRecord.resize(4 + nCompressed);
+
+        /* Write our uncompressed length header. */
+        std::copy((uint8_t*)&nLength, (uint8_t*)&nLength + 4, vRecord.begin());
+    }
+
+
+    /*  Decompress a record read from a compressed sector file. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::decompress(std::vector<uint8_t>& vRecord) const
+    {
+        /* Check that we have our length header. */
+        if(vRecord.size() < 4)
+            return debug::error(FUNCTION, "record of ", vRecord.size(), " bytes is missing compression header");
+
+        /* Read our uncompressed length header. */
+        uint32_t nLength = 0;
+        std::copy(vRecord.begin(), vRecord.begin() + 4, (uint8_t*)&nLength);
+
+        /* Handle records that were stored raw. */
+        if(nLength == 0)
+        {
+            vRecord.erase(vRecord.begin(), vRecord.begin() + 4);
+            return true;
+        }
+
+        /* Check our length against the maximum ratio of lz4 to avoid oversized allocations. */
+        if(nLength > (vRecord.size() - 4) * 255)
+            return debug::error(FUNCTION, "invalid uncompressed length ", nLength, " for ", vRecord.size(), " bytes");
+
+        /* Decompress into our record buffer. */
+        std::vector<uint8_t> vData(nLength, 0);
+        const int32_t nRead = LZ4_decompress_safe((const char*)&vRecord[4], (char*)&vData[0],
+            static_cast<int32_t>(vRecord.size() - 4), static_cast<int32_t>(nLength));
+
+        /* Check that we decompressed the whole record. */
+        if(nRead != static_cast<int32_t>(nLength))
+            return debug::error(FUNCTION, "only ", nRead, "/", nLength, " bytes decompressed");
+
+        vRecord.swap(vData);
+
+        return true;
+    }
+
+
+    /*  Group commit a batch of buffered records. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::write_batch(const std::vector< std::pair<std::vector<uint8_t>, std::vector<uint8_t>> >& vRecords,
+                                                               std::vector< std::pair<std::vector<uint8_t>, std::vector<uint8_t>> >& vFailed)
+    {
+        /* Only the last write of each key needs to reach disk. */
+        std::vector<bool> vSkip(vRecords.size(), false);
+        {
+            std::set<std::vector<uint8_t>> setKeys;
+            for(int64_t n = int64_t(vRecords.size()) - 1; n >= 0; --n)
+                vSkip[n] = !setKeys.insert(vRecords[n].first).second;
+        }
+
+        /* The records that are appended, by index of record, offset in batch, and size on disk. */
+        std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> vPending;
+        std::vector<uint8_t> vBatch;
+
+        /* Track if every record was committed. */
+        bool fSuccess = true;
+        for(uint32_t n = 0; n <= vRecords.size(); ++n)
+        {
+            /* Get our next record to write, if any. */
+            const bool fEnd = (n == vRecords.size());
+            if(!fEnd)
+            {
+                /* Skip over records that are overwritten later in this batch, which stay reserved until then. */
+                if(vSkip[n])
+                    continue;
+
+                /* Records that keep their size are updated in place. */
+                const std::vector<uint8_t>& vData = vRecords[n].second;
+                if(!(nFlags & FLAGS::APPEND) && Update(vRecords[n].first, vData))
+                {
+                    cachePool->Reserve(vRecords[n].first, false);
+                    continue;
+                }
+            }
+
+            /* Append our batch when done, or when the next record would overflow the current sector file. */
+            if(!vBatch.empty() && (fEnd || nCurrentFileSize + vBatch.size() > MAX_SECTOR_FILE_SIZE))
+            {
+                /* Write and sync all the records before any keys point to them. */
+                uint32_t nFile = 0, nStart = 0;
+                if(!append_batch(vBatch, nFile, nStart))
+                {
+                    /* Hand back every record we haven't committed, so none are dropped. */
+                    for(const auto& tPending : vPending)
+                        vFailed.push_back(vRecords[std::get<0>(tPending)]);
+
+                    for(uint32_t nNext = n; nNext < vRecords.size(); ++nNext)
+                        if(!vSkip[nNext])
+                            vFailed.push_back(vRecords[nNext]);
+
+                    /* Sync the keys of anything we did commit. */
+                    if(pOrderedKeys)
+                        pOrderedKeys->Flush();
+
+                    pSectorKeys->Flush();
+
+                    return debug::error(FUNCTION, "failed to append ", vPending.size(), " records");
+                }
+
+                /* Write the keys for our appended records. */
+                for(const auto& tPending : vPending)
+                {
+                    const std::vector<uint8_t>& vKey  = vRecords[std::get<0>(tPending)].first;
+                    const std::vector<uint8_t>& vData = vRecords[std::get<0>(tPending)].second;
+
+                    /* Create the sector key for this record. */
+                    const SectorKey key(STATE::READY, vKey, static_cast<uint16_t>(nFile),
+                        nStart + std::get<1>(tPending), std::get<2>(tPending));
+
+                    {
+                        /* Lock the stripe for this key, to block readers until the keychain points to new record. */
+                        LOCK(RECORD_MUTEX[stripe(vKey)]);
+
+                        /* Assign the Key to Keychain, handing the record back to be retried if we can't. */
+                        if(!put_key(key))
+                        {
+                            vFailed.push_back(vRecords[std::get<0>(tPending)]);
+                            fSuccess = debug::error(FUNCTION, "failed to write key to keychain");
+
+                            continue;
+                        }
+
+                        /* Write the data into the memory cache. */
+                        cachePool->Put(key, vKey, vData, false);
+                    }
+
+                    /* Records flushed indicator. */
+                    ++nRecordsFlushed;
+
+                    /* Set no longer reserved in cache pool. */
+                    cachePool->Reserve(vKey, false);
+                }
+
+                vBatch.clear();
+                vPending.clear();
+            }
+
+            /* Check if we are finished. */
+            if(fEnd)
+                break;
+
+            /* Compress the record if needed. */
+            const std::vector<uint8_t>& vData = vRecords[n].second;
+            const bool fCompressed = compressed(nCurrentFile);
+
+            std::vector<uint8_t> vCompressed;
+            if(fCompressed)
+                compress(vData, vCompressed);
+
+            /* Get the bytes that will be written to disk. */
+            const std::vector<uint8_t>& vRecord = (fCompressed ? vCompressed : vData);
+
+            /* Serialize the record into our batch. */
+            const uint32_t nOffset = static_cast<uint32_t>(vBatch.size());
+
+            DataStream ssRecord(SER_LLD, DATABASE_VERSION);
+            WriteCompactSize(ssRecord, vRecord.size());
+            ssRecord.write((char*)vRecord.data(), vRecord.size());
+
+            vBatch.insert(vBatch.end(), ssRecord.begin(), ssRecord.end());
+            vPending.push_back(std::make_tuple(n, nOffset, static_cast<uint32_t>(ssRecord.size())));
+        }
+
+        /* Sync the records we updated in place, which are only durable once their files are. */
+        if(!sync_dirty())
+            fSuccess = debug::error(FUNCTION, "failed to sync updated records");
+
+        /* Sync our ordered keys along with the keychain, once for the whole batch. */
+        if(pOrderedKeys && !pOrderedKeys->Flush())
+            fSuccess = debug::error(FUNCTION, "failed to sync ordered keys");
+
+        pSectorKeys->Flush();
+
+        return fSuccess;
+    }
+
+
+    /*  Append a contiguous buffer of records to the current sector file and synchronize it with disk. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::append_batch(const std::vector<uint8_t>& vBatch, uint32_t &nFile, uint32_t &nStart)
+    {
+        LOCK(SECTOR_MUTEX);
+
+        /* Create new file if above current file size. */
+        if(nCurrentFileSize > MAX_SECTOR_FILE_SIZE)
+        {
+            debug::log(4, FUNCTION, "allocating new sector file ", nCurrentFile + 1);
+
+            ++nCurrentFile;
+            nCurrentFileSize = 0;
+
+            std::ofstream stream
+            (
+                debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile),
+                std::ios::out | std::ios::binary | std::ios::trunc
+            );
+            stream.close();
+        }
+
+        /* Get the path of our current file. */
+        const std::string strPath = debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile);
+
+        /* Find the file stream for LRU cache. */
+        std::fstream* pstream;
+        if(!fileCache->Get(nCurrentFile, pstream))
+        {
+            /* Set the new stream pointer. */
+            pstream = new std::fstream(strPath, std::ios::in | std::ios::out | std::ios::binary);
+            if(!pstream->is_open())
+            {
+                delete pstream;
+                return false;
+            }
+
+            /* If file not found add to LRU cache. */
+            fileCache->Put(nCurrentFile, pstream);
+        }
+
+        /* Check stream file is still open. */
+        if(!pstream->is_open())
+            pstream->open(strPath, std::ios::in | std::ios::out | std::ios::binary);
+
+        /* Append all records with a single write. */
+        pstream->seekp(nCurrentFileSize, std::ios::beg);
+        if(!pstream->write((char*)vBatch.data(), vBatch.size()))
+            return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vBatch.size(), " bytes written");
+
+        pstream->flush();
+
+        /* Sync the file once for the whole batch. */
+        if(!filesystem::sync(strPath))
+            return debug::error(FUNCTION, "failed to sync ", strPath);
+
+        /* Set the position of our records. */
+        nFile  = nCurrentFile;
+        nStart = nCurrentFileSize;
+
+        /* Increment the current filesize */
+        nCurrentFileSize += static_cast<uint32_t>(vBatch.size());
+
+        /* Records flushed indicator. */
+        nBytesWrote += static_cast<uint32_t>(vBatch.size());
+
+        return true;
+    }
+
+
+    /*  Synchronize the sector files that records were updated in place in. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::sync_dirty()
+    {
+        /* Take our dirty files, so that updates made while we sync are tracked for the next one. */
+        std::set<uint32_t> setFiles;
+        {
+            LOCK(SECTOR_MUTEX);
+            setFiles.swap(setDirtyFiles);
+        }
+
+        /* Sync each file, keeping the ones that fail dirty. */
+        bool fSuccess = true;
+        for(const uint32_t nFile : setFiles)
+        {
+            /* Skip over files that were removed by compaction, since their records were moved. */
+            const std::string strPath = debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile);
+            if(!filesystem::exists(strPath))
+                continue;
+
+            if(!filesystem::sync(strPath))
+            {
+                LOCK(SECTOR_MUTEX);
+                setDirtyFiles.insert(nFile);
+
+                fSuccess = debug::error(FUNCTION, "failed to sync sector file ", nFile);
+            }
+        }
+
+        return fSuccess;
+    }
+
+
     /* Explicity instantiate all template instances needed for compiler. */
     template class SectorDatabase<BinaryHashMap,  BinaryLRU>;
+    template class SectorDatabase<BinaryMappedMap, BinaryLRU>;
+    template class SectorDatabase<BinaryMappedMap, BinaryCLOCK>;
 
 }
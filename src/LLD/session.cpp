@@ -34,6 +34,8 @@ namespace LLD
     , nBucketsIn
     , nCacheIn)
     {
+        /* Keep our register proofs in order so they can be listed by owner. */
+        Order(std::string("registers.proof"));
     }
 
 
@@ -398,7 +400,35 @@ namespace LLD
         /* Cache our txid and contract as a pair. */
         uint256_t hashRegister;
 
-        /* Loop until we have failed. */
+        /* Scan our register proofs by owner, which avoids reading each index record. */
+        KeyCursor cursor;
+        if(Seek(std::make_pair(std::string("registers.proof"), hashGenesis), cursor))
+        {
+            while(!config::fShutdown.load() && cursor.Next()) //we want to early terminate on shutdown
+            {
+                /* Get the register address from our proof key. */
+                std::tuple<std::string, uint256_t, uint256_t> tProof;
+                if(!cursor.Get(tProof))
+                    continue;
+
+                hashRegister = std::get<2>(tProof);
+
+                /* Check for transfer keys. */
+                if(!fTransferred && HasTransfer(hashGenesis, hashRegister))
+                    continue; //NOTE: we skip over transfer keys
+
+                /* Check for de-indexed keys. */
+                if(HasDeindex(hashGenesis, hashRegister))
+                    continue; //NOTE: we skip over deindexed keys
+
+                /* Check for already executed contracts to omit. */
+                setAddresses.insert(hashRegister);
+            }
+
+            return !setAddresses.empty();
+        }
+
+        /* Loop until we have failed, for databases that had registers before their proofs were ordered. */
         uint32_t nSequence = 0;
         while(!config::fShutdown.load()) //we want to early terminate on shutdown
         {
@@ -1009,4 +1039,62 @@ namespace LLD
     {
         return Exists(std::make_tuple(std::string("contracts.proof"), hashTx, nContract));
     }
+
+
+    /* Order the register proofs that were written before they were kept in order. */
+    void SessionDB::IndexRegisters()
+    {
+        /* Check if our proofs are already ordered. */
+        if(Ordered())
+            return;
+
+        /* Start a timer to track. */
+        runtime::timer timer;
+        timer.Start();
+
+        /* Every owner that indexed registers has an access entry, so walk their register sequences. */
+        debug::notice(FUNCTION, "Ordering register proofs for existing sessions");
+
+        uint32_t nSessions = 0;
+        Read(std::string("sessions.sequence"), nSessions);
+
+        /* Our session list begins at sequence one, so read up to and including our last sequence. */
+        uint32_t nTotal = 0;
+        for(uint32_t nSession = 0; nSession <= nSessions; ++nSession)
+        {
+            uint256_t hashGenesis = 0;
+            if(!Read(std::make_pair(std::string("sessions.list"), nSession), hashGenesis))
+                continue;
+
+            uint256_t hashRegister = 0;
+            for(uint32_t nSequence = 0; Read(std::make_tuple(std::string("registers.index"), nSequence, hashGenesis), hashRegister); ++nSequence)
+            {
+                /* Check for shutdown, we will resume on next startup since we haven't set our marker. */
+                if(config::fShutdown.load())
+                    return;
+
+                /* Only order proofs that still exist. */
+                const std::tuple<std::string, uint256_t, uint256_t> tProof =
+                    std::make_tuple(std::string("registers.proof"), hashGenesis, hashRegister);
+
+                if(!Exists(tProof))
+                    continue;
+
+                /* Add to our ordered keys. */
+                if(!Backfill(tProof))
+                {
+                    debug::error(FUNCTION, "failed to order proof for ", hashRegister.SubString());
+                    return;
+                }
+
+                ++nTotal;
+            }
+        }
+
+        /* Write our marker so that we list registers from our ordered proofs from now on. */
+        if(!SetOrdered())
+            return;
+
+        debug::notice(FUNCTION, "Ordered ", nTotal, " register proofs in ", timer.Elapsed(), " seconds");
+    }
 }
@@ -0,0 +1,198 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLD_TEMPLATES_BLOOM_H
+#define NEXUS_LLD_TEMPLATES_BLOOM_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LLD
+{
+
+    /** BloomFilter
+     *
+     *  Probabilistic set of keys that exist in a keychain.
+     *
+     *  A negative answer is definite, so keychains can answer lookups of missing keys without any disk access.
+     *  Bits are never cleared on erase, which only adds false positives that fall through to the keychain.
+     *  Bits are held in atomic words so that lookups don't need the keychain lock.
+     *
+     *  The filter grows in stages: once the newest stage holds its capacity of keys, a stage of twice the
+     *  capacity is added, and lookups check every stage. This keeps the false positive rate bounded without
+     *  having to rebuild the filter from the keychain.
+     *
+     **/
+    class BloomFilter
+    {
+        /** Stage
+         *
+         *  Fixed size set of bits sized for a capacity of keys.
+         *
+         **/
+        struct Stage
+        {
+            /** The bits of this stage, stored as 64-bit words. **/
+            std::vector<std::atomic<uint64_t>> vBits;
+
+
+            /** The total bits in this stage. **/
+            uint64_t nTotalBits;
+
+
+            /** The total keys this stage is sized for. **/
+            uint64_t nCapacity;
+
+
+            /** Capacity Constructor
+             *
+             *  @param[in] nCapacityIn The total keys to size this stage for.
+             *
+             **/
+            Stage(const uint64_t nCapacityIn);
+        };
+
+
+        /** The most stages a filter will grow to. **/
+        static const uint32_t MAX_STAGES = 32;
+
+
+        /** The stages of this filter, with only the first nTotalStages allocated. **/
+        std::vector<Stage*> vStages;
+
+
+        /** The total stages in use. **/
+        std::atomic<uint32_t> nTotalStages;
+
+
+        /** The total keys inserted into the newest stage. **/
+        std::atomic<uint64_t> nStageKeys;
+
+
+        /** The total hash functions for each key. **/
+        uint32_t nTotalHashes;
+
+
+        /** Mutex for adding new stages. **/
+        std::mutex STAGE_MUTEX;
+
+
+    public:
+
+        /** Default Constructor. **/
+        BloomFilter() = delete;
+
+
+        /** Copy Constructor. **/
+        BloomFilter(const BloomFilter& filter) = delete;
+
+
+        /** Copy assignment. **/
+        BloomFilter& operator=(const BloomFilter& filter) = delete;
+
+
+        /** Filter Capacity Constructor
+         *
+         *  @param[in] nCapacityIn The total keys to size the first stage for.
+         *  @param[in] nHashesIn The total hash functions for each key.
+         *
+         **/
+        BloomFilter(const uint64_t nCapacityIn, const uint32_t nHashesIn = 6);
+
+
+        /** Default Destructor. **/
+        ~BloomFilter();
+
+
+        /** Insert
+         *
+         *  Add a key to the filter, growing it by a stage if the newest stage is full.
+         *
+         *  @param[in] pBegin The beginning of the key's binary data.
+         *  @param[in] nSize The size of the key's binary data.
+         *
+         **/
+        void Insert(const uint8_t* pBegin, const uint64_t nSize);
+
+
+        /** Has
+         *
+         *  Check if a key may be contained in the filter.
+         *
+         *  @param[in] pBegin The beginning of the key's binary data.
+         *  @param[in] nSize The size of the key's binary data.
+         *
+         *  @return False if the key was never inserted, true if it may have been.
+         *
+         **/
+        bool Has(const uint8_t* pBegin, const uint64_t nSize) const;
+
+
+        /** Load
+         *
+         *  Load the filter stages from disk, replacing the current stages.
+         *
+         *  @param[in] strPath The file to load from.
+         *  @param[in] nStamp The stamp of the keychain files this filter must have been saved with.
+         *
+         *  @return True if the file existed and matched our version and stamp.
+         *
+         **/
+        bool Load(const std::string& strPath, const uint64_t nStamp);
+
+
+        /** Save
+         *
+         *  Save the filter stages to disk.
+         *
+         *  @param[in] strPath The file to save to.
+         *  @param[in] nStamp The stamp of the keychain files this filter was built from.
+         *
+         *  @return True if the file was written.
+         *
+         **/
+        bool Save(const std::string& strPath, const uint64_t nStamp) const;
+
+
+        /** Stamp
+         *
+         *  Get a stamp of the sizes and modification times of a keychain's files, so that a filter saved
+         *  before any other process wrote to the keychain is never trusted.
+         *
+         *  @param[in] strBaseLocation The base location of the keychain files.
+         *
+         *  @return The stamp of the keychain files.
+         *
+         **/
+        static uint64_t Stamp(const std::string& strBaseLocation);
+
+
+    private:
+
+        /** add_stage
+         *
+         *  Add a new stage of twice the capacity of the newest, if the newest is full.
+         *
+         *  @param[in] pStage The stage that was found to be full.
+         *
+         **/
+        void add_stage(const Stage* pStage);
+
+    };
+}
+
+#endif
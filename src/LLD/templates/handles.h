@@ -0,0 +1,180 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLD_TEMPLATES_HANDLES_H
+#define NEXUS_LLD_TEMPLATES_HANDLES_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace LLD
+{
+
+    /** HandleTable
+     *
+     *  Table of file handles indexed by keychain file number, that can be read without a lock.
+     *
+     *  Handles are held in blocks that are allocated on first use and never move, so a reader can look up a
+     *  handle while another thread is adding one. Handles are owned by the table and deleted with it.
+     *
+     **/
+    template<typename HandleType>
+    class HandleTable
+    {
+        /** The total handles in each block. **/
+        static const uint32_t BLOCK_SIZE = 256;
+
+
+        /** The total blocks, to cover every 16-bit file number. **/
+        static const uint32_t TOTAL_BLOCKS = 256;
+
+
+        /** The blocks of handles, with nullptr for blocks that aren't allocated yet. **/
+        std::atomic<std::atomic<HandleType*>*> vBlocks[TOTAL_BLOCKS];
+
+
+        /** One past the highest file number that has a handle. **/
+        std::atomic<uint32_t> nSize;
+
+
+    public:
+
+        /** Default Constructor. **/
+        HandleTable()
+        : nSize (0)
+        {
+            for(uint32_t n = 0; n < TOTAL_BLOCKS; ++n)
+                vBlocks[n].store(nullptr);
+        }
+
+
+        /** Copy Constructor. **/
+        HandleTable(const HandleTable& table) = delete;
+
+
+        /** Copy Assignment Operator. **/
+        HandleTable& operator=(const HandleTable& table) = delete;
+
+
+        /** Default Destructor. **/
+        ~HandleTable()
+        {
+            Clear();
+        }
+
+
+        /** Get
+         *
+         *  Get the handle of a given file.
+         *
+         *  @param[in] nFile The file number to get the handle for.
+         *
+         *  @return The handle of the file, or nullptr if there is none.
+         *
+         **/
+        HandleType* Get(const uint16_t nFile) const
+        {
+            /* Check that the block for this file is allocated. */
+            const std::atomic<HandleType*>* pBlock = vBlocks[nFile / BLOCK_SIZE].load(std::memory_order_acquire);
+            if(!pBlock)
+                return nullptr;
+
+            return pBlock[nFile % BLOCK_SIZE].load(std::memory_order_acquire);
+        }
+
+
+        /** Insert
+         *
+         *  Add the handle of a given file, unless another thread added one first.
+         *
+         *  @param[in] nFile The file number to add the handle for.
+         *  @param[in] pHandle The handle to add, which the table takes ownership of.
+         *
+         *  @return The handle that is in the table, which is only pHandle if it was added.
+         *
+         **/
+        HandleType* Insert(const uint16_t nFile, HandleType* pHandle)
+        {
+            /* Allocate the block for this file if needed, using the other thread's block if it beats us. */
+            std::atomic<HandleType*>* pBlock = vBlocks[nFile / BLOCK_SIZE].load(std::memory_order_acquire);
+            if(!pBlock)
+            {
+                std::atomic<HandleType*>* pNew = new std::atomic<HandleType*>[BLOCK_SIZE];
+                for(uint32_t n = 0; n < BLOCK_SIZE; ++n)
+                    pNew[n].store(nullptr);
+
+                if(vBlocks[nFile / BLOCK_SIZE].compare_exchange_strong(pBlock, pNew, std::memory_order_acq_rel))
+                    pBlock = pNew;
+                else
+                    delete[] pNew;
+            }
+
+            /* Add our handle, or drop it if another thread added this file first. */
+            HandleType* pExpected = nullptr;
+            if(!pBlock[nFile % BLOCK_SIZE].compare_exchange_strong(pExpected, pHandle, std::memory_order_acq_rel))
+            {
+                delete pHandle;
+                return pExpected;
+            }
+
+            /* Track the highest file number for iterating. */
+            uint32_t nCurrent = nSize.load();
+            while(nCurrent < uint32_t(nFile) + 1 && !nSize.compare_exchange_weak(nCurrent, uint32_t(nFile) + 1));
+
+            return pHandle;
+        }
+
+
+        /** Size
+         *
+         *  Get one past the highest file number that has a handle, to iterate all handles with Get.
+         *
+         **/
+        uint32_t Size() const
+        {
+            return nSize.load();
+        }
+
+
+        /** Clear
+         *
+         *  Delete all handles. This must not be called while other threads are using the table.
+         *
+         **/
+        void Clear()
+        {
+            for(uint32_t n = 0; n < TOTAL_BLOCKS; ++n)
+            {
+                /* Skip over blocks that were never allocated. */
+                std::atomic<HandleType*>* pBlock = vBlocks[n].exchange(nullptr);
+                if(!pBlock)
+                    continue;
+
+                /* Delete all of the handles in this block. */
+                for(uint32_t i = 0; i < BLOCK_SIZE; ++i)
+                {
+                    HandleType* pHandle = pBlock[i].load();
+                    if(pHandle)
+                        delete pHandle;
+                }
+
+                delete[] pBlock;
+            }
+
+            nSize.store(0);
+        }
+    };
+}
+
+#endif
@@ -21,6 +21,8 @@ ________________________________________________________________________________
 #include <LLD/templates/key.h>
 #include <LLD/templates/transaction.h>
 
+#include <LLD/keychain/hashtree.h>
+
 #include <LLD/cache/template_lru.h>
 
 #include <Util/templates/datastream.h>
@@ -28,9 +30,11 @@ ________________________________________________________________________________
 #include <Util/include/debug.h>
 #include <Util/include/filesystem.h>
 
+#include <algorithm>
 #include <string>
 #include <cstdint>
 #include <atomic>
+#include <set>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -50,6 +54,18 @@ namespace LLD
     const uint32_t MAX_SECTOR_BUFFER_SIZE = 1024 * 1024 * 4; //32 MB Max Disk Buffer
 
 
+    /* The total lock stripes for record level locking. */
+    const uint32_t SECTOR_LOCK_STRIPES = 1024;
+
+
+    /* The total reader lanes that hold their own file streams. */
+    const uint32_t SECTOR_READ_LANES = 8;
+
+
+    /* The maximum amount of bytes copied in one write while compacting. */
+    const uint32_t MAX_COMPACT_BUFFER_SIZE = 1024 * 1024; //1 MB Compaction Buffer
+
+
     /** SectorDatabase
      *
      *  Base Template Class for a Sector Database.
@@ -88,14 +104,20 @@ namespace LLD
         std::condition_variable CONDITION;
 
     protected:
-        /* Mutex for Thread Synchronization.
-            TODO: Lock Mutex based on Read / Writes on a per Sector Basis.
-            Will allow higher efficiency for thread concurrency. */
+        /* Mutex for Thread Synchronization. */
         std::mutex SECTOR_MUTEX;
         std::mutex BUFFER_MUTEX;
         std::mutex TRANSACTION_MUTEX;
 
 
+        /* Record level lock stripes, selected by the hash of a key. */
+        std::vector<std::mutex> RECORD_MUTEX;
+
+
+        /* Reader lane locks, guarding the file streams of each lane. */
+        std::vector<std::mutex> READER_MUTEX;
+
+
         /* The String to hold the Disk Location of Database File. */
         std::string strBaseLocation;
         std::string strName;
@@ -113,6 +135,14 @@ namespace LLD
         KeychainType* pSectorKeys;
 
 
+        /* Ordered keys, for databases that iterate keys by prefix. */
+        BinaryHashTree* pOrderedKeys;
+
+
+        /* The binary prefixes of keys that are kept in order. */
+        std::vector<std::vector<uint8_t>> vOrderedPrefixes;
+
+
         /* Cache Pool */
         CacheType* cachePool;
 
@@ -121,11 +151,19 @@ namespace LLD
         mutable TemplateLRU<uint32_t, std::fstream*>* fileCache;
 
 
+        /* Read only file stream objects for each reader lane. */
+        std::vector<TemplateLRU<uint32_t, std::fstream*>*> vReaderCache;
+
+
         /* The current File Position. */
         mutable uint32_t nCurrentFile;
         mutable uint32_t nCurrentFileSize;
 
 
+        /* The first sector file that holds compressed records. */
+        uint32_t nCompressedFile;
+
+
         /* Cache Writer Thread. */
         std::thread CacheWriterThread;
 
@@ -134,6 +172,18 @@ namespace LLD
         std::thread MeterThread;
 
 
+        /* The compactor thread. */
+        std::thread CompactorThread;
+
+
+        /* The sector file that is being compacted, no records are updated in place in this file. */
+        std::atomic<uint32_t> nCompactFile;
+
+
+        /* Sector files with records updated in place since they were last synchronized, guarded by SECTOR_MUTEX. */
+        std::set<uint32_t> setDirtyFiles;
+
+
         /* Disk Buffer Vector. */
         std::vector< std::pair< std::vector<uint8_t>, std::vector<uint8_t> > > vDiskBuffer;
 
@@ -141,11 +191,22 @@ namespace LLD
         /* Disk Buffer Memory Size. */
         std::atomic<uint32_t> nBufferBytes;
 
+
+        /* Sequence of the last record added to the disk buffer, and of the last record synchronized with disk. */
+        std::atomic<uint64_t> nBufferSequence;
+        std::atomic<uint64_t> nSyncedSequence;
+
+        /* Total batches that failed to commit and were put back to be retried. */
+        std::atomic<uint64_t> nFailedBatches;
+
         /* For the Meter. */
         std::atomic<uint32_t> nBytesRead;
         std::atomic<uint32_t> nBytesWrote;
         std::atomic<uint32_t> nRecordsFlushed;
 
+        /* Flag to show if a transaction is active, so readers can skip the transaction lock. */
+        std::atomic<bool> fTransaction;
+
         /* Destructor Flag. */
         std::atomic<bool> fDestruct;
 
@@ -198,6 +259,7 @@ namespace LLD
             const std::vector<uint8_t>& vKey = ssKey.Bytes();
 
             /* Check that the key is not pending in a transaction for Erase. */
+            if(fTransaction.load())
             {
                 LOCK(TRANSACTION_MUTEX);
 
@@ -225,6 +287,9 @@ namespace LLD
             if(cachePool->Has(vKey))
                 return true;
 
+            /* Lock only this key's stripe so writers to other keys don't block us. */
+            LOCK(RECORD_MUTEX[stripe(vKey)]);
+
             /* Return the Key existance in the Keychain Database. */
             SectorKey cKey;
             return pSectorKeys->Get(vKey, cKey);
@@ -268,7 +333,18 @@ namespace LLD
                 }
             }
 
-            return (fKeychainOnly ? pSectorKeys->Erase(ssKey.Bytes()) : Delete(ssKey.Bytes()));
+            /* Commit any buffered writes first, so they can't bring back the key once it is erased. */
+            if(!(nFlags & FLAGS::FORCE))
+                Sync();
+
+            /* Handle keychain only erase under the key's stripe, Delete handles its own locking. */
+            if(fKeychainOnly)
+            {
+                LOCK(RECORD_MUTEX[stripe(ssKey.Bytes())]);
+                return erase_key(ssKey.Bytes());
+            }
+
+            return Delete(ssKey.Bytes());
         }
 
 
@@ -322,6 +398,73 @@ namespace LLD
         }
 
 
+        /** Seek
+         *
+         *  Position a cursor before the first key that begins with a prefix, in binary order of keys.
+         *  Keys are ordered by their serialized bytes, so integers in keys only order by value when big endian.
+         *
+         *  @param[in] prefix The leading part of the keys to iterate.
+         *  @param[out] cursor The cursor to iterate keys with.
+         *
+         *  @return True if keys with this prefix are ordered, false if callers need another way to list them.
+         *
+         **/
+        template<typename Type>
+        bool Seek(const Type& prefix, KeyCursor& cursor)
+        {
+            /* Serialize the prefix into bytes. */
+            DataStream ssPrefix(SER_LLD, DATABASE_VERSION);
+            ssPrefix << prefix;
+
+            /* Check that these keys are ordered. */
+            if(!ordered(ssPrefix.Bytes()) || !pOrderedKeys->Complete())
+                return false;
+
+            /* Get the keys of an open transaction, so the cursor sees the same keys that Exists does. */
+            std::set<std::vector<uint8_t>> setPending, setErased;
+            pending_keys(ssPrefix.Bytes(), setPending, setErased);
+
+            cursor.Seek(pOrderedKeys, ssPrefix.Bytes(), ssPrefix.Bytes(), setPending, setErased);
+
+            return true;
+        }
+
+
+        /** Seek
+         *
+         *  Position a cursor before the first key that begins with a prefix, starting from a given key.
+         *
+         *  @param[in] prefix The leading part of the keys to iterate.
+         *  @param[in] key The key to start iterating from, inclusive.
+         *  @param[out] cursor The cursor to iterate keys with.
+         *
+         *  @return True if keys with this prefix are ordered, false if callers need another way to list them.
+         *
+         **/
+        template<typename Type, typename Key>
+        bool Seek(const Type& prefix, const Key& key, KeyCursor& cursor)
+        {
+            /* Serialize the prefix and key into bytes. */
+            DataStream ssPrefix(SER_LLD, DATABASE_VERSION);
+            ssPrefix << prefix;
+
+            DataStream ssKey(SER_LLD, DATABASE_VERSION);
+            ssKey << key;
+
+            /* Check that these keys are ordered. */
+            if(!ordered(ssPrefix.Bytes()) || !pOrderedKeys->Complete())
+                return false;
+
+            /* Get the keys of an open transaction, so the cursor sees the same keys that Exists does. */
+            std::set<std::vector<uint8_t>> setPending, setErased;
+            pending_keys(ssPrefix.Bytes(), setPending, setErased);
+
+            cursor.Seek(pOrderedKeys, ssPrefix.Bytes(), ssKey.Bytes(), setPending, setErased);
+
+            return true;
+        }
+
+
         /** GetBatch
          *
          *  Sequential read from a specified binary position.
@@ -415,6 +558,49 @@ namespace LLD
                                 continue;
                             }
 
+                            /* Records in compressed sector files are deserialized from their decompressed bytes. */
+                            if(compressed(nFile))
+                            {
+                                /* Check that the whole record is inside our buffer. */
+                                const uint64_t nBegin = ssData.GetPos();
+                                if(nBegin + nSize > ssData.size())
+                                    throw debug::exception(FUNCTION, "record exceeds read buffer");
+
+                                /* Get the record and skip past it in our buffer. */
+                                std::vector<uint8_t> vRecord(ssData.begin() + nBegin, ssData.begin() + nBegin + nSize);
+                                ssData.SetPos(nBegin + nSize);
+
+                                /* Iterate to next position. */
+                                nFilePos += nSize + GetSizeOfCompactSize(nSize);
+
+                                /* Skip over records that fail to decompress. */
+                                if(!decompress(vRecord))
+                                    continue;
+
+                                /* Deserialize the String. */
+                                const DataStream ssRecord(vRecord, SER_LLD, DATABASE_VERSION);
+
+                                std::string strThis;
+                                ssRecord >> strThis;
+
+                                /* Check the type. */
+                                if(strType == strThis)
+                                {
+                                    /* Get the value. */
+                                    Type value;
+                                    ssRecord >> value;
+
+                                    /* Push next value. */
+                                    vValues.push_back(value);
+
+                                    /* Check limits. */
+                                    if(nLimit != -1 && --nLimit == 0)
+                                        return (vValues.size() > 0);
+                                }
+
+                                continue;
+                            }
+
                             /* Deserialize the String. */
                             std::string strThis;
                             ssData >> strThis;
@@ -490,6 +676,7 @@ namespace LLD
                 std::vector<uint8_t>& vKey = ssKey.Bytes();
 
                 /* Check that the key is not pending in a transaction for Erase. */
+                if(fTransaction.load())
                 {
                     LOCK(TRANSACTION_MUTEX);
                     if(pTransaction)
@@ -589,6 +776,15 @@ namespace LLD
                 }
             }
 
+            /* Lock the stripes of both keys in order, so compaction can't move the record between our read and write. */
+            const uint32_t nIndexStripe = stripe(vIndex);
+            const uint32_t nKeyStripe   = stripe(vKey);
+
+            std::unique_lock<std::mutex> INDEX_LOCK(RECORD_MUTEX[std::min(nIndexStripe, nKeyStripe)]);
+            std::unique_lock<std::mutex> KEY_LOCK(RECORD_MUTEX[std::max(nIndexStripe, nKeyStripe)], std::defer_lock);
+            if(nIndexStripe != nKeyStripe)
+                KEY_LOCK.lock();
+
             /* Get the key. */
             SectorKey cKey;
             if(!pSectorKeys->Get(vIndex, cKey))
@@ -600,7 +796,7 @@ namespace LLD
 
             /* Write the new sector key. */
             cKey.SetKey(vKey);
-            return pSectorKeys->Put(cKey);
+            return put_key(cKey);
         }
 
 
@@ -645,9 +841,12 @@ namespace LLD
                 }
             }
 
+            /* Lock the stripe of the key we are writing. */
+            LOCK(RECORD_MUTEX[stripe(vKey)]);
+
             /* Return the Key existance in the Keychain Database. */
             SectorKey cKey(STATE::READY, vKey, 0, 0, 0);
-            return pSectorKeys->Put(cKey);
+            return put_key(cKey);
         }
 
 
@@ -782,6 +981,17 @@ namespace LLD
         bool Delete(const std::vector<uint8_t>& vKey);
 
 
+        /** Sync
+         *
+         *  Wait until all records written before this call are synchronized with disk.
+         *  Writes return as soon as they are buffered, callers that need durable writes follow them with Sync.
+         *
+         *  @return True if the records were synchronized, false if they failed to commit and are waiting to be retried.
+         *
+         **/
+        bool Sync();
+
+
         /** CacheWriter
          *
          *  Flushes periodically data from the cache buffer to disk.
@@ -798,6 +1008,27 @@ namespace LLD
         void Meter();
 
 
+        /** Compact
+         *
+         *  Rewrite the live records of a sector file to the end of the current file, then point their keys
+         *  to the new records and truncate the old file to reclaim the space of overwritten and erased records.
+         *
+         *  @param[in] nFile The sector file to compact, which can't be the current file.
+         *
+         *  @return True if the sector file was compacted.
+         *
+         **/
+        bool Compact(const uint32_t nFile);
+
+
+        /** Compactor
+         *
+         *  Periodically compacts sector files that are mostly dead space, when enabled by FLAGS::COMPACT.
+         *
+         **/
+        void Compactor();
+
+
         /** TxnBegin
          *
          *  Start a database transaction.
@@ -839,6 +1070,236 @@ namespace LLD
          **/
         bool TxnRecovery();
 
+
+    protected:
+
+        /** Order
+         *
+         *  Keep keys that begin with a prefix in binary order, so they can be iterated with Seek.
+         *  This must be called from the constructor of a database, and the prefixes shouldn't change once
+         *  it has records, since keys written before a prefix was ordered aren't in the tree.
+         *
+         *  @param[in] prefix The leading part of the keys to order.
+         *
+         **/
+        template<typename Type>
+        void Order(const Type& prefix)
+        {
+            /* Serialize the prefix into bytes. */
+            DataStream ssPrefix(SER_LLD, DATABASE_VERSION);
+            ssPrefix << prefix;
+
+            /* Create our tree on first use, it only knows every key if we don't have any records yet. */
+            if(!pOrderedKeys)
+                pOrderedKeys = new BinaryHashTree(config::GetDataDir() + strName + "/keychain/", (nCurrentFile == 0 && nCurrentFileSize == 0));
+
+            vOrderedPrefixes.push_back(ssPrefix.Bytes());
+        }
+
+
+        /** Ordered
+         *
+         *  Check if our ordered keys hold every key, either from being created with the database or from a backfill.
+         *
+         *  @return True if ordered keys can be iterated with Seek.
+         *
+         **/
+        bool Ordered() const
+        {
+            return pOrderedKeys && pOrderedKeys->Complete();
+        }
+
+
+        /** Backfill
+         *
+         *  Add a key that was written before its prefix was ordered. Once every such key is added, databases
+         *  call SetOrdered so that Seek can be used.
+         *
+         *  @param[in] key The key to add, which must already exist.
+         *
+         *  @return True if the key was added.
+         *
+         **/
+        template<typename Key>
+        bool Backfill(const Key& key)
+        {
+            /* Serialize the key into bytes. */
+            DataStream ssKey(SER_LLD, DATABASE_VERSION);
+            ssKey << key;
+
+            /* Check that this key is one we order. */
+            if(!pOrderedKeys || !ordered(ssKey.Bytes()))
+                return false;
+
+            return pOrderedKeys->Put(ssKey.Bytes());
+        }
+
+
+        /** SetOrdered
+         *
+         *  Mark our ordered keys as holding every key, once a backfill has finished.
+         *
+         *  @return True if the marker was written.
+         *
+         **/
+        bool SetOrdered()
+        {
+            return pOrderedKeys && pOrderedKeys->SetComplete();
+        }
+
+
+    private:
+
+        /** ordered
+         *
+         *  Determine if a key begins with one of our ordered prefixes.
+         *
+         *  @param[in] vKey The binary data of the key.
+         *
+         *  @return True if the key is kept in order.
+         *
+         **/
+        bool ordered(const std::vector<uint8_t>& vKey) const;
+
+
+        /** put_key
+         *
+         *  Write a key to the keychain, and to our ordered keys if it has an ordered prefix.
+         *
+         *  @param[in] cKey The sector key to write.
+         *
+         *  @return True if the key was written.
+         *
+         **/
+        bool put_key(const SectorKey& cKey);
+
+
+        /** erase_key
+         *
+         *  Erase a key from the keychain, and from our ordered keys if it has an ordered prefix.
+         *
+         *  @param[in] vKey The binary data of the key.
+         *
+         *  @return True if the key was erased.
+         *
+         **/
+        bool erase_key(const std::vector<uint8_t>& vKey);
+
+
+        /** pending_keys
+         *
+         *  Get the keys of an open transaction that begin with a prefix.
+         *
+         *  @param[in] vPrefix The binary data that keys must begin with.
+         *  @param[out] setPending The keys that are written in the transaction.
+         *  @param[out] setErased The keys that are erased in the transaction.
+         *
+         **/
+        void pending_keys(const std::vector<uint8_t>& vPrefix, std::set<std::vector<uint8_t>>& setPending,
+                          std::set<std::vector<uint8_t>>& setErased);
+
+
+        /** stripe
+         *
+         *  Get the lock stripe that a given key is assigned to.
+         *
+         *  @param[in] vKey The binary data of the key.
+         *
+         *  @return The index into the record lock stripes.
+         *
+         **/
+        uint32_t stripe(const std::vector<uint8_t>& vKey) const;
+
+
+        /** read_sector
+         *
+         *  Read a record from disk through a reader lane's file streams.
+         *  Caller must hold the record stripe lock for the key.
+         *
+         *  @param[in] cKey The sector key from keychain.
+         *  @param[in] nLane The reader lane to read through.
+         *  @param[out] vData The binary data of the record read.
+         *
+         *  @return True if the record was read successfully.
+         *
+         **/
+        bool read_sector(const SectorKey& cKey, const uint32_t nLane, std::vector<uint8_t>& vData);
+
+
+        /** compressed
+         *
+         *  Determine if a sector file holds compressed records.
+         *
+         *  @param[in] nFile The sector file number.
+         *
+         *  @return True if records in this file are compressed.
+         *
+         **/
+        bool compressed(const uint32_t nFile) const;
+
+
+        /** compress
+         *
+         *  Compress a record into its on disk format for compressed sector files.
+         *  Records that don't shrink are stored raw behind a zero length marker.
+         *
+         *  @param[in] vData The binary data of the record.
+         *  @param[out] vRecord The compressed record to write.
+         *
+         **/
+        void compress(const std::vector<uint8_t>& vData, std::vector<uint8_t>& vRecord) const;
+
+
+        /** decompress
+         *
+         *  Decompress a record read from a compressed sector file.
+         *
+         *  @param[out] vRecord The record to decompress in place.
+         *
+         *  @return True if the record was decompressed successfully.
+         *
+         **/
+        bool decompress(std::vector<uint8_t>& vRecord) const;
+
+
+        /** write_batch
+         *
+         *  Group commit a batch of buffered records. Records that can't be updated in place are appended
+         *  to the sector files with one write and one sync per file before their keys are written.
+         *
+         *  @param[in] vRecords The buffered key and data pairs, in the order they were written.
+         *  @param[out] vFailed The records that were not committed, in the order they were written.
+         *
+         *  @return True if all records were committed.
+         *
+         **/
+        bool write_batch(const std::vector< std::pair<std::vector<uint8_t>, std::vector<uint8_t>> >& vRecords,
+                         std::vector< std::pair<std::vector<uint8_t>, std::vector<uint8_t>> >& vFailed);
+
+
+        /** append_batch
+         *
+         *  Append a contiguous buffer of records to the current sector file and synchronize it with disk.
+         *
+         *  @param[in] vBatch The serialized records to append.
+         *  @param[out] nFile The sector file the records were appended to.
+         *  @param[out] nStart The binary position the records were appended at.
+         *
+         *  @return True if the records were appended and synchronized.
+         *
+         **/
+        bool append_batch(const std::vector<uint8_t>& vBatch, uint32_t &nFile, uint32_t &nStart);
+
+
+        /** sync_dirty
+         *
+         *  Synchronize the sector files that records were updated in place in, which are kept dirty if they fail.
+         *
+         *  @return True if all of the files were synchronized.
+         *
+         **/
+        bool sync_dirty();
+
     };
 }
 
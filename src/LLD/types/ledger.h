@@ -18,8 +18,8 @@ ________________________________________________________________________________
 #include <LLC/types/uint1024.h>
 
 #include <LLD/templates/sector.h>
-#include <LLD/cache/binary_lru.h>
-#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/binary_clock.h>
+#include <LLD/keychain/mappedmap.h>
 
 #include <TAO/Operation/types/contract.h>
 
@@ -38,6 +38,7 @@ namespace TAO
     namespace Ledger
     {
         class BlockState;
+        class Metrics;
         class Transaction;
     }
 
@@ -74,7 +75,7 @@ namespace LLD
      *  The database class for the Ledger Layer.
      *
      **/
-    class LedgerDB : public SectorDatabase<BinaryHashMap, BinaryLRU>
+    class LedgerDB : public SectorDatabase<BinaryMappedMap, BinaryCLOCK>
     {
 
         /** Mutex to lock internall when accessing memory mode. **/
@@ -634,6 +635,32 @@ namespace LLD
         bool ReadStake(const uint256_t& hashGenesis, uint512_t& hashLast, const uint8_t nFlags = TAO::Ledger::FLAGS::BLOCK);
 
 
+        /** WriteMetrics
+         *
+         *  Writes the ledger metrics of a bucket of block time.
+         *
+         *  @param[in] nBucket The bucket to write, which is the block time over METRICS_BUCKET.
+         *  @param[in] tMetrics The metrics to write.
+         *
+         *  @return True if successfully written, false otherwise.
+         *
+         **/
+        bool WriteMetrics(const uint32_t nBucket, const TAO::Ledger::Metrics& tMetrics);
+
+
+        /** ReadMetrics
+         *
+         *  Reads the ledger metrics of a bucket of block time.
+         *
+         *  @param[in] nBucket The bucket to read, which is the block time over METRICS_BUCKET.
+         *  @param[out] tMetrics The metrics that were read.
+         *
+         *  @return True if successfully read, false otherwise.
+         *
+         **/
+        bool ReadMetrics(const uint32_t nBucket, TAO::Ledger::Metrics &tMetrics);
+
+
         /** WriteProof
          *
          *  Writes a proof to disk. Proofs are used to keep track of spent temporal proofs.
@@ -735,6 +762,15 @@ namespace LLD
         void IndexProofs();
 
 
+        /** IndexMetrics
+         *
+         *  Build the ledger metrics buckets of the last four weeks of blocks, for chains connected before metrics were
+         *  written on block connect.
+         *
+         **/
+        void IndexMetrics();
+
+
         /** WriteBlock
          *
          *  Writes a block state object to disk.
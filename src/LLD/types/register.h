@@ -18,8 +18,8 @@ ________________________________________________________________________________
 #include <LLC/types/uint1024.h>
 
 #include <LLD/templates/sector.h>
-#include <LLD/cache/binary_lru.h>
-#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/binary_clock.h>
+#include <LLD/keychain/mappedmap.h>
 
 #include <TAO/Register/types/object.h>
 
@@ -57,7 +57,7 @@ namespace LLD
      *  The database class for the Register Layer.
      *
      **/
-    class RegisterDB : public SectorDatabase<BinaryHashMap, BinaryLRU>
+    class RegisterDB : public SectorDatabase<BinaryMappedMap, BinaryCLOCK>
     {
 
         /** Memory mutex to lock when accessing internal memory states. **/
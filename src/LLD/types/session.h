@@ -794,5 +794,14 @@ namespace LLD
          **/
         bool HasContract(const uint512_t& hashTx, const uint32_t nContract);
 
+
+        /** IndexRegisters
+         *
+         *  Order the register proofs that were written before they were kept in order, so they can be listed
+         *  by owner. This only runs once, the ordered keys persist a marker once the backfill has finished.
+         *
+         **/
+        void IndexRegisters();
+
     };
 }
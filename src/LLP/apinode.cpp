@@ -340,6 +340,16 @@ namespace LLP
         if(config::GetBoolArg("-httpresponse", false))
             debug::log(0, jRet.dump(4));
 
+        /* Our content is always JSON, so the packet doesn't need to check. */
+        RESPONSE.mapHeaders["Content-Type"] = "application/json";
+
+        /* Stream array results in chunks for clients that support chunked transfer encoding. */
+        if(jRet.find("result") != jRet.end() && jRet["result"].is_array() && INCOMING.strVersion == "HTTP/1.1")
+        {
+            push_stream(RESPONSE, jRet);
+            return true;
+        }
+
         /* Add content. */
         RESPONSE.strContent = jRet.dump();
 
@@ -351,6 +361,68 @@ namespace LLP
     }
 
 
+    /* Write a response with an array result in chunks, serializing one row at a time. */
+    void APINode::push_stream(HTTPPacket& RESPONSE, encoding::json& jRet)
+    {
+        /* The size of content to buffer before writing a chunk. */
+        const uint64_t nChunkSize = 64 * 1024;
+
+        /* Write our header first, since the content follows in chunks. */
+        RESPONSE.fChunked = true;
+        if(!this->WritePacket(RESPONSE))
+        {
+            Disconnect();
+            return;
+        }
+
+        /* Serialize our rows directly into the chunk buffer. */
+        std::string strChunk = "{\"result\":[";
+        encoding::detail::serializer<encoding::json> tSerializer(encoding::detail::output_adapter<char>(strChunk), ' ');
+
+        /* Loop through our rows, releasing each one once it is serialized. */
+        bool fFirst = true;
+        for(auto& jRow : jRet["result"])
+        {
+            /* Add our delimiter between rows. */
+            if(!fFirst)
+                strChunk += ',';
+
+            tSerializer.dump(jRow, false, false, 0);
+            jRow   = nullptr;
+            fFirst = false;
+
+            /* Write our chunk when the buffer is full. */
+            if(strChunk.size() >= nChunkSize)
+            {
+                /* Close the connection if our client can't keep up, rather than finishing a response with rows missing. */
+                if(!WriteChunk(strChunk))
+                {
+                    debug::log(0, FUNCTION, "send buffer full, closing stream to ", this->addr.ToString());
+
+                    Disconnect();
+                    return;
+                }
+
+                strChunk.clear();
+            }
+        }
+
+        /* Close our result and add our info. */
+        strChunk += "],\"info\":";
+        tSerializer.dump(jRet["info"], false, false, 0);
+        strChunk += "}";
+
+        /* Write the last of our content and the chunk to end it. */
+        if(!WriteChunk(strChunk) || !WriteChunk(""))
+        {
+            debug::log(0, FUNCTION, "send buffer full, closing stream to ", this->addr.ToString());
+
+            Disconnect();
+            return;
+        }
+    }
+
+
     bool APINode::Authorized(std::map<std::string, std::string>& mapHeaders)
     {
         /* Make a local cache of our authorization header. */
@@ -228,36 +228,44 @@ namespace LLP
 
     /*  Write a single packet to the TCP stream. */
     template <class PacketType>
-    void BaseConnection<PacketType>::WritePacket(const PacketType& PACKET)
+    bool BaseConnection<PacketType>::WritePacket(const PacketType& PACKET)
+    {
+        return WritePacket(std::make_shared<const std::vector<uint8_t>>(PACKET.GetBytes()));
+    }
+
+
+    /*  Write a packet that was already serialized to the TCP stream. */
+    template <class PacketType>
+    bool BaseConnection<PacketType>::WritePacket(const shared_bytes_t& pBytes)
     {
 
         /* Only get this value one time so we don't need to keep accessing the args map. */
         static const uint64_t nMaxSendBuffer =
             config::GetArg("-maxsendbuffer", MAX_SEND_BUFFER);
 
-        /* Get the bytes of the packet. */
-        const std::vector<uint8_t> vBytes = PACKET.GetBytes();
-
         /* Stop sending packets if send buffer is full. */
-        if(Buffered() + vBytes.size() + 1024 < nMaxSendBuffer //reserve 1Kb of buffer for critical messages
-        || (fBufferFull.load() && Buffered() + vBytes.size() < nMaxSendBuffer)) //catch for critical messages (< 1 Kb)
+        bool fWritten = false;
+        if(Buffered() + pBytes->size() + 1024 < nMaxSendBuffer //reserve 1Kb of buffer for critical messages
+        || (fBufferFull.load() && Buffered() + pBytes->size() < nMaxSendBuffer)) //catch for critical messages (< 1 Kb)
         {
             /* Debug dump of message type. */
-            debug::log(4, NODE, "sent packet (", vBytes.size(), " bytes)");
+            debug::log(4, NODE, "sent packet (", pBytes->size(), " bytes)");
 
             /* Debug dump of packet data. */
             if(config::nVerbose >= 5)
-                PrintHex(vBytes);
+                PrintHex(*pBytes);
 
             /* Write the packet to socket buffer. */
-            Write(vBytes, vBytes.size());
+            Write(pBytes);
 
             /* Update packet count. */
             ++PACKETS;
+
+            fWritten = true;
         }
         else
         {
-            debug::log(4, NODE, "Socket buffer full. Packet size: ", vBytes.size(), " bytes.  Buffered: ", Buffered(), " bytes");
+            debug::log(4, NODE, "Socket buffer full. Packet size: ", pBytes->size(), " bytes.  Buffered: ", Buffered(), " bytes");
 
             /* set buffer to full */
             fBufferFull.store(true);
@@ -266,6 +274,8 @@ namespace LLP
         /* Notify condition if available. */
         if(FLUSH_CONDITION && Buffered())
             FLUSH_CONDITION->notify_all();
+
+        return fWritten;
     }
 
 
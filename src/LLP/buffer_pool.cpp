@@ -0,0 +1,99 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLP/include/buffer_pool.h>
+
+#include <Util/include/args.h>
+
+namespace LLP
+{
+    /* Get the most bytes a thread can hold in free buffers, set by -bufferpool in megabytes. */
+    static uint64_t max_pooled()
+    {
+        static const uint64_t nMaxPooled = config::GetArg("-bufferpool", 8) * 1024 * 1024;
+        return nMaxPooled;
+    }
+
+
+    /* Default Constructor. */
+    BufferPool::BufferPool()
+    : vFree   ( )
+    , nPooled (0)
+    {
+    }
+
+
+    /* Get the pool for the calling thread. */
+    BufferPool& BufferPool::Local()
+    {
+        static thread_local BufferPool POOL;
+        return POOL;
+    }
+
+
+    /* Get an empty buffer with room for a given number of bytes, from the pool if one is free. */
+    std::vector<uint8_t> BufferPool::Get(const uint32_t nSize)
+    {
+        /* Find the smallest size class that fits. */
+        uint32_t nClass = 0;
+        while(nClass < CLASSES - 1 && (MIN_SIZE << nClass) < nSize)
+            ++nClass;
+
+        /* Use a free buffer if we have one. */
+        std::vector<uint8_t> vBuffer;
+        if(!vFree[nClass].empty())
+        {
+            vBuffer = std::move(vFree[nClass].back());
+            vFree[nClass].pop_back();
+
+            nPooled -= vBuffer.capacity();
+            return vBuffer;
+        }
+
+        /* Otherwise allocate the full size class, so it can be reused by any packet in this class. */
+        vBuffer.reserve(MIN_SIZE << nClass);
+        return vBuffer;
+    }
+
+
+    /* Return a buffer to the pool, or free it if the pool is full. */
+    void BufferPool::Release(std::vector<uint8_t>& vBuffer)
+    {
+        /* Check that this buffer is worth keeping. */
+        const uint64_t nCapacity = vBuffer.capacity();
+        if(nCapacity < MIN_SIZE || nCapacity > MAX_SIZE || nPooled + nCapacity > max_pooled())
+        {
+            std::vector<uint8_t>().swap(vBuffer);
+            return;
+        }
+
+        /* Find the largest size class this buffer can hold. */
+        uint32_t nClass = 0;
+        while(nClass < CLASSES - 1 && (uint64_t(MIN_SIZE) << (nClass + 1)) <= nCapacity)
+            ++nClass;
+
+        /* Add to our free buffers. */
+        vBuffer.clear();
+        vFree[nClass].push_back(std::move(vBuffer));
+        vBuffer = std::vector<uint8_t>();
+
+        nPooled += nCapacity;
+    }
+
+
+    /* Get the total bytes held in free buffers. */
+    uint64_t BufferPool::Pooled() const
+    {
+        return nPooled;
+    }
+}
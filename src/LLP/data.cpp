@@ -26,9 +26,25 @@ ________________________________________________________________________________
 
 #include <Util/include/hex.h>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <limits>
+
 
 namespace LLP
 {
+    /* The maximum ready events to handle for each wait. */
+    const uint32_t MAX_EPOLL_EVENTS = 256;
+
+
+    /* The event index reserved for our wakeup descriptor. */
+    const uint32_t WAKE_INDEX = std::numeric_limits<uint32_t>::max();
+
+
     /** Default Constructor **/
     template <class ProtocolType>
     DataThread<ProtocolType>::DataThread(const uint32_t nID, const bool ffDDOSIn,
@@ -47,6 +63,13 @@ namespace LLP
         (new std::vector<std::shared_ptr<ProtocolType>>()))
     , RELAY           (util::atomic::lock_unique_ptr<std::queue<std::pair<typename ProtocolType::message_t, DataStream>> >
         (new std::queue<std::pair<typename ProtocolType::message_t, DataStream>>()))
+#ifdef __linux__
+    , nEpollFD        (epoll_create1(EPOLL_CLOEXEC))
+    , nEventFD        (eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+#else
+    , nEpollFD        (-1)
+    , nEventFD        (-1)
+#endif
     , CONDITION       ( )
     , DATA_THREAD     (std::bind(&DataThread::Thread, this))
     , FLUSH_CONDITION ( )
@@ -61,11 +84,25 @@ namespace LLP
     {
         fDestruct = true;
         CONDITION.notify_all();
+        wake_thread();
 
         /* Wait for all data threads. */
         if(DATA_THREAD.joinable())
             DATA_THREAD.join();
 
+#ifdef __linux__
+        /* Remove our connections from our epoll descriptor before it is closed. */
+        for(uint32_t nIndex = 0; nIndex < CONNECTIONS->size(); ++nIndex)
+            unwatch_connection(nIndex);
+
+        /* Close our event descriptors. */
+        if(nEpollFD >= 0)
+            close(nEpollFD);
+
+        if(nEventFD >= 0)
+            close(nEventFD);
+#endif
+
         FLUSH_CONDITION.notify_all();
 
         /* Wait for any threads still flushing buffers. */
@@ -116,6 +153,9 @@ namespace LLP
             else
                 CONNECTIONS->at(nSlot) = std::shared_ptr<ProtocolType>(pnode);
 
+            /* Register our socket for ready events. */
+            watch_connection(nSlot);
+
             /* Notify data thread to wake up. */
             CONDITION.notify_all();
 
@@ -176,7 +216,6 @@ namespace LLP
     {
         /* Cache sleep time if applicable. */
         const uint32_t nSleep = config::GetArg("-llpsleep", 0);
-        const uint32_t nWait  = config::GetArg("-llpwait", 1);
 
         /* The mutex for the condition. */
         std::mutex CONDITION_MUTEX;
@@ -186,6 +225,29 @@ namespace LLP
          */
         std::vector<pollfd> POLLFDS;
 
+#ifdef __linux__
+
+        /* Register our wakeup descriptor, falling back to poll if epoll isn't available. */
+        epoll_event tWake;
+        tWake.events   = EPOLLIN;
+        tWake.data.u32 = WAKE_INDEX;
+
+        const bool fEpoll = (nEpollFD >= 0 && nEventFD >= 0 && epoll_ctl(nEpollFD, EPOLL_CTL_ADD, nEventFD, &tWake) == 0);
+        if(!fEpoll)
+            debug::log(0, FUNCTION, ProtocolType::Name(), " epoll unavailable, using poll");
+
+        /* The events returned from each wait. */
+        std::vector<epoll_event> vEvents(MAX_EPOLL_EVENTS);
+
+        /* The connections with data buffered that we need to process again without waiting. */
+        std::vector<uint32_t> vPending;
+
+        /* Track the time since all connections were checked. */
+        runtime::timer tSweep;
+        tSweep.Start();
+
+#endif
+
         /* The main connection handler loop. */
         while(!fDestruct.load() && !config::fShutdown.load())
         {
@@ -222,6 +284,74 @@ namespace LLP
                 continue;
             }
 
+#ifdef __linux__
+
+            /* Sockets are registered once when added, so we only wake for those that are ready. */
+            if(fEpoll)
+            {
+                /* Wait for ready sockets or our wakeup descriptor, without waiting if we have buffered data. */
+                const int32_t nReady = epoll_wait(nEpollFD, &vEvents[0], static_cast<int32_t>(vEvents.size()), vPending.empty() ? 100 : 0);
+                if(nReady < 0)
+                {
+                    /* Signals interrupt our wait, anything else we back off from. */
+                    if(errno != EINTR)
+                        runtime::sleep(1);
+
+                    continue;
+                }
+
+                /* Check the connections that had data buffered after they were last processed. */
+                std::vector<uint32_t> vBuffered;
+                vBuffered.swap(vPending);
+                for(const uint32_t nIndex : vBuffered)
+                {
+                    /* Skip over slots that were removed. */
+                    if(nIndex >= CONNECTIONS->size())
+                        continue;
+
+                    process_connection(nIndex, POLLIN);
+                    if(pending_connection(nIndex))
+                        vPending.push_back(nIndex);
+                }
+
+                /* Check the connections that are ready. */
+                for(int32_t n = 0; n < nReady; ++n)
+                {
+                    /* Reset our wakeup descriptor. */
+                    const uint32_t nIndex = vEvents[n].data.u32;
+                    if(nIndex == WAKE_INDEX)
+                    {
+                        uint64_t nCount = 0;
+                        if(read(nEventFD, &nCount, sizeof(nCount)) < 0) { }
+
+                        continue;
+                    }
+
+                    /* Skip over events for slots that were removed. */
+                    if(nIndex >= CONNECTIONS->size())
+                        continue;
+
+                    /* The epoll event bits have the same values as poll on linux. */
+                    process_connection(nIndex, static_cast<int16_t>(vEvents[n].events & (EPOLLIN | EPOLLERR | EPOLLHUP)));
+                    if(pending_connection(nIndex))
+                        vPending.push_back(nIndex);
+                }
+
+                /* Check all connections periodically, so that timeouts and generic events still run for idle sockets. */
+                if(tSweep.ElapsedMilliseconds() >= 100)
+                {
+                    const uint32_t nSize = static_cast<uint32_t>(CONNECTIONS->size());
+                    for(uint32_t nIndex = 0; nIndex < nSize; ++nIndex)
+                        process_connection(nIndex, 0);
+
+                    tSweep.Reset();
+                }
+
+                continue;
+            }
+
+#endif
+
             /* Wrapped mutex lock. */
             const uint32_t nSize = static_cast<uint32_t>(CONNECTIONS->size());
 
@@ -274,126 +404,7 @@ namespace LLP
 
             /* Check all connections for data and packets. */
             for(uint32_t nIndex = 0; nIndex < nSize; ++nIndex)
-            {
-                /* Access the shared pointer. */
-                std::shared_ptr<ProtocolType> CONNECTION = CONNECTIONS->at(nIndex);
-                try
-                {
-                    /* Skip over Inactive Connections. */
-                    if(!CONNECTION || !CONNECTION->Connected())
-                        continue;
-
-                    /* Disconnect if there was a polling error */
-                    if(POLLFDS.at(nIndex).revents & POLLERR)
-                    {
-                         remove_connection_with_event(nIndex, DISCONNECT::POLL_ERROR);
-                         continue;
-                    }
-
-                    /* Disconnect if the socket was disconnected by peer (need for Windows) */
-                    if(POLLFDS.at(nIndex).revents & POLLHUP)
-                    {
-                        remove_connection_with_event(nIndex, DISCONNECT::PEER);
-                        continue;
-                    }
-
-                    /* Remove Connection if it has Timed out or had any read/write Errors. */
-                    if(CONNECTION->Errors())
-                    {
-                        remove_connection_with_event(nIndex, DISCONNECT::ERRORS);
-                        continue;
-                    }
-
-                    /* Remove Connection if it has Timed out or had any Errors. */
-                    if(CONNECTION->Timeout(TIMEOUT * 1000, Socket::READ))
-                    {
-                        remove_connection_with_event(nIndex, DISCONNECT::TIMEOUT);
-                        continue;
-                    }
-
-                    /* Disconnect if pollin signaled with no data for 1ms consistently (This happens on Linux). */
-                    if((POLLFDS.at(nIndex).revents & POLLIN)
-                    && CONNECTION->Timeout(nWait, Socket::READ)
-                    && CONNECTION->Available() == 0)
-                    {
-                        remove_connection_with_event(nIndex, DISCONNECT::POLL_EMPTY);
-                        continue;
-                    }
-
-                    /* Disconnect if buffer is full and remote host isn't reading at all. */
-                    if(CONNECTION->Buffered()
-                    && CONNECTION->Timeout(5000, Socket::WRITE))
-                    {
-                        remove_connection_with_event(nIndex, DISCONNECT::TIMEOUT_WRITE);
-                        continue;
-                    }
-
-                    /* Check that write buffers aren't overflowing with too much data. */
-                    if(CONNECTION->Buffered() > config::GetArg("-maxsendbuffer", MAX_SEND_BUFFER))
-                    {
-                        remove_connection_with_event(nIndex, DISCONNECT::BUFFER);
-                        continue;
-                    }
-
-                    /* Generic event for Connection. */
-                    CONNECTION->Event(EVENTS::GENERIC);
-
-                    /* Work on Reading a Packet. **/
-                    CONNECTION->ReadPacket();
-
-                    /* Handle any DDOS Filters. */
-                    if(fDDOS.load() && CONNECTION->DDOS && !CONNECTION->addr.IsLocal())
-                    {
-                        /* Ban a node if it has too many Requests per Second. **/
-                        if(CONNECTION->DDOS->rSCORE.Score() > DDOS_rSCORE)
-                            CONNECTION->DDOS->Ban();
-
-                        /* Remove a connection if it was banned by DDOS Protection. */
-                        if(!CONNECTION->GetAddress().IsLocal() && CONNECTION->DDOS->Banned())
-                        {
-                            debug::log(0, ProtocolType::Name(), " BANNED: ", CONNECTION->GetAddress().ToString());
-                            remove_connection_with_event(nIndex, DISCONNECT::DDOS);
-                            continue;
-                        }
-                    }
-
-                    /* If a Packet was received successfully, increment request count [and DDOS count if enabled]. */
-                    if(CONNECTION->PacketComplete())
-                    {
-                        /* Debug dump of message type. */
-                        if(config::nVerbose.load() >= 4)
-                            debug::log(4, FUNCTION, "Received Message (", CONNECTION->INCOMING.GetBytes().size(), " bytes)");
-
-                        /* Debug dump of packet data. */
-                        if(config::nVerbose.load() >= 5)
-                            PrintHex(CONNECTION->INCOMING.GetBytes());
-
-                        /* Handle Meters and DDOS. */
-                        if(fMETER)
-                            ++ProtocolType::REQUESTS;
-
-                        /* Packet Process return value of False will flag Data Thread to Disconnect. */
-                        if(!CONNECTION->ProcessPacket())
-                        {
-                            remove_connection_with_event(nIndex, DISCONNECT::FORCE);
-                            continue;
-                        }
-
-                        /* Increment rScore. */
-                        if(fDDOS.load() && CONNECTION->DDOS)
-                            CONNECTION->DDOS->rSCORE += 1;
-
-                        /* Run procssed event for connection triggers. */
-                        CONNECTION->Event(EVENTS::PROCESSED);
-                        CONNECTION->ResetPacket();
-                    }
-                }
-                catch(const std::exception& e)
-                {
-                    debug::error(FUNCTION, "Data Connection: ", e.what());
-                    remove_connection_with_event(nIndex, DISCONNECT::ERRORS);
-                }
-            }
+                process_connection(nIndex, POLLFDS.at(nIndex).revents);
         }
     }
 
@@ -471,12 +482,16 @@ namespace LLP
             /* Grab data from queue. */
             if(!RELAY->empty())
             {
-                /* Make a copy of the relay data. */
-                qRelay = RELAY->front();
+                /* Take the relay data, only this thread pops so the front stays valid. */
+                qRelay = std::move(RELAY->front());
                 RELAY->pop();
             }
 
+            /* Packets built for this relay by the ranges each filter kept, so connections with the same outcome share one buffer. */
+            std::vector<std::pair<std::vector<std::pair<uint64_t, uint64_t>>, shared_bytes_t>> vPackets;
+
             /* Check all connections for data and packets. */
+            std::vector<std::pair<uint64_t, uint64_t>> vRanges;
             uint32_t nSize = CONNECTIONS->size();
             for(uint32_t nIndex = 0; nIndex < nSize; ++nIndex)
             {
@@ -493,15 +508,45 @@ namespace LLP
                         continue;
 
                     /* Relay if there are active subscriptions. */
-                    const DataStream ssRelay = CONNECTION->RelayFilter(qRelay.first, qRelay.second);
-                    if(ssRelay.size() != 0)
+                    vRanges.clear();
+                    CONNECTION->RelayFilter(qRelay.first, qRelay.second, vRanges);
+                    if(!vRanges.empty())
                     {
-                        /* Build the sender packet. */
-                        typename ProtocolType::packet_t PACKET = typename ProtocolType::packet_t(qRelay.first);
-                        PACKET.SetData(ssRelay);
+                        /* Check for a packet that was already built for this outcome. */
+                        shared_bytes_t pPacket;
+                        for(const auto& prPacket : vPackets)
+                        {
+                            if(prPacket.first == vRanges)
+                            {
+                                pPacket = prPacket.second;
+                                break;
+                            }
+                        }
+
+                        /* Build and serialize the sender packet once. */
+                        if(!pPacket)
+                        {
+                            typename ProtocolType::packet_t PACKET = typename ProtocolType::packet_t(qRelay.first);
+
+                            /* Pass the relay data straight through when the filter kept all of it. */
+                            if(vRanges.size() == 1 && vRanges[0].first == 0 && vRanges[0].second == qRelay.second.size())
+                                PACKET.SetData(qRelay.second);
+                            else
+                            {
+                                /* Gather the ranges that were kept. */
+                                DataStream ssRelay(SER_NETWORK, MIN_PROTO_VERSION);
+                                for(const auto& prRange : vRanges)
+                                    ssRelay.write((char*)&qRelay.second.Bytes()[prRange.first], prRange.second - prRange.first);
+
+                                PACKET.SetData(ssRelay);
+                            }
+
+                            pPacket = std::make_shared<const std::vector<uint8_t>>(PACKET.GetBytes());
+                            vPackets.push_back(std::make_pair(vRanges, pPacket));
+                        }
 
-                        /* Write packet to socket. */
-                        CONNECTION->WritePacket(PACKET);
+                        /* Queue packet on socket by pointer. */
+                        CONNECTION->WritePacket(pPacket);
                     }
 
                     /* Attempt to flush data when buffer is available. */
@@ -531,7 +576,12 @@ namespace LLP
                 try { CONNECTION->NotifyEvent(); }
                 catch(const std::exception& e) { }
             }
+
+            ++ITT;
         }
+
+        /* Wake up our data thread to handle the event. */
+        wake_thread();
     }
 
 
@@ -602,12 +652,196 @@ namespace LLP
         else
             --nOutbound;
 
+        /* Stop watching for ready events. */
+        unwatch_connection(nIndex);
+
         /* Free the memory and notify threads. */
         CONNECTIONS->at(nIndex) = nullptr;
         CONDITION.notify_all();
     }
 
 
+    /* Check a connection for errors and timeouts, and read and process its packets. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::process_connection(const uint32_t nIndex, const int16_t nEvents)
+    {
+        /* Cache wait time if applicable. */
+        static const uint32_t nWait = config::GetArg("-llpwait", 1);
+
+        /* Access the shared pointer. */
+        std::shared_ptr<ProtocolType> CONNECTION = CONNECTIONS->at(nIndex);
+        try
+        {
+            /* Skip over Inactive Connections. */
+            if(!CONNECTION || !CONNECTION->Connected())
+                return;
+
+            /* Disconnect if there was a polling error */
+            if(nEvents & POLLERR)
+            {
+                 remove_connection_with_event(nIndex, DISCONNECT::POLL_ERROR);
+                 return;
+            }
+
+            /* Disconnect if the socket was disconnected by peer (need for Windows) */
+            if(nEvents & POLLHUP)
+            {
+                remove_connection_with_event(nIndex, DISCONNECT::PEER);
+                return;
+            }
+
+            /* Remove Connection if it has Timed out or had any read/write Errors. */
+            if(CONNECTION->Errors())
+            {
+                remove_connection_with_event(nIndex, DISCONNECT::ERRORS);
+                return;
+            }
+
+            /* Remove Connection if it has Timed out or had any Errors. */
+            if(CONNECTION->Timeout(TIMEOUT * 1000, Socket::READ))
+            {
+                remove_connection_with_event(nIndex, DISCONNECT::TIMEOUT);
+                return;
+            }
+
+            /* Disconnect if pollin signaled with no data for 1ms consistently (This happens on Linux). */
+            if((nEvents & POLLIN)
+            && CONNECTION->Timeout(nWait, Socket::READ)
+            && CONNECTION->Available() == 0)
+            {
+                remove_connection_with_event(nIndex, DISCONNECT::POLL_EMPTY);
+                return;
+            }
+
+            /* Disconnect if buffer is full and remote host isn't reading at all. */
+            if(CONNECTION->Buffered()
+            && CONNECTION->Timeout(5000, Socket::WRITE))
+            {
+                remove_connection_with_event(nIndex, DISCONNECT::TIMEOUT_WRITE);
+                return;
+            }
+
+            /* Check that write buffers aren't overflowing with too much data. */
+            if(CONNECTION->Buffered() > config::GetArg("-maxsendbuffer", MAX_SEND_BUFFER))
+            {
+                remove_connection_with_event(nIndex, DISCONNECT::BUFFER);
+                return;
+            }
+
+            /* Generic event for Connection. */
+            CONNECTION->Event(EVENTS::GENERIC);
+
+            /* Work on Reading a Packet. **/
+            CONNECTION->ReadPacket();
+
+            /* Handle any DDOS Filters. */
+            if(fDDOS.load() && CONNECTION->DDOS && !CONNECTION->addr.IsLocal())
+            {
+                /* Ban a node if it has too many Requests per Second. **/
+                if(CONNECTION->DDOS->rSCORE.Score() > DDOS_rSCORE)
+                    CONNECTION->DDOS->Ban();
+
+                /* Remove a connection if it was banned by DDOS Protection. */
+                if(!CONNECTION->GetAddress().IsLocal() && CONNECTION->DDOS->Banned())
+                {
+                    debug::log(0, ProtocolType::Name(), " BANNED: ", CONNECTION->GetAddress().ToString());
+                    remove_connection_with_event(nIndex, DISCONNECT::DDOS);
+                    return;
+                }
+            }
+
+            /* If a Packet was received successfully, increment request count [and DDOS count if enabled]. */
+            if(CONNECTION->PacketComplete())
+            {
+                /* Debug dump of message type. */
+                if(config::nVerbose.load() >= 4)
+                    debug::log(4, FUNCTION, "Received Message (", CONNECTION->INCOMING.GetBytes().size(), " bytes)");
+
+                /* Debug dump of packet data. */
+                if(config::nVerbose.load() >= 5)
+                    PrintHex(CONNECTION->INCOMING.GetBytes());
+
+                /* Handle Meters and DDOS. */
+                if(fMETER)
+                    ++ProtocolType::REQUESTS;
+
+                /* Packet Process return value of False will flag Data Thread to Disconnect. */
+                if(!CONNECTION->ProcessPacket())
+                {
+                    remove_connection_with_event(nIndex, DISCONNECT::FORCE);
+                    return;
+                }
+
+                /* Increment rScore. */
+                if(fDDOS.load() && CONNECTION->DDOS)
+                    CONNECTION->DDOS->rSCORE += 1;
+
+                /* Run procssed event for connection triggers. */
+                CONNECTION->Event(EVENTS::PROCESSED);
+                CONNECTION->ResetPacket();
+            }
+        }
+        catch(const std::exception& e)
+        {
+            debug::error(FUNCTION, "Data Connection: ", e.what());
+            remove_connection_with_event(nIndex, DISCONNECT::ERRORS);
+        }
+    }
+
+
+    /* Check if a connection has bytes already read into its SSL buffer, which won't be reported as ready again. */
+    template <class ProtocolType>
+    bool DataThread<ProtocolType>::pending_connection(const uint32_t nIndex)
+    {
+        /* Access the shared pointer. */
+        std::shared_ptr<ProtocolType> CONNECTION = CONNECTIONS->at(nIndex);
+        if(!CONNECTION || !CONNECTION->Connected() || !CONNECTION->IsSSL())
+            return false;
+
+        return CONNECTION->Available() > 0;
+    }
+
+
+    /* Register a connection's socket to wake our data thread when it is ready. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::watch_connection(const uint32_t nIndex)
+    {
+        /* Access the shared pointer. */
+        std::shared_ptr<ProtocolType> CONNECTION = CONNECTIONS->at(nIndex);
+        if(CONNECTION)
+            CONNECTION->Watch(nEpollFD, nIndex);
+
+        /* Wake up our data thread for the new connection. */
+        wake_thread();
+    }
+
+
+    /* Remove a connection's socket from our ready events. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::unwatch_connection(const uint32_t nIndex)
+    {
+        /* Access the shared pointer. */
+        std::shared_ptr<ProtocolType> CONNECTION = CONNECTIONS->at(nIndex);
+        if(CONNECTION)
+            CONNECTION->Unwatch();
+    }
+
+
+    /* Wake up our data thread if it is waiting for ready sockets. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::wake_thread()
+    {
+#ifdef __linux__
+        /* Signal our wakeup descriptor. */
+        if(nEventFD >= 0)
+        {
+            const uint64_t nCount = 1;
+            if(write(nEventFD, &nCount, sizeof(nCount)) < 0) { }
+        }
+#endif
+    }
+
+
     /* Returns the index of a component of the CONNECTIONS vector that has been flagged Disconnected */
     template <class ProtocolType>
     uint32_t DataThread<ProtocolType>::find_slot()
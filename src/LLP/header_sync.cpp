@@ -0,0 +1,422 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/include/global.h>
+
+#include <LLP/include/header_sync.h>
+
+#include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/include/process.h>
+#include <TAO/Ledger/include/timelocks.h>
+#include <TAO/Ledger/types/client.h>
+#include <TAO/Ledger/types/state.h>
+
+#include <Util/include/args.h>
+#include <Util/include/debug.h>
+#include <Util/include/mutex.h>
+#include <Util/include/runtime.h>
+
+namespace LLP
+{
+    /* The total windows that can be requested ahead of our best chain. */
+    const uint32_t MAX_WINDOWS_AHEAD = 16;
+
+
+    /* The total recent headers kept to find which nodes are on our headers chain. */
+    const uint32_t MAX_RECENT_HEADERS = 4096;
+
+
+    /* Get the total blocks in each window, set by -syncwindow. */
+    static uint32_t window_size()
+    {
+        static const uint32_t nWindowSize = std::max(1u, uint32_t(config::GetArg("-syncwindow", 128)));
+        return nWindowSize;
+    }
+
+
+    /* Get the seconds to wait for a window before requesting it from another node, set by -synctimeout. */
+    static uint64_t window_timeout()
+    {
+        static const uint64_t nTimeout = std::max(1u, uint32_t(config::GetArg("-synctimeout", 30)));
+        return nTimeout;
+    }
+
+
+    /* Check a header on its own, since we don't have the blocks before it to check it against. */
+    static bool check_header(const TAO::Ledger::ClientBlock& block, const uint64_t nPrevTime)
+    {
+        /* Check the timestamp is after the previous header. */
+        if(block.GetBlockTime() <= nPrevTime)
+            return debug::error(FUNCTION, "header timestamp too early");
+
+        /* Check that the time was within range. */
+        if(block.GetBlockTime() > runtime::unifiedtimestamp() + runtime::maxdrift())
+            return debug::error(FUNCTION, "header timestamp too far in the future");
+
+        /* Make sure the header was created within an active channel. */
+        if(block.GetChannel() > (config::fHybrid.load() ? 3 : 2))
+            return debug::error(FUNCTION, "channel out of range");
+
+        /* Check the current version block time-lock. */
+        if(!TAO::Ledger::BlockVersionActive(block.GetBlockTime(), block.nVersion))
+            return debug::error(FUNCTION, "header created with invalid version");
+
+        /* Check the network launch and channel time-locks. */
+        if(!TAO::Ledger::NetworkActive(block.GetBlockTime()) || !TAO::Ledger::ChannelActive(block.GetBlockTime(), block.GetChannel()))
+            return debug::error(FUNCTION, "header created before time-lock");
+
+        /* Proof of stake specific checks. */
+        if(block.IsProofOfStake())
+        {
+            /* Check for nonce of zero values. */
+            if(block.nNonce == 0)
+                return debug::error(FUNCTION, "proof of stake can't have Nonce value of zero");
+        }
+
+        /* Proof of work specific checks. */
+        else if(block.IsProofOfWork())
+        {
+            /* Check for prime offsets. */
+            if(block.GetChannel() == TAO::Ledger::CHANNEL::PRIME && block.vOffsets.empty())
+                return debug::error(FUNCTION, "prime header requires valid offsets");
+
+            /* Check that other channels do not have offsets. */
+            if(block.GetChannel() != TAO::Ledger::CHANNEL::PRIME && !block.vOffsets.empty())
+                return debug::error(FUNCTION, "offsets included in non prime header");
+
+            /* Check the proof of work claims, so windows are only planned on headers that did the work. */
+            if(!block.VerifyWork())
+                return debug::error(FUNCTION, "invalid proof of work");
+        }
+
+        return true;
+    }
+
+
+    /* Mutex to protect our windows. */
+    std::mutex HeaderSync::MUTEX;
+
+
+    /* The windows from our best chain to our last header, in order. */
+    std::deque<HeaderSync::Window> HeaderSync::qWindows;
+
+
+    /* The sessions that were given windows, so their blocks aren't treated as unsolicited. */
+    std::set<uint64_t> HeaderSync::setSessions;
+
+
+    /* The last header we received. */
+    uint1024_t HeaderSync::hashLastHeader;
+
+
+    /* The height of the last header we received. */
+    uint32_t HeaderSync::nLastHeight = 0;
+
+
+    /* The timestamp of the last header we received. */
+    uint64_t HeaderSync::nLastTime = 0;
+
+
+    /* The most recent headers we received, in order. */
+    std::deque<uint1024_t> HeaderSync::qRecent;
+
+
+    /* The heights of our most recent headers by hash. */
+    std::map<uint1024_t, uint32_t> HeaderSync::mapRecent;
+
+
+    /* Flag to track if a headers first sync is running. */
+    std::atomic<bool> HeaderSync::fActive(false);
+
+
+    /* Flag to track if the sync node has sent all of its headers. */
+    std::atomic<bool> HeaderSync::fComplete(false);
+
+
+    /* Check if headers first sync was enabled with -headersync. */
+    bool HeaderSync::Enabled()
+    {
+        return config::GetBoolArg("-headersync", false) && !config::fClient.load();
+    }
+
+
+    /* Check if a headers first sync is running. */
+    bool HeaderSync::Active()
+    {
+        return fActive.load();
+    }
+
+
+    /* Check if the sync node has sent all of its headers. */
+    bool HeaderSync::Complete()
+    {
+        return fComplete.load();
+    }
+
+
+    /* Start a headers first sync from our best chain, or keep our current one if it is already running. */
+    void HeaderSync::Start()
+    {
+        LOCK(MUTEX);
+
+        /* Keep our headers when switching sync nodes. */
+        if(fActive.load())
+        {
+            /* Ask the new sync node for any headers we are missing. */
+            fComplete.store(false);
+            return;
+        }
+
+        /* Start our headers from our best chain. */
+        const TAO::Ledger::BlockState stateBest = TAO::Ledger::ChainState::tStateBest.load();
+        hashLastHeader = stateBest.GetHash();
+        nLastHeight    = stateBest.nHeight;
+        nLastTime      = stateBest.GetBlockTime();
+
+        qWindows.clear();
+        setSessions.clear();
+        qRecent.clear();
+        mapRecent.clear();
+
+        fComplete.store(false);
+        fActive.store(true);
+
+        debug::log(0, FUNCTION, "Headers first sync started at height ", nLastHeight);
+    }
+
+
+    /* Stop a headers first sync and clear our windows. */
+    bool HeaderSync::Stop()
+    {
+        LOCK(MUTEX);
+
+        qWindows.clear();
+        setSessions.clear();
+        qRecent.clear();
+        mapRecent.clear();
+
+        fComplete.store(false);
+        return fActive.exchange(false);
+    }
+
+
+    /* Get the last header that was received. */
+    uint1024_t HeaderSync::LastHeader()
+    {
+        LOCK(MUTEX);
+        return hashLastHeader;
+    }
+
+
+    /* Add the next header from the sync node, which must connect to the last header received. */
+    bool HeaderSync::Header(const TAO::Ledger::ClientBlock& block)
+    {
+        LOCK(MUTEX);
+
+        /* Check that we are syncing. */
+        if(!fActive.load())
+            return false;
+
+        /* Lists start from the last header we asked from, so skip it. */
+        const uint1024_t hashBlock = block.GetHash();
+        if(hashBlock == hashLastHeader)
+            return true;
+
+        /* Check that this header connects to our last one. */
+        if(block.hashPrevBlock != hashLastHeader)
+        {
+            /* The sync node can start us from an earlier common ancestor when we are on a fork. */
+            TAO::Ledger::BlockState statePrev;
+            if(!qWindows.empty() || !LLD::Ledger->ReadBlock(block.hashPrevBlock, statePrev))
+                return debug::error(FUNCTION, "header ", hashBlock.SubString(), " doesn't connect to ", hashLastHeader.SubString());
+
+            nLastHeight = statePrev.nHeight;
+            nLastTime   = statePrev.GetBlockTime();
+
+            qRecent.clear();
+            mapRecent.clear();
+        }
+
+        /* Check our heights are sequential. */
+        if(block.nHeight != nLastHeight + 1)
+            return debug::error(FUNCTION, "header ", hashBlock.SubString(), " height ", block.nHeight, " expected ", nLastHeight + 1);
+
+        /* Check the header before we plan any windows on it. */
+        if(!check_header(block, nLastTime))
+            return debug::error(FUNCTION, "header ", hashBlock.SubString(), " failed checks");
+
+        /* Set this as our last header. */
+        hashLastHeader = hashBlock;
+        nLastHeight    = block.nHeight;
+        nLastTime      = block.GetBlockTime();
+
+        /* Keep our recent headers, so nodes announcing them can be given windows. */
+        qRecent.push_back(hashBlock);
+        mapRecent[hashBlock] = block.nHeight;
+        if(qRecent.size() > MAX_RECENT_HEADERS)
+        {
+            mapRecent.erase(qRecent.front());
+            qRecent.pop_front();
+        }
+
+        /* Skip over blocks we already have, only before our first window. */
+        if(qWindows.empty() && LLD::Ledger->HasBlock(hashBlock))
+            return true;
+
+        /* Start a new window if our last one is full. */
+        if(qWindows.empty() || qWindows.back().nBlocks >= window_size())
+            qWindows.push_back({block.hashPrevBlock, hashBlock, hashBlock, block.nHeight, 0, 0, 0});
+
+        /* Add to our last window. */
+        Window& window = qWindows.back();
+        window.hashStop = hashBlock;
+        window.nHeight  = block.nHeight;
+        ++window.nBlocks;
+
+        return true;
+    }
+
+
+    /* Flag that the sync node has sent all of its headers, closing the last window. */
+    void HeaderSync::SetComplete()
+    {
+        LOCK(MUTEX);
+
+        /* Check that we are syncing. */
+        if(!fActive.load())
+            return;
+
+        /* Log once per sync. */
+        if(!fComplete.exchange(true))
+            debug::log(0, FUNCTION, "Received headers to height ", nLastHeight, ", ", qWindows.size(), " windows to download");
+    }
+
+
+    /* Give the next window to a node, if that node has no window outstanding and has the blocks for it. */
+    bool HeaderSync::Request(const uint64_t nSession, const uint1024_t& hashBest, uint1024_t &hashStart, uint1024_t &hashStop)
+    {
+        LOCK(MUTEX);
+
+        /* Check that we are syncing. */
+        if(!fActive.load())
+            return false;
+
+        /* Get the height this node has of our headers chain, our sync node sent us all of them. */
+        uint32_t nHeight = nLastHeight;
+        if(nSession != TAO::Ledger::nSyncSession.load())
+        {
+            /* Other nodes must have announced a best chain in our recent headers, so they have every window before it. */
+            const auto itRecent = mapRecent.find(hashBest);
+            if(itRecent == mapRecent.end())
+                return false;
+
+            nHeight = itRecent->second;
+        }
+
+        /* Remove the windows that have been connected to our best chain. */
+        const uint32_t nWindowSize = window_size();
+        const uint32_t nBestHeight = TAO::Ledger::ChainState::nBestHeight.load();
+        while(!qWindows.empty() && qWindows.front().nHeight <= nBestHeight
+            && (qWindows.front().nBlocks >= nWindowSize || fComplete.load()))
+            qWindows.pop_front();
+
+        /* Check that this node isn't still sending a window. */
+        const uint64_t nTimeout   = window_timeout();
+        const uint64_t nTimestamp = runtime::timestamp();
+        for(const auto& window : qWindows)
+        {
+            if(window.nSession == nSession && window.nRequested + nTimeout >= nTimestamp)
+                return false;
+        }
+
+        /* Find the first window that isn't outstanding. */
+        for(auto& window : qWindows)
+        {
+            /* Stop at the windows that are too far ahead of our best chain. */
+            if(window.nHeight > nBestHeight + (MAX_WINDOWS_AHEAD * nWindowSize))
+                break;
+
+            /* Stop at our last window if it is still filling with headers. */
+            if(window.nBlocks < nWindowSize && !fComplete.load())
+                break;
+
+            /* Skip over windows that are outstanding. */
+            if(window.nSession != 0 && window.nRequested + nTimeout >= nTimestamp)
+                continue;
+
+            /* Skip over windows this node doesn't have yet. */
+            if(window.nHeight > nHeight)
+                continue;
+
+            /* Check for a window that timed out. */
+            if(window.nSession != 0)
+                debug::log(1, FUNCTION, "window at height ", window.nHeight, " timed out, requesting again");
+
+            /* Give this window to our node. */
+            window.nSession   = nSession;
+            window.nRequested = nTimestamp;
+            setSessions.insert(nSession);
+
+            /* Lists stop as soon as they start on their stop block, so ask from the previous block for windows of one block. */
+            hashStart = (window.nBlocks == 1 ? window.hashPrev : window.hashStart);
+            hashStop  = window.hashStop;
+
+            return true;
+        }
+
+        return false;
+    }
+
+
+    /* Check if a node was given windows during this sync. */
+    bool HeaderSync::Requested(const uint64_t nSession)
+    {
+        LOCK(MUTEX);
+        return setSessions.count(nSession);
+    }
+
+
+    /* Release the windows given to a node so they are requested from others, used on disconnect. */
+    void HeaderSync::Release(const uint64_t nSession)
+    {
+        LOCK(MUTEX);
+
+        /* Reset any windows that were given to this node. */
+        for(auto& window : qWindows)
+        {
+            if(window.nSession == nSession)
+            {
+                window.nSession   = 0;
+                window.nRequested = 0;
+            }
+        }
+
+        setSessions.erase(nSession);
+    }
+
+
+    /* Check if all headers were received and our best chain reached the last of them. */
+    bool HeaderSync::Finished()
+    {
+        /* Check that the sync node sent all of its headers. */
+        if(!fActive.load() || !fComplete.load())
+            return false;
+
+        /* Check that our best chain reached our last header. */
+        if(TAO::Ledger::ChainState::hashBestChain.load() != LastHeader())
+            return false;
+
+        return Stop();
+    }
+}
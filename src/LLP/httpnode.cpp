@@ -18,9 +18,42 @@ ________________________________________________________________________________
 #include <Util/include/string.h>
 
 #include <algorithm>
+#include <cctype>
+#include <limits>
 
 namespace LLP
 {
+    /* The largest chunk we accept, so a chunk size can't overflow our offsets into the read buffer. */
+    const uint64_t MAX_CHUNK_SIZE = 1024 * 1024 * 16;
+
+
+    /* Parse the size in hex from a chunk size line, ignoring any extensions. */
+    static bool chunk_size(const std::string& strLine, uint64_t &nSize)
+    {
+        /* Get the size without extensions or its CLRF. */
+        std::string strSize = strLine.substr(0, strLine.find(';'));
+        while(!strSize.empty() && (strSize.back() == '\r' || strSize.back() == ' ' || strSize.back() == '\t'))
+            strSize.pop_back();
+
+        /* Check that we have a size at all. */
+        if(strSize.empty())
+            return false;
+
+        /* Parse each digit, stopping as soon as our size is over our maximum. */
+        nSize = 0;
+        for(const char chDigit : strSize)
+        {
+            if(!std::isxdigit(static_cast<uint8_t>(chDigit)))
+                return false;
+
+            nSize = (nSize << 4) | (std::isdigit(static_cast<uint8_t>(chDigit)) ? chDigit - '0' : std::tolower(chDigit) - 'a' + 10);
+            if(nSize > MAX_CHUNK_SIZE)
+                return false;
+        }
+
+        return true;
+    }
+
 
     /** Default Constructor **/
     HTTPNode::HTTPNode()
@@ -84,6 +117,62 @@ namespace LLP
             /* Allow up to 10 iterations to parse the header. */
             for(int i = 0; i < 10; ++i)
             {
+                /* Decode chunks of content as they arrive. */
+                if(INCOMING.fHeader && INCOMING.fChunked)
+                {
+                    /* Find the end of the chunk size line. */
+                    auto it = std::find(vchBuffer.begin(), vchBuffer.end(), '\n');
+                    if(it == vchBuffer.end())
+                        return;
+
+                    /* Parse the size in hex, rejecting sizes over our maximum before we use them. */
+                    uint64_t nSize = 0;
+                    if(!chunk_size(std::string(vchBuffer.begin(), it), nSize)
+                    || INCOMING.strContent.size() + nSize > std::numeric_limits<uint32_t>::max())
+                    {
+                        debug::error(FUNCTION, "invalid chunk size");
+
+                        DoS(25, false);
+                        Disconnect();
+
+                        return;
+                    }
+
+                    /* The last chunk is followed by optional trailers and an empty line. */
+                    if(nSize == 0)
+                    {
+                        /* Erase trailers line by line until we reach the empty line. */
+                        auto itLine = std::find(it + 1, vchBuffer.end(), '\n');
+                        while(itLine != vchBuffer.end() && (itLine - it) > 2)
+                        {
+                            it     = itLine;
+                            itLine = std::find(it + 1, vchBuffer.end(), '\n');
+                        }
+
+                        /* Wait for the rest of the trailers. */
+                        if(itLine == vchBuffer.end())
+                            return;
+
+                        /* Our content is now complete. */
+                        INCOMING.nContentLength = INCOMING.strContent.size();
+                        INCOMING.fChunked = false;
+
+                        vchBuffer.erase(vchBuffer.begin(), itLine + 1);
+                        return;
+                    }
+
+                    /* Wait until we have the whole chunk and its CLRF. */
+                    const uint64_t nStart = (it - vchBuffer.begin()) + 1;
+                    if(vchBuffer.size() < nStart + nSize + 2)
+                        return;
+
+                    /* Add the chunk to our content. */
+                    INCOMING.strContent.append(vchBuffer.begin() + nStart, vchBuffer.begin() + nStart + nSize);
+                    vchBuffer.erase(vchBuffer.begin(), vchBuffer.begin() + nStart + nSize + 2);
+
+                    continue;
+                }
+
                 /* Read content if there is some. */
                 if(INCOMING.fHeader)
                 {
@@ -104,6 +193,10 @@ namespace LLP
                 {
                     INCOMING.fHeader = true;
 
+                    /* Check if the content will follow in chunks. */
+                    if(INCOMING.mapHeaders.count("transfer-encoding"))
+                        INCOMING.fChunked = (ToLower(INCOMING.mapHeaders["transfer-encoding"]).find("chunked") != std::string::npos);
+
                     vchBuffer.erase(vchBuffer.begin(), it + 1); //erase the CLRF
 
                     /* Fire off header event. */
@@ -162,6 +255,31 @@ namespace LLP
     }
 
 
+    /* Write a chunk of content for a response sent with chunked transfer encoding. */
+    bool HTTPNode::WriteChunk(const std::string& strChunk)
+    {
+        /* Build the chunk with its size in hex, where an empty chunk is the last one. */
+        const std::string strSize = debug::safe_printstr(std::hex, strChunk.size(), "\r\n");
+
+        std::vector<uint8_t> vBytes;
+        vBytes.reserve(strSize.size() + strChunk.size() + 2);
+        vBytes.insert(vBytes.end(), strSize.begin(), strSize.end());
+        vBytes.insert(vBytes.end(), strChunk.begin(), strChunk.end());
+
+        /* Each chunk ends with a CLRF, which for the last chunk ends our empty trailers. */
+        vBytes.insert(vBytes.end(), { '\r', '\n' });
+
+        /* A dropped chunk would leave a hole in our content, so let our caller know to stop. */
+        if(!this->WritePacket(std::make_shared<const std::vector<uint8_t>>(std::move(vBytes))))
+            return false;
+
+        /* Send what we can now, so the client can read while we build the next chunk. */
+        this->Flush();
+
+        return true;
+    }
+
+
     /* Returns an HTTP packet with response code and content. */
     void HTTPNode::PushResponse(const uint16_t nMsg, const std::string& strContent)
     {
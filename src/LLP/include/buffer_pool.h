@@ -0,0 +1,102 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLP_INCLUDE_BUFFER_POOL_H
+#define NEXUS_LLP_INCLUDE_BUFFER_POOL_H
+
+#include <cstdint>
+#include <vector>
+
+namespace LLP
+{
+
+    /** BufferPool
+     *
+     *  Pool of receive buffers, kept in power of two size classes so a packet can be read straight into a buffer
+     *  that was sized for it when its header arrived. Each data thread has its own pool, so buffers are taken and
+     *  returned without locking, and are shared between all of the connections on that thread.
+     *
+     **/
+    class BufferPool
+    {
+    public:
+
+        /** The smallest buffer that is pooled, smaller buffers are cheaper to allocate than to keep. **/
+        static const uint32_t MIN_SIZE = 512;
+
+
+        /** The largest buffer that is pooled, which is also the largest packet we accept. **/
+        static const uint32_t MAX_SIZE = 1024 * 1024 * 2;
+
+
+    private:
+
+        /** The total size classes from MIN_SIZE to MAX_SIZE. **/
+        static const uint32_t CLASSES = 13;
+
+
+        /** The free buffers for each size class. **/
+        std::vector<std::vector<uint8_t>> vFree[CLASSES];
+
+
+        /** The total bytes held in free buffers. **/
+        uint64_t nPooled;
+
+
+    public:
+
+        /** Default Constructor. **/
+        BufferPool();
+
+
+        /** Local
+         *
+         *  Get the pool for the calling thread.
+         *
+         **/
+        static BufferPool& Local();
+
+
+        /** Get
+         *
+         *  Get an empty buffer with room for a given number of bytes, from the pool if one is free.
+         *
+         *  @param[in] nSize The total bytes the buffer needs to hold, capped at MAX_SIZE.
+         *
+         *  @return an empty buffer with at least nSize bytes reserved.
+         *
+         **/
+        std::vector<uint8_t> Get(const uint32_t nSize);
+
+
+        /** Release
+         *
+         *  Return a buffer to the pool, or free it if the pool is full. The buffer is left empty.
+         *
+         *  @param[in] vBuffer The buffer to return.
+         *
+         **/
+        void Release(std::vector<uint8_t>& vBuffer);
+
+
+        /** Pooled
+         *
+         *  Get the total bytes held in free buffers.
+         *
+         **/
+        uint64_t Pooled() const;
+    };
+}
+
+#endif
@@ -0,0 +1,233 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLP_INCLUDE_HEADER_SYNC_H
+#define NEXUS_LLP_INCLUDE_HEADER_SYNC_H
+
+#include <LLC/types/uint1024.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+
+/* Forward declarations. */
+namespace TAO::Ledger { class ClientBlock; }
+
+namespace LLP
+{
+
+    /** HeaderSync
+     *
+     *  Tracks a headers first synchronization. Block headers are listed from the sync node ahead of their bodies,
+     *  and split into windows of consecutive blocks that are downloaded from every connected node in parallel.
+     *  Blocks that arrive ahead of their parents are held as orphans, and connected in order as the gaps fill.
+     *
+     **/
+    class HeaderSync
+    {
+        /** Window
+         *
+         *  A range of consecutive blocks to be downloaded from one node.
+         *
+         **/
+        struct Window
+        {
+            /** The block before this window. **/
+            uint1024_t hashPrev;
+
+            /** The first block in this window. **/
+            uint1024_t hashStart;
+
+            /** The last block in this window. **/
+            uint1024_t hashStop;
+
+            /** The height of the last block in this window. **/
+            uint32_t nHeight;
+
+            /** The total blocks in this window. **/
+            uint32_t nBlocks;
+
+            /** The session this window was requested from, 0 if not requested. **/
+            uint64_t nSession;
+
+            /** The time this window was requested. **/
+            uint64_t nRequested;
+        };
+
+
+        /** Mutex to protect our windows. **/
+        static std::mutex MUTEX;
+
+
+        /** The windows from our best chain to our last header, in order. **/
+        static std::deque<Window> qWindows;
+
+
+        /** The sessions that were given windows, so their blocks aren't treated as unsolicited. **/
+        static std::set<uint64_t> setSessions;
+
+
+        /** The last header we received. **/
+        static uint1024_t hashLastHeader;
+
+
+        /** The height of the last header we received. **/
+        static uint32_t nLastHeight;
+
+
+        /** The timestamp of the last header we received. **/
+        static uint64_t nLastTime;
+
+
+        /** The most recent headers we received, in order. **/
+        static std::deque<uint1024_t> qRecent;
+
+
+        /** The heights of our most recent headers by hash, to find which nodes are on our headers chain. **/
+        static std::map<uint1024_t, uint32_t> mapRecent;
+
+
+        /** Flag to track if a headers first sync is running. **/
+        static std::atomic<bool> fActive;
+
+
+        /** Flag to track if the sync node has sent all of its headers. **/
+        static std::atomic<bool> fComplete;
+
+
+    public:
+
+        /** Enabled
+         *
+         *  Check if headers first sync was enabled with -headersync.
+         *
+         **/
+        static bool Enabled();
+
+
+        /** Active
+         *
+         *  Check if a headers first sync is running.
+         *
+         **/
+        static bool Active();
+
+
+        /** Complete
+         *
+         *  Check if the sync node has sent all of its headers.
+         *
+         **/
+        static bool Complete();
+
+
+        /** Start
+         *
+         *  Start a headers first sync from our best chain, or keep our current one if it is already running.
+         *
+         **/
+        static void Start();
+
+
+        /** Stop
+         *
+         *  Stop a headers first sync and clear our windows.
+         *
+         *  @return true if a sync was running.
+         *
+         **/
+        static bool Stop();
+
+
+        /** LastHeader
+         *
+         *  Get the last header that was received, or our best chain if no headers were received yet.
+         *
+         **/
+        static uint1024_t LastHeader();
+
+
+        /** Header
+         *
+         *  Add the next header from the sync node, which must connect to the last header received, and pass the
+         *  checks that can be done without its block, including its proof of work.
+         *
+         *  @param[in] block The header to add.
+         *
+         *  @return true if the header was added.
+         *
+         **/
+        static bool Header(const TAO::Ledger::ClientBlock& block);
+
+
+        /** SetComplete
+         *
+         *  Flag that the sync node has sent all of its headers, closing the last window.
+         *
+         **/
+        static void SetComplete();
+
+
+        /** Request
+         *
+         *  Give the next window to a node, if that node has no window outstanding and has the blocks for it.
+         *  Windows are only given out a limited distance ahead of our best chain, so orphans stay bounded,
+         *  and windows that weren't received in time are given to the next node that asks. Nodes other than our
+         *  sync node are only given windows up to their best chain, which must be one of our recent headers.
+         *
+         *  @param[in] nSession The session of the node requesting a window.
+         *  @param[in] hashBest The best chain announced by the node.
+         *  @param[out] hashStart The first block to request.
+         *  @param[out] hashStop The last block to request.
+         *
+         *  @return true if a window was given.
+         *
+         **/
+        static bool Request(const uint64_t nSession, const uint1024_t& hashBest, uint1024_t &hashStart, uint1024_t &hashStop);
+
+
+        /** Requested
+         *
+         *  Check if a node was given windows during this sync.
+         *
+         *  @param[in] nSession The session of the node.
+         *
+         **/
+        static bool Requested(const uint64_t nSession);
+
+
+        /** Release
+         *
+         *  Release the windows given to a node so they are requested from others, used on disconnect.
+         *
+         *  @param[in] nSession The session of the node.
+         *
+         **/
+        static void Release(const uint64_t nSession);
+
+
+        /** Finished
+         *
+         *  Check if all headers were received and our best chain reached the last of them, stopping the sync
+         *  if so. Only returns true once per sync.
+         *
+         **/
+        static bool Finished();
+    };
+}
+
+#endif
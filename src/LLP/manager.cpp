@@ -40,7 +40,8 @@ namespace LLP
     , pDatabase(nullptr)
     , nPort(nPortIn)
     {
-        pDatabase = new LLD::AddressDB(nPortIn, LLD::FLAGS::CREATE | LLD::FLAGS::FORCE);
+        /* Buffer address writes so they are group committed off of our lock, since they are updated often. */
+        pDatabase = new LLD::AddressDB(nPortIn, LLD::FLAGS::CREATE | LLD::FLAGS::WRITE);
         if(!pDatabase)
             throw debug::exception(FUNCTION, "Failed to allocate memory for AddressManager");
     }
@@ -438,8 +439,8 @@ namespace LLP
             /* Update the Seed addresses. */
             AddSeedAddresses(config::fTestNet.load());
 
-            /* Write that DNS was updated. */
-            if(!pDatabase->WriteLastUpdate())
+            /* Write that DNS was updated, and sync with our seed addresses so a restart won't refresh them again. */
+            if(!pDatabase->WriteLastUpdate() || !pDatabase->Sync())
                 debug::error(FUNCTION, "failed to update DNS timer");
 
             /* Log the time it took to resolve DNS items. */
@@ -67,6 +67,10 @@ namespace LLP
         bool fHeader;
 
 
+        /* Flag for chunked transfer encoding, where the content follows the header in chunks. */
+        bool fChunked;
+
+
         /** Default Constructor **/
         HTTPPacket()
         : strType        ("")
@@ -76,6 +80,7 @@ namespace LLP
         , nContentLength (0)
         , strContent     ("")
         , fHeader        (false)
+        , fChunked       (false)
         {
         }
 
@@ -89,6 +94,7 @@ namespace LLP
         , nContentLength (packet.nContentLength)
         , strContent     (packet.strContent)
         , fHeader        (packet.fHeader)
+        , fChunked       (packet.fChunked)
         {
         }
 
@@ -102,6 +108,7 @@ namespace LLP
         , nContentLength (std::move(packet.nContentLength))
         , strContent     (std::move(packet.strContent))
         , fHeader        (std::move(packet.fHeader))
+        , fChunked       (std::move(packet.fChunked))
         {
         }
 
@@ -116,6 +123,7 @@ namespace LLP
             nContentLength = packet.nContentLength;
             strContent     = packet.strContent;
             fHeader        = packet.fHeader;
+            fChunked       = packet.fChunked;
 
             return *this;
         }
@@ -131,6 +139,7 @@ namespace LLP
             nContentLength = std::move(packet.nContentLength);
             strContent     = std::move(packet.strContent);
             fHeader        = std::move(packet.fHeader);
+            fChunked       = std::move(packet.fChunked);
 
             return *this;
         }
@@ -151,6 +160,7 @@ namespace LLP
         , nContentLength (0)
         , strContent     ("")
         , fHeader        (false)
+        , fChunked       (false)
         {
             SetStatus(nStatus);
         }
@@ -171,7 +181,8 @@ namespace LLP
             strContent = "";
             nContentLength = 0;
 
-            fHeader = false;
+            fHeader  = false;
+            fChunked = false;
         }
 
 
@@ -182,7 +193,7 @@ namespace LLP
          **/
         bool IsNull() const
         {
-            return strType == "" && strRequest == "" && strVersion == "" && mapHeaders.empty() && strContent == "" && !fHeader;
+            return strType == "" && strRequest == "" && strVersion == "" && mapHeaders.empty() && strContent == "" && !fHeader && !fChunked;
         }
 
 
@@ -193,6 +204,10 @@ namespace LLP
          **/
         bool Complete() const
         {
+            /* Chunked content isn't complete until the last chunk is read. */
+            if(fChunked)
+                return false;
+
             if(strType == "GET" && fHeader)
                 return true;
 
@@ -276,15 +291,19 @@ namespace LLP
                 "Server: Tritium HTTP\r\n"
             );
 
+            /* Chunked content is written after the header, so it has no length. */
+            if(fChunked)
+                strReply += std::string("Transfer-Encoding: chunked\r\n");
+
             /* Check for content. */
-            if(strContent.size() > 0)
+            else if(strContent.size() > 0)
             {
                 /* Set our content length here. */
                 strReply +=
                     debug::safe_printstr("Content-Length: ", strContent.size(), "\r\n");
 
-                /* Set our content type for JSON if applicable. */
-                if(encoding::json::accept(strContent))
+                /* Set our content type for JSON if applicable, unless the sender has already given one. */
+                if(!mapHeaders.count("Content-Type") && encoding::json::accept(strContent))
                     strReply += std::string("Content-Type: application/json\r\n");
             }
 
@@ -292,11 +311,17 @@ namespace LLP
             for(const auto& header : mapHeaders)
                 strReply += debug::safe_printstr(header.first, ": ", header.second, "\r\n");;
 
-            /* Add end of header and content. */
-            strReply += debug::safe_printstr("\r\n", strContent);
+            /* Add end of header. */
+            strReply += "\r\n";
+
+            /* Build our bytes with the content appended directly, so the content is only copied once. */
+            std::vector<uint8_t> vBytes;
+            vBytes.reserve(strReply.size() + (fChunked ? 0 : strContent.size()));
+            vBytes.insert(vBytes.end(), strReply.begin(), strReply.end());
 
-            //get the bytes to submit over socket
-            std::vector<uint8_t> vBytes(strReply.begin(), strReply.end());
+            /* Add the content if not chunked. */
+            if(!fChunked)
+                vBytes.insert(vBytes.end(), strContent.begin(), strContent.end());
 
             return vBytes;
         }
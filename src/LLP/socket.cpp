@@ -24,6 +24,11 @@ ________________________________________________________________________________
 #ifndef WIN32
 #include <arpa/inet.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
 #endif
 
 #include <openssl/ssl.h>
@@ -38,11 +43,13 @@ namespace LLP
     : pollfd             ( )
     , SOCKET_MUTEX       ( )
     , pSSL(nullptr)
+    , nWatchFD           (-1)
     , ADDRESS_MUTEX      ( )
     , nLastSend          (0)
     , nLastRecv          (0)
     , nError             (0)
-    , vBuffer            ( )
+    , qBuffer            ( )
+    , nBufferOffset      (0)
     , nBufferSize        (0)
     , fBufferFull        (false)
     , nConsecutiveErrors (0)
@@ -61,11 +68,13 @@ namespace LLP
     : pollfd             (socket)
     , SOCKET_MUTEX       ( )
     , pSSL(nullptr)
+    , nWatchFD           (-1)
     , ADDRESS_MUTEX      ( )
     , nLastSend          (socket.nLastSend.load())
     , nLastRecv          (socket.nLastRecv.load())
     , nError             (socket.nError.load())
-    , vBuffer            (socket.vBuffer)
+    , qBuffer            (socket.qBuffer)
+    , nBufferOffset      (socket.nBufferOffset)
     , nBufferSize        (socket.nBufferSize.load())
     , fBufferFull        (socket.fBufferFull.load())
     , nConsecutiveErrors (socket.nConsecutiveErrors.load())
@@ -96,11 +105,13 @@ namespace LLP
     : pollfd             ( )
     , SOCKET_MUTEX       ( )
     , pSSL(nullptr)
+    , nWatchFD           (-1)
     , ADDRESS_MUTEX      ( )
     , nLastSend          (0)
     , nLastRecv          (0)
     , nError             (0)
-    , vBuffer            ( )
+    , qBuffer            ( )
+    , nBufferOffset      (0)
     , nBufferSize        (0)
     , fBufferFull        (false)
     , nConsecutiveErrors (0)
@@ -250,11 +261,13 @@ namespace LLP
     : pollfd             ( )
     , SOCKET_MUTEX       ( )
     , pSSL(nullptr)
+    , nWatchFD           (-1)
     , ADDRESS_MUTEX      ( )
     , nLastSend          (0)
     , nLastRecv          (0)
     , nError             (0)
-    , vBuffer            ( )
+    , qBuffer            ( )
+    , nBufferOffset      (0)
     , nBufferSize        (0)
     , fBufferFull        (false)
     , nConsecutiveErrors (0)
@@ -615,6 +628,9 @@ namespace LLP
     {
         RECURSIVE(SOCKET_MUTEX);
 
+        /* Remove from our epoll descriptor while we still own this descriptor. */
+        Unwatch();
+
         if(fd != INVALID_SOCKET)
         {
             if(IsSSL())
@@ -649,8 +665,56 @@ namespace LLP
     }
 
 
+    /* Register this socket with an epoll descriptor, to report when it is ready to read. */
+    void Socket::Watch(const int32_t nWatchFDIn, const uint32_t nIndex)
+    {
+    #ifdef __linux__
+        RECURSIVE(SOCKET_MUTEX);
+
+        /* Check that we still have a descriptor to watch. */
+        if(fd == INVALID_SOCKET || nWatchFDIn < 0)
+            return;
+
+        /* Our index is kept with the event so the data thread doesn't need to search for it. */
+        epoll_event tEvent;
+        tEvent.events   = EPOLLIN;
+        tEvent.data.u32 = nIndex;
+
+        /* Modify our registration if we are already watched, such as when moving slots. */
+        if(epoll_ctl(nWatchFDIn, EPOLL_CTL_ADD, fd, &tEvent) == 0
+        || (errno == EEXIST && epoll_ctl(nWatchFDIn, EPOLL_CTL_MOD, fd, &tEvent) == 0))
+            nWatchFD = nWatchFDIn;
+    #endif
+    }
+
+
+    /* Remove this socket from the epoll descriptor it is registered with. */
+    void Socket::Unwatch()
+    {
+    #ifdef __linux__
+        RECURSIVE(SOCKET_MUTEX);
+
+        /* Our descriptor is only closed under this lock, so it can't have been reused while it is registered. */
+        if(nWatchFD >= 0 && fd != INVALID_SOCKET)
+        {
+            epoll_event tEvent;
+            epoll_ctl(nWatchFD, EPOLL_CTL_DEL, fd, &tEvent);
+        }
+
+        nWatchFD = -1;
+    #endif
+    }
+
+
     /* Read data from the socket buffer non-blocking */
     int Socket::Read(std::vector<uint8_t> &vData, size_t nBytes)
+    {
+        return Read(&vData[0], nBytes);
+    }
+
+
+    /* Read data from the socket buffer non-blocking, directly into a buffer that is already sized. */
+    int32_t Socket::Read(uint8_t* pData, size_t nBytes)
     {
         RECURSIVE(SOCKET_MUTEX);
 
@@ -660,13 +724,13 @@ namespace LLP
         int32_t nRead = 0;
 
         if(pSSL)
-            nRead = SSL_read(pSSL, (int8_t*)&vData[0], nBytes);
+            nRead = SSL_read(pSSL, (int8_t*)pData, nBytes);
         else
         {
         #ifdef WIN32
-            nRead = static_cast<int32_t>(recv(fd, (char*)&vData[0], nBytes, MSG_DONTWAIT));
+            nRead = static_cast<int32_t>(recv(fd, (char*)pData, nBytes, MSG_DONTWAIT));
         #else
-            nRead = static_cast<int32_t>(recv(fd, (int8_t*)&vData[0], nBytes, MSG_DONTWAIT));
+            nRead = static_cast<int32_t>(recv(fd, (int8_t*)pData, nBytes, MSG_DONTWAIT));
         #endif
         }
 
@@ -829,61 +893,47 @@ namespace LLP
     /* Write data into the socket buffer non-blocking */
     int32_t Socket::Write(const std::vector<uint8_t>& vData, size_t nBytes)
     {
-        int32_t nSent = 0;
+        RECURSIVE(SOCKET_MUTEX);
 
         /* Check overflow buffer. */
         if(nBufferSize.load() > 0)
         {
-            RECURSIVE(SOCKET_MUTEX);
-
             /* Insert data into the buffer. */
-            vBuffer.insert(vBuffer.end(), vData.begin(), vData.end());
-
-            /* Set our atomic with size of vector. */
-            nBufferSize.store(vBuffer.size());
+            buffer_bytes(std::make_shared<const std::vector<uint8_t>>(vData), 0);
 
             return static_cast<int32_t>(nBytes);
         }
 
         /* Write the packet. */
-        {
-            RECURSIVE(SOCKET_MUTEX);
+        const int32_t nSent = send_bytes(vData.data(), static_cast<uint32_t>(vData.size()));
 
-            if(pSSL)
-                nSent = static_cast<int32_t>(SSL_write(pSSL, (int8_t*)&vData[0], nBytes));
-            else
-            {
-            #ifdef WIN32
-                nSent = static_cast<int32_t>(send(fd, (char*)&vData[0], nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
-            #else
-                nSent = static_cast<int32_t>(send(fd, (int8_t*)&vData[0], nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
-            #endif
-            }
-        }
+        /* If not all data was sent non-blocking, buffer the remaining data. */
+        if(nSent >= 0 && static_cast<uint32_t>(nSent) != vData.size())
+            buffer_bytes(std::make_shared<const std::vector<uint8_t>>(vData.begin() + nSent, vData.end()), 0);
+
+        return nSent;
+    }
 
 
-        /* Handle for error state. */
-        if(nSent < 0)
-        {
-            if(pSSL)
-                nError = SSL_get_error(pSSL, nSent);
-            else
-                nError = WSAGetLastError();
-        }
+    /* Write shared data into the socket buffer non-blocking. */
+    int32_t Socket::Write(const shared_bytes_t& pData)
+    {
+        RECURSIVE(SOCKET_MUTEX);
 
-        /* If not all data was sent non-blocking, recurse until it is complete. */
-        else if(nSent != vData.size())
+        /* Check overflow buffer, queueing the pointer rather than the data. */
+        if(nBufferSize.load() > 0)
         {
-            RECURSIVE(SOCKET_MUTEX);
-
-            /* Insert remaining data into the buffer. */
-            vBuffer.insert(vBuffer.end(), vData.begin() + nSent, vData.end());
+            buffer_bytes(pData, 0);
 
-            /* Set our atomic with size of vector. */
-            nBufferSize.store(vBuffer.size());
+            return static_cast<int32_t>(pData->size());
         }
-        else //don't update last sent unless all the data was written to the buffer
-            nLastSend = runtime::timestamp(true);
+
+        /* Write the packet. */
+        const int32_t nSent = send_bytes(pData->data(), static_cast<uint32_t>(pData->size()));
+
+        /* If not all data was sent non-blocking, buffer the rest by pointer and remember where we stopped. */
+        if(nSent >= 0 && static_cast<uint32_t>(nSent) != pData->size())
+            buffer_bytes(pData, nSent);
 
         return nSent;
     }
@@ -892,35 +942,65 @@ namespace LLP
     /* Flushes data out of the overflow buffer */
     int Socket::Flush()
     {
-        int32_t nSent   = 0;
-        uint32_t nBytes = 0;
-        uint32_t nSize  =
-            static_cast<uint32_t>(nBufferSize.load());
-
         /* Don't flush if buffer doesn't have any data. */
-        if(nSize == 0)
+        if(nBufferSize.load() == 0)
             return 0;
 
         /* maximum transmission unit. */
         const uint32_t MTU = 16384;
 
+        /* maximum packets to gather into one send. */
+        const uint32_t MAX_SEGMENTS = 64;
+
         /* Set the maximum bytes to flush to 2^16 or maximum socket buffers. */
-        nBytes = std::min(nSize, std::min((uint32_t)config::GetArg("-maxsendsize", MTU), MTU));
+        const uint32_t nBytes = std::min((uint32_t)config::GetArg("-maxsendsize", MTU), MTU);
+
+        /* Hold our lock until the sent bytes are removed from the buffer. */
+        RECURSIVE(SOCKET_MUTEX);
 
-        /* If there were any errors, handle them gracefully. */
+        /* Check that our buffer wasn't emptied before we got our lock. */
+        if(qBuffer.empty())
+            return 0;
+
+        int32_t nSent = 0;
+    #ifndef WIN32
+        if(!pSSL)
         {
-            RECURSIVE(SOCKET_MUTEX);
+            /* Gather the queued packets into one send, so shared packets never need to be joined. */
+            struct iovec vSegments[MAX_SEGMENTS];
 
-            if(pSSL)
-                nSent = static_cast<int32_t>(SSL_write(pSSL, (int8_t *)&vBuffer[0], nBytes));
-            else
+            uint32_t nSegments = 0, nTotal = 0;
+            uint64_t nOffset   = nBufferOffset;
+            for(const auto& pData : qBuffer)
             {
-            #ifdef WIN32
-                nSent = static_cast<int32_t>(send(fd, (char*)&vBuffer[0], nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
-            #else
-                nSent = static_cast<int32_t>(send(fd, (int8_t*)&vBuffer[0], nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
-            #endif
+                /* Check our limits. */
+                if(nSegments == MAX_SEGMENTS || nTotal >= nBytes)
+                    break;
+
+                /* Add the unsent part of this packet. */
+                const uint32_t nSegment = static_cast<uint32_t>(std::min<uint64_t>(pData->size() - nOffset, nBytes - nTotal));
+                vSegments[nSegments].iov_base = const_cast<uint8_t*>(pData->data() + nOffset);
+                vSegments[nSegments].iov_len  = nSegment;
+
+                ++nSegments;
+                nTotal  += nSegment;
+                nOffset  = 0;
             }
+
+            /* Use sendmsg over writev so we can set our flags. */
+            struct msghdr msg = { };
+            msg.msg_iov    = vSegments;
+            msg.msg_iovlen = nSegments;
+
+            nSent = static_cast<int32_t>(sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT));
+        }
+        else
+    #endif
+        {
+            /* SSL writes one record at a time, so send from the first packet. */
+            const shared_bytes_t& pData = qBuffer.front();
+            nSent = send_bytes(pData->data() + nBufferOffset,
+                static_cast<uint32_t>(std::min<uint64_t>(pData->size() - nBufferOffset, nBytes)));
         }
 
         /* Handle errors on flush. */
@@ -937,16 +1017,27 @@ namespace LLP
         /* If not all data was sent non-blocking, recurse until it is complete. */
         else if(nSent > 0)
         {
+            /* Release the packets that were completely sent. */
+            uint64_t nRemaining = static_cast<uint64_t>(nSent);
+            while(nRemaining > 0)
             {
-                RECURSIVE(SOCKET_MUTEX);
+                /* Check for a partially sent packet. */
+                const uint64_t nUnsent = qBuffer.front()->size() - nBufferOffset;
+                if(nRemaining < nUnsent)
+                {
+                    nBufferOffset += nRemaining;
+                    break;
+                }
 
-                /* Erase from current buffer. */
-                vBuffer.erase(vBuffer.begin(), vBuffer.begin() + nSent);
+                nRemaining -= nUnsent;
+                nBufferOffset = 0;
 
-                /* Set our atomic with size of vector. */
-                nBufferSize.store(vBuffer.size());
+                qBuffer.pop_front();
             }
 
+            /* Set our atomic with size of buffer. */
+            nBufferSize.store(nBufferSize.load() - nSent);
+
             /* Update socket timers. */
             nLastSend          = runtime::timestamp(true);
             nConsecutiveErrors = 0;
@@ -1050,4 +1141,53 @@ namespace LLP
         return false;
     }
 
+
+    /* Send bytes to the socket non-blocking, caller must hold the socket mutex. */
+    int32_t Socket::send_bytes(const uint8_t* pData, const uint32_t nBytes)
+    {
+        int32_t nSent = 0;
+        if(pSSL)
+            nSent = static_cast<int32_t>(SSL_write(pSSL, (int8_t*)pData, nBytes));
+        else
+        {
+        #ifdef WIN32
+            nSent = static_cast<int32_t>(send(fd, (char*)pData, nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
+        #else
+            nSent = static_cast<int32_t>(send(fd, (int8_t*)pData, nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
+        #endif
+        }
+
+        /* Handle for error state. */
+        if(nSent < 0)
+        {
+            if(pSSL)
+                nError = SSL_get_error(pSSL, nSent);
+            else
+                nError = WSAGetLastError();
+
+            /* A full socket buffer sends nothing, so the caller buffers it rather than dropping it. */
+            if(!pSSL && nError.load() == WSAEWOULDBLOCK)
+                nSent = 0;
+        }
+
+        /* Don't update last sent unless all the data was written. */
+        else if(static_cast<uint32_t>(nSent) == nBytes)
+            nLastSend = runtime::timestamp(true);
+
+        return nSent;
+    }
+
+
+    /* Queue shared bytes on the overflow buffer, caller must hold the socket mutex. */
+    void Socket::buffer_bytes(const shared_bytes_t& pData, const uint64_t nOffset)
+    {
+        /* Only the first packet can be partially sent. */
+        if(qBuffer.empty())
+            nBufferOffset = nOffset;
+
+        qBuffer.push_back(pData);
+
+        /* Set our atomic with size of buffer. */
+        nBufferSize.store(nBufferSize.load() + pData->size() - nOffset);
+    }
 }
@@ -181,11 +181,16 @@ namespace LLP
          *
          *  Filter out relay requests with notifications node is subscribed to.
          *
+         *  @param[in] message The message type being relayed.
+         *  @param[in] ssData The data being relayed.
+         *  @param[out] vRanges The byte ranges of the data to relay, empty to relay nothing.
+         *
          **/
         template<typename MessageType>
-        const DataStream RelayFilter(const MessageType& message, const DataStream& ssData) const
+        void RelayFilter(const MessageType& message, const DataStream& ssData, std::vector<std::pair<uint64_t, uint64_t>>& vRanges) const
         {
-            return ssData; //copy over relay like normal for all items to be relayed
+            if(ssData.size() > 0)
+                vRanges.push_back(std::make_pair(0, ssData.size())); //pass relay through like normal for all items to be relayed
         }
 
 
@@ -295,8 +300,23 @@ namespace LLP
          *
          *  @param[in] PACKET The packet of type PacketType to write.
          *
+         *  @return True if the packet was written, false if it was dropped because the send buffer is full.
+         *
+         **/
+        bool WritePacket(const PacketType& PACKET);
+
+
+        /** WritePacket
+         *
+         *  Write a packet that was already serialized to the TCP stream. The bytes are shared rather than
+         *  copied, so a packet relayed to many connections is only serialized once.
+         *
+         *  @param[in] pBytes The shared bytes of the serialized packet.
+         *
+         *  @return True if the packet was written, false if it was dropped because the send buffer is full.
+         *
          **/
-        void WritePacket(const PacketType& PACKET);
+        bool WritePacket(const shared_bytes_t& pBytes);
 
 
         /** ReadPacket
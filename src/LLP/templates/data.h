@@ -88,6 +88,14 @@ namespace LLP
         util::atomic::lock_unique_ptr<std::queue<std::pair<typename ProtocolType::message_t, DataStream>>> RELAY;
 
 
+        /** The epoll descriptor that sockets are registered with, or -1 to use poll. **/
+        int32_t nEpollFD;
+
+
+        /** The eventfd descriptor that wakes the data thread from its wait. **/
+        int32_t nEventFD;
+
+
         /** The condition for thread sleeping. **/
         std::condition_variable CONDITION;
 
@@ -162,6 +170,9 @@ namespace LLP
                 else
                     CONNECTIONS->at(nSlot) = std::shared_ptr<ProtocolType>(pnode);
 
+                /* Register our socket for ready events. */
+                watch_connection(nSlot);
+
                 /* Notify data thread to wake up. */
                 CONDITION.notify_all();
             }
@@ -225,6 +236,9 @@ namespace LLP
                 else
                     CONNECTIONS->at(nSlot) = std::shared_ptr<ProtocolType>(pnode);
 
+                /* Register our socket for ready events. */
+                watch_connection(nSlot);
+
                 /* Notify data thread to wake up. */
                 CONDITION.notify_all();
 
@@ -377,6 +391,57 @@ namespace LLP
         void remove_connection(const uint32_t nIndex);
 
 
+        /** process_connection
+         *
+         *  Check a connection for errors and timeouts, and read and process its packets.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *  @param[in] nEvents The poll events returned for the connection's socket.
+         *
+         **/
+        void process_connection(const uint32_t nIndex, const int16_t nEvents);
+
+
+        /** pending_connection
+         *
+         *  Check if a connection has bytes already read into its SSL buffer, which won't be reported as ready again.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *
+         *  @return True if the connection needs to be processed again without waiting for it to be ready.
+         *
+         **/
+        bool pending_connection(const uint32_t nIndex);
+
+
+        /** watch_connection
+         *
+         *  Register a connection's socket to wake our data thread when it is ready.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *
+         **/
+        void watch_connection(const uint32_t nIndex);
+
+
+        /** unwatch_connection
+         *
+         *  Remove a connection's socket from our ready events.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *
+         **/
+        void unwatch_connection(const uint32_t nIndex);
+
+
+        /** wake_thread
+         *
+         *  Wake up our data thread if it is waiting for ready sockets.
+         *
+         **/
+        void wake_thread();
+
+
         /** find_slot
          *
          *  Returns the index of a component of the CONNECTIONS vector that
@@ -19,6 +19,8 @@ ________________________________________________________________________________
 #include <LLP/include/base_address.h>
 
 #include <vector>
+#include <deque>
+#include <memory>
 #include <cstdint>
 #include <mutex>
 #include <atomic>
@@ -34,6 +36,10 @@ namespace LLP
     const uint64_t MAX_SEND_BUFFER = 17 * 1024 * 1024; //17MB max send buffer
 
 
+    /** Immutable reference counted bytes, so one serialized packet can be queued on many sockets. **/
+    typedef std::shared_ptr<const std::vector<uint8_t>> shared_bytes_t;
+
+
     /** Socket
      *
      *  Base Template class to handle outgoing / incoming LLP data for both
@@ -50,6 +56,10 @@ namespace LLP
         /* SSL object */
         SSL* pSSL;
 
+
+        /* The epoll descriptor this socket is registered with, or -1 if it isn't. */
+        int32_t nWatchFD;
+
     protected:
 
         /** Mutex to protect buffered data. **/
@@ -68,8 +78,12 @@ namespace LLP
         std::atomic<int32_t> nError;
 
 
-        /** Oversize buffer for large packets. **/
-        std::vector<uint8_t> vBuffer;
+        /** Oversize buffer for large packets, queued by pointer so shared packets aren't copied. **/
+        std::deque<shared_bytes_t> qBuffer;
+
+
+        /** The bytes of the first buffered packet that were already sent. **/
+        uint64_t nBufferOffset;
 
 
         /** Keep track of the buffer with an atomic. */
@@ -170,6 +184,26 @@ namespace LLP
         void Close();
 
 
+        /** Watch
+         *
+         *  Register this socket with an epoll descriptor, to report when it is ready to read.
+         *  Close removes it again before the descriptor is closed, so a reused descriptor is never left registered.
+         *
+         *  @param[in] nWatchFDIn The epoll descriptor to register with.
+         *  @param[in] nIndex The index to be returned with ready events.
+         *
+         **/
+        void Watch(const int32_t nWatchFDIn, const uint32_t nIndex);
+
+
+        /** Unwatch
+         *
+         *  Remove this socket from the epoll descriptor it is registered with.
+         *
+         **/
+        void Unwatch();
+
+
         /** Read
          *
          *  Read data from the socket buffer non-blocking
@@ -196,6 +230,19 @@ namespace LLP
         int32_t Read(std::vector<int8_t>& vchData, size_t nBytes);
 
 
+        /** Read
+         *
+         *  Read data from the socket buffer non-blocking, directly into a buffer that is already sized.
+         *
+         *  @param[out] pData The buffer to read into
+         *  @param[in] nBytes The total bytes to read
+         *
+         *  @return the total bytes that were read
+         *
+         **/
+        int32_t Read(uint8_t* pData, size_t nBytes);
+
+
         /** Write
          *
          *  Write data into the socket buffer non-blocking
@@ -209,9 +256,22 @@ namespace LLP
         int32_t Write(const std::vector<uint8_t>& vData, size_t nBytes);
 
 
+        /** Write
+         *
+         *  Write shared data into the socket buffer non-blocking. Anything that can't be sent right away is
+         *  queued by pointer rather than copied, so the same packet can be buffered on many sockets.
+         *
+         *  @param[in] pData The shared bytes to be written
+         *
+         *  @return the total bytes that were written
+         *
+         **/
+        int32_t Write(const shared_bytes_t& pData);
+
+
         /** Flush
          *
-         *  Flushes data out of the overflow buffer
+         *  Flushes data out of the overflow buffer, gathering the queued packets into one send where supported.
          *
          *  @return the total bytes that were written
          *
@@ -291,6 +351,30 @@ namespace LLP
          **/
         int32_t error_code() const;
 
+
+        /** send_bytes
+         *
+         *  Send bytes to the socket non-blocking, caller must hold the socket mutex.
+         *
+         *  @param[in] pData Pointer to the bytes to send.
+         *  @param[in] nBytes The total bytes to send.
+         *
+         *  @return the total bytes that were sent, or negative on error.
+         *
+         **/
+        int32_t send_bytes(const uint8_t* pData, const uint32_t nBytes);
+
+
+        /** buffer_bytes
+         *
+         *  Queue shared bytes on the overflow buffer, caller must hold the socket mutex.
+         *
+         *  @param[in] pData The shared bytes to queue.
+         *  @param[in] nOffset The bytes at the start of the data that were already sent.
+         *
+         **/
+        void buffer_bytes(const shared_bytes_t& pData, const uint64_t nOffset);
+
     };
 
 }
@@ -18,6 +18,8 @@ ________________________________________________________________________________
 
 #include <LLP/types/tritium.h>
 #include <LLP/include/global.h>
+#include <LLP/include/buffer_pool.h>
+#include <LLP/include/header_sync.h>
 #include <LLP/include/manager.h>
 #include <LLP/templates/events.h>
 
@@ -391,6 +393,33 @@ namespace LLP
                 }
 
 
+                /* Request our next window of blocks when running a headers first sync. */
+                if(HeaderSync::Active() && nCurrentSession != 0)
+                {
+                    /* Get the best chain of every node, so we know which windows they can send. */
+                    if(!(nSubscriptions & SUBSCRIPTION::BESTCHAIN))
+                        Subscribe(SUBSCRIPTION::BESTCHAIN);
+
+                    /* Our sync node sends LASTINDEX after every list, so it only sends windows once it sent all headers. */
+                    uint1024_t hashStart, hashStop;
+                    if((nCurrentSession != TAO::Ledger::nSyncSession.load() || HeaderSync::Complete())
+                    && HeaderSync::Request(nCurrentSession, hashBestChain, hashStart, hashStop))
+                    {
+                        /* Ask for the blocks in this window. */
+                        PushMessage(ACTION::LIST,
+                            uint8_t(SPECIFIER::SYNC),
+                            uint8_t(TYPES::BLOCK),
+                            uint8_t(TYPES::UINT1024_T),
+                            hashStart,
+                            hashStop
+                        );
+
+                        /* Debug output. */
+                        debug::log(3, NODE, "requested window ", hashStart.SubString(), " to ", hashStop.SubString());
+                    }
+                }
+
+
                 /* Unreliabilitiy re-requesting (max time since getblocks) */
                 if(TAO::Ledger::ChainState::Synchronizing()
                 && nCurrentSession == TAO::Ledger::nSyncSession.load()
@@ -500,6 +529,10 @@ namespace LLP
                         SwitchNode();
                     }
 
+                    /* Give the windows this node was sending to other nodes. */
+                    if(HeaderSync::Active())
+                        HeaderSync::Release(nCurrentSession);
+
                     /* Critical Section changing mapSessions. */
                     { LOCK(SESSIONS_MUTEX);
 
@@ -529,8 +562,20 @@ namespace LLP
     /** Main message handler once a packet is recieved. **/
     bool TritiumNode::ProcessPacket()
     {
-        /* Deserialize the packeet from incoming packet payload. */
-        DataStream ssPacket(INCOMING.DATA, SER_NETWORK, PROTOCOL_VERSION);
+        /* Deserialize the packet from incoming packet payload, moving its buffer into our stream rather than copying. */
+        DataStream ssPacket(std::move(INCOMING.DATA), SER_NETWORK, PROTOCOL_VERSION);
+
+        /* Process the packet, then hand its buffer back to this data thread's pool for the next packet. */
+        const bool fProcessed = process_packet(ssPacket);
+        BufferPool::Local().Release(ssPacket.Bytes());
+
+        return fProcessed;
+    }
+
+
+    /* Handle a packet's message once its payload is deserialized. */
+    bool TritiumNode::process_packet(DataStream& ssPacket)
+    {
         switch(INCOMING.MESSAGE)
         {
             /* Handle for the version command. */
@@ -2281,8 +2326,36 @@ namespace LLP
                                     uint1024_t hashLast;
                                     ssPacket >> hashLast;
 
+                                    /* Check if is sync node listing headers for a headers first sync. */
+                                    if(nCurrentSession == TAO::Ledger::nSyncSession.load() && HeaderSync::Active())
+                                    {
+                                        /* Check if our sync node has no more headers to send. */
+                                        if(HeaderSync::Complete())
+                                            debug::log(3, NODE, "ACTION::NOTIFY: LASTINDEX after headers completed");
+
+                                        else if(hashLastIndex == hashLast || hashLast == hashBestChain)
+                                        {
+                                            /* Set our headers as complete so windows can be requested up to our last header. */
+                                            HeaderSync::SetComplete();
+
+                                            /* Unsubscribe so our sync node can send us windows without notifying of their last index. */
+                                            Unsubscribe(SUBSCRIPTION::LASTINDEX);
+                                        }
+                                        else
+                                        {
+                                            /* Ask for the next list of headers. */
+                                            PushMessage(ACTION::LIST,
+                                                uint8_t(SPECIFIER::CLIENT),
+                                                uint8_t(TYPES::BLOCK),
+                                                uint8_t(TYPES::UINT1024_T),
+                                                hashLast,
+                                                uint1024_t(0)
+                                            );
+                                        }
+                                    }
+
                                     /* Check if is sync node. */
-                                    if(nCurrentSession == TAO::Ledger::nSyncSession.load())
+                                    else if(nCurrentSession == TAO::Ledger::nSyncSession.load())
                                     {
                                         /* Check if we are repeating our last index. */
                                         if(hashLastIndex == hashLast)
@@ -2359,6 +2432,9 @@ namespace LLP
                                 fSynchronized.store(true);
                                 TAO::Ledger::nSyncSession.store(0);
 
+                                /* Stop requesting windows if running a headers first sync. */
+                                HeaderSync::Stop();
+
                                 /* Unsubcribe from last. */
                                 Unsubscribe(SUBSCRIPTION::LASTINDEX);
 
@@ -2659,8 +2735,8 @@ namespace LLP
                         if(config::fClient.load())
                             return debug::drop(NODE, "TYPES::BLOCK::SYNC: disabled in -client mode");
 
-                        /* Check if this is an unsolicited sync block. */
-                        if(nCurrentSession != TAO::Ledger::nSyncSession || fSynchronized.load())
+                        /* Check if this is an unsolicited sync block, nodes that were given windows can send them too. */
+                        if((nCurrentSession != TAO::Ledger::nSyncSession && !HeaderSync::Requested(nCurrentSession)) || fSynchronized.load())
                             return debug::drop(FUNCTION, "unsolicted sync block");
 
                         /* Get the block from the stream. */
@@ -2704,6 +2780,27 @@ namespace LLP
                         TAO::Ledger::ClientBlock block;
                         ssPacket >> block;
 
+                        /* Full nodes only receive client blocks as headers for a headers first sync. */
+                        if(!config::fClient.load())
+                        {
+                            /* Check if this is an unsolicited header. */
+                            if(nCurrentSession != TAO::Ledger::nSyncSession || !HeaderSync::Active())
+                                return debug::drop(NODE, "TYPES::BLOCK::CLIENT: unsolicited header");
+
+                            /* Add the header to our windows. */
+                            if(!HeaderSync::Header(block))
+                            {
+                                /* Headers that don't connect mean our sync node is on another chain. */
+                                SwitchNode();
+                                return true;
+                            }
+
+                            /* Headers count as progress for our sync node timeout. */
+                            nLastTimeReceived.store(runtime::timestamp());
+
+                            break;
+                        }
+
                         /* Process the block. */
                         TAO::Ledger::Process(block, nStatus);
 
@@ -2742,17 +2839,36 @@ namespace LLP
                     nConsecutiveOrphans = 0;
                     nConsecutiveFails   = 0;
 
-                    /* Reset last time received. */
-                    if(nCurrentSession == TAO::Ledger::nSyncSession.load())
+                    /* Reset last time received, blocks from any node count when they were sent as windows. */
+                    if(nCurrentSession == TAO::Ledger::nSyncSession.load() || HeaderSync::Active())
                         nLastTimeReceived.store(runtime::timestamp());
+
+                    /* Check if a headers first sync connected up to its last header. */
+                    if(HeaderSync::Finished())
+                    {
+                        /* Set state to synchronized. */
+                        fSynchronized.store(true);
+                        TAO::Ledger::nSyncSession.store(0);
+
+                        /* Total blocks synchronized */
+                        const uint32_t nBlocks = TAO::Ledger::ChainState::tStateBest.load().nHeight - nSyncStart.load();
+
+                        /* Calculate the time to sync*/
+                        const uint32_t nElapsed = SYNCTIMER.Elapsed();
+
+                        /* Log that sync is complete. */
+                        debug::log(0, NODE, "TYPES::BLOCK: Synchronization COMPLETE at ", TAO::Ledger::ChainState::hashBestChain.load().SubString());
+                        debug::log(0, NODE, "TYPES::BLOCK: Synchronized ", nBlocks, " blocks in ", nElapsed,
+                            " seconds [", double(nBlocks / (nElapsed + 1.0)), " blocks/s]" );
+                    }
                 }
 
                 /* Check for failure status messages. */
                 if(nStatus & TAO::Ledger::PROCESS::REJECTED)
                     ++nConsecutiveFails;
 
-                /* Check for orphan status messages. */
-                if(nStatus & TAO::Ledger::PROCESS::ORPHAN)
+                /* Check for orphan status messages, windows ahead of our best chain are expected to be orphans. */
+                if((nStatus & TAO::Ledger::PROCESS::ORPHAN) && !HeaderSync::Active())
                     ++nConsecutiveOrphans;
 
                 /* Detect large orphan chains and ask for new blocks from origin again. */
@@ -3120,6 +3236,23 @@ namespace LLP
                     DataStream ssHeader(BYTES, SER_NETWORK, MIN_PROTO_VERSION);
                     ssHeader >> INCOMING;
 
+                    /* Reject packets larger than we accept before reserving anything for them. */
+                    if(INCOMING.LENGTH > BufferPool::MAX_SIZE)
+                    {
+                        /* Give higher score for bad packets. */
+                        if(DDOS)
+                            DDOS->rSCORE += 15;
+
+                        debug::drop(NODE, "packet length ", INCOMING.LENGTH, " over maximum ", uint32_t(BufferPool::MAX_SIZE));
+
+                        Disconnect();
+                        return;
+                    }
+
+                    /* Get a buffer from this data thread's pool for the bytes that have arrived, and grow it as the rest arrives,
+                       so a length we were sent can't make us reserve memory for data that never comes. */
+                    INCOMING.DATA = BufferPool::Local().Get(std::min(INCOMING.LENGTH, std::max(uint32_t(std::max(Available(), 0)), uint32_t(BufferPool::MIN_SIZE))));
+
                     Event(EVENTS::HEADER);
                 }
             }
@@ -3132,21 +3265,25 @@ namespace LLP
                    minus any already read on previous reads*/
                 uint32_t nMaxRead = (uint32_t)(INCOMING.LENGTH - INCOMING.DATA.size());
 
-                /* Vector to receve the read bytes. This should be the smaller of the number of bytes currently available or the
-                   maximum amount to read */
-                std::vector<uint8_t> DATA(std::min(nAvailable, nMaxRead), 0);
+                /* Grow the packet data by the smaller of the number of bytes currently available or the maximum amount to read.
+                   Our reservation at least doubles when it runs out, up to the packet length, so the bytes are read in place. */
+                const uint32_t nOffset = static_cast<uint32_t>(INCOMING.DATA.size());
+                const uint32_t nBytes  = std::min(nAvailable, nMaxRead);
+                if(nOffset + nBytes > INCOMING.DATA.capacity())
+                    INCOMING.DATA.reserve(std::min(INCOMING.LENGTH, std::max(nOffset + nBytes, uint32_t(INCOMING.DATA.capacity() * 2))));
+
+                INCOMING.DATA.resize(nOffset + nBytes);
 
                 /* Read up to the buffer size. */
-                int32_t nRead = Read(DATA, DATA.size());
+                int32_t nRead = Read(&INCOMING.DATA[nOffset], nBytes);
 
-                /* If something was read, insert it into the packet data.  NOTE: that due to SSL packet framing we could end up
-                   reading less bytes than appear available.  Therefore we only copy the number of bytes actually read */
-                if(nRead > 0)
-                    INCOMING.DATA.insert(INCOMING.DATA.end(), DATA.begin(), DATA.begin() + nRead);
+                /* NOTE: that due to SSL packet framing we could end up reading less bytes than appear available.
+                   Therefore we only keep the number of bytes actually read */
+                INCOMING.DATA.resize(nOffset + std::max(nRead, 0));
 
                 /* If the packet is now considered complete, fire the packet complete event */
                 if(INCOMING.Complete())
-                    Event(EVENTS::PACKET, static_cast<uint32_t>(DATA.size()));
+                    Event(EVENTS::PACKET, nBytes);
             }
         }
     }
@@ -3484,11 +3621,8 @@ namespace LLP
 
 
     /* Checks if a node is subscribed to receive a notification. */
-    const DataStream TritiumNode::RelayFilter(const uint16_t nMsg, const DataStream& ssData) const
+    void TritiumNode::RelayFilter(const uint16_t nMsg, const DataStream& ssData, std::vector<std::pair<uint64_t, uint64_t>>& vRanges) const
     {
-        /* The data stream to relay*/
-        DataStream ssRelay(SER_NETWORK, MIN_PROTO_VERSION);
-
         /* Switch based on message type */
         switch(nMsg)
         {
@@ -3498,6 +3632,10 @@ namespace LLP
                 /* Build a response data stream. */
                 while(!ssData.End())
                 {
+                    /* Track where this notification starts, so we can relay its bytes as they are. */
+                    const uint64_t nBegin = ssData.GetPos();
+                    bool fRelay = false;
+
                     /* Get the first notify type. */
                     uint8_t nType = 0;
                     ssData >> nType;
@@ -3525,11 +3663,7 @@ namespace LLP
 
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::BLOCK)
-                            {
-                                /* Write block to stream. */
-                                ssRelay << uint8_t(TYPES::BLOCK);
-                                ssRelay << hashBlock;
-                            }
+                                fRelay = true;
 
                             break;
                         }
@@ -3544,15 +3678,7 @@ namespace LLP
 
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::TRANSACTION)
-                            {
-                                /* Check for legacy. */
-                                if(fLegacy)
-                                    ssRelay << uint8_t(SPECIFIER::LEGACY);
-
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::TRANSACTION);
-                                ssRelay << hashTx;
-                            }
+                                fRelay = true;
 
                             break;
                         }
@@ -3574,11 +3700,7 @@ namespace LLP
 
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::BESTHEIGHT)
-                            {
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::BESTHEIGHT);
-                                ssRelay << nHeight;
-                            }
+                                fRelay = true;
 
                             break;
                         }
@@ -3600,11 +3722,7 @@ namespace LLP
 
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::CHECKPOINT)
-                            {
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::CHECKPOINT);
-                                ssRelay << hashCheck;
-                            }
+                                fRelay = true;
 
                             break;
                         }
@@ -3626,11 +3744,7 @@ namespace LLP
 
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::BESTCHAIN)
-                            {
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::BESTCHAIN);
-                                ssRelay << hashBest;
-                            }
+                                fRelay = true;
 
                             break;
                         }
@@ -3652,11 +3766,7 @@ namespace LLP
 
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::ADDRESS)
-                            {
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::ADDRESS);
-                                ssRelay << addr;
-                            }
+                                fRelay = true;
 
                             break;
                         }
@@ -3680,14 +3790,7 @@ namespace LLP
                                 if(hashSigchain != hashGenesis)
                                     break;
 
-                                /* Check for legacy. */
-                                if(fLegacy)
-                                    ssRelay << uint8_t(SPECIFIER::LEGACY);
-
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::SIGCHAIN);
-                                ssRelay << hashSigchain;
-                                ssRelay << hashTx;
+                                fRelay = true;
                             }
 
                             break;
@@ -3719,10 +3822,7 @@ namespace LLP
                                 if(!setSubscriptions.count(hashAddress))
                                     break;
 
-                                /* Write transaction to stream. */
-                                ssRelay << uint8_t(TYPES::REGISTER);
-                                ssRelay << hashAddress;
-                                ssRelay << hashTx;
+                                fRelay = true;
                             }
 
                             break;
@@ -3732,9 +3832,18 @@ namespace LLP
                         default:
                         {
                             debug::error(FUNCTION, "Malformed binary stream");
-                            return ssRelay;
+                            return;
                         }
                     }
+
+                    /* Relay this notification, joining it to the last one kept when they are adjacent. */
+                    if(fRelay)
+                    {
+                        if(!vRanges.empty() && vRanges.back().second == nBegin)
+                            vRanges.back().second = ssData.GetPos();
+                        else
+                            vRanges.push_back(std::make_pair(nBegin, ssData.GetPos()));
+                    }
                 }
 
                 break;
@@ -3743,12 +3852,11 @@ namespace LLP
             default:
             {
                 /* default behaviour is to let the message be relayed */
-                ssRelay = ssData;
+                if(ssData.size() > 0)
+                    vRanges.push_back(std::make_pair(0, ssData.size()));
                 break;
             }
         }
-
-        return ssRelay;
     }
 
 
@@ -3938,6 +4046,40 @@ namespace LLP
         /* Subscribe to this node. */
         Subscribe(SUBSCRIPTION::LASTINDEX | SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
 
+        /* Ask for headers first, so blocks can be downloaded in windows from all of our nodes. */
+        if(HeaderSync::Enabled())
+        {
+            /* Start our headers, or continue from our last header if we switched sync nodes. */
+            HeaderSync::Start();
+
+            /* Ask for list of headers from our last header. */
+            const uint1024_t hashLast = HeaderSync::LastHeader();
+            if(hashLast != TAO::Ledger::ChainState::hashBestChain.load())
+            {
+                PushMessage(ACTION::LIST,
+                    uint8_t(SPECIFIER::CLIENT),
+                    uint8_t(TYPES::BLOCK),
+                    uint8_t(TYPES::UINT1024_T),
+                    hashLast,
+                    uint1024_t(0)
+                );
+            }
+
+            /* Otherwise find our common ancestor with a locator. */
+            else
+            {
+                PushMessage(ACTION::LIST,
+                    uint8_t(SPECIFIER::CLIENT),
+                    uint8_t(TYPES::BLOCK),
+                    uint8_t(TYPES::LOCATOR),
+                    TAO::Ledger::Locator(hashLast),
+                    uint1024_t(0)
+                );
+            }
+
+            return;
+        }
+
         /* Ask for list of blocks if this is current sync node. */
         PushMessage(ACTION::LIST,
             config::fClient.load() ? uint8_t(SPECIFIER::CLIENT) : uint8_t(SPECIFIER::SYNC),
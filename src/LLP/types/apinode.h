@@ -94,6 +94,20 @@ namespace LLP
          **/
         bool Authorized(std::map<std::string, std::string>& mapHeaders);
 
+
+    private:
+
+        /** push_stream
+         *
+         *  Write a response with an array result in chunks, serializing one row at a time into a bounded buffer
+         *  and releasing each row once it is written, so the whole response is never held as one string.
+         *
+         *  @param[in] RESPONSE The response packet holding our status and headers.
+         *  @param[in] jRet The response to write, which has its rows released as they are written.
+         *
+         **/
+        void push_stream(HTTPPacket& RESPONSE, encoding::json& jRet);
+
     };
 }
 
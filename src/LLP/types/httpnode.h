@@ -111,6 +111,19 @@ namespace LLP
         void ReadPacket() final;
 
 
+        /** WriteChunk
+         *
+         *  Write a chunk of content for a response sent with chunked transfer encoding. The header is written
+         *  first as a packet with fChunked set, and an empty chunk ends the content.
+         *
+         *  @param[in] strChunk The content to write in this chunk.
+         *
+         *  @return True if the chunk was written, false if the send buffer is full and the response can't be finished.
+         *
+         **/
+        bool WriteChunk(const std::string& strChunk);
+
+
         /** PushResponse
          *
          *  Returns an HTTP packet with response code and content.
@@ -502,10 +502,12 @@ namespace LLP
          *
          *  Checks if a node is subscribed to receive a notification.
          *
-         *  @return a data stream with relevant relay information
+         *  @param[in] nMsg The message type being relayed.
+         *  @param[in] ssData The data being relayed.
+         *  @param[out] vRanges The byte ranges of the data with relevant relay information.
          *
          **/
-        const DataStream RelayFilter(const uint16_t nMsg, const DataStream& ssData) const;
+        void RelayFilter(const uint16_t nMsg, const DataStream& ssData, std::vector<std::pair<uint64_t, uint64_t>>& vRanges) const;
 
 
         /** Auth
@@ -686,6 +688,20 @@ namespace LLP
          **/
         void Sync();
 
+
+    private:
+
+        /** process_packet
+         *
+         *  Handle a packet's message once its payload is deserialized.
+         *
+         *  @param[in] ssPacket The packet's payload.
+         *
+         *  @return false if the node should be disconnected.
+         *
+         **/
+        bool process_packet(DataStream& ssPacket);
+
     };
 } // end namespace LLP
 
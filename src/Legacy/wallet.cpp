@@ -89,6 +89,8 @@ namespace Legacy
     , vchDefaultKey     ( )
     , vchTrustKey       ( )
     , nWalletUnlockTime (0)
+    , mapUnspent        ( )
+    , fUnspentIndexed   (false)
     , cs_wallet         ( )
     , mapWallet         ( )
     {
@@ -755,9 +757,12 @@ namespace Legacy
         {
             RECURSIVE(cs_wallet);
             nBalance = 0;
-            for(auto it = mapWallet.begin(); it != mapWallet.end(); ++it)
+
+            /* Only walk the transactions that still have unspent outputs */
+            RefreshUnspent();
+            for(const auto& pairUnspent : mapUnspent)
             {
-                const WalletTx* pcoin = &(*it).second;
+                const WalletTx* pcoin = &mapWallet.at(pairUnspent.first);
                 if(!pcoin->IsFinal())
                     continue;
 
@@ -767,10 +772,10 @@ namespace Legacy
                 if((pcoin->IsCoinBase() || pcoin->IsCoinStake()) && pcoin->GetBlocksToMaturity() > 0)
                     continue;
 
-                for(int i = 0; i < pcoin->vout.size(); i++)
+                for(const uint32_t i : pairUnspent.second)
                 {
 
-                    if(!pcoin->IsSpent(i) && IsMine(pcoin->vout[i]) && pcoin->vout[i].nValue > 0)
+                    if(pcoin->vout[i].nValue > 0)
                     {
                         if(strAccount == "*")
                         {
@@ -885,9 +890,11 @@ namespace Legacy
 
             vCoins.clear();
 
-            for(const auto& item : mapWallet)
+            /* Only walk the transactions that still have unspent outputs */
+            RefreshUnspent();
+            for(const auto& pairUnspent : mapUnspent)
             {
-                const WalletTx& wtx = item.second;
+                const WalletTx& wtx = mapWallet.at(pairUnspent.first);
 
                 /* Filter transactions not final */
                 if (!wtx.IsFinal())
@@ -901,14 +908,14 @@ namespace Legacy
                 if ((wtx.IsCoinBase() || wtx.IsCoinStake()) && wtx.GetBlocksToMaturity() > 0)
                     continue;
 
-                for (uint32_t i = 0; i < wtx.vout.size(); i++)
+                for (const uint32_t i : pairUnspent.second)
                 {
                     /* Filter transactions after requested spend time */
                     if (wtx.nTime > nSpendTime)
                         continue;
 
-                    /* To be included in result, vout must not be spent, must belong to current wallet, and must have positive value */
-                    if (!(wtx.IsSpent(i)) && IsMine(wtx.vout[i]) && wtx.vout[i].nValue > 0)
+                    /* The index only holds unspent outputs of this wallet, so to be included in result, vout must have positive value */
+                    if (wtx.vout[i].nValue > 0)
                     {
                         /* Create output from the current vout and add to result */
                         Output txOutput(wtx, i, wtx.GetDepthInMainChain());
@@ -1034,6 +1041,9 @@ namespace Legacy
             }
         }
 
+        /* Add any of our outputs that are still unspent to the unspent index */
+        IndexUnspent(hash, wtx);
+
         /* since AddToWallet is called directly for self-originating transactions, check for consumption of own coins */
         WalletUpdateSpent(wtx);
 
@@ -1195,6 +1205,8 @@ namespace Legacy
                     {
                         txPrev.MarkUnspent(txin.prevout.n);
                         txPrev.WriteToDisk(tx.GetHash());
+
+                        IndexUnspent(txin.prevout.hash, txPrev);
                     }
                 }
             }
@@ -1515,6 +1527,8 @@ namespace Legacy
 
                         wtx.MarkSpent(txin.prevout.n);
                         wtx.WriteToDisk(txin.prevout.hash);
+
+                        RemoveUnspent(txin.prevout.hash, txin.prevout.n);
                     }
                 }
             }
@@ -1597,7 +1611,12 @@ namespace Legacy
 
             /* Update mapWallet with repaired transactions */
             for (const auto& map : mapRepaired)
+            {
                 mapWallet[map.first] = map.second;
+
+                /* Outputs that were repaired as unspent need to go back into the unspent index */
+                IndexUnspent(map.first, mapWallet[map.first]);
+            }
         }
     }
 
@@ -2116,6 +2135,8 @@ namespace Legacy
                 txPrev.BindWallet(this);
                 txPrev.MarkSpent(txin.prevout.n);
                 txPrev.WriteToDisk(wtxNew.GetHash()); //Stores to wallet database
+
+                RemoveUnspent(txin.prevout.hash, txin.prevout.n);
             }
         }
 
@@ -2143,9 +2164,11 @@ namespace Legacy
         /* Keep a local list of wallet pointers. */
         std::vector<uint512_t> vCoins;
 
-        /* Build a set of wallet transactions from all transaction in the wallet map */
-        vCoins.reserve(mapWallet.size());
-        for (const auto& item : mapWallet)
+        /* Build a set of wallet transactions from the transactions that still have unspent outputs */
+        RefreshUnspent();
+
+        vCoins.reserve(mapUnspent.size());
+        for (const auto& item : mapUnspent)
             vCoins.push_back(item.first);
 
         /* Randomly order the transactions as potential inputs */
@@ -2174,13 +2197,9 @@ namespace Legacy
             if (wtx->nTime > block.vtx[0].nTime)
                 continue;
 
-            /* Transaction is ok to use. Now determine which transaction outputs to include in coinstake input */
-            for (uint32_t i = 0; i < wtx->vout.size(); i++)
+            /* Transaction is ok to use. Now determine which unspent outputs to include in coinstake input */
+            for (const uint32_t i : mapUnspent[hash])
             {
-                /* Can't spend outputs that are already spent or not belonging to this wallet */
-                if (wtx->IsSpent(i) || !IsMine(wtx->vout[i]))
-                    continue;
-
                 /* Stop adding Inputs if has reached Maximum Transaction Size. */
                 unsigned int nBytes = ::GetSerializeSize(block.vtx[0], SER_NETWORK, LLP::PROTOCOL_VERSION);
                 if(nBytes >= TAO::Ledger::MAX_BLOCK_SIZE_GEN / 5)
@@ -2300,9 +2319,11 @@ namespace Legacy
         if(config::GetBoolArg("-printselectcoin", false))
             debug::log(0, FUNCTION, "Selecting coins for account ", strAccount);
 
-        /* Build a set of wallet transactions from all transaction in the wallet map */
-        vCoins.reserve(mapWallet.size());
-        for(const auto& item : mapWallet)
+        /* Build a set of wallet transactions from the transactions that still have unspent outputs */
+        RefreshUnspent();
+
+        vCoins.reserve(mapUnspent.size());
+        for(const auto& item : mapUnspent)
             vCoins.push_back(item.first);
 
         /* Randomly order the transactions as potential inputs */
@@ -2330,17 +2351,9 @@ namespace Legacy
             if((wtx->IsCoinBase() || wtx->IsCoinStake()) && wtx->GetBlocksToMaturity() > 0)
                 continue;
 
-            /* So far, the transaction itself is available, now have to check each output to see if there are any we can use */
-            for(uint32_t i = 0; i < wtx->vout.size(); i++)
+            /* So far, the transaction itself is available, now have to check each unspent output to see if there are any we can use */
+            for(const uint32_t i : mapUnspent[hash])
             {
-                /* Check for null values. */
-                if(wtx->vout[i].IsNull())
-                    continue;
-
-                /* Can't spend outputs that are already spent or not belonging to this wallet */
-                if(wtx->IsSpent(i) || !IsMine(wtx->vout[i]))
-                    continue;
-
                 /* Handle send from specific address here. */
                 if(fromAddress.IsValid())
                 {
@@ -2426,4 +2439,87 @@ namespace Legacy
         return true;
     }
 
+
+    /* Adds the unspent outputs of a wallet transaction that belong to this wallet to the unspent index. */
+    void Wallet::IndexUnspent(const uint512_t& hash, const WalletTx& wtx)
+    {
+        RECURSIVE(cs_wallet);
+
+        /* Nothing to do until the index is built, it will pick these outputs up from mapWallet */
+        if(!fUnspentIndexed)
+            return;
+
+        for(uint32_t n = 0; n < wtx.vout.size(); ++n)
+        {
+            /* Only index outputs that can still be spent by this wallet */
+            if(wtx.vout[n].IsNull() || wtx.IsSpent(n) || !IsMine(wtx.vout[n]))
+                continue;
+
+            mapUnspent[hash].insert(n);
+        }
+    }
+
+
+    /* Removes an output that has been spent from the unspent index. */
+    void Wallet::RemoveUnspent(const uint512_t& hash, const uint32_t nOut)
+    {
+        RECURSIVE(cs_wallet);
+
+        /* Check that we are holding this transaction. */
+        auto it = mapUnspent.find(hash);
+        if(it == mapUnspent.end())
+            return;
+
+        /* Drop the transaction once it has no unspent outputs left. */
+        it->second.erase(nOut);
+        if(it->second.empty())
+            mapUnspent.erase(it);
+    }
+
+
+    /* Builds the unspent index on first use, then prunes any outputs that have since been spent. */
+    void Wallet::RefreshUnspent()
+    {
+        RECURSIVE(cs_wallet);
+
+        /* Walk the whole wallet once to build our index. */
+        if(!fUnspentIndexed)
+        {
+            fUnspentIndexed = true;
+            for(const auto& item : mapWallet)
+                IndexUnspent(item.first, item.second);
+
+            debug::log(2, FUNCTION, "Indexed ", mapUnspent.size(), " transactions with unspent outputs from ", mapWallet.size());
+
+            return;
+        }
+
+        /* Outputs can be marked spent or transactions removed without going through RemoveUnspent. */
+        for(auto it = mapUnspent.begin(); it != mapUnspent.end(); )
+        {
+            /* Check the transaction is still in our wallet. */
+            const auto mi = mapWallet.find(it->first);
+            if(mi == mapWallet.end())
+            {
+                it = mapUnspent.erase(it);
+                continue;
+            }
+
+            /* Remove any outputs that have been spent. */
+            for(auto itOut = it->second.begin(); itOut != it->second.end(); )
+            {
+                if(mi->second.IsSpent(*itOut))
+                    itOut = it->second.erase(itOut);
+                else
+                    ++itOut;
+            }
+
+            /* Remove the transaction once all of its outputs are spent. */
+            if(it->second.empty())
+                it = mapUnspent.erase(it);
+            else
+                ++it;
+        }
+    }
+
 }
@@ -255,6 +255,16 @@ namespace Legacy
         uint64_t nWalletUnlockTime;
 
 
+        /** Output indexes of this wallet's unspent outputs by transaction hash, so selecting coins doesn't have to
+         *  walk every wallet transaction. Spent outputs are pruned the next time the index is used.
+         **/
+        std::map<uint512_t, std::set<uint32_t>> mapUnspent;
+
+
+        /** Flag indicating whether or not mapUnspent has been built from mapWallet. **/
+        bool fUnspentIndexed;
+
+
 
     public:
         /** Mutex for thread concurrency across wallet operations **/
@@ -1162,6 +1172,40 @@ namespace Legacy
     /*----------------------------------------------------------------------------------------*/
     /*  Helper Methods                                                                        */
     /*----------------------------------------------------------------------------------------*/
+        /** IndexUnspent
+         *
+         *  Adds the unspent outputs of a wallet transaction that belong to this wallet to the unspent index.
+         *  Does nothing until the index has been built, since building it will pick them up.
+         *
+         *  @param[in] hash The transaction hash
+         *
+         *  @param[in] wtx The wallet transaction to index
+         *
+         **/
+        void IndexUnspent(const uint512_t& hash, const WalletTx& wtx);
+
+
+        /** RemoveUnspent
+         *
+         *  Removes an output that has been spent from the unspent index.
+         *
+         *  @param[in] hash The transaction hash
+         *
+         *  @param[in] nOut The output index
+         *
+         **/
+        void RemoveUnspent(const uint512_t& hash, const uint32_t nOut);
+
+
+        /** RefreshUnspent
+         *
+         *  Builds the unspent index from mapWallet on first use, then prunes any outputs that have since been spent
+         *  or whose transactions have been removed from the wallet.
+         *
+         **/
+        void RefreshUnspent();
+
+
        /** SelectCoins
          *
          *  Selects the unspent transaction outputs to use as inputs when creating a transaction that sends
@@ -22,6 +22,8 @@ ________________________________________________________________________________
 #include <TAO/API/types/authentication.h>
 #include <TAO/API/types/notifications.h>
 
+#include <TAO/Ledger/types/transaction.h>
+
 #include <TAO/Register/types/address.h>
 #include <TAO/Register/types/object.h>
 
@@ -594,6 +596,20 @@ namespace TAO::API
 
             /* Update our internal session. */
             rSession.Update(strNewPIN, nUpdatedActions);
+
+            /* Derive the keys for our next transaction in the background while we are unlocked for transactions. */
+            if(nUpdatedActions & TAO::Ledger::PinUnlock::UnlockActions::TRANSACTIONS)
+            {
+                /* Get the last transaction of our sigchain. */
+                uint512_t hashLast;
+                if(LLD::Ledger->ReadLast(rSession.Genesis(), hashLast, TAO::Ledger::FLAGS::MEMPOOL))
+                {
+                    /* Our next transaction is signed by the key after it. */
+                    TAO::Ledger::Transaction txLast;
+                    if(LLD::Ledger->ReadTx(hashLast, txLast, TAO::Ledger::FLAGS::MEMPOOL))
+                        rSession.Credentials()->Prefill(txLast.nSequence + 1, strNewPIN);
+                }
+            }
         }
     }
 
@@ -23,6 +23,8 @@ ________________________________________________________________________________
 
 #include <Util/include/string.h>
 
+#include <limits>
+
 /* Global TAO namespace. */
 namespace TAO::API
 {
@@ -131,17 +133,96 @@ namespace TAO::API
             if(nSettings & ENABLE::CACHING)
             {
                 /* Check if we can get it in a cache. */
-                if(!xFunction.oCache.Get(jParams, jResults))
+                std::shared_ptr<const ResultIndex> pResults;
+                if(!xFunction.oCache.Get(jParams, pResults))
                 {
                     /* Execute our function so we can have an up to date cache. */
-                    jResults =
-                        xFunction.Execute(jParams, fHelp);
-
-                    /* Now insert it into our cache. */
-                    xFunction.oCache.Insert(jParams, jResults);
+                    pResults =
+                        xFunction.oCache.Insert(jParams, xFunction.Execute(jParams, fHelp));
                 }
                 else
-                    debug::notice("Using CACHE for ", strMethod, " of size ", jResults.size());
+                    debug::notice("Using CACHE for ", strMethod, " of size ", pResults->Results().size());
+
+                /* Get a reference of our cached results. */
+                const encoding::json& jRows =
+                    pResults->Results();
+
+                /* Only arrays can be sorted and paged. */
+                if(!jRows.is_array())
+                    jResults = jRows;
+                else
+                {
+                    /* Get our sorted index if enabled. */
+                    const std::vector<uint32_t>* pSorted = nullptr;
+
+                    /* Get our current order and column. */
+                    std::string strOrder = "desc", strColumn = xFunction.oCache.strDefaultColumn;
+                    if(nSettings & ENABLE::SORTING)
+                    {
+                        ExtractSort(jParams, strOrder, strColumn);
+                        pSorted = &pResults->Sorted(strColumn);
+                    }
+
+                    /* Descending order walks our index backwards. */
+                    const bool fDesc =
+                        (strOrder == "desc");
+
+                    /* Check if we are reading a page of our results without an operator needing all of them. */
+                    const bool fPage = (nSettings & ENABLE::PAGING) &&
+                        !((nSettings & ENABLE::OPERATORS) && CheckRequest(jParams, "operator", "string, array"));
+
+                    /* Number of results to return. */
+                    uint32_t nLimit = std::numeric_limits<uint32_t>::max(), nOffset = 0;
+                    if(fPage)
+                        ExtractList(jParams, nLimit, nOffset);
+
+                    /* Build our results in order, only copying the rows we need. */
+                    jResults = encoding::json::array();
+
+                    /* Loop through our rows in order. */
+                    uint32_t nTotal = 0;
+                    for(uint32_t n = 0; n < jRows.size(); ++n)
+                    {
+                        /* Get the position of our row from our index. */
+                        const uint32_t nRow =
+                            (pSorted ? (*pSorted)[fDesc ? jRows.size() - n - 1 : n] : n);
+
+                        /* Copy our row so that our filters don't change the cache. */
+                        encoding::json jItem = jRows[nRow];
+
+                        /* Check our filters when paging, since they come before the page is taken. */
+                        if(fPage)
+                        {
+                            /* Check that we match our filters. */
+                            if((nSettings & ENABLE::QUERIES) && !FilterResults(jParams, jItem))
+                                continue;
+
+                            /* Check that we match our filters. */
+                            if((nSettings & ENABLE::FILTERS) && !FilterFieldname(jParams, jItem))
+                                continue;
+
+                            /* Check the offset. */
+                            if(++nTotal <= nOffset)
+                                continue;
+
+                            /* Check the limit */
+                            if(jResults.size() >= nLimit)
+                                break;
+                        }
+
+                        jResults.emplace_back(std::move(jItem));
+                    }
+
+                    /* Return our page now that it has been filtered. */
+                    if(fPage)
+                    {
+                        /* Check that our offset is in range. */
+                        if(nOffset > nTotal)
+                            throw Exception(-75, "Value [offset=", nOffset, "] exceeds dataset size [", nTotal, "]");
+
+                        return jResults;
+                    }
+                }
             }
             else
                 jResults = xFunction.Execute(jParams, fHelp);
@@ -155,10 +155,11 @@ namespace TAO::API
             }
 
             /* Add mutable flag */
-            jField["mutable"] = rObject.mapData[strMember].second;
+            const bool fMutable = rObject.Check(strMember, nType, true);
+            jField["mutable"] = fMutable;
 
             /* If mutable, add the max size */
-            if(rObject.mapData[strMember].second && nMaxSize > 0)
+            if(fMutable && nMaxSize > 0)
                 jField["maxlength"] = nMaxSize;
 
             /* Add the field to the response array */
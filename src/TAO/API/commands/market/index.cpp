@@ -44,80 +44,188 @@ namespace TAO::API
             /* Check that transaction has a condition. */
             case TAO::Operation::OP::CONDITION:
             {
-                /* Check for valid exchange contract. */
-                if(Contracts::Verify(Contracts::Exchange::Token[0], rContract)) //checking for version 1
+                /* Get the market side of our order. */
+                std::pair<uint256_t, uint256_t> pairMarket;
+                if(!OrderMarket(rContract, pairMarket))
+                    break;
+
+                /* Write the order to logical database, unless it was written before its block was disconnected. */
+                if(!LLD::Logical->HasOrder(rContract.Hash(), nContract) && !LLD::Logical->PushOrder(pairMarket, rContract, nContract))
+                    debug::warning(FUNCTION, "Market indexes failed to be pushed ", rContract.Hash().SubString());
+
+                /* Add the order to our book, if its block wasn't disconnected before we got here. */
+                else if(LLD::Ledger->HasIndex(rContract.Hash()))
+                    tBook.Insert(pairMarket, rContract, nContract);
+
+                /* Give a verbose=3 debug log for the indexing entry. */
+                if(config::nVerbose >= 3)
                 {
-                    try //in case de-serialization fails from non-standard contracts
-                    {
-                        /* Get the next OP. */
-                        rContract.Seek(4, TAO::Operation::Contract::CONDITIONS);
-
-                        /* Get the comparison bytes. */
-                        TAO::Operation::Stream ssBytes;
-                        rContract >= ssBytes;
-
-                        /* Skip ahead to our token-id. */
-                        ssBytes.seek(33, STREAM::BEGIN);
-
-                        /* Grab our deposit token-id now. */
-                        uint256_t hashDeposit;
-                        ssBytes >> hashDeposit;
-
-                        /* Read the object to get token-id. */
-                        TAO::Register::Object oDeposit;
-                        if(!LLD::Register->ReadObject(hashDeposit, oDeposit))
-                            return;
-
-                        /* Grab our other withdraw token-id from pre-state. */
-                        TAO::Register::Object oWithdraw =
-                            rContract.PreState();
-
-                        /* Skip over non objects for now. */
-                        if(oWithdraw.nType != TAO::Register::REGISTER::OBJECT)
-                            return;
-
-                        /* Parse pre-state if needed. */
-                        oWithdraw.Parse();
-
-                        /* Create our market-pair. */
-                        const std::pair<uint256_t, uint256_t> pairMarket =
-                            std::make_pair(oDeposit.get<uint256_t>("token"), oWithdraw.get<uint256_t>("token"));
-
-                        /* Write the order to logical database. */
-                        if(!LLD::Logical->PushOrder(pairMarket, rContract, nContract))
-                            debug::warning(FUNCTION, "Market indexes failed to be pushed ", rContract.Hash().SubString());
-
-                        /* Give a verbose=3 debug log for the indexing entry. */
-                        if(config::nVerbose >= 3)
-                        {
-                            /* This will hold our market name. */
-                            std::string strMarket =
-                                (TAO::Register::Address(pairMarket.first).ToString() + "/");
-
-                            /* Build our market-pair. */
-                            std::string strName;
-                            if(Names::ReverseLookup(pairMarket.first, strName))
-                                strMarket = strName + "/";
-
-                            /* Now add our second pair. */
-                            if(!Names::ReverseLookup(pairMarket.second, strName))
-                                strMarket += TAO::Register::Address(pairMarket.second).ToString();
-                            else
-                                strMarket += strName;
-
-                            /* Output our new debug info. */
-                            debug::log(3, "Market ", strMarket, " record created for ", rContract.Hash().SubString(), " txid");
-                        }
-
-                    }
-                    catch(const std::exception& e)
-                    {
-                        debug::warning(e.what());
-                    }
+                    /* This will hold our market name. */
+                    std::string strMarket =
+                        (TAO::Register::Address(pairMarket.first).ToString() + "/");
+
+                    /* Build our market-pair. */
+                    std::string strName;
+                    if(Names::ReverseLookup(pairMarket.first, strName))
+                        strMarket = strName + "/";
+
+                    /* Now add our second pair. */
+                    if(!Names::ReverseLookup(pairMarket.second, strName))
+                        strMarket += TAO::Register::Address(pairMarket.second).ToString();
+                    else
+                        strMarket += strName;
+
+                    /* Output our new debug info. */
+                    debug::log(3, "Market ", strMarket, " record created for ", rContract.Hash().SubString(), " txid");
                 }
 
                 break;
             }
+
+            /* Executing or cancelling an order validates or credits its contract. */
+            case TAO::Operation::OP::VALIDATE:
+            case TAO::Operation::OP::CREDIT:
+            {
+                /* Get the order's txid. */
+                uint512_t hashOrder;
+                rContract >> hashOrder;
+
+                /* Get the order's contract-id. */
+                uint32_t nOrder = 0;
+                rContract >> nOrder;
+
+                /* Our block may have been disconnected before we got here, so check the order is still spent. */
+                const std::pair<uint512_t, uint32_t> pairOrder = std::make_pair(hashOrder, nOrder);
+                if(nType == TAO::Operation::OP::VALIDATE)
+                {
+                    /* Check for the validation record of an executed order. */
+                    if(!LLD::Contract->HasContract(pairOrder))
+                        break;
+                }
+                else
+                {
+                    /* Skip over the address we credited. */
+                    rContract.Seek(32);
+
+                    /* Get the proof of our credit. */
+                    uint256_t hashProof;
+                    rContract >> hashProof;
+
+                    /* Check for the proof of a cancelled order. */
+                    if(!LLD::Ledger->HasProof(hashProof, hashOrder, nOrder))
+                        break;
+                }
+
+                /* Take the order out of our book. */
+                if(tBook.Remove(pairOrder))
+                    debug::log(3, "Market order ", hashOrder.SubString(), " removed from book");
+
+                break;
+            }
+        }
+    }
+
+
+    /* Generic handler for undoing indexes of this command-set when a contract is disconnected. */
+    void Market::Disconnect(const TAO::Operation::Contract& rContract, const uint32_t nContract)
+    {
+        /* Start our stream at 0. */
+        rContract.Reset();
+
+        /* Get the operation byte. */
+        uint8_t nType = 0;
+        rContract >> nType;
+
+        /* Orders that are no longer in the chain are taken out of our book. */
+        if(nType == TAO::Operation::OP::CONDITION)
+        {
+            if(tBook.Remove(std::make_pair(rContract.Hash(), nContract)))
+                debug::log(3, "Market order ", rContract.Hash().SubString(), " disconnected from book");
+
+            return;
         }
+
+        /* Only executed or cancelled orders were taken out of our book. */
+        if(nType != TAO::Operation::OP::VALIDATE && nType != TAO::Operation::OP::CREDIT)
+            return;
+
+        /* Get the order's txid. */
+        uint512_t hashOrder;
+        rContract >> hashOrder;
+
+        /* Get the order's contract-id. */
+        uint32_t nOrder = 0;
+        rContract >> nOrder;
+
+        /* Catch exception if we throw on ReadContract. */
+        try
+        {
+            /* Get the contract of our order, which is open again. */
+            const TAO::Operation::Contract tOrder =
+                LLD::Ledger->ReadContract(hashOrder, nOrder);
+
+            /* Credits of plain debits aren't market orders. */
+            std::pair<uint256_t, uint256_t> pairMarket;
+            if(!OrderMarket(tOrder, pairMarket))
+                return;
+
+            /* Put the order back into our book. */
+            tBook.Insert(pairMarket, tOrder, nOrder);
+
+            debug::log(3, "Market order ", hashOrder.SubString(), " restored to book");
+        }
+        catch(const std::exception& e) { }
+    }
+
+
+    /* Get the market side an exchange contract is indexed under. */
+    bool Market::OrderMarket(const TAO::Operation::Contract& rContract, std::pair<uint256_t, uint256_t> &pairMarket)
+    {
+        /* Check for valid exchange contract. */
+        if(!Contracts::Verify(Contracts::Exchange::Token[0], rContract)) //checking for version 1
+            return false;
+
+        try //in case de-serialization fails from non-standard contracts
+        {
+            /* Get the next OP. */
+            rContract.Seek(4, TAO::Operation::Contract::CONDITIONS);
+
+            /* Get the comparison bytes. */
+            TAO::Operation::Stream ssBytes;
+            rContract >= ssBytes;
+
+            /* Skip ahead to our token-id. */
+            ssBytes.seek(33, STREAM::BEGIN);
+
+            /* Grab our deposit token-id now. */
+            uint256_t hashDeposit;
+            ssBytes >> hashDeposit;
+
+            /* Read the object to get token-id. */
+            TAO::Register::Object oDeposit;
+            if(!LLD::Register->ReadObject(hashDeposit, oDeposit))
+                return false;
+
+            /* Grab our other withdraw token-id from pre-state. */
+            TAO::Register::Object oWithdraw =
+                rContract.PreState();
+
+            /* Skip over non objects for now. */
+            if(oWithdraw.nType != TAO::Register::REGISTER::OBJECT)
+                return false;
+
+            /* Parse pre-state if needed. */
+            oWithdraw.Parse();
+
+            /* Create our market-pair. */
+            pairMarket = std::make_pair(oDeposit.get<uint256_t>("token"), oWithdraw.get<uint256_t>("token"));
+        }
+        catch(const std::exception& e)
+        {
+            debug::warning(e.what());
+            return false;
+        }
+
+        return true;
     }
 }
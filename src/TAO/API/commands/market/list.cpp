@@ -14,6 +14,7 @@ ________________________________________________________________________________
 #include <LLD/include/global.h>
 
 #include <TAO/API/include/build.h>
+#include <TAO/API/include/check.h>
 #include <TAO/API/include/compare.h>
 #include <TAO/API/include/extract.h>
 #include <TAO/API/include/filter.h>
@@ -59,178 +60,268 @@ namespace TAO::API
         encoding::json jRet =
             encoding::json::object();
 
-        /* Check for our bids type. */
-        if(setTypes.find("bid") != setTypes.end() || fAll)
+        /* Check if our orders need to be built before they can be paged. */
+        const bool fFilter =
+            (jParams.find("where") != jParams.end() || CheckRequest(jParams, "fieldname", "string, array"));
+
+        /* Open orders are sorted by price unless asked otherwise, and executed orders by our defaults above. */
+        const bool fSort  = CheckParameter(jParams, "sort", "string");
+        const bool fOrder = CheckParameter(jParams, "order", "string");
+
+        /* Pages the open orders of a market side from our book, which lists them by best price first. */
+        const auto fnBook = [&](const std::pair<uint256_t, uint256_t>& pairSide, const std::string& strBest)
         {
-            /* Set our default sort by price for non executed. */
-            if(!fExecuted)
-            {
-                strColumn = "price";
-                strOrder  = "desc";
-            }
+            /* Get the sorting asked for, where our book's order is the best price first. */
+            const std::string strSideColumn = (fSort  ? strColumn : std::string("price"));
+            const std::string strSideOrder  = (fOrder ? strOrder  : strBest);
 
-            /* Get a list of our active orders. */
-            std::vector<std::pair<uint512_t, uint32_t>> vBids;
-            if(LLD::Logical->ListAllOrders(pairMarket, vBids))
-            {
-                /* Build our object list and sort on insert. */
-                std::set<encoding::json, CompareResults> setBids({}, CompareResults(strOrder, strColumn));
+            /* Any other sorting needs every order built before it can be paged. */
+            const bool fSorted =
+                (strSideColumn != "price" || strSideOrder != strBest);
 
-                /* Build our list of orders now. */
-                for(const auto& pairOrder : vBids)
-                {
-                    /* Catch exception if we throw on ReadContract. */
-                    try
-                    {
-                        /* Get our contract now. */
-                        const TAO::Operation::Contract tContract =
-                            LLD::Ledger->ReadContract(pairOrder.first, pairOrder.second);
+            /* Build our object list and sort on insert, when our book's order can't be used. */
+            std::set<encoding::json, CompareResults> setSorted({}, CompareResults(strSideOrder, strSideColumn));
 
-                        /* Unpack our register address. */
-                        uint256_t hashRegister;
-                        if(!TAO::Register::Unpack(tContract, hashRegister))
-                            continue;
+            /* Build our return value. */
+            encoding::json jOrders = encoding::json::array();
 
-                        /* Check if the order has been executed. */
-                        if(LLD::Contract->HasContract(pairOrder, TAO::Ledger::FLAGS::MEMPOOL) != fExecuted)
-                            continue;
+            /* Walk our price levels until our page is full. */
+            uint32_t nTotal = 0;
+            tBook.List(pairSide, [&](const std::pair<uint512_t, uint32_t>& pairOrder, const TAO::Operation::Contract& rContract)
+            {
+                /* Check the limit */
+                if(!fSorted && jOrders.size() == nLimit)
+                    return false;
 
-                        /* Check for a spent proof already. */
-                        if(LLD::Ledger->HasProof(hashRegister, pairOrder.first, pairOrder.second) && !fExecuted)
-                            continue;
+                /* Check if the order is being executed in the mempool. */
+                if(LLD::Contract->HasContract(pairOrder, TAO::Ledger::FLAGS::MEMPOOL))
+                    return true;
 
-                        /* Get our order's json. */
-                        encoding::json jOrder =
-                            OrderToJSON(tContract, pairMarket);
+                /* Check the offset, without building orders that are only being skipped. */
+                if(!fSorted && !fFilter && ++nTotal <= nOffset)
+                    return true;
 
-                        /* Check for null value. */
-                        if(jOrder.is_null())
-                            continue;
+                /* Get our order's json. */
+                encoding::json jOrder =
+                    OrderToJSON(rContract, pairMarket);
 
-                        /* Check that we match our filters. */
-                        if(!FilterResults(jParams, jOrder))
-                            continue;
+                /* Check for null value. */
+                if(jOrder.is_null())
+                    return true;
 
-                        /* Filter out our expected fieldnames if specified. */
-                        if(!FilterFieldname(jParams, jOrder))
-                            continue;
+                /* Check that we match our filters. */
+                if(!FilterResults(jParams, jOrder))
+                    return true;
 
-                        /* Insert into set and automatically sort. */
-                        setBids.insert(jOrder);
-                    }
-                    catch(const std::exception& e) { }
+                /* Filter out our expected fieldnames if specified. */
+                if(!FilterFieldname(jParams, jOrder))
+                    return true;
+
+                /* Insert into set and automatically sort. */
+                if(fSorted)
+                {
+                    setSorted.insert(jOrder);
+                    return true;
                 }
 
-                /* Build our return value. */
-                encoding::json jBids = encoding::json::array();
+                /* Check the offset once filtered. */
+                if(fFilter && ++nTotal <= nOffset)
+                    return true;
 
-                /* Handle paging and offsets. */
-                uint32_t nTotal = 0;
-                for(const auto& jOrder : setBids)
-                {
-                    /* Check the offset. */
-                    if(++nTotal <= nOffset)
-                        continue;
+                jOrders.push_back(jOrder);
 
-                    /* Check the limit */
-                    if(jBids.size() == nLimit)
-                        break;
+                return true;
+            });
 
-                    jBids.push_back(jOrder);
-                }
+            /* Handle paging and offsets of sorted orders. */
+            for(const auto& jOrder : setSorted)
+            {
+                /* Check the offset. */
+                if(++nTotal <= nOffset)
+                    continue;
+
+                /* Check the limit */
+                if(jOrders.size() == nLimit)
+                    break;
 
-                /* Add to our return value. */
-                jRet["bids"] = jBids;
+                jOrders.push_back(jOrder);
             }
-            else
-                jRet["bids"] = encoding::json::array();
-        }
+
+            return jOrders;
+        };
 
         /* Check for our bids type. */
-        if(setTypes.find("ask") != setTypes.end() || fAll)
+        if(setTypes.find("bid") != setTypes.end() || fAll)
         {
-            /* Set our default sort by price for non executed. */
+            /* Open orders are listed by price from our book. */
             if(!fExecuted)
-            {
-                strColumn = "price";
-                strOrder  = "asc";
-            }
+                jRet["bids"] = fnBook(pairMarket, "desc");
 
-            /* Get a list of our active orders. */
-            std::vector<std::pair<uint512_t, uint32_t>> vAsks;
-            if(LLD::Logical->ListAllOrders(pairReverse, vAsks))
+            /* Get a list of our executed orders. */
+            else
             {
-                /* Build our object list and sort on insert. */
-                std::set<encoding::json, CompareResults> setAsks({}, CompareResults(strOrder, strColumn));
-
-                /* Build our list of orders now. */
-                for(const auto& pairOrder : vAsks)
+                std::vector<std::pair<uint512_t, uint32_t>> vBids;
+                if(LLD::Logical->ListAllOrders(pairMarket, vBids))
                 {
-                    /* Catch exception if we throw on ReadContract. */
-                    try
+                    /* Build our object list and sort on insert. */
+                    std::set<encoding::json, CompareResults> setBids({}, CompareResults(strOrder, strColumn));
+
+                    /* Build our list of orders now. */
+                    for(const auto& pairOrder : vBids)
                     {
-                        /* Get our contract now. */
-                        const TAO::Operation::Contract tContract =
-                            LLD::Ledger->ReadContract(pairOrder.first, pairOrder.second);
+                        /* Catch exception if we throw on ReadContract. */
+                        try
+                        {
+                            /* Get our contract now. */
+                            const TAO::Operation::Contract tContract =
+                                LLD::Ledger->ReadContract(pairOrder.first, pairOrder.second);
+
+                            /* Unpack our register address. */
+                            uint256_t hashRegister;
+                            if(!TAO::Register::Unpack(tContract, hashRegister))
+                                continue;
+
+                            /* Check if the order has been executed. */
+                            if(LLD::Contract->HasContract(pairOrder, TAO::Ledger::FLAGS::MEMPOOL) != fExecuted)
+                                continue;
+
+                            /* Check for a spent proof already. */
+                            if(LLD::Ledger->HasProof(hashRegister, pairOrder.first, pairOrder.second) && !fExecuted)
+                                continue;
+
+                            /* Get our order's json. */
+                            encoding::json jOrder =
+                                OrderToJSON(tContract, pairMarket);
+
+                            /* Check for null value. */
+                            if(jOrder.is_null())
+                                continue;
+
+                            /* Check that we match our filters. */
+                            if(!FilterResults(jParams, jOrder))
+                                continue;
+
+                            /* Filter out our expected fieldnames if specified. */
+                            if(!FilterFieldname(jParams, jOrder))
+                                continue;
+
+                            /* Insert into set and automatically sort. */
+                            setBids.insert(jOrder);
+                        }
+                        catch(const std::exception& e) { }
+                    }
 
-                        /* Unpack our register address. */
-                        uint256_t hashRegister;
-                        if(!TAO::Register::Unpack(tContract, hashRegister))
-                            continue;
+                    /* Build our return value. */
+                    encoding::json jBids = encoding::json::array();
 
-                        /* Check if the order has been executed. */
-                        if(LLD::Contract->HasContract(pairOrder, TAO::Ledger::FLAGS::MEMPOOL) != fExecuted)
+                    /* Handle paging and offsets. */
+                    uint32_t nTotal = 0;
+                    for(const auto& jOrder : setBids)
+                    {
+                        /* Check the offset. */
+                        if(++nTotal <= nOffset)
                             continue;
 
-                        /* Check for a spent proof already. */
-                        if(LLD::Ledger->HasProof(hashRegister, pairOrder.first, pairOrder.second) && !fExecuted)
-                            continue;
+                        /* Check the limit */
+                        if(jBids.size() == nLimit)
+                            break;
 
-                        /* Get our order's json. */
-                        encoding::json jOrder =
-                            OrderToJSON(tContract, pairMarket);
+                        jBids.push_back(jOrder);
+                    }
 
-                        /* Check for null value. */
-                        if(jOrder.is_null())
-                            continue;
+                    /* Add to our return value. */
+                    jRet["bids"] = jBids;
+                }
+                else
+                    jRet["bids"] = encoding::json::array();
+            }
+        }
 
-                        /* Check that we match our filters. */
-                        if(!FilterResults(jParams, jOrder))
-                            continue;
+        /* Check for our bids type. */
+        if(setTypes.find("ask") != setTypes.end() || fAll)
+        {
+            /* Open orders are listed by price from our book. */
+            if(!fExecuted)
+                jRet["asks"] = fnBook(pairReverse, "asc");
 
-                        /* Filter out our expected fieldnames if specified. */
-                        if(!FilterFieldname(jParams, jOrder))
-                            continue;
+            /* Get a list of our executed orders. */
+            else
+            {
+                std::vector<std::pair<uint512_t, uint32_t>> vAsks;
+                if(LLD::Logical->ListAllOrders(pairReverse, vAsks))
+                {
+                    /* Build our object list and sort on insert. */
+                    std::set<encoding::json, CompareResults> setAsks({}, CompareResults(strOrder, strColumn));
 
-                        /* Insert into set and automatically sort. */
-                        setAsks.insert(jOrder);
+                    /* Build our list of orders now. */
+                    for(const auto& pairOrder : vAsks)
+                    {
+                        /* Catch exception if we throw on ReadContract. */
+                        try
+                        {
+                            /* Get our contract now. */
+                            const TAO::Operation::Contract tContract =
+                                LLD::Ledger->ReadContract(pairOrder.first, pairOrder.second);
+
+                            /* Unpack our register address. */
+                            uint256_t hashRegister;
+                            if(!TAO::Register::Unpack(tContract, hashRegister))
+                                continue;
+
+                            /* Check if the order has been executed. */
+                            if(LLD::Contract->HasContract(pairOrder, TAO::Ledger::FLAGS::MEMPOOL) != fExecuted)
+                                continue;
+
+                            /* Check for a spent proof already. */
+                            if(LLD::Ledger->HasProof(hashRegister, pairOrder.first, pairOrder.second) && !fExecuted)
+                                continue;
+
+                            /* Get our order's json. */
+                            encoding::json jOrder =
+                                OrderToJSON(tContract, pairMarket);
+
+                            /* Check for null value. */
+                            if(jOrder.is_null())
+                                continue;
+
+                            /* Check that we match our filters. */
+                            if(!FilterResults(jParams, jOrder))
+                                continue;
+
+                            /* Filter out our expected fieldnames if specified. */
+                            if(!FilterFieldname(jParams, jOrder))
+                                continue;
+
+                            /* Insert into set and automatically sort. */
+                            setAsks.insert(jOrder);
+                        }
+                        catch(const std::exception& e) { }
                     }
-                    catch(const std::exception& e) { }
-                }
 
-                /* Build our return value. */
-                encoding::json jAsks = encoding::json::array();
+                    /* Build our return value. */
+                    encoding::json jAsks = encoding::json::array();
 
-                /* Handle paging and offsets. */
-                uint32_t nTotal = 0;
-                for(const auto& jOrder : setAsks)
-                {
-                    /* Check the offset. */
-                    if(++nTotal <= nOffset)
-                        continue;
+                    /* Handle paging and offsets. */
+                    uint32_t nTotal = 0;
+                    for(const auto& jOrder : setAsks)
+                    {
+                        /* Check the offset. */
+                        if(++nTotal <= nOffset)
+                            continue;
 
-                    /* Check the limit */
-                    if(jAsks.size() == nLimit)
-                        break;
+                        /* Check the limit */
+                        if(jAsks.size() == nLimit)
+                            break;
 
-                    jAsks.push_back(jOrder);
-                }
+                        jAsks.push_back(jOrder);
+                    }
 
-                /* Add to our return value. */
-                jRet["asks"] = jAsks;
+                    /* Add to our return value. */
+                    jRet["asks"] = jAsks;
+                }
+                else
+                    jRet["asks"] = encoding::json::array();
             }
-            else
-                jRet["asks"] = encoding::json::array();
         }
 
         return jRet;
@@ -36,6 +36,26 @@ namespace TAO::API
     }
 
 
+    /* Undo the indexes of a transaction for all registered command-sets when its block is disconnected. */
+    void Indexing::DisconnectTransaction(const TAO::Ledger::Transaction& tx)
+    {
+        /* Iterate the transaction contracts in reverse order. */
+        for(uint32_t nContract = tx.Size(); nContract > 0; --nContract)
+        {
+            /* Grab contract reference. */
+            const TAO::Operation::Contract& rContract = tx[nContract - 1];
+
+            {
+                LOCK(REGISTERED_MUTEX);
+
+                /* Loop through registered commands. */
+                for(const auto& strCommands : REGISTERED)
+                    Commands::Instance(strCommands)->Disconnect(rContract, nContract - 1);
+            }
+        }
+    }
+
+
     /* Handle relays of all events for LLP when processing block. */
     void Indexing::Manager()
     {
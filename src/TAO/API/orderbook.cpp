@@ -0,0 +1,190 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/include/global.h>
+
+#include <TAO/API/types/orderbook.h>
+
+#include <TAO/Operation/include/enum.h>
+
+#include <TAO/Register/include/unpack.h>
+
+/* Global TAO namespace. */
+namespace TAO::API
+{
+    /* Adds a new order to its market side. */
+    void OrderBook::Insert(const std::pair<uint256_t, uint256_t>& pairMarket,
+                           const TAO::Operation::Contract& rContract, const uint32_t nContract)
+    {
+        LOCK(MUTEX);
+
+        /* Skip over sides that will read this order from disk when loaded. */
+        if(!mapSides.count(pairMarket))
+            return;
+
+        insert_order(pairMarket, rContract, nContract);
+    }
+
+
+    /* Removes an order from the book once it has been executed or cancelled. */
+    bool OrderBook::Remove(const std::pair<uint512_t, uint32_t>& pairOrder)
+    {
+        LOCK(MUTEX);
+
+        /* Check that we are holding this order. */
+        const auto itOrder = mapOrders.find(pairOrder);
+        if(itOrder == mapOrders.end())
+            return false;
+
+        /* Find the price level the order is in. */
+        const Entry& rEntry = itOrder->second;
+
+        std::map<Price, Level, ComparePrice>& mapLevels = mapSides[rEntry.pairMarket];
+        const auto itLevel = mapLevels.find(rEntry.tPrice);
+        if(itLevel != mapLevels.end())
+        {
+            /* Erase the order and drop the level once it is empty. */
+            itLevel->second.erase(std::make_pair(rEntry.nTimestamp, pairOrder));
+            if(itLevel->second.empty())
+                mapLevels.erase(itLevel);
+        }
+
+        mapOrders.erase(itOrder);
+
+        return true;
+    }
+
+
+    /* Visits the orders of a market side from the best price down. */
+    void OrderBook::List(const std::pair<uint256_t, uint256_t>& pairMarket,
+        const std::function<bool(const std::pair<uint512_t, uint32_t>&, const TAO::Operation::Contract&)>& fnVisit)
+    {
+        LOCK(MUTEX);
+
+        /* Build the side from disk the first time it is listed. */
+        if(!mapSides.count(pairMarket))
+            load_side(pairMarket);
+
+        /* Walk our levels and the orders within them. */
+        for(const auto& pairLevel : mapSides[pairMarket])
+        {
+            for(const auto& pairEntry : pairLevel.second)
+            {
+                /* Check if our caller is done. */
+                if(!fnVisit(pairEntry.first.second, pairEntry.second))
+                    return;
+            }
+        }
+    }
+
+
+    /* Adds an order to a loaded side. */
+    void OrderBook::insert_order(const std::pair<uint256_t, uint256_t>& pairMarket,
+                                 const TAO::Operation::Contract& rContract, const uint32_t nContract)
+    {
+        /* Build our order key. */
+        const std::pair<uint512_t, uint32_t> pairOrder =
+            std::make_pair(rContract.Hash(), nContract);
+
+        /* Check we aren't already holding this order. */
+        if(mapOrders.count(pairOrder))
+            return;
+
+        /* Catch exceptions from non-standard contracts. */
+        try
+        {
+            /* Seek over our OP::CONDITION and OP::DEBIT enums. */
+            rContract.Reset();
+            rContract.Seek(2, TAO::Operation::Contract::OPERATIONS);
+
+            /* Seek over our from and to addresses. */
+            rContract.Seek(64, TAO::Operation::Contract::OPERATIONS);
+
+            /* Deserialize the amount we are selling. */
+            Price tPrice;
+            rContract >> tPrice.nSelling;
+
+            /* Get the comparison bytes. */
+            rContract.Seek(4, TAO::Operation::Contract::CONDITIONS);
+
+            TAO::Operation::Stream ssCompare;
+            rContract >= ssCompare;
+
+            /* Skip ahead to the amount we are buying. */
+            ssCompare.seek(65, STREAM::BEGIN);
+            ssCompare >> tPrice.nBuying;
+
+            /* Orders without both amounts have no price to list them at. */
+            if(tPrice.nSelling == 0 || tPrice.nBuying == 0)
+                return;
+
+            /* Add to our price level. */
+            const uint64_t nTimestamp = rContract.Timestamp();
+            mapSides[pairMarket][tPrice].insert(std::make_pair(std::make_pair(nTimestamp, pairOrder), rContract));
+
+            /* Track where we put it. */
+            mapOrders[pairOrder] = Entry{pairMarket, tPrice, nTimestamp};
+        }
+        catch(const std::exception& e)
+        {
+            debug::warning(FUNCTION, e.what());
+        }
+    }
+
+
+    /* Builds a market side from the orders in the logical database that are still open. */
+    void OrderBook::load_side(const std::pair<uint256_t, uint256_t>& pairMarket)
+    {
+        /* Add our side even if it has no orders, so that we know it is loaded. */
+        mapSides[pairMarket];
+
+        /* Get the full list of orders for this side. */
+        std::vector<std::pair<uint512_t, uint32_t>> vOrders;
+        if(!LLD::Logical->ListAllOrders(pairMarket, vOrders))
+            return;
+
+        /* Check each of our orders. */
+        for(const auto& pairOrder : vOrders)
+        {
+            /* Catch exception if we throw on ReadContract. */
+            try
+            {
+                /* Get our contract now. */
+                const TAO::Operation::Contract tContract =
+                    LLD::Ledger->ReadContract(pairOrder.first, pairOrder.second);
+
+                /* Unpack our register address. */
+                uint256_t hashRegister;
+                if(!TAO::Register::Unpack(tContract, hashRegister))
+                    continue;
+
+                /* Check if the order has been executed. */
+                if(LLD::Contract->HasContract(pairOrder))
+                    continue;
+
+                /* Check if the order has been cancelled. */
+                if(LLD::Ledger->HasProof(hashRegister, pairOrder.first, pairOrder.second))
+                    continue;
+
+                /* Check that the order's block wasn't disconnected. */
+                if(!LLD::Ledger->HasIndex(pairOrder.first))
+                    continue;
+
+                insert_order(pairMarket, tContract, pairOrder.second);
+            }
+            catch(const std::exception& e) { }
+        }
+
+        debug::log(2, FUNCTION, "Loaded ", mapSides[pairMarket].size(), " price levels from ", vOrders.size(), " orders");
+    }
+}
@@ -193,6 +193,18 @@ namespace TAO::API
          *
          **/
         virtual void Index(const TAO::Operation::Contract& rContract, const uint32_t nContract) { }
+
+
+        /** Disconnect
+         *
+         *  Generic handler for undoing indexes of this command-set when a contract is disconnected from the chain.
+         *  This handler is called for each contract of a transaction in a block that is being disconnected.
+         *
+         *  @param[in] rContract The contract being disconnected.
+         *  @param[in] nContract The contract-id being disconnected.
+         *
+         **/
+        virtual void Disconnect(const TAO::Operation::Contract& rContract, const uint32_t nContract) { }
     };
 
 
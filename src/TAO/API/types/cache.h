@@ -22,8 +22,13 @@ ________________________________________________________________________________
 
 #include <Util/include/json.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 
 /* Global TAO namespace. */
 namespace TAO::API
@@ -122,6 +127,121 @@ namespace TAO::API
     };
 
 
+    /** ResultIndex
+     *
+     *  Class to hold the results of a cached request, with the rows indexed in sorted order by each column that has
+     *  been requested. A column is only sorted once for the life of the results, so changing the order or column of
+     *  a cached request walks an existing index rather than sorting the results again.
+     *
+     **/
+    class ResultIndex
+    {
+
+        /** Mutex for thread concurrency when building our indexes. **/
+        mutable std::mutex MUTEX;
+
+
+        /** The results returned by the function. **/
+        const encoding::json jResults;
+
+
+        /** The rows in ascending order by column. **/
+        mutable std::map<std::string, std::vector<uint32_t>> mapColumns;
+
+    public:
+
+        ResultIndex() = delete;
+
+
+        /** Constructor. **/
+        ResultIndex(encoding::json&& jResultsIn)
+        : MUTEX      ( )
+        , jResults   (std::move(jResultsIn))
+        , mapColumns ( )
+        {
+        }
+
+
+        /** Results
+         *
+         *  Get the results as they were returned by the function.
+         *
+         **/
+        const encoding::json& Results() const
+        {
+            return jResults;
+        }
+
+
+        /** Sorted
+         *
+         *  Get the rows of our results in ascending order by a given column, building the index the first time the
+         *  column is requested. Rows missing the column sort before all others, and rows that are equal keep their
+         *  original order.
+         *
+         *  @param[in] strColumn The column to sort our rows by.
+         *
+         *  @return The positions of our rows in ascending order.
+         *
+         **/
+        const std::vector<uint32_t>& Sorted(const std::string& strColumn) const
+        {
+            LOCK(MUTEX);
+
+            /* Check if we have already built this index. */
+            const auto it = mapColumns.find(strColumn);
+            if(it != mapColumns.end())
+                return it->second;
+
+            /* Grab our column values once, so we don't search each row on every compare. */
+            std::vector<std::pair<const encoding::json*, uint32_t>> vValues;
+            if(jResults.is_array())
+            {
+                vValues.reserve(jResults.size());
+                for(uint32_t nRow = 0; nRow < jResults.size(); ++nRow)
+                {
+                    /* Get a reference of our current row. */
+                    const encoding::json& jRow = jResults[nRow];
+
+                    /* Check that our row has the given column. */
+                    const auto itColumn = jRow.is_object() ? jRow.find(strColumn) : jRow.end();
+                    vValues.emplace_back((itColumn != jRow.end() ? &(*itColumn) : nullptr), nRow);
+                }
+            }
+
+            /* Sort our values by their json types, keeping the original order for equal values. */
+            std::sort(vValues.begin(), vValues.end(), [](const auto& a, const auto& b)
+            {
+                /* Check for missing columns, which come first. */
+                if(!a.first || !b.first)
+                {
+                    if(a.first != b.first)
+                        return (a.first == nullptr);
+
+                    return a.second < b.second;
+                }
+
+                /* Compare our values, falling back to our positions. */
+                if(*a.first < *b.first)
+                    return true;
+
+                if(*b.first < *a.first)
+                    return false;
+
+                return a.second < b.second;
+            });
+
+            /* Build our index from the sorted values. */
+            std::vector<uint32_t>& vIndex = mapColumns[strColumn];
+            vIndex.reserve(vValues.size());
+            for(const auto& rValue : vValues)
+                vIndex.push_back(rValue.second);
+
+            return vIndex;
+        }
+    };
+
+
     /** ResponseCache
      *
      *  Class to track cached API requests so that we can page and cache them if asked for repeatedly and chain state remains unchanged.
@@ -130,8 +250,8 @@ namespace TAO::API
     class ResponseCache
     {
 
-        /** The function pointer to be called. */
-        LLD::TemplateLRU<encoding::json, encoding::json> mapCache;
+        /** The results of our requests, by parameters without paging or sorting. */
+        LLD::TemplateLRU<encoding::json, std::shared_ptr<const ResultIndex>> mapCache;
 
 
         /** Track if our cache has been refreshed. **/
@@ -220,17 +340,16 @@ namespace TAO::API
 
         /** Get
          *
-         *  Get the cached request data based on command and parameters.
+         *  Get the cached results based on parameters. Requests that only differ by paging, sorting or queries share
+         *  the same results, since those are applied when the results are read.
          *
-         *  @param[in] strCommand The command to push data to
          *  @param[in] jParams The json formatted parameters
-         *  @param[out] jRet The cached request data
-         *  @param[out] fReversed Determine if the cache needs to be reverse iterated
+         *  @param[out] pResults The cached results
          *
          *  @return true if cache was found, false if it was not
          *
          **/
-        bool Get(const encoding::json& jParams, encoding::json &jRet)
+        bool Get(const encoding::json& jParams, std::shared_ptr<const ResultIndex> &pResults)
         {
             /* Check if caching is disabled. */
             if(!(nSettings & ENABLE::CACHING))
@@ -240,236 +359,69 @@ namespace TAO::API
             if(refresh_cache())
                 return false; //cache is out of date, we need to re-insert it
 
-            /* Check the list of all of our available caches for this command. */
-            const std::vector<encoding::json> vParams = mapCache.Keys();
-            for(const auto& jCachedParams : vParams)
-            {
-                /* Check our types match here. */
-                if(CheckRequest(jCachedParams, "type", "string, array"))
-                {
-                    /* Check that we have matching types. */
-                    if(ExtractTypes(jParams) != ExtractTypes(jCachedParams))
-                        continue;
-                }
-
-                /* Use this to escape this loop. */
-                bool fFound = true;
-
-                /* Decode now if we are paging a list command or if we are just passing back a cached request. */
-                for(const auto& jCached : jCachedParams.items())
-                {
-                    /* Skip over paging information. */
-                    if(jCached.key() == "page" || jCached.key() == "limit" || jCached.key() == "offset" || jCached.key() == "where")
-                        continue;
-
-                    /* Skip over other these additional fields. */
-                    if(jCached.key() == "request" || jCached.key() == "order" || jCached.key() == "sort")
-                        continue;
-
-                    /* Check that the types match. */
-                    if(jParams.find(jCached.key()) == jParams.end())
-                    {
-                        fFound = false;
-                        break;
-                    }
-
-                    /* Check that our values match now. */
-                    if(jParams[jCached.key()] != jCached.value())
-                    {
-                        fFound = false;
-                        break;
-                    }
-                }
-
-                /* Track if we have found our cache object. */
-                if(fFound)
-                {
-                    /* Get a copy of our cache here. */
-                    if(mapCache.Get(jCachedParams, jRet))
-                    {
-                        /* Handle here if we need to sort. */
-                        if(nSettings & ENABLE::SORTING)
-                        {
-                            /* Get our previous order and column. */
-                            std::string strPrevOrder = "desc", strPrevColumn = strDefaultColumn;
-                            ExtractSort(jCachedParams, strPrevOrder, strPrevColumn);
-
-                            /* Get our current order and column. */
-                            std::string strOrder = "desc", strColumn = strDefaultColumn;
-                            ExtractSort(jParams, strOrder, strColumn);
-
-                            /* Check if our orders have changed. */
-                            const bool fOrderChanged =
-                                (strOrder != strPrevOrder);
-
-                            /* Check if our columns have changed. */
-                            const bool fColumnChanged =
-                                (strColumn != strPrevColumn);
-
-                            /* Check if we need to adjust our sorts. */
-                            if(fOrderChanged || fColumnChanged)
-                            {
-                                /* We need to clear out old key since next call will use same sort */
-                                mapCache.Remove(jCachedParams);
-
-                                /* Reverse if only the order changed. */
-                                if(!fColumnChanged)
-                                    std::reverse(jRet.begin(), jRet.end());
-                                else //we can sort using our compare functor
-                                    sort(strOrder, strColumn, jRet);
-
-                                /* Update our cache with new sorts and parameters now. */
-                                mapCache.Put(jParams, jRet);
-                            }
-                        }
-
-                        return true;
-                    }
-                }
-
-            }
-
-            return false;
+            return mapCache.Get(cache_key(jParams), pResults);
         }
 
 
         /** Insert
          *
-         *  Push data into our cache object.
+         *  Push results into our cache object.
          *
-         *  @param[in] strCommand The command to push data to
          *  @param[in] jParams The json formatted parameters
-         *  @param[in] jCache The cached request data to push
+         *  @param[in] jResults The results returned by the function
+         *
+         *  @return The results now held by the cache.
          *
          **/
-        void Insert(const encoding::json& jParams, encoding::json &jCache)
+        std::shared_ptr<const ResultIndex> Insert(const encoding::json& jParams, encoding::json&& jResults)
         {
+            /* Build our results to share with the cache. */
+            const std::shared_ptr<const ResultIndex> pResults =
+                std::make_shared<const ResultIndex>(std::move(jResults));
+
             /* Check if caching is disabled. */
             if(!(nSettings & ENABLE::CACHING))
-                return;
+                return pResults;
 
             /* Make sure our cache is up to date. */
             refresh_cache();
 
-            /* Handle here if we need to sort. */
-            if(nSettings & ENABLE::SORTING)
-            {
-                /* Get our current order and column. */
-                std::string strOrder = "desc", strColumn = strDefaultColumn;
-                ExtractSort(jParams, strOrder, strColumn);
-
-                /* Now we sort the data. */
-                sort(strOrder, strColumn, jCache);
-            }
-
             /* Add to our LRU cache. */
-            mapCache.Put(jParams, jCache);
+            mapCache.Put(cache_key(jParams), pResults);
+
+            return pResults;
         }
 
     private:
 
-        /** sort
+        /** cache_key
+         *
+         *  Local helper function to get the parameters that our results are cached by, removing the parameters that
+         *  are applied when our results are read and keeping only the types from our request.
          *
-         *  Local helper function to sort our lists.
+         *  @param[in] jParams The json formatted parameters
          *
-         *  @param[in] strOrder The order to sort it either ascending or descending
-         *  @param[in] strColumn The column we want to sort our data by.
-         *  @param[out] jRet The data that we are sorting returned by reference.
+         *  @return The parameters to use as our cache key.
          *
          **/
-        void sort(const std::string& strOrder, const std::string& strColumn, encoding::json &jRet)
+        encoding::json cache_key(const encoding::json& jParams) const
         {
-            /* Detect if we are descending or ascending order. */
-            const bool fDesc =
-                (strOrder == "desc");
+            /* Copy our parameters to remove the ones that don't change our results. */
+            encoding::json jKey = jParams;
+            for(const auto& strKey : { "page", "limit", "offset", "where", "order", "sort", "request" })
+                jKey.erase(strKey);
 
-            /* Sort using our own lambda function. */
-            std::sort(jRet.begin(), jRet.end(), [&](const encoding::json& a, const encoding::json& b)
+            /* Types are part of our request, and change our results. */
+            if(CheckRequest(jParams, "type", "string, array"))
             {
-                /* Check for sort by invalid parameter. */
-                if(a.find(strColumn) == a.end() || b.find(strColumn) == b.end())
-                    return true;
-
-                /* Handle based on unsigned integer type. */
-                if(a[strColumn].is_number_unsigned())
-                {
-                    /* Grab both of our values. */
-                    const uint64_t nA = a[strColumn].get<uint64_t>();
-                    const uint64_t nB = b[strColumn].get<uint64_t>();
-
-                    /* Check if they are equal. */
-                    if(nA == nB)
-                        return false;
-
-                    /* Regular descending sort. */
-                    if(fDesc)
-                        return nA > nB;
-
-                    /* Ascending sorting. */
-                    return nA < nB;
-                }
-
-                /* Handle based on signed integer type. */
-                else if(a[strColumn].is_number_integer())
-                {
-                    /* Grab both of our values. */
-                    const int64_t nA = a[strColumn].get<int64_t>();
-                    const int64_t nB = b[strColumn].get<int64_t>();
-
-                    /* Check if they are equal. */
-                    if(nA == nB)
-                        return false;
-
-                    /* Regular descending sort. */
-                    if(fDesc)
-                        return nA > nB;
-
-                    /* Ascending sorting. */
-                    return nA < nB;
-                }
-
-                /* Handle based on signed integer type. */
-                else if(a[strColumn].is_number_float())
-                {
-                    /* Grab a copy of our doubles here casting to ints at given figures for efficiency. */
-                    const double nA = a[strColumn].get<double>();
-                    const double nB = b[strColumn].get<double>();
-
-                    /* Check if they are equal. */
-                    if(nA == nB)
-                        return false;
-
-                    /* Regular descending sort. */
-                    if(fDesc)
-                        return nA > nB;
-
-                    /* Ascending sorting. */
-                    return nA < nB;
-                }
-
-                /* Handle based on integer type. */
-                else if(a[strColumn].is_string())
-                {
-                    /* Grab both of our values. */
-                    const std::string strA = a[strColumn].get<std::string>();
-                    const std::string strB = b[strColumn].get<std::string>();
-
-                    /* Check if they are equal. */
-                    if(strA == strB)
-                        return false;
-
-                    /* Regular descending sort. */
-                    if(fDesc)
-                        return strA > strB;
-
-                    /* Ascending sorting. */
-                    return strA < strB;
-                }
+                const std::set<std::string> setTypes = ExtractTypes(jParams);
+                jKey["request"]["type"] = encoding::json(setTypes);
+            }
 
-                return false;
-            });
+            return jKey;
         }
 
+
         /** refresh_cache
          *
          *  Local helper function to check if the cache needs to be refreshed.
@@ -14,6 +14,7 @@ ________________________________________________________________________________
 #pragma once
 
 #include <TAO/API/types/base.h>
+#include <TAO/API/types/orderbook.h>
 
 #include <TAO/Operation/types/contract.h>
 
@@ -33,12 +34,17 @@ namespace TAO::API
         std::map<uint256_t, std::pair<uint256_t, uint64_t>> mapFees;
 
 
+        /** The active orders of every listed market side. **/
+        OrderBook tBook;
+
+
     public:
 
         /** Default Constructor. **/
         Market()
         : Derived<Market>()
         , mapFees        ()
+        , tBook          ()
         {
         }
 
@@ -66,6 +72,10 @@ namespace TAO::API
         void Index(const TAO::Operation::Contract& rContract, const uint32_t nContract) override;
 
 
+        /* Generic handler for undoing indexes of this command-set when a contract is disconnected. */
+        void Disconnect(const TAO::Operation::Contract& rContract, const uint32_t nContract) override;
+
+
         /** Create
          *
          *  Create an order on the market
@@ -157,5 +167,18 @@ namespace TAO::API
          **/
         __attribute__((pure)) encoding::json OrderToJSON(const TAO::Operation::Contract& rContract, const uint256_t& hashBase);
 
+
+        /** OrderMarket
+         *
+         *  Get the market side an exchange contract is indexed under, as its deposit and withdraw token-ids.
+         *
+         *  @param[in] rContract The exchange contract of the order.
+         *  @param[out] pairMarket The market side of the order.
+         *
+         *  @return true if the contract is a valid exchange order.
+         *
+         **/
+        static bool OrderMarket(const TAO::Operation::Contract& rContract, std::pair<uint256_t, uint256_t> &pairMarket);
+
     };
 }
@@ -118,6 +118,16 @@ namespace TAO::API
         static void PushTransaction(const uint512_t& hashTx);
 
 
+        /** DisconnectTransaction
+         *
+         *  Undo the indexes of a transaction for all registered command-sets when its block is disconnected.
+         *
+         *  @param[in] tx The transaction being disconnected.
+         *
+         **/
+        static void DisconnectTransaction(const TAO::Ledger::Transaction& tx);
+
+
         /** Register
          *
          *  Register a new command-set to indexing by class type.
@@ -0,0 +1,179 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+
+#include <LLC/types/uint1024.h>
+
+#include <TAO/Operation/types/contract.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+/* Global TAO namespace. */
+namespace TAO::API
+{
+
+    /** OrderBook
+     *
+     *  Holds the active orders of each market side grouped into price levels. A side is loaded from the logical
+     *  database the first time it is listed, and is then kept up to date by the market indexes as orders are created,
+     *  executed, or cancelled, so listing a market never has to walk its order history again.
+     *
+     **/
+    class OrderBook
+    {
+    public:
+
+        /** Price
+         *
+         *  The price of an order, as the amount it sells over the amount it asks for. Both amounts of one side are in the
+         *  same tokens, so prices are compared by cross multiplying and orders with equal ratios share a level.
+         *
+         **/
+        struct Price
+        {
+            /** The amount of the token being sold. **/
+            uint64_t nSelling;
+
+
+            /** The amount of the token being bought. **/
+            uint64_t nBuying;
+        };
+
+
+        /** ComparePrice
+         *
+         *  Orders price levels from the highest price down, which is the best offer for whoever takes the order.
+         *
+         **/
+        struct ComparePrice
+        {
+            bool operator()(const Price& a, const Price& b) const
+            {
+                return (uint128_t(a.nSelling) * b.nBuying) > (uint128_t(b.nSelling) * a.nBuying);
+            }
+        };
+
+
+    private:
+
+        /** Orders of a price level by timestamp, so older orders are listed first within a level. **/
+        typedef std::map<std::pair<uint64_t, std::pair<uint512_t, uint32_t>>, TAO::Operation::Contract> Level;
+
+
+        /** Where an order is stored in the book, so that it can be removed by its txid and contract. **/
+        struct Entry
+        {
+            /** The market side the order was indexed under. **/
+            std::pair<uint256_t, uint256_t> pairMarket;
+
+
+            /** The price level of the order. **/
+            Price tPrice;
+
+
+            /** The timestamp the order is keyed by within its level. **/
+            uint64_t nTimestamp;
+        };
+
+
+        /** Mutex for thread safety. **/
+        mutable std::mutex MUTEX;
+
+
+        /** The price levels of each loaded market side. **/
+        std::map<std::pair<uint256_t, uint256_t>, std::map<Price, Level, ComparePrice>> mapSides;
+
+
+        /** The location of every order held in a loaded side. **/
+        std::map<std::pair<uint512_t, uint32_t>, Entry> mapOrders;
+
+
+    public:
+
+        /** Default Constructor. **/
+        OrderBook()
+        : MUTEX     ()
+        , mapSides  ()
+        , mapOrders ()
+        {
+        }
+
+
+        /** Insert
+         *
+         *  Adds a new order to its market side. Sides that haven't been loaded yet are skipped, since they will pick the
+         *  order up from the logical database when they are.
+         *
+         *  @param[in] pairMarket The market side the order was indexed under.
+         *  @param[in] rContract The exchange contract of the order.
+         *  @param[in] nContract The contract-id of the order.
+         *
+         **/
+        void Insert(const std::pair<uint256_t, uint256_t>& pairMarket,
+                    const TAO::Operation::Contract& rContract, const uint32_t nContract);
+
+
+        /** Remove
+         *
+         *  Removes an order from the book once it has been executed or cancelled.
+         *
+         *  @param[in] pairOrder The txid and contract-id of the order.
+         *
+         *  @return true if the order was held in the book.
+         *
+         **/
+        bool Remove(const std::pair<uint512_t, uint32_t>& pairOrder);
+
+
+        /** List
+         *
+         *  Visits the orders of a market side from the best price down, loading the side first if needed.
+         *
+         *  @param[in] pairMarket The market side to list.
+         *  @param[in] fnVisit Called with each order's txid, contract-id, and contract, returns false to stop.
+         *
+         **/
+        void List(const std::pair<uint256_t, uint256_t>& pairMarket,
+                  const std::function<bool(const std::pair<uint512_t, uint32_t>&, const TAO::Operation::Contract&)>& fnVisit);
+
+
+    private:
+
+        /** insert_order
+         *
+         *  Adds an order to a loaded side, must be called with MUTEX held.
+         *
+         *  @param[in] pairMarket The market side the order was indexed under.
+         *  @param[in] rContract The exchange contract of the order.
+         *  @param[in] nContract The contract-id of the order.
+         *
+         **/
+        void insert_order(const std::pair<uint256_t, uint256_t>& pairMarket,
+                          const TAO::Operation::Contract& rContract, const uint32_t nContract);
+
+
+        /** load_side
+         *
+         *  Builds a market side from the orders in the logical database that are still open, must be called with MUTEX
+         *  held.
+         *
+         *  @param[in] pairMarket The market side to load.
+         *
+         **/
+        void load_side(const std::pair<uint256_t, uint256_t>& pairMarket);
+
+    };
+}
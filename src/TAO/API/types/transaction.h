@@ -120,7 +120,10 @@ namespace TAO::API
 
                 /* Reset our cache if deserializing. */
                 if(fRead)
+                {
                     hashCache = 0;
+                    fVerified = false;
+                }
             }
         )
 
@@ -288,31 +288,75 @@ namespace TAO
         }
 
 
-        /* Generate the Merkle Tree from uint512_t hashes. */
-        uint512_t Block::BuildMerkleTree(const std::vector<uint512_t>& vtx) const
+        /* Build the levels of a merkle tree above its leaves, hashing four pairs of nodes at a time. */
+        static void build_merkle_levels(std::vector<uint512_t>& vMerkleTree)
         {
-            /* Build the in memory cache of merkle tree. */
-            vMerkleTree.clear();
-            for(const auto& hash : vtx)
-                vMerkleTree.push_back(hash);
+            static_assert(sizeof(uint512_t) == 64, "merkle nodes must be packed to hash pairs in place");
 
-            /* Compute the merkle root. */
-            uint32_t i = 0;
+            /* Reserve the whole tree up front, so our pointers into each level stay valid as we push the next. */
+            uint64_t nTotal = vMerkleTree.size();
+            for(uint32_t nSize = static_cast<uint32_t>(vMerkleTree.size()); nSize > 1; nSize = (nSize + 1) >> 1)
+                nTotal += (nSize + 1) >> 1;
+
+            vMerkleTree.reserve(nTotal);
+
+            /* Compute each level from the one below it. */
             uint32_t j = 0;
-            for(uint32_t nSize = static_cast<uint32_t>(vtx.size()); nSize > 1; nSize = (nSize + 1) >> 1)
+            for(uint32_t nSize = static_cast<uint32_t>(vMerkleTree.size()); nSize > 1; nSize = (nSize + 1) >> 1)
             {
-                for(i = 0; i < nSize; i += 2)
-                {
-                    /* get the references to the left and right leaves in the merkle tree */
-                    const uint512_t& hashLeft  = vMerkleTree[j + i];
-                    const uint512_t& hashRight = vMerkleTree[j + std::min(i + 1, nSize - 1)];
+                /* An odd node at the end of a level is paired with itself. */
+                uint512_t vOdd[2];
 
-                    vMerkleTree.push_back(LLC::SK512(BEGIN(hashLeft),  END(hashLeft),
-                                                     BEGIN(hashRight), END(hashRight)));
+                for(uint32_t i = 0; i < nSize; i += 8)
+                {
+                    /* Each pair of neighbouring nodes is already the 128 byte message to hash. */
+                    const uint8_t* pData[4];
+
+                    uint32_t nPairs = 0;
+                    for( ; nPairs < 4 && i + (nPairs * 2) < nSize; ++nPairs)
+                    {
+                        const uint32_t nLeft = i + (nPairs * 2);
+                        if(nLeft + 1 < nSize)
+                            pData[nPairs] = (uint8_t*)&vMerkleTree[j + nLeft];
+                        else
+                        {
+                            vOdd[0] = vMerkleTree[j + nLeft];
+                            vOdd[1] = vMerkleTree[j + nLeft];
+
+                            pData[nPairs] = (uint8_t*)&vOdd[0];
+                        }
+                    }
+
+                    /* Hash four pairs at once when we have them. */
+                    if(nPairs == 4)
+                    {
+                        uint512_t vHashes[4];
+                        LLC::SK512x4(pData, 128, vHashes);
+
+                        vMerkleTree.insert(vMerkleTree.end(), vHashes, vHashes + 4);
+                        continue;
+                    }
+
+                    /* Hash the pairs left over at the end of a level one at a time. */
+                    for(uint32_t n = 0; n < nPairs; ++n)
+                        vMerkleTree.push_back(LLC::SK512(pData[n], pData[n] + 64, pData[n] + 64, pData[n] + 128));
                 }
 
                 j += nSize;
             }
+        }
+
+
+        /* Generate the Merkle Tree from uint512_t hashes. */
+        uint512_t Block::BuildMerkleTree(const std::vector<uint512_t>& vtx) const
+        {
+            /* Build the in memory cache of merkle tree. */
+            vMerkleTree.clear();
+            for(const auto& hash : vtx)
+                vMerkleTree.push_back(hash);
+
+            /* Compute the merkle root. */
+            build_merkle_levels(vMerkleTree);
 
             return (vMerkleTree.empty() ? 0 : vMerkleTree.back());
         }
@@ -327,22 +371,7 @@ namespace TAO
                 vMerkleTree.push_back(hash.second);
 
             /* Compute the merkle root. */
-            uint32_t i = 0;
-            uint32_t j = 0;
-            for(uint32_t nSize = static_cast<uint32_t>(vtx.size()); nSize > 1; nSize = (nSize + 1) / 2)
-            {
-                for(i = 0; i < nSize; i += 2)
-                {
-                    /* get the references to the left and right leaves in the merkle tree */
-                    const uint512_t& hashLeft  = vMerkleTree[j + i];
-                    const uint512_t& hashRight = vMerkleTree[j + std::min(i + 1, nSize - 1)];
-
-                    vMerkleTree.push_back(LLC::SK512(BEGIN(hashLeft),  END(hashLeft),
-                                                     BEGIN(hashRight), END(hashRight)));
-                }
-
-                j += nSize;
-            }
+            build_merkle_levels(vMerkleTree);
 
             return (vMerkleTree.empty() ? 0 : vMerkleTree.back());
         }
@@ -49,6 +49,9 @@ ________________________________________________________________________________
 #include <Util/include/debug.h>
 #include <Util/include/runtime.h>
 
+#include <mutex>
+#include <set>
+
 /* Global TAO namespace. */
 namespace TAO::Ledger
 {
@@ -153,26 +156,110 @@ namespace TAO::Ledger
     }
 
 
-    /* Gets a list of transactions from memory pool for current block. */
-    void AddTransactions(TAO::Ledger::TritiumBlock& block)
+    /* Package of mempool transactions verified on top of the best chain, so templates don't verify them again. */
+    struct TemplatePackage
     {
-        /* Clear the transactions. */
-        block.vtx.clear();
+        /* Mutex for thread concurrency, which also guards our use of the MINER transaction. */
+        std::mutex MUTEX;
 
-        /* Check the memory pool. */
-        std::vector<uint512_t> vMempool;
-        mempool.List(vMempool);
+
+        /* The best chain our package was verified on. */
+        uint1024_t hashBestChain;
+
+
+        /* The verified transactions in dependency order. */
+        std::vector<uint512_t> vtx;
+
+
+        /* The transactions in our package for fast lookups. */
+        std::set<uint512_t> setPackage;
+
+
+        /* The transactions that have been checked, whether they were added or not. */
+        std::set<uint512_t> setChecked;
+
+
+        /* Flag to check again when transactions were skipped for reasons that change over time. */
+        bool fRetry;
+
+
+        /* Clear our package for a new best chain. */
+        void Clear(const uint1024_t& hashBestIn)
+        {
+            hashBestChain = hashBestIn;
+
+            vtx.clear();
+            setPackage.clear();
+            setChecked.clear();
+
+            fRetry = false;
+        }
+    };
+
+
+    /* Our package for the next block. */
+    static TemplatePackage tPackage;
+
+
+    /* Get the bytes added to a serialized block by its last transaction. */
+    static uint64_t entry_size(const TAO::Ledger::TritiumBlock& block)
+    {
+        /* Get our current count of transactions. */
+        const uint64_t nCount = block.vtx.size();
+
+        return ::GetSerializeSize(block.vtx.back().first,  SER_NETWORK, LLP::PROTOCOL_VERSION)
+             + ::GetSerializeSize(block.vtx.back().second, SER_NETWORK, LLP::PROTOCOL_VERSION)
+             + GetSizeOfCompactSize(nCount) - GetSizeOfCompactSize(nCount - 1);
+    }
+
+
+    /* Check new mempool transactions against our package, adding the ones that pass. */
+    static void update_package(const std::vector<uint512_t>& vMempool)
+    {
+        /* Our package never needs more transactions than can fit in a block. */
+        const uint64_t nMaxPackage = MAX_BLOCK_SIZE /
+            (::GetSerializeSize(uint8_t(TRANSACTION::TRITIUM), SER_NETWORK, LLP::PROTOCOL_VERSION)
+           + ::GetSerializeSize(uint512_t(0), SER_NETWORK, LLP::PROTOCOL_VERSION));
 
         /* Start a ACID transaction (to be disposed). */
         LLD::TxnBegin(FLAGS::MINER);
 
+        /* Connect our package again, so that new transactions are checked on top of it. */
+        for(const auto& hash : tPackage.vtx)
+        {
+            /* Check that our package is still valid, which it should be on the same best chain. */
+            TAO::Ledger::Transaction tx;
+            if(!mempool.Get(hash, tx) || !tx.Connect(FLAGS::MINER))
+            {
+                debug::log(2, FUNCTION, "Package transaction ", hash.SubString(), " failed to connect, rebuilding...");
+
+                /* Start again with an empty package. */
+                LLD::TxnAbort(FLAGS::MINER);
+                tPackage.Clear(tPackage.hashBestChain);
+                LLD::TxnBegin(FLAGS::MINER);
+
+                break;
+            }
+        }
+
+        /* Check every transaction that isn't in our package. */
+        tPackage.setChecked.clear();
+        tPackage.fRetry = false;
+
         /* Loop through the list of transactions. */
         std::set<uint512_t> setDependents;
         for(const auto& hash : vMempool)
         {
-            /* Check the Size limits of the Current Block. */
-            if(::GetSerializeSize(block, SER_NETWORK, LLP::PROTOCOL_VERSION) + 256 >= MAX_BLOCK_SIZE)
-                break;
+            /* Track that we have checked this transaction. */
+            tPackage.setChecked.insert(hash);
+
+            /* Skip over transactions that are already verified. */
+            if(tPackage.setPackage.count(hash))
+                continue;
+
+            /* Check the size limits of our package. */
+            if(tPackage.vtx.size() >= nMaxPackage)
+                continue;
 
             /* Get the transaction from the memory pool. */
             TAO::Ledger::Transaction tx;
@@ -195,10 +282,11 @@ namespace TAO::Ledger
                 continue;
             }
 
-            /* Check for timestamp violations. */
+            /* Check for timestamp violations, which we need to check again on the next template. */
             if(tx.nTimestamp > runtime::unifiedtimestamp() + runtime::maxdrift())
             {
                 setDependents.insert(hash);
+                tPackage.fRetry = true;
 
                 debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - timesamp too far in future");
                 continue;
@@ -238,12 +326,77 @@ namespace TAO::Ledger
                 continue;
             }
 
-            /* Add the transaction to the block. */
-            block.vtx.push_back(std::make_pair(TRANSACTION::TRITIUM, hash));
+            /* Add the transaction to our package. */
+            tPackage.vtx.push_back(hash);
+            tPackage.setPackage.insert(hash);
         }
 
         /* Abort the temporary ACID transaction. */
         LLD::TxnAbort(FLAGS::MINER);
+    }
+
+
+    /* Gets a list of transactions from memory pool for current block. */
+    void AddTransactions(TAO::Ledger::TritiumBlock& block)
+    {
+        /* Clear the transactions. */
+        block.vtx.clear();
+
+        /* Track the serialized size of our block as transactions are added. */
+        uint64_t nSize = ::GetSerializeSize(block, SER_NETWORK, LLP::PROTOCOL_VERSION);
+
+        /* Check the memory pool. */
+        std::vector<uint512_t> vMempool;
+        mempool.List(vMempool);
+
+        {
+            LOCK(tPackage.MUTEX);
+
+            /* Start a new package when our best chain has changed. */
+            const uint1024_t hashBestChain = ChainState::hashBestChain.load();
+            if(tPackage.hashBestChain != hashBestChain)
+                tPackage.Clear(hashBestChain);
+
+            /* Start a new package if any of our transactions have left the mempool. */
+            const std::set<uint512_t> setMempool(vMempool.begin(), vMempool.end());
+            for(const auto& hash : tPackage.vtx)
+            {
+                /* Check that our transaction is still listed. */
+                if(!setMempool.count(hash))
+                {
+                    tPackage.Clear(hashBestChain);
+                    break;
+                }
+            }
+
+            /* Check for new transactions, or transactions that need to be checked again. */
+            bool fUpdate = tPackage.fRetry;
+            for(const auto& hash : vMempool)
+            {
+                /* Check if we have seen this transaction. */
+                if(!tPackage.setChecked.count(hash))
+                {
+                    fUpdate = true;
+                    break;
+                }
+            }
+
+            /* Only verify transactions when our mempool has changed. */
+            if(fUpdate)
+                update_package(vMempool);
+
+            /* Add our package to the block. */
+            for(const auto& hash : tPackage.vtx)
+            {
+                /* Check the Size limits of the Current Block. */
+                if(nSize + 256 >= MAX_BLOCK_SIZE)
+                    break;
+
+                /* Add the transaction to the block. */
+                block.vtx.push_back(std::make_pair(TRANSACTION::TRITIUM, hash));
+                nSize += entry_size(block);
+            }
+        }
 
         /* Clear for legacy. */
         vMempool.clear();
@@ -257,7 +410,7 @@ namespace TAO::Ledger
         for(const auto& hash : vMempool)
         {
             /* Check the Size limits of the Current Block. */
-            if(::GetSerializeSize(block, SER_NETWORK, LLP::PROTOCOL_VERSION) + 256 >= MAX_BLOCK_SIZE)
+            if(nSize + 256 >= MAX_BLOCK_SIZE)
                 break;
 
             /* Get the transaction from the memory pool. */
@@ -315,6 +468,7 @@ namespace TAO::Ledger
 
             /* Add the transaction to the block. */
             block.vtx.push_back(std::make_pair(TRANSACTION::LEGACY, hash));
+            nSize += entry_size(block);
         }
     }
 
@@ -18,6 +18,7 @@ ________________________________________________________________________________
 #include <LLC/include/argon2.h>
 #include <LLC/include/flkey.h>
 #include <LLC/include/eckey.h>
+#include <LLC/aes/aes.h>
 
 #include <LLD/include/global.h>
 
@@ -31,6 +32,16 @@ ________________________________________________________________________________
 
 #include <Util/include/debug.h>
 
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <set>
+#include <system_error>
+#include <thread>
+
 /* Global TAO namespace. */
 namespace TAO
 {
@@ -39,12 +50,339 @@ namespace TAO
     namespace Ledger
     {
 
+        /* Bounded cache of derived keys, shared with the background threads that fill it. */
+        struct Credentials::KeyCache
+        {
+            /* Mutex to guard our pending keys and the cache together. */
+            std::mutex MUTEX;
+
+
+            /* Condition to wake threads waiting on a key that is being derived. */
+            std::condition_variable CONDITION;
+
+
+            /* The keys being derived right now, by key type and sequence. */
+            std::set<std::pair<std::string, uint32_t>> setPending;
+
+
+            /* The derived keys encrypted under our cipher key, each with its IV and the check of the password and secret. */
+            LLD::TemplateLRU<std::pair<std::string, uint32_t>, SecureString> cacheKeys;
+
+
+            /* Random key our cached keys are encrypted with, so they are never held in plaintext. */
+            SecureString strCipher;
+
+
+            /* Random key our checks are hashed with, so a check can't be used to test passwords without argon2. */
+            SecureString strSalt;
+
+
+            /* Holds every key type and a few sequences at once. */
+            KeyCache()
+            : MUTEX      ( )
+            , CONDITION  ( )
+            , setPending ( )
+            , cacheKeys  (16)
+            , strCipher  (AES_KEYLEN, 0)
+            , strSalt    (32, 0)
+            {
+                RAND_bytes((uint8_t*)&strCipher[0], strCipher.size());
+                RAND_bytes((uint8_t*)&strSalt[0], strSalt.size());
+            }
+
+
+            /* Hash the password and secret a key was derived from, keyed by our salt. */
+            uint256_t Check(const SecureString& strPassword, const SecureString& strSecret) const
+            {
+                /* Length prefix the password so the boundary between the two is fixed. */
+                const uint32_t nLength = static_cast<uint32_t>(strPassword.size());
+
+                SecureString strData = strSalt;
+                strData.append((char*)&nLength, sizeof(nLength));
+                strData.append(strPassword);
+                strData.append(strSecret);
+
+                return LLC::SK256(strData.begin(), strData.end());
+            }
+
+
+            /* Encrypt or decrypt a cache record in place, past the IV it starts with. */
+            void Crypt(SecureString &strRecord) const
+            {
+                struct AES_ctx ctx;
+                AES_init_ctx_iv(&ctx, (const uint8_t*)&strCipher[0], (const uint8_t*)&strRecord[0]);
+                AES_CTR_xcrypt_buffer(&ctx, (uint8_t*)&strRecord[AES_BLOCKLEN], strRecord.size() - AES_BLOCKLEN);
+
+                /* Don't leave our expanded key on the stack. */
+                OPENSSL_cleanse(&ctx, sizeof(ctx));
+            }
+
+
+            /* Get a key from the cache if it was derived from the same password and secret. */
+            bool Get(const std::pair<std::string, uint32_t>& pairKey, const uint256_t& hashCheck, uint512_t &hashKey)
+            {
+                /* Check for the key in our cache. */
+                SecureString strKey;
+                if(!cacheKeys.Get(pairKey, strKey) || strKey.size() != AES_BLOCKLEN + 96)
+                    return false;
+
+                /* Decrypt our copy of the record. */
+                Crypt(strKey);
+
+                /* Check that the key came from the same password and secret. */
+                const std::vector<uint8_t> vCheck = hashCheck.GetBytes();
+                if(!std::equal(vCheck.begin(), vCheck.end(), (uint8_t*)&strKey[AES_BLOCKLEN + 64]))
+                    return false;
+
+                /* Set the bytes of return value. */
+                hashKey.SetBytes(std::vector<uint8_t>(strKey.begin() + AES_BLOCKLEN, strKey.begin() + AES_BLOCKLEN + 64));
+
+                return true;
+            }
+
+
+            /* Add a key to the cache along with the check of the password and secret it came from. */
+            void Put(const std::pair<std::string, uint32_t>& pairKey, const uint256_t& hashCheck, const uint512_t& hashKey)
+            {
+                /* Grab our key's binary data. */
+                const std::vector<uint8_t> vBytes = hashKey.GetBytes();
+                const std::vector<uint8_t> vCheck = hashCheck.GetBytes();
+
+                /* Start our record with a fresh IV. */
+                SecureString strKey(AES_BLOCKLEN, 0);
+                RAND_bytes((uint8_t*)&strKey[0], AES_BLOCKLEN);
+
+                /* Set our cache record now with it, encrypted. */
+                strKey.append(vBytes.begin(), vBytes.end());
+                strKey.append(vCheck.begin(), vCheck.end());
+                Crypt(strKey);
+
+                cacheKeys.Put(pairKey, strKey);
+            }
+
+
+            /* Derive a pending key and add it to the cache, waking anyone waiting on it. */
+            uint512_t Fill(const SecureString& strUsername, const SecureString& strPassword, const SecureString& strSecret,
+                           const std::string& strType, const uint32_t nKeyID, const uint256_t& hashCheck,
+                           const uint32_t nCost, const uint32_t nMemory);
+        };
+
+
+        /* Single thread that derives prefilled keys in turn, so prefills never run argon2 side by side. */
+        class PrefillWorker
+        {
+            /* A key to derive, and how to release it if it is dropped instead. */
+            typedef std::pair<std::function<void()>, std::function<void()>> Job;
+
+
+            /* The most keys that can wait for our thread, anything past this is derived when it is needed. */
+            static const uint32_t MAX_QUEUE = 4;
+
+
+            /* Mutex to guard our queue and thread. */
+            std::mutex MUTEX;
+
+
+            /* Condition to wake our thread when keys are queued. */
+            std::condition_variable CONDITION;
+
+
+            /* The keys waiting for our thread. */
+            std::deque<Job> QUEUE;
+
+
+            /* Our thread, started on first use. */
+            std::thread THREAD;
+
+
+            /* Flag to tell our thread to stop. */
+            bool fStop;
+
+
+            /* Derive queued keys until we are stopped. */
+            void worker()
+            {
+                while(true)
+                {
+                    Job tJob;
+                    {
+                        std::unique_lock<std::mutex> lock(MUTEX);
+                        CONDITION.wait(lock, [this]{ return fStop || !QUEUE.empty(); });
+
+                        /* Check for shutdown. */
+                        if(fStop)
+                            return;
+
+                        tJob = std::move(QUEUE.front());
+                        QUEUE.pop_front();
+                    }
+
+                    tJob.first();
+                }
+            }
+
+
+        public:
+
+            /* Default Constructor. */
+            PrefillWorker()
+            : MUTEX     ( )
+            , CONDITION ( )
+            , QUEUE     ( )
+            , THREAD    ( )
+            , fStop     (false)
+            {
+            }
+
+
+            /* Stop our thread before it is destroyed. */
+            ~PrefillWorker()
+            {
+                Stop();
+            }
+
+
+            /* Queue a key to derive, returning false if the queue is full or we are stopped. */
+            bool Push(const std::function<void()>& fnDerive, const std::function<void()>& fnCancel)
+            {
+                {
+                    LOCK(MUTEX);
+
+                    /* Check that we can take another key. */
+                    if(fStop || QUEUE.size() >= MAX_QUEUE)
+                        return false;
+
+                    /* Start our thread on first use. */
+                    if(!THREAD.joinable())
+                    {
+                        try
+                        {
+                            THREAD = std::thread(&PrefillWorker::worker, this);
+                        }
+                        catch(const std::system_error& e)
+                        {
+                            debug::warning(FUNCTION, "could not start key derivation: ", e.what());
+                            return false;
+                        }
+                    }
+
+                    QUEUE.emplace_back(fnDerive, fnCancel);
+                }
+                CONDITION.notify_one();
+
+                return true;
+            }
+
+
+            /* Stop our thread once its current key is done, and release the keys still queued. */
+            void Stop()
+            {
+                std::deque<Job> vDropped;
+                {
+                    LOCK(MUTEX);
+                    fStop = true;
+
+                    vDropped.swap(QUEUE);
+                }
+                CONDITION.notify_all();
+
+                /* Wait for our current key to finish. */
+                if(THREAD.joinable())
+                    THREAD.join();
+
+                /* Let anyone waiting on a dropped key derive it themselves. */
+                for(Job& tJob : vDropped)
+                    tJob.second();
+            }
+        };
+
+
+        /* Our one background thread for prefilled keys. */
+        static PrefillWorker tPrefill;
+
+
+        /* Run argon2 over our credentials for a key in the keychain, seeded with the key type if given. */
+        static uint512_t derive_key(const SecureString& strUsername, const SecureString& strPassword, const SecureString& strSecret,
+                             const std::string& strType, const uint32_t nKeyID, const uint32_t nCost, const uint32_t nMemory)
+        {
+            /* Generate the Secret Phrase */
+            std::vector<uint8_t> vUsername(strUsername.begin(), strUsername.end());
+            vUsername.insert(vUsername.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
+
+            /* Set to minimum salt limits. */
+            if(vUsername.size() < 8)
+                vUsername.resize(8);
+
+            /* Generate the Secret Phrase */
+            std::vector<uint8_t> vPassword(strPassword.begin(), strPassword.end());
+            vPassword.insert(vPassword.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
+
+            /* Generate the secret data. */
+            std::vector<uint8_t> vSecret(strSecret.begin(), strSecret.end());
+            vSecret.insert(vSecret.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
+
+            /* Seed secret data with the key type. */
+            vSecret.insert(vSecret.end(), strType.begin(), strType.end());
+
+            /* Argon2 hash the secret */
+            return LLC::Argon2_512(vPassword, vUsername, vSecret, nCost, nMemory);
+        }
+
+
+        /* Get the argon2 computational cost from our configuration. */
+        static uint32_t argon2_cost()
+        {
+            return std::max(1u, uint32_t(config::GetArg("-argon2", 12)));
+        }
+
+
+        /* Get the argon2 memory cost in KiB from our configuration. */
+        static uint32_t argon2_memory()
+        {
+            return uint32_t(1 << std::max(4u, uint32_t(config::GetArg("-argon2_memory", 16))));
+        }
+
+
+        /* Derive a pending key and add it to the cache, waking anyone waiting on it. */
+        uint512_t Credentials::KeyCache::Fill(const SecureString& strUsername, const SecureString& strPassword,
+                                              const SecureString& strSecret, const std::string& strType,
+                                              const uint32_t nKeyID, const uint256_t& hashCheck,
+                                              const uint32_t nCost, const uint32_t nMemory)
+        {
+            const std::pair<std::string, uint32_t> pairKey = std::make_pair(strType, nKeyID);
+
+            /* Always clear our pending key, even if argon2 fails. */
+            uint512_t hashKey;
+            try
+            {
+                hashKey = derive_key(strUsername, strPassword, strSecret, strType, nKeyID, nCost, nMemory);
+
+                LOCK(MUTEX);
+                Put(pairKey, hashCheck, hashKey);
+                setPending.erase(pairKey);
+            }
+            catch(...)
+            {
+                {
+                    LOCK(MUTEX);
+                    setPending.erase(pairKey);
+                }
+
+                CONDITION.notify_all();
+                throw;
+            }
+
+            CONDITION.notify_all();
+
+            return hashKey;
+        }
+
+
         /* Copy Constructor */
         Credentials::Credentials(const Credentials& sigchain)
         : strUsername (sigchain.strUsername)
         , strPassword (sigchain.strPassword)
-        , MUTEX       ( )
-        , pairCache   (sigchain.pairCache)
+        , pCache      (std::make_shared<KeyCache>())
         , hashGenesis (sigchain.hashGenesis)
         {
         }
@@ -54,8 +392,7 @@ namespace TAO
         Credentials::Credentials(Credentials&& sigchain) noexcept
         : strUsername (std::move(sigchain.strUsername.c_str()))
         , strPassword (std::move(sigchain.strPassword.c_str()))
-        , MUTEX       ( )
-        , pairCache   (std::move(sigchain.pairCache))
+        , pCache      (std::move(sigchain.pCache))
         , hashGenesis (std::move(sigchain.hashGenesis))
         {
         }
@@ -71,8 +408,7 @@ namespace TAO
         Credentials::Credentials(const SecureString& strUsernameIn, const SecureString& strPasswordIn)
         : strUsername (strUsernameIn.c_str())
         , strPassword (strPasswordIn.c_str())
-        , MUTEX       ( )
-        , pairCache   (std::make_pair(std::numeric_limits<uint32_t>::max(), ""))
+        , pCache      (std::make_shared<KeyCache>())
         , hashGenesis (Credentials::Genesis(strUsernameIn))
         {
         }
@@ -124,145 +460,39 @@ namespace TAO
         }
 
 
-        /* Set's the current cached key manually in case it was generated externally from this object. */
-        void Credentials::SetCache(const uint512_t& hashSecret, const uint32_t nKeyID)
+        /* Derive the keys for a sequence and the one after it in the background. */
+        void Credentials::Prefill(const uint32_t nKeyID, const SecureString& strSecret) const
         {
-            {
-                LOCK(MUTEX);
-
-                /* Handle cache to stop exhaustive hash key generation. */
-                if(nKeyID == pairCache.first)
-                {
-                    /* Grab our key's binary data. */
-                    const std::vector<uint8_t> vBytes = hashSecret.GetBytes();
-
-                    /* Set our cache record now with it. */
-                    pairCache.first  = nKeyID;
-                    pairCache.second = SecureString(vBytes.begin(), vBytes.end());
-                }
-            }
+            prefill("", nKeyID, strSecret);
+            prefill("", nKeyID + 1, strSecret);
         }
 
 
         /* This function is responsible for genearting the private key in the keychain of a specific account. */
         uint512_t Credentials::Generate(const uint32_t nKeyID, const SecureString& strSecret, const bool fCache) const
         {
-            {
-                LOCK(MUTEX);
-
-                /* Handle cache to stop exhaustive hash key generation. */
-                if(fCache && nKeyID == pairCache.first)
-                {
-                    /* Get the bytes from secure allocator. */
-                    const std::vector<uint8_t> vBytes =
-                        std::vector<uint8_t>(pairCache.second.begin(), pairCache.second.end());
-
-                    /* Set the bytes of return value. */
-                    uint512_t hashKey;
-                    hashKey.SetBytes(vBytes);
-
-                    return hashKey;
-                }
-            }
-
-            /* Generate the Secret Phrase */
-            std::vector<uint8_t> vUsername(strUsername.begin(), strUsername.end());
-            vUsername.insert(vUsername.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Set to minimum salt limits. */
-            if(vUsername.size() < 8)
-                vUsername.resize(8);
-
-            /* Generate the Secret Phrase */
-            std::vector<uint8_t> vPassword(strPassword.begin(), strPassword.end());
-            vPassword.insert(vPassword.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Generate the secret data. */
-            std::vector<uint8_t> vSecret(strSecret.begin(), strSecret.end());
-            vSecret.insert(vSecret.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Argon2 hash the secret */
-            uint512_t hashKey = LLC::Argon2_512(vPassword, vUsername, vSecret,
-                            std::max(1u, uint32_t(config::GetArg("-argon2", 12))),
-                            uint32_t(1 << std::max(4u, uint32_t(config::GetArg("-argon2_memory", 16)))));
+            /* Skip over our cache if requested. */
+            if(!fCache)
+                return derive_key(strUsername, strPassword, strSecret, "", nKeyID, argon2_cost(), argon2_memory());
 
-            /* Set the cache items. */
-            {
-                LOCK(MUTEX);
+            /* Start on the next key while we get this one, since the next transaction will need it. */
+            prefill("", nKeyID + 1, strSecret);
 
-                if(fCache)
-                {
-                    /* Grab our key's binary data. */
-                    const std::vector<uint8_t> vBytes = hashKey.GetBytes();
-
-                    /* Set our cache record now with it. */
-                    pairCache.first  = nKeyID;
-                    pairCache.second = SecureString(vBytes.begin(), vBytes.end());
-                }
-            }
-
-            return hashKey;
+            return cached("", nKeyID, strSecret);
         }
 
 
         /* This function is responsible for generating the private key in the sigchain with a specific password and pin. */
         uint512_t Credentials::Generate(const uint32_t nKeyID, const SecureString& strPassword, const SecureString& strSecret) const
         {
-            /* Generate the Secret Phrase */
-            std::vector<uint8_t> vUsername(strUsername.begin(), strUsername.end());
-            vUsername.insert(vUsername.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Set to minimum salt limits. */
-            if(vUsername.size() < 8)
-                vUsername.resize(8);
-
-            /* Generate the Secret Phrase */
-            std::vector<uint8_t> vPassword(strPassword.begin(), strPassword.end());
-            vPassword.insert(vPassword.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Generate the secret data. */
-            std::vector<uint8_t> vSecret(strSecret.begin(), strSecret.end());
-            vSecret.insert(vSecret.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-
-            /* Argon2 hash the secret */
-            uint512_t hashKey = LLC::Argon2_512(vPassword, vUsername, vSecret,
-                            std::max(1u, uint32_t(config::GetArg("-argon2", 12))),
-                            uint32_t(1 << std::max(4u, uint32_t(config::GetArg("-argon2_memory", 16)))));
-
-
-            return hashKey;
+            return derive_key(strUsername, strPassword, strSecret, "", nKeyID, argon2_cost(), argon2_memory());
         }
 
 
         /* This function is responsible for genearting the private key in the keychain of a specific account. */
         uint512_t Credentials::Generate(const std::string& strType, const uint32_t nKeyID, const SecureString& strSecret) const
         {
-            /* Generate the Secret Phrase */
-            std::vector<uint8_t> vUsername(strUsername.begin(), strUsername.end());
-            vUsername.insert(vUsername.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Set to minimum salt limits. */
-            if(vUsername.size() < 8)
-                vUsername.resize(8);
-
-            /* Generate the Secret Phrase */
-            std::vector<uint8_t> vPassword(strPassword.begin(), strPassword.end());
-            vPassword.insert(vPassword.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Generate the secret data. */
-            std::vector<uint8_t> vSecret(strSecret.begin(), strSecret.end());
-            vSecret.insert(vSecret.end(), (uint8_t*)&nKeyID, (uint8_t*)&nKeyID + sizeof(nKeyID));
-
-            /* Seed secret data with the key type. */
-            vSecret.insert(vSecret.end(), strType.begin(), strType.end());
-
-            /* Argon2 hash the secret */
-            uint512_t hashKey = LLC::Argon2_512(vPassword, vUsername, vSecret,
-                            std::max(1u, uint32_t(config::GetArg("-argon2", 12))),
-                            uint32_t(1 << std::max(4u, uint32_t(config::GetArg("-argon2_memory", 16)))));
-
-            return hashKey;
+            return cached(strType, nKeyID, strSecret);
         }
 
 
@@ -567,6 +797,10 @@ namespace TAO
         void Credentials::Update(const SecureString& strPasswordNew)
         {
             strPassword = strPasswordNew.c_str();
+
+            /* Our cached keys came from the old password. */
+            LOCK(pCache->MUTEX);
+            pCache->cacheKeys.Clear();
         }
 
 
@@ -575,8 +809,9 @@ namespace TAO
         {
             encrypt(strUsername);
             encrypt(strPassword);
-            encrypt(pairCache);
             encrypt(hashGenesis);
+
+            /* Our cached keys stay encrypted under the cache's own key, since prefill threads use it while we are locked. */
         }
 
 
@@ -751,5 +986,100 @@ namespace TAO
             return true;
         }
 
+
+        /* Get a key from the cache, or derive it and cache it, waiting if it is being derived already. */
+        uint512_t Credentials::cached(const std::string& strType, const uint32_t nKeyID, const SecureString& strSecret) const
+        {
+            const std::pair<std::string, uint32_t> pairKey = std::make_pair(strType, nKeyID);
+            const uint256_t hashCheck = pCache->Check(strPassword, strSecret);
+
+            {
+                std::unique_lock<std::mutex> lock(pCache->MUTEX);
+
+                /* Wait for this key if another thread is deriving it already. */
+                pCache->CONDITION.wait(lock, [&]{ return pCache->setPending.count(pairKey) == 0; });
+
+                /* Handle cache to stop exhaustive hash key generation. */
+                uint512_t hashKey;
+                if(pCache->Get(pairKey, hashCheck, hashKey))
+                    return hashKey;
+
+                /* Let other threads know we are deriving this key. */
+                pCache->setPending.insert(pairKey);
+            }
+
+            /* Derive the key and add it to our cache. */
+            return pCache->Fill(strUsername, strPassword, strSecret, strType, nKeyID, hashCheck,
+                                argon2_cost(), argon2_memory());
+        }
+
+
+        /* Queue a key for the background thread to derive, unless it is cached or being derived already. */
+        void Credentials::prefill(const std::string& strType, const uint32_t nKeyID, const SecureString& strSecret) const
+        {
+            const std::pair<std::string, uint32_t> pairKey = std::make_pair(strType, nKeyID);
+            const uint256_t hashCheck = pCache->Check(strPassword, strSecret);
+
+            {
+                LOCK(pCache->MUTEX);
+
+                /* Check that this key isn't being derived already. */
+                if(pCache->setPending.count(pairKey))
+                    return;
+
+                /* Check that this key isn't cached already. */
+                uint512_t hashKey;
+                if(pCache->Get(pairKey, hashCheck, hashKey))
+                    return;
+
+                /* Let other threads know we are deriving this key. */
+                pCache->setPending.insert(pairKey);
+            }
+
+            /* Copy everything our job needs, so it can outlive this object. */
+            const std::shared_ptr<KeyCache> pFill = pCache;
+            const SecureString strUsernameFill = strUsername;
+            const SecureString strPasswordFill = strPassword;
+            const SecureString strSecretFill   = strSecret;
+            const uint32_t nCost   = argon2_cost();
+            const uint32_t nMemory = argon2_memory();
+
+            /* Release our pending key if it is never derived, so waiters derive it themselves. */
+            const std::function<void()> fnCancel = [pFill, pairKey]()
+            {
+                {
+                    LOCK(pFill->MUTEX);
+                    pFill->setPending.erase(pairKey);
+                }
+
+                pFill->CONDITION.notify_all();
+            };
+
+            /* Derive the key asynchronously, anyone who needs it in the meantime will wait on our pending key. */
+            const std::function<void()> fnDerive = [=]()
+            {
+                try
+                {
+                    pFill->Fill(strUsernameFill, strPasswordFill, strSecretFill, strType, nKeyID, hashCheck,
+                                nCost, nMemory);
+                }
+                catch(...)
+                {
+                    /* A failed key is derived again in the foreground when it is needed. */
+                }
+            };
+
+            /* Skip the prefill when our thread is busy, the key will be derived when it is needed. */
+            if(!tPrefill.Push(fnDerive, fnCancel))
+                fnCancel();
+        }
+
+
+        /* Stops the background thread that derives prefilled keys. */
+        void Credentials::Shutdown()
+        {
+            tPrefill.Stop();
+        }
+
     }
 }
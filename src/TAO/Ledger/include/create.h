@@ -76,7 +76,9 @@ namespace TAO
 
         /** AddTransactions
          *
-         *  Gets a list of transactions from memory pool for current block.
+         *  Gets a list of transactions from memory pool for current block. Transactions are verified once on top of
+         *  the best chain and kept in order in a package, so only new mempool transactions are verified when the
+         *  next template is built.
          *
          *  @param[out] block The block to add the transactions to.
          *
@@ -0,0 +1,188 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_TAO_LEDGER_INCLUDE_METRICS_H
+#define NEXUS_TAO_LEDGER_INCLUDE_METRICS_H
+
+#include <LLC/types/uint1024.h>
+#include <Util/templates/serialize.h>
+#include <vector>
+
+/* Forward declarations. */
+namespace Legacy { class Transaction; }
+
+/* Global TAO namespace. */
+namespace TAO
+{
+    /* Ledger layer namespace. */
+    namespace Ledger
+    {
+        class Transaction;
+
+
+        /** Seconds of block time that are aggregated into each bucket of ledger metrics. **/
+        const uint32_t METRICS_BUCKET = 60 * 60;
+
+
+        /** Total registers in the unique accounts sketch, which gives a standard error of around three percent. **/
+        const uint32_t METRICS_REGISTERS = 1024;
+
+
+        /** Metrics
+         *
+         *  Holds the ledger activity totals of a bucket of blocks, which are written to the ledger database as each block
+         *  is connected and disconnected, so that ledger/metrics only has to add up buckets.
+         *
+         *  Unique accounts are counted with a HyperLogLog sketch, so buckets are merged by taking the largest register of
+         *  each. A sketch can't have accounts taken out of it, so disconnecting a block only reverses its totals.
+         *
+         **/
+        class Metrics
+        {
+        public:
+
+            /** Total transactions. **/
+            uint64_t nTransactions;
+
+
+            /** Total tritium contracts. **/
+            uint64_t nContracts;
+
+
+            /** Total deposited from legacy into tritium. **/
+            uint64_t nDeposits;
+
+
+            /** Total withdrawn from tritium to legacy. **/
+            uint64_t nWithdraws;
+
+
+            /** Total minted by coinbase transactions. **/
+            uint64_t nMining;
+
+
+            /** Total minted by trust and genesis transactions. **/
+            uint64_t nStaking;
+
+
+            /** Total change in the stake of trust accounts. **/
+            int64_t nStake;
+
+
+            /** Registers of our unique accounts sketch. **/
+            std::vector<uint8_t> vAccounts;
+
+
+            //Object serialization for storage
+            IMPLEMENT_SERIALIZE
+            (
+                READWRITE(nTransactions);
+                READWRITE(nContracts);
+                READWRITE(nDeposits);
+                READWRITE(nWithdraws);
+                READWRITE(nMining);
+                READWRITE(nStaking);
+                READWRITE(nStake);
+                READWRITE(vAccounts);
+            )
+
+
+            /** Default Constructor. **/
+            Metrics();
+
+
+            /** Copy constructor. **/
+            Metrics(const Metrics& tMetrics);
+
+
+            /** Move constructor. **/
+            Metrics(Metrics&& tMetrics) noexcept;
+
+
+            /** Copy assignment. **/
+            Metrics& operator=(const Metrics& tMetrics);
+
+
+            /** Move assignment. **/
+            Metrics& operator=(Metrics&& tMetrics) noexcept;
+
+
+            /** Default Destructor. **/
+            ~Metrics();
+
+
+            /** Operator +=
+             *
+             *  Adds the totals of another bucket and merges its unique accounts into ours.
+             *
+             *  @param[in] tMetrics The metrics to add.
+             *
+             **/
+            Metrics& operator+=(const Metrics& tMetrics);
+
+
+            /** Operator -=
+             *
+             *  Takes away the totals of another bucket, leaving our unique accounts as they are.
+             *
+             *  @param[in] tMetrics The metrics to take away.
+             *
+             **/
+            Metrics& operator-=(const Metrics& tMetrics);
+
+
+            /** Add
+             *
+             *  Adds the contracts of a tritium transaction to our totals.
+             *
+             *  @param[in] tx The transaction to add.
+             *
+             **/
+            void Add(const Transaction& tx);
+
+
+            /** Add
+             *
+             *  Adds the outputs of a legacy transaction to our totals.
+             *
+             *  @param[in] tx The transaction to add.
+             *
+             **/
+            void Add(const Legacy::Transaction& tx);
+
+
+            /** Insert
+             *
+             *  Adds an account to our unique accounts sketch.
+             *
+             *  @param[in] hashAccount The register or legacy address hash of the account.
+             *
+             **/
+            void Insert(const uint256_t& hashAccount);
+
+
+            /** Accounts
+             *
+             *  Estimates the number of unique accounts from our sketch.
+             *
+             *  @return the estimated total unique accounts.
+             *
+             **/
+            uint64_t Accounts() const;
+
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*__________________________________________________________________________________________
+
+			Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+			(c) Copyright The Nexus Developers 2014 - 2026
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To The Voice of The People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+
+#include <LLC/types/uint1024.h>
+
+#include <Util/templates/singleton.h>
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <condition_variable>
+
+/* Global TAO namespace. */
+namespace TAO::Ledger
+{
+    /* Forward declarations. */
+    class Transaction;
+
+
+    /** @class
+     *
+     *  This class is responsible for verifying transaction signatures in parallel.
+     *  A batch of transactions is split between a pool of worker threads and the calling thread,
+     *  and the results are joined before returning, so signatures are verified ahead of Check
+     *  and Connect rather than one at a time.
+     *
+     **/
+    class Verifier : public Singleton<Verifier>
+    {
+        /** Internal batch of transactions shared between threads. **/
+        struct Batch;
+
+
+        /** Queue to hand batches to worker threads. **/
+        std::queue<std::shared_ptr<Batch>> BATCH_QUEUE;
+
+
+        /** Mutex to protect our batch queue. **/
+        std::mutex QUEUE_MUTEX;
+
+
+        /** Condition variable to wake up the worker threads. **/
+        std::condition_variable CONDITION;
+
+
+        /** Threads for running verification. **/
+        std::vector<std::thread> VERIFY_THREADS;
+
+
+        /** Flag to tell our worker threads to stop. **/
+        std::atomic<bool> fStop;
+
+
+    public:
+
+        /** Default Constructor. **/
+        Verifier();
+
+
+        /** Default Destructor. **/
+        ~Verifier();
+
+
+        /** Verify
+         *
+         *  Verify the signatures of a batch of transactions in parallel. Transactions that pass are flagged
+         *  as verified, so their following Check doesn't repeat the work. Verifies on the calling thread
+         *  if the verifier isn't running.
+         *
+         *  @param[in] vtx The transactions to verify.
+         *
+         *  @return the total transactions that passed verification.
+         *
+         **/
+        static uint32_t Verify(const std::vector<const Transaction*>& vtx);
+
+
+        /** Shutdown
+         *
+         *  Stop our worker threads and destroy our instance. Waits for any batches being verified to finish,
+         *  so a caller of Verify never uses an instance that was destroyed.
+         *
+         **/
+        static void Shutdown();
+
+
+        /** Cached
+         *
+         *  Check the cache of verified signatures, which is shared between the mempool and blocks so that
+         *  transactions accepted into the mempool aren't verified again when their block arrives.
+         *
+         *  @param[in] hashTx The txid of the transaction.
+         *  @param[in] hashKeys The hash of the public key and signature.
+         *
+         *  @return true if this signature was already verified.
+         *
+         **/
+        static bool Cached(const uint512_t& hashTx, const uint256_t& hashKeys);
+
+
+        /** Cache
+         *
+         *  Add a verified signature to the cache, removing the oldest entry when full.
+         *  The size of the cache is set by -sigcachesize.
+         *
+         *  @param[in] hashTx The txid of the transaction.
+         *  @param[in] hashKeys The hash of the public key and signature.
+         *
+         **/
+        static void Cache(const uint512_t& hashTx, const uint256_t& hashKeys);
+
+
+        /** Worker Thread
+         *
+         *  Handle verification of batches pushed by Verify.
+         *
+         **/
+        void Worker();
+
+
+    private:
+
+        /** process
+         *
+         *  Verify transactions from a batch until none are left unclaimed.
+         *
+         *  @param[in] pbatch The batch to work on.
+         *
+         **/
+        static void process(const std::shared_ptr<Batch>& pbatch);
+    };
+}
@@ -22,11 +22,13 @@ ________________________________________________________________________________
 #include <TAO/Operation/include/enum.h>
 #include <TAO/Operation/types/contract.h>
 
+#include <TAO/Register/include/unpack.h>
 #include <TAO/Register/include/verify.h>
 
 #include <TAO/Ledger/include/constants.h>
 #include <TAO/Ledger/include/timelocks.h>
 #include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/verifier.h>
 #include <TAO/Ledger/types/mempool.h>
 
 #include <TAO/Ledger/include/create.h>
@@ -41,6 +43,51 @@ namespace TAO
 
         Mempool mempool;
 
+
+        /* Get the recipient register or sigchain of a debit or transfer contract. */
+        static bool unpack_recipient(const TAO::Operation::Contract& rContract, uint256_t& hashRecipient)
+        {
+            /* Reset the contract to the position of the primitive. */
+            rContract.SeekToPrimitive();
+
+            /* Make sure no exceptions are thrown. */
+            try
+            {
+                /* Deserialize the operation. */
+                uint8_t OPERATION = 0;
+                rContract >> OPERATION;
+
+                /* Only debits and transfers have a recipient. */
+                if(OPERATION != TAO::Operation::OP::DEBIT && OPERATION != TAO::Operation::OP::TRANSFER)
+                    return false;
+
+                /* Skip over the source address to get the recipient. */
+                rContract.Seek(32);
+                rContract >> hashRecipient;
+
+                return true;
+            }
+            catch(const std::exception& e)
+            {
+            }
+
+            return false;
+        }
+
+
+        /* Get the transaction a credit, claim or validate contract is proving against. */
+        static bool unpack_proof(const TAO::Operation::Contract& rContract, uint512_t& hashProof)
+        {
+            /* Check for credits and claims. */
+            if(TAO::Register::Unpack(rContract, hashProof))
+                return true;
+
+            /* Check for validates of a previous condition. */
+            uint32_t nContract = 0;
+            return TAO::Register::Unpack(rContract, hashProof, nContract);
+        }
+
+
         /** Default Constructor. **/
         Mempool::Mempool()
         : MUTEX              ( )
@@ -53,6 +100,11 @@ namespace TAO
         , mapRejected        ( )
         , mapInputs          ( )
         , setOrphansByIndex  ( )
+        , mapSequences       ( )
+        , mapRegisters       ( )
+        , mapProofs          ( )
+        , setDirty           ( )
+        , setConnected       ( )
         {
         }
 
@@ -77,6 +129,10 @@ namespace TAO
 
             /* Add to the map. */
             mapLedger[hashTx] = tx;
+            index_tx(hashTx, tx);
+
+            /* Check this sigchain on our next consistency check, since it wasn't validated. */
+            setDirty.insert(tx.hashGenesis);
 
             return true;
         }
@@ -268,6 +324,7 @@ namespace TAO
 
                 /* Set the internal memory. */
                 mapLedger[hashTx] = tx;
+                index_tx(hashTx, tx);
 
                 /* Update map claimed if not first tx. */
                 if(!tx.IsFirst())
@@ -311,6 +368,23 @@ namespace TAO
         {
             RECURSIVE(MUTEX);
 
+            /* Verify signatures for our chain of orphans in parallel (if not synchronizing) */
+            if(!ChainState::Synchronizing())
+            {
+                /* Get the orphans that are waiting on this transaction. */
+                std::vector<const TAO::Ledger::Transaction*> vVerify;
+                for(uint512_t hashNext = hash; mapOrphans.count(hashNext) && vVerify.size() < mapOrphans.size(); )
+                {
+                    const TAO::Ledger::Transaction& tx = mapOrphans[hashNext];
+                    vVerify.push_back(&tx);
+
+                    hashNext = tx.GetHash();
+                }
+
+                /* Failures are left for Accept to report. */
+                Verifier::Verify(vVerify);
+            }
+
             /* Check orphan queue. */
             uint512_t hashTx = hash;
             while(mapOrphans.count(hashTx))
@@ -419,24 +493,20 @@ namespace TAO
         {
             RECURSIVE(MUTEX);
 
-            /* Check through the ledger map for the genesis. */
-            for(const auto& tx : mapLedger)
-            {
-                /* Check for non-conflicted genesis-id's. */
-                if(tx.second.hashGenesis == hashGenesis)
-                {
-                    /* Cache our txid in here. */
-                    tx.second.hashCache = tx.first;
-                    vtx.push_back(tx.second);
-                }
-            }
-
-            /* Check that a transaction was found. */
-            if(vtx.size() == 0)
+            /* Check our index for the genesis. */
+            const auto it = mapSequences.find(hashGenesis);
+            if(it == mapSequences.end())
                 return false;
 
-            /* Sort the list by sequence numbers. */
-            std::sort(vtx.begin(), vtx.end());
+            /* Add the transactions in order of sequence. */
+            for(const auto& rSequence : it->second)
+            {
+                /* Cache our txid in here. */
+                const TAO::Ledger::Transaction& tx = mapLedger.at(rSequence.second);
+                tx.hashCache = rSequence.second;
+
+                vtx.push_back(tx);
+            }
 
             /* Check that the mempool transactions are in correct order. */
             uint512_t hashLast = vtx[0].GetHash();
@@ -464,13 +534,31 @@ namespace TAO
         /* Gets a transaction by genesis. */
         bool Mempool::Get(const uint256_t& hashGenesis, TAO::Ledger::Transaction &tx) const
         {
-            /* Get the list of transactions by genesis. */
-            std::vector<TAO::Ledger::Transaction> vtx;
-            if(!Get(hashGenesis, vtx))
+            RECURSIVE(MUTEX);
+
+            /* Check our index for the genesis. */
+            const auto it = mapSequences.find(hashGenesis);
+            if(it == mapSequences.end())
                 return false;
 
-            /* Return last item in list (newest). */
-            tx = vtx.back();
+            /* Walk the transactions in order of sequence, stopping at the first one out of sequence. */
+            uint512_t hashLast = it->second.begin()->second;
+            for(auto rSequence = std::next(it->second.begin()); rSequence != it->second.end(); ++rSequence)
+            {
+                /* Check that transaction is in sequence. */
+                if(mapLedger.at(rSequence->second).hashPrevTx != hashLast)
+                {
+                    debug::log(0, FUNCTION, "Last hash mismatch");
+                    break;
+                }
+
+                /* Set last hash. */
+                hashLast = rSequence->second;
+            }
+
+            /* Return last item in sequence (newest). */
+            tx = mapLedger.at(hashLast);
+            tx.hashCache = hashLast;
 
             return true;
         }
@@ -490,12 +578,7 @@ namespace TAO
         {
             RECURSIVE(MUTEX);
 
-            /* Check through the ledger map for the genesis. */
-            for(const auto& tx : mapLedger)
-                if(tx.second.hashGenesis == hashGenesis)
-                    return true;
-
-            return false;
+            return mapSequences.count(hashGenesis);
         }
 
 
@@ -526,6 +609,10 @@ namespace TAO
                 /* Get a reference from the map. */
                 const TAO::Ledger::Transaction& tx = mapLedger[hashTx];
 
+                /* Remove from our indexes, and check the sigchains this transaction touched again. */
+                unindex_tx(hashTx, tx);
+                mark_dirty(hashTx, tx);
+
                 /* Erase from the memory map. */
                 mapClaimed.erase(tx.hashPrevTx);
                 mapOrphans.erase(tx.hashPrevTx);
@@ -547,6 +634,10 @@ namespace TAO
                 mapLegacy.erase(hashTx);
             }
 
+            /* Track transactions connected from outside our pool, if we have sigchains they could affect. */
+            else if(!mapLedger.empty() && hashTx.GetType() == TAO::Ledger::TRITIUM)
+                setConnected.insert(hashTx);
+
             return false;
         }
 
@@ -556,132 +647,164 @@ namespace TAO
         {
             RECURSIVE(MUTEX);
 
-            /* Create map of transactions by genesis. */
-            std::map<uint256_t, std::vector<TAO::Ledger::Transaction> > mapTransactions;
+            /* Check the sigchains touched by transactions connected from outside our pool. */
+            if(!mapLedger.empty())
+            {
+                for(const auto& hashTx : setConnected)
+                {
+                    /* Read the transaction from disk now that it has been committed. */
+                    TAO::Ledger::Transaction tx;
+                    if(LLD::Ledger->ReadTx(hashTx, tx))
+                        mark_dirty(hashTx, tx);
+                }
+            }
+            setConnected.clear();
 
-            /* Loop through all the transactions. */
-            for(const auto& tx : mapLedger)
+            /* Check the first transaction of every sigchain against the disk, which is one lookup per sigchain. */
+            for(const auto& rSequences : mapSequences)
             {
-                /* Cache the genesis. */
-                const uint256_t& hashGenesis = tx.second.hashGenesis;
+                /* Skip over sigchains that are already marked. */
+                if(setDirty.count(rSequences.first))
+                    continue;
 
-                /* Check in map for push back. */
-                if(!mapTransactions.count(hashGenesis))
-                    mapTransactions[hashGenesis] = std::vector<TAO::Ledger::Transaction>();
+                /* Get the last transaction on disk. */
+                uint512_t hashLastDisk = 0;
+                if(!LLD::Ledger->ReadLast(rSequences.first, hashLastDisk))
+                    continue;
 
-                /* Push to back of map. */
-                mapTransactions[hashGenesis].push_back(tx.second);
+                /* Check our sigchain again if it no longer follows from the disk. */
+                if(mapLedger.at(rSequences.second.begin()->second).hashPrevTx != hashLastDisk)
+                    setDirty.insert(rSequences.first);
             }
 
-            /* Loop transctions map by genesis. */
-            for(auto& rTransaction : mapTransactions)
+            /* Keep checking while sigchains are marked, since disconnecting transactions marks the sigchains they touched. */
+            while(!setDirty.empty())
             {
-                /* Get reference of the vector. */
-                std::vector<TAO::Ledger::Transaction>& vtx = rTransaction.second;
+                /* Create map of transactions by genesis. */
+                std::map<uint256_t, std::vector<TAO::Ledger::Transaction> > mapTransactions;
 
-                /* Sort the list by sequence numbers. */
-                std::sort(vtx.begin(), vtx.end());
+                /* Loop through our marked sigchains. */
+                for(const auto& hashGenesis : setDirty)
+                {
+                    /* Check that the sigchain is still in our pool. */
+                    const auto it = mapSequences.find(hashGenesis);
+                    if(it == mapSequences.end())
+                        continue;
 
-                /* Add the hashes into list. */
-                uint512_t hashLastDisk = 0;
-                if(!LLD::Ledger->ReadLast(rTransaction.first, hashLastDisk))
-                    break;
+                    /* Push to back of map in order of sequence. */
+                    std::vector<TAO::Ledger::Transaction>& vtx = mapTransactions[hashGenesis];
+                    for(const auto& rSequence : it->second)
+                        vtx.push_back(mapLedger.at(rSequence.second));
+                }
+                setDirty.clear();
 
-                /* Loop through transaction by genesis. */
-                uint512_t hashLast = hashLastDisk; //we make a copy here so we can know when we reached end of chain.
-                for(uint32_t n = 0; n < vtx.size(); ++n)
+                /* Loop transctions map by genesis. */
+                for(auto& rTransaction : mapTransactions)
                 {
-                    /* We don't run this check on our first transaction. */
-                    if(!vtx[n].IsFirst())
-                    {
-                        /* Start a ACID transaction (to be disposed). */
-                        LLD::TxnBegin(TAO::Ledger::FLAGS::SANITIZE, LLD::INSTANCES::MEMORY);
-
-                        /* Check the contracts for our root transaction to make sure it's valid. */
-                        bool fContractInvalid = false;
-                        for(const auto& rContract : vtx[n].Contracts())
-                        {
-                            /* Sanitize the contract. */
-                            if(!rContract.Sanitize())
-                            {
-                                fContractInvalid = true;
-                                break;
-                            }
-                        }
+                    /* Get reference of the vector. */
+                    std::vector<TAO::Ledger::Transaction>& vtx = rTransaction.second;
 
-                        /* Abort the mempool ACID transaction once the contract is sanitized */
-                        LLD::TxnAbort(TAO::Ledger::FLAGS::SANITIZE, LLD::INSTANCES::MEMORY);
+                    /* Add the hashes into list. */
+                    uint512_t hashLastDisk = 0;
+                    if(!LLD::Ledger->ReadLast(rTransaction.first, hashLastDisk))
+                        continue;
 
-                        /* Check that transaction is in sequence. */
-                        if(vtx[n].hashPrevTx != hashLast || fContractInvalid)
+                    /* Loop through transaction by genesis. */
+                    uint512_t hashLast = hashLastDisk; //we make a copy here so we can know when we reached end of chain.
+                    for(uint32_t n = 0; n < vtx.size(); ++n)
+                    {
+                        /* We don't run this check on our first transaction. */
+                        if(!vtx[n].IsFirst())
                         {
-                            /* Debug information. */
-                            if(fContractInvalid)
-                                debug::notice(FUNCTION, "ORPHAN REJECTED AT INDEX ", n, ": invalid orphan chain ", vtx[n].hashPrevTx.SubString());
-                            else
-                                debug::notice(FUNCTION, "ORPHAN DETECTED AT INDEX ", n, ": last hash mismatch ", vtx[n].hashPrevTx.SubString());
-
-                            /* Begin the memory transaction. */
-                            LLD::TxnBegin(FLAGS::MEMPOOL, LLD::INSTANCES::MEMORY);
+                            /* Start a ACID transaction (to be disposed). */
+                            LLD::TxnBegin(TAO::Ledger::FLAGS::SANITIZE, LLD::INSTANCES::MEMORY);
 
-                            /* Disconnect all transactions in reverse order. */
-                            for(auto tx = vtx.rbegin(); tx != vtx.rend(); ++tx)
+                            /* Check the contracts for our root transaction to make sure it's valid. */
+                            bool fContractInvalid = false;
+                            for(const auto& rContract : vtx[n].Contracts())
                             {
-                                /* Find the transaction in pool. */
-                                const uint512_t hashTx = tx->GetHash();
-
-                                /* Check for our stop hash. */
-                                if(hashTx == hashLast)
+                                /* Sanitize the contract. */
+                                if(!rContract.Sanitize())
                                 {
-                                    debug::notice(FUNCTION, "REACHED HASH LAST ", hashLast.SubString());
+                                    fContractInvalid = true;
                                     break;
                                 }
+                            }
 
-                                /* Debug output tx. */
-                                tx->print();
-
-                                /* Check for ending of sequence. */
-                                const bool fRoot = (n == 0);
+                            /* Abort the mempool ACID transaction once the contract is sanitized */
+                            LLD::TxnAbort(TAO::Ledger::FLAGS::SANITIZE, LLD::INSTANCES::MEMORY);
 
-                                /* Reset memory states to disk indexes. */
-                                if(!tx->Disconnect(fRoot ? FLAGS::ERASE : FLAGS::MEMPOOL))
-                                {
-                                    LLD::TxnAbort(FLAGS::MEMPOOL, LLD::INSTANCES::MEMORY);
-                                    break;
-                                }
+                            /* Check that transaction is in sequence. */
+                            if(vtx[n].hashPrevTx != hashLast || fContractInvalid)
+                            {
+                                /* Debug information. */
+                                if(fContractInvalid)
+                                    debug::notice(FUNCTION, "ORPHAN REJECTED AT INDEX ", n, ": invalid orphan chain ", vtx[n].hashPrevTx.SubString());
+                                else
+                                    debug::notice(FUNCTION, "ORPHAN DETECTED AT INDEX ", n, ": last hash mismatch ", vtx[n].hashPrevTx.SubString());
 
-                                /* Erase from the memory map. */
-                                Remove(hashTx);
+                                /* Begin the memory transaction. */
+                                LLD::TxnBegin(FLAGS::MEMPOOL, LLD::INSTANCES::MEMORY);
 
-                                /* Remove the API sessions indexes if disconnecting a mempool transaction. */
-                                if(LLD::Sessions->Active(tx->hashGenesis))
+                                /* Disconnect all transactions in reverse order. */
+                                for(auto tx = vtx.rbegin(); tx != vtx.rend(); ++tx)
                                 {
-                                    /* Get a reference of our transaction. */
-                                    TAO::API::Transaction wtx =
-                                        TAO::API::Transaction(*tx);
-
-                                    /* Make sure indexes are deleted. */
-                                    if(wtx.Delete(hashTx))
-                                        debug::log(0, FUNCTION, "DELETED API session indexes for ", hashTx.SubString());
+                                    /* Find the transaction in pool. */
+                                    const uint512_t hashTx = tx->GetHash();
+
+                                    /* Check for our stop hash. */
+                                    if(hashTx == hashLast)
+                                    {
+                                        debug::notice(FUNCTION, "REACHED HASH LAST ", hashLast.SubString());
+                                        break;
+                                    }
+
+                                    /* Debug output tx. */
+                                    tx->print();
+
+                                    /* Check for ending of sequence. */
+                                    const bool fRoot = (n == 0);
+
+                                    /* Reset memory states to disk indexes. */
+                                    if(!tx->Disconnect(fRoot ? FLAGS::ERASE : FLAGS::MEMPOOL))
+                                    {
+                                        LLD::TxnAbort(FLAGS::MEMPOOL, LLD::INSTANCES::MEMORY);
+                                        break;
+                                    }
+
+                                    /* Erase from the memory map. */
+                                    Remove(hashTx);
+
+                                    /* Remove the API sessions indexes if disconnecting a mempool transaction. */
+                                    if(LLD::Sessions->Active(tx->hashGenesis))
+                                    {
+                                        /* Get a reference of our transaction. */
+                                        TAO::API::Transaction wtx =
+                                            TAO::API::Transaction(*tx);
+
+                                        /* Make sure indexes are deleted. */
+                                        if(wtx.Delete(hashTx))
+                                            debug::log(0, FUNCTION, "DELETED API session indexes for ", hashTx.SubString());
+                                    }
+
+                                    /* Write the txid of deleted transactions. */
+                                    debug::notice(FUNCTION, "DELETED ", hashTx.SubString());
+
+                                    /* Special output for our root orphan. */
+                                    if(fRoot)
+                                        debug::notice(FUNCTION, "ROOT ORPHAN: disconnected root with FLAGS::ERASE: ", hashTx.SubString());
                                 }
 
-                                /* Write the txid of deleted transactions. */
-                                debug::notice(FUNCTION, "DELETED ", hashTx.SubString());
+                                /* Commit the memory transaction. */
+                                LLD::TxnCommit(FLAGS::MEMPOOL, LLD::INSTANCES::MEMORY);
 
-                                /* Special output for our root orphan. */
-                                if(fRoot)
-                                    debug::notice(FUNCTION, "ROOT ORPHAN: disconnected root with FLAGS::ERASE: ", hashTx.SubString());
+                                break;
                             }
-
-                            /* Commit the memory transaction. */
-                            LLD::TxnCommit(FLAGS::MEMPOOL, LLD::INSTANCES::MEMORY);
-
-                            break;
                         }
-                    }
 
-                    /* Set last hash. */
-                    hashLast = vtx[n].GetHash();
+                        /* Set last hash. */
+                        hashLast = vtx[n].GetHash();
+                    }
                 }
             }
 
@@ -714,7 +837,7 @@ namespace TAO
                 /* Add the hashes into list. */
                 uint512_t hashLastDisk = 0;
                 if(!LLD::Ledger->ReadLast(rTransaction.first, hashLastDisk))
-                    break;
+                    continue;
 
                 /* Check if our conflict chain needs to be evicted. */
                 if(vtx[0].hashPrevTx != hashLastDisk)
@@ -735,66 +858,51 @@ namespace TAO
             /* If legacy flag set, skip over getting tritium transactions. */
             if(!fLegacy)
             {
-                /* Create map of transactions by genesis. */
-                std::map<uint256_t, std::vector<TAO::Ledger::Transaction> > mapTransactions;
-
-                /* Loop through all the transactions. */
-                for(const auto& tx : mapLedger)
+                /* Loop through our sigchains in order of genesis. */
+                for(const auto& rSequences : mapSequences)
                 {
-                    /* Check that this transaction isn't conflicted. */
-                    //if(mapConflicts.count(tx.first))
-                    //    continue;
-
-                    /* Check that this transaction hasn't been rejected. */
-                    if(mapRejected.count(tx.first))
-                        continue;
-
-                    /* Cache the genesis. */
-                    const uint256_t& hashGenesis = tx.second.hashGenesis;
-
-                    /* Check in map for push back. */
-                    if(!mapTransactions.count(hashGenesis))
-                        mapTransactions[hashGenesis] = std::vector<TAO::Ledger::Transaction>();
-
-                    /* Push to back of map. */
-                    mapTransactions[hashGenesis].push_back(tx.second);
-                }
+                    /* Get the transactions that haven't been rejected, in order of sequence. */
+                    std::vector<uint512_t> vChain;
+                    for(const auto& rSequence : rSequences.second)
+                    {
+                        /* Check that this transaction hasn't been rejected. */
+                        if(mapRejected.count(rSequence.second))
+                            continue;
 
-                /* Loop transctions map by genesis. */
-                for(auto& list : mapTransactions)
-                {
-                    /* Get reference of the vector. */
-                    std::vector<TAO::Ledger::Transaction>& vtx = list.second;
+                        vChain.push_back(rSequence.second);
+                    }
 
-                    /* Sort the list by sequence numbers. */
-                    std::sort(vtx.begin(), vtx.end());
+                    /* Check that we have transactions left. */
+                    if(vChain.empty())
+                        continue;
 
                     /* Add the hashes into list. */
                     uint512_t hashLast = 0;
 
                     /* Check last hash for valid transactions. */
-                    if(!vtx[0].IsFirst())
+                    const TAO::Ledger::Transaction& txRoot = mapLedger.at(vChain[0]);
+                    if(!txRoot.IsFirst())
                     {
                         /* Read last index from disk. */
-                        if(!LLD::Ledger->ReadLast(list.first, hashLast))
-                            break; //NOTE: this may need an error
+                        if(!LLD::Ledger->ReadLast(rSequences.first, hashLast))
+                            continue; //NOTE: this may need an error
 
                         /* Check the last hash. */
-                        if(vtx[0].hashPrevTx != hashLast)
-                            break;
+                        if(txRoot.hashPrevTx != hashLast)
+                            continue;
                     }
 
                     /* Set last from next transaction. */
-                    hashLast = vtx[0].GetHash();
+                    hashLast = vChain[0];
 
                     /* Loop through transaction by genesis. */
-                    for(uint32_t n = 1; n <= vtx.size(); ++n)
+                    for(uint32_t n = 1; n <= vChain.size(); ++n)
                     {
                         /* Add to the output queue. */
                         vHashes.push_back(hashLast);
 
                         /* Check for end of index. */
-                        if(n == vtx.size())
+                        if(n == vChain.size())
                             break;
 
                         /* Check count. */
@@ -802,11 +910,11 @@ namespace TAO
                             return true;
 
                         /* Check that transaction is in sequence. */
-                        if(vtx[n].hashPrevTx != hashLast)
+                        if(mapLedger.at(vChain[n]).hashPrevTx != hashLast)
                             break; //SKIP ANY ORPHANS FOUND
 
                         /* Set last hash. */
-                        hashLast = vtx[n].GetHash();
+                        hashLast = vChain[n];
                     }
                 }
             }
@@ -844,5 +952,148 @@ namespace TAO
 
             return static_cast<uint32_t>(mapConflicts.size() + mapLegacyConflicts.size());
         }
+
+
+        /* Add a transaction to our sigchain and register indexes. */
+        void Mempool::index_tx(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx)
+        {
+            /* Add to our sigchain in order of sequence. */
+            mapSequences[tx.hashGenesis].insert(std::make_pair(tx.nSequence, hashTx));
+
+            /* Add to the registers our contracts operate on, and the transactions they prove against. */
+            for(const auto& rContract : tx.Contracts())
+            {
+                /* Get the register address of this contract. */
+                uint256_t hashAddress = 0;
+                if(TAO::Register::Unpack(rContract, hashAddress))
+                    mapRegisters[hashAddress].insert(hashTx);
+
+                /* Get the recipient of a debit or transfer. */
+                uint256_t hashRecipient = 0;
+                if(unpack_recipient(rContract, hashRecipient) && hashRecipient != hashAddress)
+                    mapRegisters[hashRecipient].insert(hashTx);
+
+                /* Get the transaction a credit, claim or validate is proving against. */
+                uint512_t hashProof = 0;
+                if(unpack_proof(rContract, hashProof))
+                    mapProofs[hashProof].insert(hashTx);
+            }
+        }
+
+
+        /* Remove a transaction from our sigchain and register indexes. */
+        void Mempool::unindex_tx(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx)
+        {
+            /* Remove from our sigchain. */
+            auto itSequences = mapSequences.find(tx.hashGenesis);
+            if(itSequences != mapSequences.end())
+            {
+                /* Erase the sigchain when it has no transactions left. */
+                itSequences->second.erase(std::make_pair(tx.nSequence, hashTx));
+                if(itSequences->second.empty())
+                    mapSequences.erase(itSequences);
+            }
+
+            /* Remove from the registers our contracts operate on, and the transactions they prove against. */
+            for(const auto& rContract : tx.Contracts())
+            {
+                /* Get the register address of this contract. */
+                uint256_t hashAddress = 0;
+                if(TAO::Register::Unpack(rContract, hashAddress))
+                    unindex_register(hashTx, hashAddress);
+
+                /* Get the recipient of a debit or transfer. */
+                uint256_t hashRecipient = 0;
+                if(unpack_recipient(rContract, hashRecipient))
+                    unindex_register(hashTx, hashRecipient);
+
+                /* Get the transaction a credit, claim or validate is proving against. */
+                uint512_t hashProof = 0;
+                if(!unpack_proof(rContract, hashProof))
+                    continue;
+
+                /* Erase the proof when it has no transactions left. */
+                auto itProof = mapProofs.find(hashProof);
+                if(itProof == mapProofs.end())
+                    continue;
+
+                itProof->second.erase(hashTx);
+                if(itProof->second.empty())
+                    mapProofs.erase(itProof);
+            }
+        }
+
+
+        /* Remove a transaction from a register index. */
+        void Mempool::unindex_register(const uint512_t& hashTx, const uint256_t& hashAddress)
+        {
+            /* Erase the register when it has no transactions left. */
+            auto itRegister = mapRegisters.find(hashAddress);
+            if(itRegister == mapRegisters.end())
+                return;
+
+            itRegister->second.erase(hashTx);
+            if(itRegister->second.empty())
+                mapRegisters.erase(itRegister);
+        }
+
+
+        /* Mark the sigchains touched by a transaction to be checked again. */
+        void Mempool::mark_dirty(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx)
+        {
+            /* Mark our own sigchain if we have it. */
+            if(mapSequences.count(tx.hashGenesis))
+                setDirty.insert(tx.hashGenesis);
+
+            /* Mark the sigchains with credits, claims or validates proving against this transaction. */
+            mark_proof(hashTx);
+
+            /* Mark the sigchains that operate on the same registers or proofs. */
+            for(const auto& rContract : tx.Contracts())
+            {
+                /* Get the register address of this contract. */
+                uint256_t hashAddress = 0;
+                if(TAO::Register::Unpack(rContract, hashAddress))
+                    mark_register(hashAddress);
+
+                /* Get the recipient of a debit or transfer. */
+                uint256_t hashRecipient = 0;
+                if(unpack_recipient(rContract, hashRecipient))
+                    mark_register(hashRecipient);
+
+                /* Get the transaction a credit, claim or validate is proving against, which may be spent twice. */
+                uint512_t hashProof = 0;
+                if(unpack_proof(rContract, hashProof))
+                    mark_proof(hashProof);
+            }
+        }
+
+
+        /* Mark the sigchains in the pool that operate on a register. */
+        void Mempool::mark_register(const uint256_t& hashAddress)
+        {
+            /* Check for transactions in our pool on this register. */
+            const auto itRegister = mapRegisters.find(hashAddress);
+            if(itRegister == mapRegisters.end())
+                return;
+
+            /* Mark the sigchain of each transaction. */
+            for(const auto& hashTx : itRegister->second)
+                setDirty.insert(mapLedger.at(hashTx).hashGenesis);
+        }
+
+
+        /* Mark the sigchains in the pool that prove against a transaction. */
+        void Mempool::mark_proof(const uint512_t& hashProof)
+        {
+            /* Check for transactions in our pool proving against this transaction. */
+            const auto itProof = mapProofs.find(hashProof);
+            if(itProof == mapProofs.end())
+                return;
+
+            /* Mark the sigchain of each transaction. */
+            for(const auto& hashTx : itProof->second)
+                setDirty.insert(mapLedger.at(hashTx).hashGenesis);
+        }
     }
 }
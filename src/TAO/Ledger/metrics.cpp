@@ -0,0 +1,307 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/hash/xxh3.h>
+
+#include <Legacy/include/evaluate.h>
+#include <Legacy/types/transaction.h>
+
+#include <TAO/Operation/include/enum.h>
+
+#include <TAO/Register/include/unpack.h>
+#include <TAO/Register/types/object.h>
+
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/include/metrics.h>
+#include <TAO/Ledger/types/transaction.h>
+
+#include <Util/include/debug.h>
+
+#include <algorithm>
+#include <cmath>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /* Default Constructor. */
+        Metrics::Metrics()
+        : nTransactions (0)
+        , nContracts    (0)
+        , nDeposits     (0)
+        , nWithdraws    (0)
+        , nMining       (0)
+        , nStaking      (0)
+        , nStake        (0)
+        , vAccounts     (METRICS_REGISTERS, 0)
+        {
+        }
+
+
+        /* Copy constructor. */
+        Metrics::Metrics(const Metrics& tMetrics)
+        : nTransactions (tMetrics.nTransactions)
+        , nContracts    (tMetrics.nContracts)
+        , nDeposits     (tMetrics.nDeposits)
+        , nWithdraws    (tMetrics.nWithdraws)
+        , nMining       (tMetrics.nMining)
+        , nStaking      (tMetrics.nStaking)
+        , nStake        (tMetrics.nStake)
+        , vAccounts     (tMetrics.vAccounts)
+        {
+        }
+
+
+        /* Move constructor. */
+        Metrics::Metrics(Metrics&& tMetrics) noexcept
+        : nTransactions (std::move(tMetrics.nTransactions))
+        , nContracts    (std::move(tMetrics.nContracts))
+        , nDeposits     (std::move(tMetrics.nDeposits))
+        , nWithdraws    (std::move(tMetrics.nWithdraws))
+        , nMining       (std::move(tMetrics.nMining))
+        , nStaking      (std::move(tMetrics.nStaking))
+        , nStake        (std::move(tMetrics.nStake))
+        , vAccounts     (std::move(tMetrics.vAccounts))
+        {
+        }
+
+
+        /* Copy assignment. */
+        Metrics& Metrics::operator=(const Metrics& tMetrics)
+        {
+            nTransactions = tMetrics.nTransactions;
+            nContracts    = tMetrics.nContracts;
+            nDeposits     = tMetrics.nDeposits;
+            nWithdraws    = tMetrics.nWithdraws;
+            nMining       = tMetrics.nMining;
+            nStaking      = tMetrics.nStaking;
+            nStake        = tMetrics.nStake;
+            vAccounts     = tMetrics.vAccounts;
+
+            return *this;
+        }
+
+
+        /* Move assignment. */
+        Metrics& Metrics::operator=(Metrics&& tMetrics) noexcept
+        {
+            nTransactions = std::move(tMetrics.nTransactions);
+            nContracts    = std::move(tMetrics.nContracts);
+            nDeposits     = std::move(tMetrics.nDeposits);
+            nWithdraws    = std::move(tMetrics.nWithdraws);
+            nMining       = std::move(tMetrics.nMining);
+            nStaking      = std::move(tMetrics.nStaking);
+            nStake        = std::move(tMetrics.nStake);
+            vAccounts     = std::move(tMetrics.vAccounts);
+
+            return *this;
+        }
+
+
+        /* Default Destructor. */
+        Metrics::~Metrics()
+        {
+        }
+
+
+        /* Adds the totals of another bucket and merges its unique accounts into ours. */
+        Metrics& Metrics::operator+=(const Metrics& tMetrics)
+        {
+            nTransactions += tMetrics.nTransactions;
+            nContracts    += tMetrics.nContracts;
+            nDeposits     += tMetrics.nDeposits;
+            nWithdraws    += tMetrics.nWithdraws;
+            nMining       += tMetrics.nMining;
+            nStaking      += tMetrics.nStaking;
+            nStake        += tMetrics.nStake;
+
+            /* The union of two sketches is the largest of each register. */
+            vAccounts.resize(METRICS_REGISTERS, 0);
+            for(uint32_t n = 0; n < tMetrics.vAccounts.size() && n < METRICS_REGISTERS; ++n)
+                vAccounts[n] = std::max(vAccounts[n], tMetrics.vAccounts[n]);
+
+            return *this;
+        }
+
+
+        /* Takes away the totals of another bucket, leaving our unique accounts as they are. */
+        Metrics& Metrics::operator-=(const Metrics& tMetrics)
+        {
+            nTransactions -= tMetrics.nTransactions;
+            nContracts    -= tMetrics.nContracts;
+            nDeposits     -= tMetrics.nDeposits;
+            nWithdraws    -= tMetrics.nWithdraws;
+            nMining       -= tMetrics.nMining;
+            nStaking      -= tMetrics.nStaking;
+            nStake        -= tMetrics.nStake;
+
+            return *this;
+        }
+
+
+        /* Adds the contracts of a tritium transaction to our totals. */
+        void Metrics::Add(const Transaction& tx)
+        {
+            /* Increment our totals. */
+            ++nTransactions;
+            nContracts += tx.Size();
+
+            /* Iterate all of our contracts. */
+            for(uint32_t n = 0; n < tx.Size(); ++n)
+            {
+                /* Get a reference of our contract. */
+                const TAO::Operation::Contract& rContract = tx[n];
+
+                /* Catch exceptions so that a contract we can't read never fails a block. */
+                try
+                {
+                    /* Check for an available address that was modified. */
+                    uint256_t hashAddress;
+                    if(TAO::Register::Unpack(rContract, hashAddress))
+                        Insert(hashAddress);
+
+                    /* Unpack our total now from contracts. */
+                    uint64_t nTotal = 0;
+                    if(!TAO::Register::Unpack(rContract, nTotal))
+                        continue;
+
+                    /* Check for trust transactions. */
+                    const uint8_t nPrimitive = rContract.Primitive();
+                    if(nPrimitive == TAO::Operation::OP::TRUST)
+                    {
+                        /* Accumulate our trust totals. */
+                        nStaking += nTotal;
+
+                        /* Skip to our stake change. */
+                        rContract.SeekToPrimitive();
+                        rContract.Seek(73);
+
+                        /* Get our stake change value. */
+                        int64_t nChange = 0;
+                        rContract >> nChange;
+
+                        /* Adjust our current stake. */
+                        nStake += nChange;
+                    }
+
+                    /* Check for genesis transactions. */
+                    else if(nPrimitive == TAO::Operation::OP::GENESIS)
+                    {
+                        /* Accumulate our inflation totals. */
+                        nStaking += nTotal;
+
+                        /* Get our pre-state to find stake. */
+                        TAO::Register::Object tPreState =
+                            rContract.PreState();
+
+                        /* Our balance is our committed stake. */
+                        if(tPreState.Parse())
+                            nStake += tPreState.get<uint64_t>("balance");
+                    }
+
+                    /* Check for credits from legacy. */
+                    else if(nPrimitive == TAO::Operation::OP::CREDIT)
+                    {
+                        uint512_t hashPrevTx;
+                        if(TAO::Register::Unpack(rContract, hashPrevTx) && hashPrevTx.GetType() == LEGACY)
+                            nWithdraws += nTotal;
+                    }
+
+                    /* Check for a legacy deposit. */
+                    else if(nPrimitive == TAO::Operation::OP::LEGACY)
+                        nDeposits += nTotal;
+
+                    /* Check for our coinbase minting. */
+                    else if(nPrimitive == TAO::Operation::OP::COINBASE)
+                        nMining += nTotal;
+                }
+                catch(const std::exception& e)
+                {
+                    debug::warning(FUNCTION, e.what());
+                }
+            }
+        }
+
+
+        /* Adds the outputs of a legacy transaction to our totals. */
+        void Metrics::Add(const Legacy::Transaction& tx)
+        {
+            /* Increment our totals. */
+            ++nTransactions;
+
+            /* Loop through all of our outputs to check. */
+            for(const Legacy::TxOut& out : tx.vout)
+            {
+                /* See if we are sending to register. */
+                uint256_t hashAddress;
+                if(Legacy::ExtractRegister(out.scriptPubKey, hashAddress))
+                    Insert(hashAddress);
+
+                /* Check for legacy to legacy transacitons. */
+                Legacy::NexusAddress addrAccount;
+                if(Legacy::ExtractAddress(out.scriptPubKey, addrAccount))
+                    Insert(addrAccount.GetHash256());
+            }
+        }
+
+
+        /* Adds an account to our unique accounts sketch. */
+        void Metrics::Insert(const uint256_t& hashAccount)
+        {
+            /* Make sure our registers are allocated. */
+            vAccounts.resize(METRICS_REGISTERS, 0);
+
+            /* The top ten bits pick our register. */
+            const uint64_t nHash = XXH64(hashAccount.begin(), 32, 0);
+            const uint32_t nRegister = (nHash >> 54);
+
+            /* The register keeps the longest run of leading zeros seen in the rest. */
+            const uint64_t nRest = (nHash << 10);
+            const uint8_t nRank  = (nRest == 0) ? 55 : (__builtin_clzll(nRest) + 1);
+
+            vAccounts[nRegister] = std::max(vAccounts[nRegister], nRank);
+        }
+
+
+        /* Estimates the number of unique accounts from our sketch. */
+        uint64_t Metrics::Accounts() const
+        {
+            /* Add up the harmonic mean of our registers. */
+            double dSum = 0;
+            uint32_t nZeros = 0;
+            for(uint32_t n = 0; n < METRICS_REGISTERS; ++n)
+            {
+                /* Registers that were never set count as zero. */
+                const uint8_t nRank = (n < vAccounts.size()) ? vAccounts[n] : 0;
+                if(nRank == 0)
+                    ++nZeros;
+
+                dSum += std::ldexp(1.0, -nRank);
+            }
+
+            /* Get our raw estimate. */
+            const double dRegisters = METRICS_REGISTERS;
+            double dEstimate = (0.7213 / (1.0 + 1.079 / dRegisters)) * dRegisters * dRegisters / dSum;
+
+            /* Use linear counting for small sets where the raw estimate is biased. */
+            if(dEstimate <= 2.5 * dRegisters && nZeros > 0)
+                dEstimate = dRegisters * std::log(dRegisters / nZeros);
+
+            return static_cast<uint64_t>(dEstimate + 0.5);
+        }
+    }
+}
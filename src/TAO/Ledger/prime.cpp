@@ -12,6 +12,7 @@
 ____________________________________________________________________________________________*/
 
 #include <TAO/Ledger/include/prime.h>
+#include <LLC/include/fermat.h>
 #include <LLC/types/bignum.h>
 #include <openssl/bn.h>
 
@@ -67,13 +68,14 @@ namespace TAO
 
                     /* Set the next offset position. */
                     hashNext += nOffset;
-
-                    /* Check prime at offset. */
-                    if(!fVerify || PrimeCheck(hashNext))
-                        ++nClusterSize;
-
                 }
 
+                /* Check primes at all offsets in one pass. */
+                if(fVerify)
+                    nClusterSize += LLC::FermatCluster(hashPrime, &vOffsets[0], nSize - 4);
+                else
+                    nClusterSize += nSize - 4;
+
                 /* Get fractional difficulty. */
                 uint32_t nFraction = 0;
                 std::copy((uint8_t*)&vOffsets[nSize - 4], (uint8_t*)&vOffsets[nSize - 1], (uint8_t*)&nFraction);
@@ -187,16 +189,7 @@ namespace TAO
         /* Used after Miller-Rabin and Divisor tests to verify primality. */
         uint1024_t FermatTest(const uint1024_t& hashTest)
         {
-            LLC::CAutoBN_CTX pctx;
-
-            LLC::CBigNum bnPrime(hashTest);
-            LLC::CBigNum bnBase(2);
-            LLC::CBigNum bnExp = bnPrime - 1;
-
-            LLC::CBigNum bnResult;
-            BN_mod_exp(bnResult.getBN(), bnBase.getBN(), bnExp.getBN(), bnPrime.getBN(), pctx);
-
-            return bnResult.getuint1024();
+            return LLC::FermatTest(hashTest);
         }
 
 
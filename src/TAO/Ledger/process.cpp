@@ -227,9 +227,14 @@ namespace TAO
                     /* Get the next hash backwards in the series. */
                     const uint1024_t hashPrev = pOrphan->GetHash();
 
-                    /* Check if this is a duplicate block. */
-                    if(LLD::Ledger->HasBlock(pOrphan->GetHash()))
+                    /* Check if this is a duplicate block, moving on to its own orphans. */
+                    if(LLD::Ledger->HasBlock(hashPrev))
+                    {
+                        mapOrphans.erase(hash);
+                        hash = hashPrev;
+
                         continue;
+                    }
 
                     /* Debug output. */
                     debug::log(0, FUNCTION, "processing ORPHAN prev=", hashPrev.SubString(), " size=", mapOrphans.size());
@@ -40,6 +40,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/difficulty.h>
 #include <TAO/Ledger/include/dispatch.h>
 #include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/include/metrics.h>
 #include <TAO/Ledger/include/prime.h>
 #include <TAO/Ledger/include/stake_change.h>
 #include <TAO/Ledger/include/supply.h>
@@ -1142,6 +1143,9 @@ namespace TAO
             /* Get a copy of our block hash. */
             const uint1024_t hashBlock = GetHash();
 
+            /* Track the ledger metrics of this block. */
+            Metrics tMetrics;
+
             /* Check through all the transactions. */
             nFees = 0; //reset our fees value here.
             for(const auto& proof : vtx)
@@ -1239,6 +1243,9 @@ namespace TAO
                         }
                     }
 
+                    /* Add the transaction to our metrics. */
+                    tMetrics.Add(tx);
+
                     /* Keep track of total contracts processed. */
                     nTotalContracts += tx.Size();
                     swContract.stop();
@@ -1267,6 +1274,9 @@ namespace TAO
                     Legacy::Wallet::Instance().AddToWalletIfInvolvingMe(tx, *this, true);
                     #endif
 
+                    /* Add the transaction to our metrics. */
+                    tMetrics.Add(tx);
+
                     /* Keep track of total inputs proceessed. */
                     nTotalInputs += tx.vin.size();
                     swScript.stop();
@@ -1303,6 +1313,16 @@ namespace TAO
                 std::fixed, (double)(nFeesBurned) / TAO::Ledger::NXS_COIN
             );
 
+            /* Add our metrics to the bucket for this block's time. */
+            const uint32_t nBucket = (GetBlockTime() / METRICS_BUCKET);
+
+            Metrics tBucket;
+            LLD::Ledger->ReadMetrics(nBucket, tBucket);
+
+            tBucket += tMetrics;
+            if(!LLD::Ledger->WriteMetrics(nBucket, tBucket))
+                return debug::error(FUNCTION, "failed to write metrics");
+
             /* Write the updated block state to disk. */
             if(!LLD::Ledger->WriteBlock(hashBlock, *this))
                 return debug::error(FUNCTION, "failed to update block state");
@@ -1330,6 +1350,9 @@ namespace TAO
         /** Disconnect a block state from the chain. **/
         bool BlockState::Disconnect()
         {
+            /* Track the ledger metrics of this block. */
+            Metrics tMetrics;
+
             /* Disconnect the transctions in reverse order to preserve sigchain ordering. */
             for(auto proof = vtx.rbegin(); proof != vtx.rend(); ++proof)
             {
@@ -1348,6 +1371,12 @@ namespace TAO
                     if(!tx.Disconnect())
                         return debug::error(FUNCTION, "failed to disconnect transaction");
 
+                    /* Undo the API indexes that were built from this transaction. */
+                    TAO::API::Indexing::DisconnectTransaction(tx);
+
+                    /* Add the transaction to our metrics. */
+                    tMetrics.Add(tx);
+
                     /* Make sure this sigchain needs to be de-indexed. */
                     if(tx.IsCoinBase() || tx.IsCoinStake() || tx.IsHybrid()) //we only delete indexes for producer transactions
                     {
@@ -1378,6 +1407,9 @@ namespace TAO
                     if(!tx.Disconnect(*this))
                         return debug::error(FUNCTION, "failed to disconnect inputs");
 
+                    /* Add the transaction to our metrics. */
+                    tMetrics.Add(tx);
+
                     /* Wallets need to refund inputs when disonnecting coinstake */
                     #ifndef NO_WALLET
                     if(tx.IsCoinStake() && Legacy::Wallet::Instance().IsFromMe(tx))
@@ -1390,6 +1422,17 @@ namespace TAO
                     debug::notice(FUNCTION, "failed to erase indexes for ", proof->second.SubString());
             }
 
+            /* Take our metrics away from the bucket for this block's time. */
+            const uint32_t nBucket = (GetBlockTime() / METRICS_BUCKET);
+
+            Metrics tBucket;
+            if(LLD::Ledger->ReadMetrics(nBucket, tBucket))
+            {
+                tBucket -= tMetrics;
+                if(!LLD::Ledger->WriteMetrics(nBucket, tBucket))
+                    return debug::error(FUNCTION, "failed to write metrics");
+            }
+
             /* Erase the index for block by height. */
             if(config::GetBoolArg("-indexheight"))
                 LLD::Ledger->EraseIndex(nHeight);
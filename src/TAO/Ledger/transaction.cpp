@@ -48,6 +48,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/stake.h>
 #include <TAO/Ledger/include/stake_change.h>
 #include <TAO/Ledger/include/timelocks.h>
+#include <TAO/Ledger/include/verifier.h>
 #include <TAO/Ledger/types/merkle.h>
 #include <TAO/Ledger/types/mempool.h>
 
@@ -77,6 +78,7 @@ namespace TAO
         , vchPubKey    ( )
         , vchSig       ( )
         , hashCache    (0)
+        , fVerified    (false)
         {
         }
 
@@ -96,6 +98,7 @@ namespace TAO
         , vchPubKey    ( )
         , vchSig       ( )
         , hashCache    (hashCacheIn)
+        , fVerified    (false)
         {
         }
 
@@ -115,6 +118,7 @@ namespace TAO
         , vchPubKey    (tx.vchPubKey)
         , vchSig       (tx.vchSig)
         , hashCache    (tx.hashCache)
+        , fVerified    (tx.fVerified)
         {
         }
 
@@ -134,6 +138,7 @@ namespace TAO
         , vchPubKey    (std::move(tx.vchPubKey))
         , vchSig       (std::move(tx.vchSig))
         , hashCache    (std::move(tx.hashCache))
+        , fVerified    (tx.fVerified)
         {
         }
 
@@ -153,6 +158,7 @@ namespace TAO
         , vchPubKey    (tx.vchPubKey)
         , vchSig       (tx.vchSig)
         , hashCache    (tx.hashCache)
+        , fVerified    (tx.fVerified)
         {
         }
 
@@ -172,6 +178,7 @@ namespace TAO
         , vchPubKey    (std::move(tx.vchPubKey))
         , vchSig       (std::move(tx.vchSig))
         , hashCache    (std::move(tx.hashCache))
+        , fVerified    (tx.fVerified)
         {
         }
 
@@ -192,6 +199,7 @@ namespace TAO
             vchPubKey    = tx.vchPubKey;
             vchSig       = tx.vchSig;
             hashCache    = tx.hashCache;
+            fVerified    = tx.fVerified;
 
             return *this;
         }
@@ -213,6 +221,7 @@ namespace TAO
             vchPubKey    = std::move(tx.vchPubKey);
             vchSig       = std::move(tx.vchSig);
             hashCache    = std::move(tx.hashCache);
+            fVerified    = tx.fVerified;
 
             return *this;
         }
@@ -234,6 +243,7 @@ namespace TAO
             vchPubKey    = tx.vchPubKey;
             vchSig       = tx.vchSig;
             hashCache    = tx.hashCache;
+            fVerified    = tx.fVerified;
 
             return *this;
         }
@@ -255,6 +265,7 @@ namespace TAO
             vchPubKey    = std::move(tx.vchPubKey);
             vchSig       = std::move(tx.vchSig);
             hashCache    = std::move(tx.hashCache);
+            fVerified    = tx.fVerified;
 
             return *this;
         }
@@ -512,45 +523,74 @@ namespace TAO
                 }
             }
 
-            /* Verify the block signature (if not synchronizing) */
-            if(!TAO::Ledger::ChainState::Synchronizing())
+            /* Verify the transaction signature (if not synchronizing) */
+            if(!TAO::Ledger::ChainState::Synchronizing() && !VerifySignature())
+                return false;
+
+            return true;
+        }
+
+
+        /* Verify the transaction signature against its public key. */
+        bool Transaction::VerifySignature() const
+        {
+            /* Check if this object was already verified. */
+            if(fVerified)
+                return true;
+
+            /* Check if these keys were already verified for this txid, the signature is part of our key since the txid
+             * doesn't commit to it, and a block must not be accepted with a signature that other nodes would reject. */
+            const uint512_t hashTx = GetHash();
+
+            std::vector<uint8_t> vKeys = vchPubKey;
+            vKeys.insert(vKeys.end(), vchSig.begin(), vchSig.end());
+
+            const uint256_t hashKeys = LLC::SK256(vKeys);
+            if(Verifier::Cached(hashTx, hashKeys))
             {
-                /* Switch based on signature type. */
-                switch(nKeyType)
-                {
-                    /* Support for the FALCON signature scheeme. */
-                    case SIGNATURE::FALCON:
-                    {
-                        /* Create the FL Key object. */
-                        LLC::FLKey key;
+                fVerified = true;
+                return true;
+            }
 
-                        /* Set the public key and verify. */
-                        key.SetPubKey(vchPubKey);
-                        if(!key.Verify(GetHash().GetBytes(), vchSig))
-                            return debug::error(FUNCTION, "invalid transaction signature");
+            /* Switch based on signature type. */
+            switch(nKeyType)
+            {
+                /* Support for the FALCON signature scheeme. */
+                case SIGNATURE::FALCON:
+                {
+                    /* Create the FL Key object. */
+                    LLC::FLKey key;
 
-                        break;
-                    }
+                    /* Set the public key and verify. */
+                    key.SetPubKey(vchPubKey);
+                    if(!key.Verify(hashTx.GetBytes(), vchSig))
+                        return debug::error(FUNCTION, "invalid transaction signature");
 
-                    /* Support for the BRAINPOOL signature scheme. */
-                    case SIGNATURE::BRAINPOOL:
-                    {
-                        /* Create EC Key object. */
-                        LLC::ECKey key = LLC::ECKey(LLC::BRAINPOOL_P512_T1, 64);
+                    break;
+                }
 
-                        /* Set the public key and verify. */
-                        key.SetPubKey(vchPubKey);
-                        if(!key.Verify(GetHash().GetBytes(), vchSig))
-                            return debug::error(FUNCTION, "invalid transaction signature");
+                /* Support for the BRAINPOOL signature scheme. */
+                case SIGNATURE::BRAINPOOL:
+                {
+                    /* Create EC Key object. */
+                    LLC::ECKey key = LLC::ECKey(LLC::BRAINPOOL_P512_T1, 64);
 
-                        break;
-                    }
+                    /* Set the public key and verify. */
+                    key.SetPubKey(vchPubKey);
+                    if(!key.Verify(hashTx.GetBytes(), vchSig))
+                        return debug::error(FUNCTION, "invalid transaction signature");
 
-                    default:
-                        return debug::error(FUNCTION, "unknown signature type");
+                    break;
                 }
+
+                default:
+                    return debug::error(FUNCTION, "unknown signature type");
             }
 
+            /* Remember our result for later checks, and for other copies of this transaction. */
+            Verifier::Cache(hashTx, hashKeys);
+            fVerified = true;
+
             return true;
         }
 
@@ -1434,6 +1474,9 @@ namespace TAO
             std::vector<uint8_t> vBytes = hashSecret.GetBytes();
             LLC::CSecret vchSecret(vBytes.begin(), vBytes.end());
 
+            /* Our new signature hasn't been verified yet. */
+            fVerified = false;
+
             /* Switch based on signature type. */
             switch(nKeyType)
             {
@@ -37,6 +37,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/process.h>
 #include <TAO/Ledger/include/supply.h>
 #include <TAO/Ledger/include/timelocks.h>
+#include <TAO/Ledger/include/verifier.h>
 #include <TAO/Ledger/types/syncblock.h>
 
 #include <TAO/Register/include/enum.h>
@@ -183,7 +184,37 @@ namespace TAO
             if(block.nVersion < 7)
                 throw debug::exception(FUNCTION, "invalid sync block version for tritium block");
 
+            /* Deserialize our tritium transactions first, so their signatures can be verified together. */
+            std::vector<Transaction> vTritium;
+            for(const auto& entry : block.vtx)
+            {
+                /* Check for tritium. */
+                if(entry.first == TRANSACTION::TRITIUM)
+                {
+                    /* Serialize stream. */
+                    DataStream ssData(entry.second, SER_DISK, LLD::DATABASE_VERSION);
+
+                    /* Build the transaction. */
+                    vTritium.emplace_back();
+                    ssData >> vTritium.back();
+                }
+            }
+
+            /* Verify signatures in parallel for transactions not on disk (if not synchronizing) */
+            if(!ChainState::Synchronizing())
+            {
+                /* Get the transactions that will be checked. */
+                std::vector<const Transaction*> vVerify;
+                for(const auto& tx : vTritium)
+                    if(!LLD::Ledger->HasTx(tx.GetHash()))
+                        vVerify.push_back(&tx);
+
+                /* Failures are left for Check to report. */
+                Verifier::Verify(vVerify);
+            }
+
             /* Loop through transctions. */
+            uint32_t nTritium = 0;
             for(uint32_t n = 0; n < block.vtx.size(); ++n)
             {
                 /* Switch for type. */
@@ -192,12 +223,8 @@ namespace TAO
                     /* Check for tritium. */
                     case TRANSACTION::TRITIUM:
                     {
-                        /* Serialize stream. */
-                        DataStream ssData(block.vtx[n].second, SER_DISK, LLD::DATABASE_VERSION);
-
-                        /* Build the transaction. */
-                        Transaction tx;
-                        ssData >> tx;
+                        /* Get the deserialized transaction. */
+                        const Transaction& tx = vTritium[nTritium++];
 
                         /* Add transaction to binary data. */
                         if(n == block.vtx.size() - 1)
@@ -361,6 +388,32 @@ namespace TAO
             if(GetBlockTime() > (uint64_t)producer.nTimestamp + ((nVersion < 4) ? 1200 : 3600))
                 return debug::error(FUNCTION, "producer transaction timestamp is too early");
 
+            /* Verify the signatures of our producer and pooled transactions in parallel, so their checks find them verified. */
+            if(!ChainState::Synchronizing())
+            {
+                /* Get the transactions from our pool, the rest are either on disk or missing. */
+                std::vector<Transaction> vPool;
+                vPool.reserve(vtx.size());
+                for(const auto& proof : vtx)
+                {
+                    /* Check for tritium. */
+                    if(proof.first != TRANSACTION::TRITIUM)
+                        continue;
+
+                    Transaction tx;
+                    if(mempool.Get(proof.second, tx))
+                        vPool.push_back(std::move(tx));
+                }
+
+                /* Get the transactions that will be checked. */
+                std::vector<const Transaction*> vVerify = { &producer };
+                for(const auto& tx : vPool)
+                    vVerify.push_back(&tx);
+
+                /* Failures are left for Check to report. */
+                Verifier::Verify(vVerify);
+            }
+
             /* Check that the producer is a valid transaction. */
             if(!producer.Check())
                 return debug::error(FUNCTION, "producer transaction is invalid");
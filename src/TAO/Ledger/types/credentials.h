@@ -24,6 +24,7 @@ ________________________________________________________________________________
 #include <Util/include/mutex.h>
 #include <Util/include/memory.h>
 
+#include <memory>
 #include <string>
 
 /* Global TAO namespace. */
@@ -54,12 +55,12 @@ namespace TAO
             SecureString strPassword;
 
 
-            /* Internal mutex for caches. */
-            mutable std::mutex MUTEX;
+            /** Forward declaration of our key cache, defined in credentials.cpp. **/
+            struct KeyCache;
 
 
-            /** Internal sigchain cache (to not exhaust ourselves regenerating the same key). **/
-            mutable std::pair<uint32_t, SecureString> pairCache;
+            /** Internal cache of derived keys (to not exhaust ourselves regenerating the same keys). **/
+            std::shared_ptr<KeyCache> pCache;
 
 
             /** Internal genesis hash. **/
@@ -129,21 +130,23 @@ namespace TAO
             static uint256_t Genesis(const SecureString& strUsername);
 
 
-            /** SetCache
+            /** Prefill
              *
-             *  Set's the current cached key manually in case it was generated externally from this object.
+             *  Derive the keys for a sequence and the one after it in the background, so that the signing and
+             *  next hash of a transaction at this sequence are found in the cache.
              *
-             *  @param[in] hashSecret The secret key to cache internally.
-             *  @param[in] nKeyID The current sequence this key was generated from.
+             *  @param[in] nKeyID The sequence of the next transaction to be signed.
+             *  @param[in] strSecret The secret phrase to use
              *
              **/
-            void SetCache(const uint512_t& hashSecret, const uint32_t nKeyID);
+            void Prefill(const uint32_t nKeyID, const SecureString& strSecret) const;
 
 
             /** Generate
              *
              *  This function is responsible for genearting the private key in the sigchain of a specific account.
-             *  The sigchain is a series of keys seeded from a secret phrase and a PIN number.
+             *  The sigchain is a series of keys seeded from a secret phrase and a PIN number. Keys are cached by
+             *  sequence, and the key for the following sequence is derived in the background.
              *
              *  @param[in] nKeyID The key number in the keychian
              *  @param[in] strSecret The secret phrase to use
@@ -171,7 +174,7 @@ namespace TAO
             /** Generate
              *
              *  This function is responsible for generating the private key in the sigchain of a specific account.
-             *  The sigchain is a series of keys seeded from a secret phrase and a PIN number.
+             *  The sigchain is a series of keys seeded from a secret phrase and a PIN number. Keys are cached by type.
              *
              *  @param[in] strType The type of signing key used.
              *  @param[in] nKeyID The key number in the keychian
@@ -346,6 +349,43 @@ namespace TAO
                         const std::vector<uint8_t>& vchPubKey, const std::vector<uint8_t>& vchSig);
 
 
+            /** Shutdown
+            *
+            *  Stops the background thread that derives prefilled keys, dropping any keys still waiting for it.
+            *
+            **/
+            static void Shutdown();
+
+
+        private:
+
+
+            /** cached
+             *
+             *  Get a key from the cache, or derive it and cache it, waiting if it is being derived already.
+             *
+             *  @param[in] strType The type of signing key, empty for the keys of the sequence.
+             *  @param[in] nKeyID The key number in the keychian
+             *  @param[in] strSecret The secret phrase to use
+             *
+             *  @return The 512 bit hash of this key in the series.
+             *
+             **/
+            uint512_t cached(const std::string& strType, const uint32_t nKeyID, const SecureString& strSecret) const;
+
+
+            /** prefill
+             *
+             *  Queue a key for the background thread to derive, unless it is cached or being derived already.
+             *
+             *  @param[in] strType The type of signing key, empty for the keys of the sequence.
+             *  @param[in] nKeyID The key number in the keychian
+             *  @param[in] strSecret The secret phrase to use
+             *
+             **/
+            void prefill(const std::string& strType, const uint32_t nKeyID, const SecureString& strSecret) const;
+
+
         };
     }
 }
@@ -89,6 +89,26 @@ namespace TAO
             /** Set to keep track of duplicate orphans by index. **/
             std::set<uint512_t> setOrphansByIndex;
 
+
+            /** The transactions in the ledger memory pool by genesis, in order of sequence. **/
+            std::map<uint256_t, std::set<std::pair<uint32_t, uint512_t>>> mapSequences;
+
+
+            /** The transactions in the ledger memory pool by the registers their contracts operate on. **/
+            std::map<uint256_t, std::set<uint512_t>> mapRegisters;
+
+
+            /** The transactions in the ledger memory pool by the transaction their credits, claims or validates prove against. **/
+            std::map<uint512_t, std::set<uint512_t>> mapProofs;
+
+
+            /** Sigchains to check again on the next consistency check. **/
+            std::set<uint256_t> setDirty;
+
+
+            /** Transactions removed that weren't in the pool, which are checked against our sigchains on the next consistency check. **/
+            std::set<uint512_t> setConnected;
+
         public:
 
             /** Default Constructor. **/
@@ -297,7 +317,9 @@ namespace TAO
 
             /** Check
              *
-             *  Check the memory pool for consistency.
+             *  Check the memory pool for consistency. Every sigchain has its first transaction checked against the
+             *  last transaction on disk, but contracts are only sanitized again for sigchains that don't match, or
+             *  that were touched by transactions leaving the pool since the last check.
              *
              **/
             void Check();
@@ -331,6 +353,73 @@ namespace TAO
              **/
             uint32_t Conflicts();
 
+        private:
+
+            /** index_tx
+             *
+             *  Add a transaction to our sigchain and register indexes.
+             *
+             *  @param[in] hashTx The hash of the transaction.
+             *  @param[in] tx The transaction to index.
+             *
+             **/
+            void index_tx(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx);
+
+
+            /** unindex_tx
+             *
+             *  Remove a transaction from our sigchain and register indexes.
+             *
+             *  @param[in] hashTx The hash of the transaction.
+             *  @param[in] tx The transaction to remove.
+             *
+             **/
+            void unindex_tx(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx);
+
+
+            /** unindex_register
+             *
+             *  Remove a transaction from the index of a register.
+             *
+             *  @param[in] hashTx The hash of the transaction.
+             *  @param[in] hashAddress The register address to remove it from.
+             *
+             **/
+            void unindex_register(const uint512_t& hashTx, const uint256_t& hashAddress);
+
+
+            /** mark_dirty
+             *
+             *  Mark the sigchain of a transaction to be checked again, along with the sigchains in the pool that
+             *  operate on the same registers or recipients, prove against the same transaction, or prove against
+             *  this transaction.
+             *
+             *  @param[in] hashTx The hash of the transaction that has changed.
+             *  @param[in] tx The transaction that has changed.
+             *
+             **/
+            void mark_dirty(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx);
+
+
+            /** mark_register
+             *
+             *  Mark the sigchains in the pool that operate on a register to be checked again.
+             *
+             *  @param[in] hashAddress The register address.
+             *
+             **/
+            void mark_register(const uint256_t& hashAddress);
+
+
+            /** mark_proof
+             *
+             *  Mark the sigchains in the pool with credits, claims or validates of a transaction to be checked again.
+             *
+             *  @param[in] hashProof The hash of the transaction being proven against.
+             *
+             **/
+            void mark_proof(const uint512_t& hashProof);
+
         };
 
         extern Mempool mempool;
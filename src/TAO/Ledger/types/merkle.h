@@ -125,7 +125,10 @@ namespace TAO
 
                     /* Reset our cache if deserializing. */
                     if(fRead)
+                    {
                         hashCache = 0;
+                        fVerified = false;
+                    }
                 }
             )
 
@@ -94,6 +94,10 @@ namespace TAO::Ledger
         mutable uint512_t hashCache;
 
 
+        /** MEMORY ONLY: flag set once the signature has been verified. **/
+        mutable bool fVerified;
+
+
         /* serialization macros */
         IMPLEMENT_SERIALIZE
         (
@@ -121,7 +125,10 @@ namespace TAO::Ledger
 
             /* Reset our cache if deserializing. */
             if(!(nSerType & SER_GETHASH) && fRead)
+            {
                 hashCache = 0;
+                fVerified = false;
+            }
         )
 
 
@@ -237,6 +244,17 @@ namespace TAO::Ledger
         bool Check(const uint8_t nFlags = 0) const;
 
 
+        /** VerifySignature
+         *
+         *  Verify the transaction signature against its public key. Successful verifications are
+         *  remembered in memory, so later checks of this object don't repeat the work.
+         *
+         *  @return true if signature is valid.
+         *
+         **/
+        bool VerifySignature() const;
+
+
         /** Verify
          *
          *  Verify a transaction contracts.
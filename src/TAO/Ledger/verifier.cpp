@@ -0,0 +1,288 @@
+/*__________________________________________________________________________________________
+
+			Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+			(c) Copyright The Nexus Developers 2014 - 2026
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To The Voice of The People
+
+____________________________________________________________________________________________*/
+
+#include <TAO/Ledger/include/verifier.h>
+#include <TAO/Ledger/types/transaction.h>
+
+#include <Util/include/args.h>
+#include <Util/include/debug.h>
+#include <Util/include/mutex.h>
+
+#include <Util/templates/mruset.h>
+
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+/* Global TAO namespace. */
+namespace TAO::Ledger
+{
+    /* Mutex to protect the cache of verified signatures. */
+    static std::mutex CACHE_MUTEX;
+
+
+    /* The cache of verified signatures, by txid and hash of public key and signature. */
+    static mruset<std::pair<uint512_t, uint256_t>> setCache;
+
+
+    /* The total callers using our instance, which Shutdown waits on before destroying it. */
+    static std::atomic<uint32_t> nActive(0);
+
+
+    /* Mutex and condition to wake up Shutdown once our last caller is done. */
+    static std::mutex ACTIVE_MUTEX;
+    static std::condition_variable ACTIVE_CONDITION;
+
+
+    /* Counts a caller as using our instance for as long as it is in scope. */
+    class ActiveLock
+    {
+        /* Flag to track if we are still counted. */
+        bool fActive;
+
+    public:
+
+        ActiveLock()
+        : fActive (true)
+        {
+            ++nActive;
+        }
+
+        ~ActiveLock()
+        {
+            Release();
+        }
+
+        /* Stop counting this caller, for callers that won't use our instance. */
+        void Release()
+        {
+            if(!fActive)
+                return;
+
+            fActive = false;
+
+            /* Wake up Shutdown when our last caller is done. */
+            if(--nActive == 0)
+            {
+                std::unique_lock<std::mutex> lock(ACTIVE_MUTEX);
+                ACTIVE_CONDITION.notify_all();
+            }
+        }
+    };
+
+
+    /* Internal batch of transactions shared between threads. */
+    struct Verifier::Batch
+    {
+        /** The transactions to verify. **/
+        const std::vector<const Transaction*> vtx;
+
+        /** The index of the next transaction to claim. **/
+        std::atomic<uint32_t> nNext;
+
+        /** The total transactions not yet verified. **/
+        std::atomic<uint32_t> nRemaining;
+
+        /** The total transactions that passed verification. **/
+        std::atomic<uint32_t> nValid;
+
+        /** Mutex and condition to wake up the calling thread once all are verified. **/
+        std::mutex MUTEX;
+        std::condition_variable CONDITION;
+
+        /** Batch Constructor. **/
+        Batch(const std::vector<const Transaction*>& vtxIn)
+        : vtx        (vtxIn)
+        , nNext      (0)
+        , nRemaining (static_cast<uint32_t>(vtxIn.size()))
+        , nValid     (0)
+        , MUTEX      ( )
+        , CONDITION  ( )
+        {
+        }
+    };
+
+
+    /* Default Constructor. */
+    Verifier::Verifier()
+    : BATCH_QUEUE    ( )
+    , QUEUE_MUTEX    ( )
+    , CONDITION      ( )
+    , VERIFY_THREADS ( )
+    , fStop          (false)
+    {
+        /* Leave a core for the thread that is processing blocks, it verifies its share of each batch. */
+        const uint32_t nCores   = std::max(2u, std::thread::hardware_concurrency());
+        const uint32_t nThreads = config::GetArg("-verifythreads", nCores - 1);
+
+        /* Start our worker threads. */
+        for(uint32_t n = 0; n < nThreads; ++n)
+            VERIFY_THREADS.push_back(std::thread(std::bind(&Verifier::Worker, this)));
+
+        debug::log(0, FUNCTION, "Started ", nThreads, " signature verification threads");
+    }
+
+
+    /* Default destructor. */
+    Verifier::~Verifier()
+    {
+        /* Tell our worker threads to stop. */
+        {
+            std::unique_lock<std::mutex> lock(QUEUE_MUTEX);
+            fStop.store(true);
+        }
+        CONDITION.notify_all();
+
+        /* Cleanup our worker threads. */
+        for(auto& thread : VERIFY_THREADS)
+            if(thread.joinable())
+                thread.join();
+    }
+
+
+    /* Verify the signatures of a batch of transactions in parallel. */
+    uint32_t Verifier::Verify(const std::vector<const Transaction*>& vtx)
+    {
+        /* Count ourselves before getting our instance, so a concurrent Shutdown waits for us to finish with it. */
+        ActiveLock lockActive;
+
+        /* Verify on this thread if there is nothing to split, or no workers to split with. */
+        Verifier* pverifier = INSTANCE.load();
+        if(vtx.size() < 2 || !pverifier || pverifier->VERIFY_THREADS.empty())
+        {
+            /* We won't use our instance, so don't hold up Shutdown. */
+            lockActive.Release();
+
+            uint32_t nValid = 0;
+            for(const auto& ptx : vtx)
+                if(ptx->VerifySignature())
+                    ++nValid;
+
+            return nValid;
+        }
+
+        /* Hand our batch to as many workers as can take a share of it. */
+        std::shared_ptr<Batch> pbatch = std::make_shared<Batch>(vtx);
+        {
+            std::unique_lock<std::mutex> lock(pverifier->QUEUE_MUTEX);
+
+            const uint32_t nWorkers = std::min(pverifier->VERIFY_THREADS.size(), vtx.size() - 1);
+            for(uint32_t n = 0; n < nWorkers; ++n)
+                pverifier->BATCH_QUEUE.push(pbatch);
+        }
+        pverifier->CONDITION.notify_all();
+
+        /* Take our own share of the batch. */
+        process(pbatch);
+
+        /* Wait for the workers to finish the transactions they claimed. */
+        std::unique_lock<std::mutex> lock(pbatch->MUTEX);
+        pbatch->CONDITION.wait(lock, [pbatch]{ return pbatch->nRemaining.load() == 0; });
+
+        return pbatch->nValid.load();
+    }
+
+
+    /* Stop our worker threads and destroy our instance, once no batches are being verified. */
+    void Verifier::Shutdown()
+    {
+        /* Take our instance away from new callers, who verify on their own thread from now on. */
+        Verifier* pverifier = INSTANCE.exchange(nullptr);
+        if(!pverifier)
+            return;
+
+        /* Wait for the callers that are still using it. */
+        {
+            std::unique_lock<std::mutex> lock(ACTIVE_MUTEX);
+            ACTIVE_CONDITION.wait(lock, []{ return nActive.load() == 0; });
+        }
+
+        delete pverifier;
+    }
+
+
+    /* Check the cache of verified signatures. */
+    bool Verifier::Cached(const uint512_t& hashTx, const uint256_t& hashKeys)
+    {
+        LOCK(CACHE_MUTEX);
+        return setCache.count(std::make_pair(hashTx, hashKeys)) > 0;
+    }
+
+
+    /* Add a verified signature to the cache, removing the oldest entry when full. */
+    void Verifier::Cache(const uint512_t& hashTx, const uint256_t& hashKeys)
+    {
+        /* Get our maximum entries once arguments are loaded, zero disables the cache. */
+        static const uint64_t nMaxSize = config::GetArg("-sigcachesize", 50000);
+        if(nMaxSize == 0)
+            return;
+
+        LOCK(CACHE_MUTEX);
+
+        /* Set our size on first use. */
+        if(setCache.max_size() != nMaxSize)
+            setCache.max_size(nMaxSize);
+
+        setCache.insert(std::make_pair(hashTx, hashKeys));
+    }
+
+
+    /* Handle verification of batches pushed by Verify. */
+    void Verifier::Worker()
+    {
+        while(true)
+        {
+            /* Wait for batches in the queue. */
+            std::shared_ptr<Batch> pbatch;
+            {
+                std::unique_lock<std::mutex> lock(QUEUE_MUTEX);
+                CONDITION.wait(lock, [this]{ return fStop.load() || !BATCH_QUEUE.empty(); });
+
+                /* Check for shutdown. */
+                if(fStop.load())
+                    return;
+
+                /* Grab the next batch in the queue. */
+                pbatch = BATCH_QUEUE.front();
+                BATCH_QUEUE.pop();
+            }
+
+            process(pbatch);
+        }
+    }
+
+
+    /* Verify transactions from a batch until none are left unclaimed. */
+    void Verifier::process(const std::shared_ptr<Batch>& pbatch)
+    {
+        const uint32_t nSize = static_cast<uint32_t>(pbatch->vtx.size());
+        while(true)
+        {
+            /* Claim our next transaction. */
+            const uint32_t nIndex = pbatch->nNext.fetch_add(1);
+            if(nIndex >= nSize)
+                return;
+
+            /* Verify the signature. */
+            if(pbatch->vtx[nIndex]->VerifySignature())
+                ++pbatch->nValid;
+
+            /* Wake up the calling thread when the last transaction is done. */
+            if(--pbatch->nRemaining == 0)
+            {
+                std::unique_lock<std::mutex> lock(pbatch->MUTEX);
+                pbatch->CONDITION.notify_all();
+            }
+        }
+    }
+}
@@ -17,6 +17,8 @@ ________________________________________________________________________________
 
 #include <TAO/Ledger/include/timelocks.h>
 
+#include <algorithm>
+
 
 /* Global TAO namespace. */
 namespace TAO
@@ -30,7 +32,9 @@ namespace TAO
         Object::Object()
         : State     (uint8_t(REGISTER::OBJECT))
         , vchSystem (512, 0) //system memory by default is 512 bytes
-        , mapData   ()
+        , vFields   ()
+        , nParsePos (0)
+        , fParsed   (false)
         {
         }
 
@@ -39,7 +43,9 @@ namespace TAO
         Object::Object(const Object& object)
         : State     (object)
         , vchSystem (object.vchSystem)
-        , mapData   (object.mapData)
+        , vFields   (object.vFields)
+        , nParsePos (object.nParsePos)
+        , fParsed   (object.fParsed)
         {
         }
 
@@ -48,7 +54,9 @@ namespace TAO
         Object::Object(Object&& object) noexcept
         : State     (std::move(object))
         , vchSystem (std::move(object.vchSystem))
-        , mapData   (std::move(object.mapData))
+        , vFields   (std::move(object.vFields))
+        , nParsePos (object.nParsePos)
+        , fParsed   (object.fParsed)
         {
         }
 
@@ -66,7 +74,9 @@ namespace TAO
             hashChecksum = object.hashChecksum;
 
             nReadPos     = 0; //don't copy over read position
-            mapData      = object.mapData;
+            vFields      = object.vFields;
+            nParsePos    = object.nParsePos;
+            fParsed      = object.fParsed;
 
             return *this;
         }
@@ -85,7 +95,9 @@ namespace TAO
             hashChecksum = std::move(object.hashChecksum);
 
             nReadPos     = 0; //don't copy over read position
-            mapData      = std::move(object.mapData);
+            vFields      = std::move(object.vFields);
+            nParsePos    = object.nParsePos;
+            fParsed      = object.fParsed;
 
             return *this;
         }
@@ -101,7 +113,9 @@ namespace TAO
         Object::Object(const State& state)
         : State     (state)
         , vchSystem ()
-        , mapData   ()
+        , vFields   ()
+        , nParsePos (0)
+        , fParsed   (false)
         {
         }
 
@@ -117,8 +131,11 @@ namespace TAO
             uint8_t nStandard =
                 OBJECTS::NONSTANDARD;
 
+            /* Finish parsing if we were parsing on demand, since we need the total data members. */
+            while(!vFields.empty() && parse_next());
+
             /* Search object register for key types. */
-            if(mapData.size() == 1
+            if(vFields.size() == 1
             && Check("namespace", TYPES::STRING, false))
             {
                 /* If it only contains one field called namespace then it must be a namespace */
@@ -126,7 +143,7 @@ namespace TAO
                 nStandard = OBJECTS::NAMESPACE;
 
             }
-            else if(mapData.size() == 9
+            else if(vFields.size() == 9
             && Check("auth",    TYPES::UINT256_T, true)
             && Check("lisp",    TYPES::UINT256_T, true)
             && Check("network", TYPES::UINT256_T, true)
@@ -140,7 +157,7 @@ namespace TAO
                 /* Set the return value. */
                 nStandard = OBJECTS::CRYPTO;
             }
-            else if(mapData.size() == 3
+            else if(vFields.size() == 3
             && Check("namespace", TYPES::STRING, false)
             && Check("name",      TYPES::STRING, false)
             && Check("address")) /* Name registers can store different types in the address so don't check the field type */
@@ -205,8 +222,8 @@ namespace TAO
         /* Get the cost to create this object register.*/
         uint64_t Object::Cost() const
         {
-            /* Check the map for empty. */
-            if(mapData.empty())
+            /* Check the index for empty. */
+            if(vFields.empty())
                 throw debug::exception(FUNCTION, "cannot get cost when object isn't parsed");
 
             /* Switch based on standard types. */
@@ -279,183 +296,195 @@ namespace TAO
             && this->nType != REGISTER::SYSTEM)
                 return debug::error(FUNCTION, "register has invalid type ", std::hex, uint32_t(this->nType));
 
-            /* Check the map for empty. */
-            if(!mapData.empty())
+            /* Check the index for empty. */
+            if(!vFields.empty())
                 return false;
 
-            /* Reset the read position. */
-            nReadPos   = 0;
+            /* Reset the parse position. */
+            nParsePos = 0;
+            fParsed   = false;
 
             /* Read until end of state. */
-            while(!end())
-            {
-                /* Deserialize the named value. */
-                std::string strName;
-                *this >> strName;
-
-                /* Disallow duplicate value entries. */
-                if(mapData.count(strName))
-                    return debug::error(FUNCTION, "duplicate value entries");
-
-                /* Deserialize the type. */
-                uint8_t nCode;
-                *this >> nCode;
-
-                /* Mutable default: false (read only). */
-                bool fMutable = false;
-
-                /* Check for mutable specifier. */
-                if(nCode == TYPES::MUTABLE)
-                {
-                    /* Set this type to be mutable. */
-                    fMutable = true;
-
-                    /* If mutable found, deserialize the type. */
-                    *this >> nCode;
-                }
-
-                /* Switch between supported types. */
-                switch(nCode)
-                {
-
-                    /* Standard type for C++ uint8_t. */
-                    case TYPES::UINT8_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
-
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 2;
-
-                        break;
-                    }
-
-
-                    /* Standard type for C++ uint16_t. */
-                    case TYPES::UINT16_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
-
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 3;
+            while(parse_next());
 
-                        break;
-                    }
+            return fParsed;
+        }
 
 
-                    /* Standard type for C++ uint32_t. */
-                    case TYPES::UINT32_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+        /* Clear the parsed data members, so they are parsed again on next use. */
+        void Object::Reset() const
+        {
+            vFields.clear();
 
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 5;
+            nParsePos = 0;
+            fParsed   = false;
+        }
 
-                        break;
-                    }
 
+        /* Parse the next data member into our index, from where parsing was left off. */
+        bool Object::parse_next() const
+        {
+            /* Check if we have parsed all data members already. */
+            if(fParsed)
+                return false;
 
-                    /* Standard type for C++ uint64_t. */
-                    case TYPES::UINT64_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+            /* Ensure that object register is of proper type. */
+            if(this->nType != REGISTER::OBJECT
+            && this->nType != REGISTER::SYSTEM)
+                return debug::error(FUNCTION, "register has invalid type ", std::hex, uint32_t(this->nType));
 
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 9;
+            /* Resume reading where we left off. */
+            nReadPos = nParsePos;
 
-                        break;
-                    }
+            /* Check for the end of state. */
+            if(end())
+            {
+                fParsed = true;
+                return false;
+            }
 
+            /* Find the size of the named value, which we compare in place rather than deserialize. */
+            const uint64_t nLength =
+                ReadCompactSize(*this);
 
-                    /* Standard type for Custom uint256_t */
-                    case TYPES::UINT256_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+            /* Check size constraints. */
+            if(nReadPos + nLength > vchState.size())
+                throw std::runtime_error(debug::safe_printstr(FUNCTION, "reached end of stream ", nReadPos));
 
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 33;
+            /* Build our index entry from the name. */
+            Field tField;
+            tField.nName    = static_cast<uint16_t>(nReadPos);
+            tField.nLength  = static_cast<uint16_t>(nLength);
+            tField.fMutable = false; //mutable default: false (read only)
 
-                        break;
-                    }
+            /* Disallow duplicate value entries. */
+            for(const auto& rField : vFields)
+            {
+                /* Check the length before comparing the bytes. */
+                if(rField.nLength == nLength
+                && std::equal(vchState.begin() + rField.nName, vchState.begin() + rField.nName + nLength, vchState.begin() + nReadPos))
+                    return debug::error(FUNCTION, "duplicate value entries");
+            }
 
+            /* Iterate past the name. */
+            nReadPos += nLength;
 
-                    /* Standard type for Custom uint512_t */
-                    case TYPES::UINT512_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+            /* Deserialize the type. */
+            uint8_t nCode;
+            *this >> nCode;
 
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 65;
+            /* Check for mutable specifier. */
+            if(nCode == TYPES::MUTABLE)
+            {
+                /* Set this type to be mutable. */
+                tField.fMutable = true;
 
-                        break;
-                    }
+                /* If mutable found, deserialize the type. */
+                *this >> nCode;
+            }
 
+            /* Track the binary position of type. */
+            tField.nPos = static_cast<uint16_t>(nReadPos - 1);
 
-                    /* Standard type for Custom uint1024_t */
-                    case TYPES::UINT1024_T:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+            /* Switch between supported types to iterate past the value. */
+            switch(nCode)
+            {
+                /* Standard type for C++ uint8_t. */
+                case TYPES::UINT8_T:
+                    nReadPos += 1;
+                    break;
 
-                        /* Iterate the types size plus type byte. */
-                        nReadPos += 129;
+                /* Standard type for C++ uint16_t. */
+                case TYPES::UINT16_T:
+                    nReadPos += 2;
+                    break;
 
-                        break;
-                    }
+                /* Standard type for C++ uint32_t. */
+                case TYPES::UINT32_T:
+                    nReadPos += 4;
+                    break;
 
+                /* Standard type for C++ uint64_t. */
+                case TYPES::UINT64_T:
+                    nReadPos += 8;
+                    break;
 
-                    /* Standard type for STL string */
-                    case TYPES::STRING:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+                /* Standard type for Custom uint256_t */
+                case TYPES::UINT256_T:
+                    nReadPos += 32;
+                    break;
 
-                        /* Iterate to start of size. */
-                        ++nReadPos;
+                /* Standard type for Custom uint512_t */
+                case TYPES::UINT512_T:
+                    nReadPos += 64;
+                    break;
 
-                        /* Find the serialized size of type. */
-                        const uint64_t nSize =
-                            ReadCompactSize(*this);
+                /* Standard type for Custom uint1024_t */
+                case TYPES::UINT1024_T:
+                    nReadPos += 128;
+                    break;
 
-                        /* Iterate the type size */
-                        nReadPos += nSize;
+                /* Standard type for STL string, or STL vector with C++ type uint8_t */
+                case TYPES::STRING:
+                case TYPES::BYTES:
+                {
+                    /* Find the serialized size of type. */
+                    const uint64_t nSize =
+                        ReadCompactSize(*this);
 
-                        break;
-                    }
+                    /* Iterate the type size */
+                    nReadPos += nSize;
 
+                    break;
+                }
 
-                    /* Standard type for STL vector with C++ type uint8_t */
-                    case TYPES::BYTES:
-                    {
-                        /* Track the binary position of type. */
-                        mapData.emplace(strName, std::make_pair(--nReadPos, fMutable));
+                /* Fail if types are unknown. */
+                default:
+                    return debug::error(FUNCTION, "malformed object register (unexpected instruction ", uint32_t(nCode), ")");
+            }
 
-                        /* Iterate to start of size. */
-                        ++nReadPos;
+            /* Add to our index and save where to resume from. */
+            vFields.push_back(tField);
+            nParsePos = nReadPos;
 
-                        /* Find the serialized size of type. */
-                        const uint64_t nSize =
-                            ReadCompactSize(*this);
+            return true;
+        }
 
-                        /* Iterate the type size */
-                        nReadPos += nSize;
 
-                        break;
-                    }
+        /* Find a data member in our index, parsing more of the object if it was parsed on demand. */
+        bool Object::find(const std::string& strName, const Field* &pField, const bool fParse) const
+        {
+            /* Search the data members we have parsed so far. */
+            const uint64_t nLength = strName.size();
+            for(const auto& rField : vFields)
+            {
+                /* Check the length before comparing the bytes. */
+                if(rField.nLength == nLength
+                && std::equal(strName.begin(), strName.end(), (const char*)vchState.data() + rField.nName))
+                {
+                    pField = &rField;
+                    return true;
+                }
+            }
 
+            /* Check that we are able to parse any more of the object. */
+            if(fParsed || (vFields.empty() && !fParse))
+                return false;
 
-                    /* Fail if types are unknown. */
-                    default:
-                        return debug::error(FUNCTION, "malformed object register (unexpected instruction ", uint32_t(nCode), ")");
+            /* Parse on demand until we find the data member. */
+            while(parse_next())
+            {
+                /* Check the data member we just parsed. */
+                const Field& rField = vFields.back();
+                if(rField.nLength == nLength
+                && std::equal(strName.begin(), strName.end(), (const char*)vchState.data() + rField.nName))
+                {
+                    pField = &rField;
+                    return true;
                 }
             }
 
-            return true;
+            return false;
         }
 
 
@@ -465,13 +494,20 @@ namespace TAO
             /* Declare the vector of field names to return */
             std::vector<std::string> vFieldNames;
 
-            /* Check the map for empty. */
-            if(mapData.empty()) //TODO: this should either throw, or this method should return by reference
+            /* Check the index for empty. */
+            if(vFields.empty()) //TODO: this should either throw, or this method should return by reference
                 throw debug::exception(FUNCTION, "object is not parsed");
 
-            /* Iterate data map and pull field names out into return vector */
-            for(const auto& fieldName : mapData)
-                vFieldNames.push_back(fieldName.first);
+            /* Finish parsing if we were parsing on demand. */
+            while(parse_next());
+
+            /* Iterate data index and pull field names out of our state into return vector */
+            vFieldNames.reserve(vFields.size());
+            for(const auto& rField : vFields)
+                vFieldNames.emplace_back(vchState.begin() + rField.nName, vchState.begin() + rField.nName + rField.nLength);
+
+            /* Keep the names in sorted order. */
+            std::sort(vFieldNames.begin(), vFieldNames.end());
 
             return vFieldNames;
         }
@@ -484,16 +520,13 @@ namespace TAO
             if(this->nType != TAO::Register::REGISTER::OBJECT)
                 return false;
 
-            /* Check the map for empty. */
-            if(mapData.empty())
-                return false;
-
             /* Check that the name exists in the object. */
-            if(!mapData.count(strName))
+            const Field* pField = nullptr;
+            if(!find(strName, pField))
                 return false;
 
             /* Find the binary position of value. */
-            nReadPos = mapData[strName].first;
+            nReadPos = pField->nPos;
 
             /* Deserialize the type specifier. */
             *this >> nType;
@@ -513,16 +546,13 @@ namespace TAO
             if(this->nType != TAO::Register::REGISTER::OBJECT)
                 return false;
 
-            /* Check the map for empty. */
-            if(mapData.empty())
-                return false;
-
             /* Check that the name exists in the object. */
-            if(!mapData.count(strName))
+            const Field* pField = nullptr;
+            if(!find(strName, pField))
                 return false;
 
             /* Find the binary position of value. */
-            nReadPos = mapData[strName].first;
+            nReadPos = pField->nPos;
 
             /* Deserialize the type specifier. */
             uint8_t nCheck;
@@ -532,7 +562,7 @@ namespace TAO
             if(nType != nCheck)
                 return false;
 
-            return (fMutable == mapData[strName].second);
+            return (fMutable == pField->fMutable);
         }
 
 
@@ -543,12 +573,9 @@ namespace TAO
             if(this->nType != TAO::Register::REGISTER::OBJECT)
                 return false;
 
-            /* Check the map for empty. */
-            if(mapData.empty())
-                return false;
-
             /* Check that the name exists in the object. */
-            return mapData.count(strName) > 0;
+            const Field* pField = nullptr;
+            return find(strName, pField);
         }
 
 
@@ -559,10 +586,6 @@ namespace TAO
             if(this->nType != TAO::Register::REGISTER::OBJECT)
                 return false;
 
-            /* Check the map for empty. */
-            if(mapData.empty())
-                return false;
-
             /* Get the type for given name. */
             uint8_t nType;
             if(!Type(strName, nType))
@@ -616,20 +639,21 @@ namespace TAO
         /* Write into the object register a value of type bytes. */
         bool Object::Write(const std::string& strName, const std::string& strValue)
         {
-            /* Check the map for empty. */
-            if(mapData.empty())
+            /* Check the index for empty. */
+            if(vFields.empty())
                 return debug::error(FUNCTION, "object is not parsed");
 
             /* Check that the name exists in the object. */
-            if(!mapData.count(strName))
+            const Field* pField = nullptr;
+            if(!find(strName, pField))
                 return false;
 
             /* Check that the value is mutable (writes allowed). */
-            if(!mapData[strName].second)
+            if(!pField->fMutable)
                 return debug::error(FUNCTION, "cannot set value for READONLY data member");
 
             /* Find the binary position of value. */
-            nReadPos = mapData[strName].first;
+            nReadPos = pField->nPos;
 
             /* Deserialize the type specifier. */
             uint8_t nType;
@@ -658,20 +682,21 @@ namespace TAO
         /* Write into the object register a value of type bytes. */
         bool Object::Write(const std::string& strName, const std::vector<uint8_t>& vData)
         {
-            /* Check the map for empty. */
-            if(mapData.empty())
+            /* Check the index for empty. */
+            if(vFields.empty())
                 return debug::error(FUNCTION, "object is not parsed");
 
             /* Check that the name exists in the object. */
-            if(!mapData.count(strName))
+            const Field* pField = nullptr;
+            if(!find(strName, pField))
                 return false;
 
             /* Check that the value is mutable (writes allowed). */
-            if(!mapData[strName].second)
+            if(!pField->fMutable)
                 return debug::error(FUNCTION, "cannot set value for READONLY data member");
 
             /* Find the binary position of value. */
-            nReadPos = mapData[strName].first;
+            nReadPos = pField->nPos;
 
             /* Deserialize the type specifier. */
             uint8_t nType;
@@ -36,10 +36,40 @@ namespace TAO
             /** Special system level memory for managing system states in protected portion of memory **/
             std::vector<uint8_t> vchSystem;
 
-        public:
 
-            /** Internal map for managing object data members and their binary positions. **/
-            mutable std::map< std::string, std::pair<uint16_t, bool> > mapData; //internal map for data members
+            /** Field
+             *
+             *  Binary position of a data member, found by comparing its name in place in the object's state.
+             *
+             **/
+            struct Field
+            {
+                /** Binary position of the name of this data member. **/
+                uint16_t nName;
+
+                /** Length of the name of this data member. **/
+                uint16_t nLength;
+
+                /** Binary position of the type specifier of this data member. **/
+                uint16_t nPos;
+
+                /** Flag to track if this data member is mutable. **/
+                bool fMutable;
+            };
+
+
+            /** Flat index of the data members parsed so far, in the order they were serialized. **/
+            mutable std::vector<Field> vFields;
+
+
+            /** Binary position to resume parsing data members from when they are read on demand. **/
+            mutable uint32_t nParsePos;
+
+
+            /** Flag to track if all data members have been parsed. **/
+            mutable bool fParsed;
+
+        public:
 
 
             /** Default constructor. **/
@@ -117,6 +147,14 @@ namespace TAO
             bool Parse() const;
 
 
+            /** Reset
+             *
+             *  Clear the parsed data members, so they are parsed again on next use.
+             *
+             **/
+            void Reset() const;
+
+
             /** Members
              *
              *  Get a list of variable names for this Object.
@@ -190,16 +228,13 @@ namespace TAO
             template<typename Type>
             bool Read(const std::string& strName, Type& value) const
             {
-                /* Check the map for empty. */
-                if(mapData.empty() && !Parse())
-                    return debug::error(FUNCTION, "object failed to parse");
-
-                /* Check that the name exists in the object. */
-                if(!mapData.count(strName))
+                /* Parse on demand up to the field we need if not parsed. */
+                const Field* pField = nullptr;
+                if(!find(strName, pField, true))
                     return false;
 
                 /* Find the binary position of value. */
-                nReadPos = mapData[strName].first;
+                nReadPos = pField->nPos;
 
                 /* Deserialize the type specifier. */
                 uint8_t nType;
@@ -234,15 +269,16 @@ namespace TAO
             bool Write(const std::string& strName, const Type& value)
             {
                 /* Check that the name exists in the object. */
-                if(!mapData.count(strName))
+                const Field* pField = nullptr;
+                if(!find(strName, pField))
                     return false;
 
                 /* Check that the value is mutable (writes allowed). */
-                if(!mapData[strName].second)
+                if(!pField->fMutable)
                     return debug::error(FUNCTION, "cannot set value for READONLY data member");
 
                 /* Find the binary position of value. */
-                nReadPos = mapData[strName].first;
+                nReadPos = pField->nPos;
 
                 /* Deserialize the type specifier. */
                 uint8_t nType;
@@ -342,6 +378,30 @@ namespace TAO
 
         private:
 
+            /** parse_next
+             *
+             *  Parse the next data member into our index, from where parsing was left off.
+             *
+             *  @return True if a data member was parsed, false at the end of the object or if it is malformed.
+             *
+             **/
+            bool parse_next() const;
+
+
+            /** find
+             *
+             *  Find a data member in our index, parsing more of the object if it was parsed on demand.
+             *
+             *  @param[in] strName The name of the data member to find.
+             *  @param[out] pField The data member that was found.
+             *  @param[in] fParse Start parsing on demand if the object has not been parsed yet.
+             *
+             *  @return True if the data member was found.
+             *
+             **/
+            bool find(const std::string& strName, const Field* &pField, const bool fParse = false) const;
+
+
             /** type
              *
              *  Helper function that uses template deduction to find type enum.
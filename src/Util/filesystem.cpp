@@ -237,6 +237,30 @@ namespace filesystem
         return true;
     }
 
+
+    /* Synchronize a file's written data with the disk. */
+    bool sync(const std::string& strPath)
+    {
+    #ifdef WIN32
+        HANDLE hFile = CreateFileA(strPath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(hFile == INVALID_HANDLE_VALUE)
+            return false;
+
+        const bool fSynced = FlushFileBuffers(hFile);
+        CloseHandle(hFile);
+    #else
+        const int nFile = open(strPath.c_str(), O_RDWR);
+        if(nFile < 0)
+            return false;
+
+        const bool fSynced = (fsync(nFile) == 0);
+        close(nFile);
+    #endif
+
+        return fSynced;
+    }
+
     /* Determines if the specified strPath is a folder. */
     bool is_directory(const std::string& strPath)
     {
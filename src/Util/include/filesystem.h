@@ -102,6 +102,19 @@ namespace filesystem
     bool copy_file(const std::string& strPathSource, const std::string& strPathDest);
 
 
+    /** sync
+     *
+     *  Synchronize a file's written data with the disk.
+     *  Any buffered stream writing to the file must be flushed first.
+     *
+     *  @param[in] strPath The path of the file to synchronize.
+     *
+     *  @return Returns true if the file was synchronized, false otherwise.
+     *
+     **/
+    bool sync(const std::string& strPath);
+
+
     /** set_permissions
      *
      *  Determines if the file or folder from the specified path exists.
@@ -62,6 +62,19 @@ public:
     DataStream(const std::vector<uint8_t>& vchDataIn, const uint32_t nSerTypeIn, const uint32_t nSerVersionIn);
 
 
+    /** DataStream
+     *
+     *  Constructs the DataStream object, taking the byte vector without copying it.
+     *  The buffer can be taken back out with Bytes() once the stream is finished with.
+     *
+     *  @param[in] vchDataIn The byte vector to take.
+     *  @param[in] nSerTypeIn The serialize type.
+     *  @param[in] nSerVersionIn The serialize version.
+     *
+     **/
+    DataStream(std::vector<uint8_t>&& vchDataIn, const uint32_t nSerTypeIn, const uint32_t nSerVersionIn);
+
+
     /** DataStream
      *
      *  Constructs the DataStream object.
@@ -26,6 +26,8 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/create.h>
 #include <TAO/Ledger/include/chainstate.h>
 #include <TAO/Ledger/include/dispatch.h>
+#include <TAO/Ledger/include/verifier.h>
+#include <TAO/Ledger/types/credentials.h>
 #include <TAO/Ledger/types/stake_minter.h>
 #include <TAO/Ledger/include/timelocks.h>
 
@@ -204,6 +206,10 @@ int main(int argc, char** argv)
         TAO::Ledger::Dispatch::Initialize();
 
 
+        /* Initialize signature verification threads. */
+        TAO::Ledger::Verifier::Initialize();
+
+
         /* Initialize ChainState. */
         TAO::Ledger::ChainState::Initialize();
 
@@ -277,6 +283,10 @@ int main(int argc, char** argv)
 
         /* Shutdown dispatch. */
         TAO::Ledger::Dispatch::Shutdown();
+
+
+        /* Shutdown signature verification threads. */
+        TAO::Ledger::Verifier::Shutdown();
     }
 
 
@@ -292,6 +302,10 @@ int main(int argc, char** argv)
     TAO::API::Shutdown();
 
 
+    /* Stop deriving sigchain keys in the background. */
+    TAO::Ledger::Credentials::Shutdown();
+
+
     /* Shutdown network subsystem. */
     LLP::Shutdown();
 
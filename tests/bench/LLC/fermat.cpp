@@ -0,0 +1,89 @@
+#include <Util/include/runtime.h>
+#include <Util/include/debug.h>
+
+#include <LLC/include/random.h>
+#include <LLC/include/fermat.h>
+#include <LLC/types/bignum.h>
+
+#include <openssl/bn.h>
+
+#include <unit/catch2/catch.hpp>
+
+
+TEST_CASE( "Fermat Test Benchmarks", "[LLC]")
+{
+    debug::log(0, "===== Begin Fermat Test Benchmarks =====");
+    debug::log(0, "IFMA kernels ", LLC::SupportsIFMA() ? "enabled" : "disabled");
+
+    //build our numbers, below 2^1023 like prime origins
+    std::vector<uint1024_t> vNumbers;
+    for(int i = 0; i < 1000; ++i)
+    {
+        uint1024_t hashTest = LLC::GetRand1024() >> 1;
+        hashTest |= 1;
+
+        vNumbers.push_back(hashTest);
+    }
+
+    //big number library
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(const auto& hashTest : vNumbers)
+        {
+            LLC::CAutoBN_CTX pctx;
+
+            LLC::CBigNum bnPrime(hashTest);
+            LLC::CBigNum bnBase(2);
+            LLC::CBigNum bnExp = bnPrime - 1;
+
+            LLC::CBigNum bnResult;
+            BN_mod_exp(bnResult.getBN(), bnBase.getBN(), bnExp.getBN(), bnPrime.getBN(), pctx);
+        }
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "BN_mod_exp::", ANSI_COLOR_RESET, vNumbers.size() * 1000000.0 / nTime, " tests / second");
+    }
+
+    //one at a time
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(const auto& hashTest : vNumbers)
+            LLC::FermatTest(hashTest);
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "FermatTest::", ANSI_COLOR_RESET, vNumbers.size() * 1000000.0 / nTime, " tests / second");
+    }
+
+    //all in one batch
+    {
+        std::vector<uint1024_t> vRemainders(vNumbers.size());
+
+        runtime::timer timer;
+        timer.Start();
+
+        LLC::FermatTest(&vNumbers[0], vNumbers.size(), &vRemainders[0]);
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "FermatTest(batch)::", ANSI_COLOR_RESET, vNumbers.size() * 1000000.0 / nTime, " tests / second");
+    }
+
+    //prime cluster of ten offsets
+    {
+        const uint8_t nOffsets[10] = { 2, 4, 2, 4, 6, 2, 6, 4, 2, 4 };
+
+        runtime::timer timer;
+        timer.Start();
+
+        for(const auto& hashTest : vNumbers)
+            LLC::FermatCluster(hashTest, nOffsets, 10);
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "FermatCluster::", ANSI_COLOR_RESET, vNumbers.size() * 1000000.0 / nTime, " clusters / second");
+    }
+
+    debug::log(0, "===== End Fermat Test Benchmarks =====\n");
+}
@@ -0,0 +1,79 @@
+#include <Util/include/runtime.h>
+#include <Util/include/debug.h>
+
+#include <LLC/include/random.h>
+#include <LLC/hash/SK.h>
+
+#include <TAO/Ledger/types/block.h>
+
+#include <unit/catch2/catch.hpp>
+
+
+TEST_CASE( "SK Hashing Benchmarks", "[LLC]")
+{
+    debug::log(0, "===== Begin SK Hashing Benchmarks =====");
+    debug::log(0, "AVX2 kernels ", LLC::SupportsAVX2() ? "enabled" : "disabled");
+
+    //build our messages, the size of a merkle node pair
+    std::vector<uint8_t> vData(128 * 4);
+    for(auto& nByte : vData)
+        nByte = static_cast<uint8_t>(LLC::GetRand());
+
+    const uint8_t* pData[4] = { &vData[0], &vData[128], &vData[256], &vData[384] };
+
+    //check the multi-buffer hashes match one at a time
+    {
+        uint512_t vHashes[4];
+        LLC::SK512x4(pData, 128, vHashes);
+
+        for(uint32_t n = 0; n < 4; ++n)
+            REQUIRE(vHashes[n] == LLC::SK512(pData[n], pData[n] + 64, pData[n] + 64, pData[n] + 128));
+    }
+
+    //one at a time
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        uint512_t hash;
+        for(int i = 0; i < 1000000; i += 4)
+            for(uint32_t n = 0; n < 4; ++n)
+                hash = LLC::SK512(pData[n], pData[n] + 64, pData[n] + 64, pData[n] + 128);
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "SK512::", ANSI_COLOR_RESET, 1000000.0 / nTime, " million hashes / second");
+    }
+
+    //four at a time
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        uint512_t vHashes[4];
+        for(int i = 0; i < 1000000; i += 4)
+            LLC::SK512x4(pData, 128, vHashes);
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "SK512x4::", ANSI_COLOR_RESET, 1000000.0 / nTime, " million hashes / second");
+    }
+
+    //merkle tree of a full block
+    {
+        std::vector<uint512_t> vtx;
+        for(int i = 0; i < 4096; ++i)
+            vtx.push_back(LLC::GetRand512());
+
+        TAO::Ledger::Block block;
+
+        runtime::timer timer;
+        timer.Start();
+
+        for(int i = 0; i < 100; ++i)
+            block.BuildMerkleTree(vtx);
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "BuildMerkleTree::", ANSI_COLOR_RESET, nTime / 100.0, " microseconds for 4096 transactions");
+    }
+
+    debug::log(0, "===== End SK Hashing Benchmarks =====\n");
+}
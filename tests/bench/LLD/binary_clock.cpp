@@ -0,0 +1,97 @@
+#include <Util/include/runtime.h>
+
+#include <LLC/include/random.h>
+
+#include <LLD/cache/binary_clock.h>
+#include <LLD/templates/key.h>
+
+#include <LLD/include/version.h>
+
+#include <Util/templates/datastream.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <thread>
+
+
+TEST_CASE( "Binary CLOCK Benchmarks", "[LLD]")
+{
+    debug::log(0, "===== Begin Binary CLOCK Benchmarks =====");
+
+    //benchmarks
+    LLD::BinaryCLOCK* cache = new LLD::BinaryCLOCK(1024 * 1024 * 256);
+    uint256_t hash = LLC::GetRand256();
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(int i = 0; i < 1000000; i++)
+        {
+            DataStream ssKey(SER_LLD, LLD::DATABASE_VERSION);
+            ssKey << std::make_pair(std::string("data"), hash + i);
+
+            DataStream ssData(SER_LLD, LLD::DATABASE_VERSION);
+            ssData << uint1024_t(4934943);
+
+            cache->Put(LLD::SectorKey(), ssKey.Bytes(), ssData.Bytes());
+        }
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Put::", ANSI_COLOR_RESET, 1000000.0 / nTime, " million records / second");
+    }
+
+
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(int i = 0; i < 1000000; i++)
+        {
+            DataStream ssKey(SER_LLD, LLD::DATABASE_VERSION);
+            ssKey << std::make_pair(std::string("data"), hash + i);
+
+            std::vector<uint8_t> vBytes;
+
+            cache->Get(ssKey.Bytes(), vBytes);
+        }
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Get::", ANSI_COLOR_RESET, 1000000.0 / nTime, " million records / second");
+    }
+
+
+    //concurrent reads, where hits on separate shards or the same shard shouldn't block each other
+    {
+        const uint32_t nThreads = std::max(2u, std::thread::hardware_concurrency());
+
+        runtime::timer timer;
+        timer.Start();
+
+        std::vector<std::thread> vThreads;
+        for(uint32_t n = 0; n < nThreads; ++n)
+        {
+            vThreads.push_back(std::thread([&]()
+            {
+                for(int i = 0; i < 1000000; i++)
+                {
+                    DataStream ssKey(SER_LLD, LLD::DATABASE_VERSION);
+                    ssKey << std::make_pair(std::string("data"), hash + i);
+
+                    std::vector<uint8_t> vBytes;
+
+                    cache->Get(ssKey.Bytes(), vBytes);
+                }
+            }));
+        }
+
+        for(auto& thread : vThreads)
+            thread.join();
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Get::", ANSI_COLOR_RESET, (nThreads * 1000000.0) / nTime, " million records / second (", nThreads, " threads)");
+    }
+
+    delete cache;
+
+    debug::log(0, "===== End Binary CLOCK Benchmarks =====\n");
+}
@@ -0,0 +1,121 @@
+#include <Util/include/runtime.h>
+#include <Util/include/filesystem.h>
+#include <Util/include/args.h>
+
+#include <LLD/keychain/hashmap.h>
+#include <LLD/keychain/mappedmap.h>
+#include <LLD/templates/key.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <atomic>
+#include <thread>
+
+
+/* Get a key that is unique for each index. */
+std::vector<uint8_t> keychain_key(const uint32_t nIndex)
+{
+    std::vector<uint8_t> vKey(32, 0xaa);
+    std::copy((uint8_t*)&nIndex, (uint8_t*)&nIndex + 4, vKey.begin());
+
+    return vKey;
+}
+
+
+/* Benchmark concurrent reads of a keychain, with and without a writer. */
+template<typename KeychainType>
+void keychain_benchmark(const std::string& strName)
+{
+    debug::log(0, "===== Begin ", strName, " Keychain Benchmarks =====");
+
+    //clear out any data from a previous run
+    const std::string strPath = config::GetDataDir() + strName + "/";
+    if(filesystem::exists(strPath))
+        filesystem::remove_directories(strPath);
+
+    KeychainType* keychain = new KeychainType(strPath, LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 256 * 256);
+
+    const uint32_t nTotal = 100000;
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(uint32_t i = 0; i < nTotal; i++)
+            keychain->Put(LLD::SectorKey(LLD::STATE::READY, keychain_key(i), 0, i, 10));
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Put::", ANSI_COLOR_RESET, nTotal / double(nTime), " million keys / second");
+    }
+
+
+    //reads on one thread and then on every core, which only contend on keys sharing a bucket stripe
+    const uint32_t nCores = std::max(2u, std::thread::hardware_concurrency());
+    for(const uint32_t nThreads : {1u, nCores})
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        std::vector<std::thread> vThreads;
+        for(uint32_t n = 0; n < nThreads; ++n)
+        {
+            vThreads.push_back(std::thread([&]()
+            {
+                LLD::SectorKey cKey;
+                for(uint32_t i = 0; i < nTotal; i++)
+                    keychain->Get(keychain_key(i), cKey);
+            }));
+        }
+
+        for(auto& thread : vThreads)
+            thread.join();
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Get::", ANSI_COLOR_RESET, (nThreads * double(nTotal)) / nTime, " million keys / second (", nThreads, " threads)");
+    }
+
+
+    //reads on every core while another thread keeps writing
+    {
+        std::atomic<bool> fStop(false);
+        std::thread tWriter([&]()
+        {
+            for(uint32_t i = 0; !fStop.load(); i = (i + 1) % nTotal)
+                keychain->Put(LLD::SectorKey(LLD::STATE::READY, keychain_key(i), 0, i, 20));
+        });
+
+        runtime::timer timer;
+        timer.Start();
+
+        std::vector<std::thread> vThreads;
+        for(uint32_t n = 0; n < nCores; ++n)
+        {
+            vThreads.push_back(std::thread([&]()
+            {
+                LLD::SectorKey cKey;
+                for(uint32_t i = 0; i < nTotal; i++)
+                    keychain->Get(keychain_key(i), cKey);
+            }));
+        }
+
+        for(auto& thread : vThreads)
+            thread.join();
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+
+        fStop.store(true);
+        tWriter.join();
+
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Get::", ANSI_COLOR_RESET, (nCores * double(nTotal)) / nTime, " million keys / second (", nCores, " threads with a writer)");
+    }
+
+    delete keychain;
+
+    debug::log(0, "===== End ", strName, " Keychain Benchmarks =====\n");
+}
+
+
+TEST_CASE( "Keychain Benchmarks", "[LLD]")
+{
+    keychain_benchmark<LLD::BinaryHashMap>("_BENCH_HASHMAP");
+    keychain_benchmark<LLD::BinaryMappedMap>("_BENCH_MAPPEDMAP");
+}
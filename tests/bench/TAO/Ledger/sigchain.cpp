@@ -26,5 +26,19 @@ TEST_CASE( "Signature Chain Benchmarks", "[ledger]")
     nTime = bench.ElapsedMilliseconds();
     debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Generate::", ANSI_COLOR_RESET, "Created in ", nTime, " ms");
 
+    bench.Reset();
+    user.Generate(0, "pin");
+
+    //time output
+    nTime = bench.ElapsedMicroseconds();
+    debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Generate(cached)::", ANSI_COLOR_RESET, "Created in ", nTime, " us");
+
+    bench.Reset();
+    user.Generate(1, "pin");
+
+    //time output, the next key was started in the background by the first
+    nTime = bench.ElapsedMilliseconds();
+    debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Generate(next)::", ANSI_COLOR_RESET, "Created in ", nTime, " ms");
+
     debug::log(0, "===== End Signature Chain Benchmarks =====\n");
 }
@@ -14,6 +14,7 @@ ________________________________________________________________________________
 #include <LLC/types/uint1024.h>
 #include <LLC/types/bignum.h>
 #include <LLC/include/random.h>
+#include <LLC/include/fermat.h>
 #include <LLC/prime/fermat.h>
 #include <openssl/bn.h>
 #include <unit/catch2/catch.hpp>
@@ -32,6 +33,7 @@ LLC::CBigNum FermatTest2(const LLC::CBigNum& bnPrime)
 }
 
 
+/* Used after Miller-Rabin and Divisor tests to verify primality. */
 uint1024_t FermatTest(const uint1024_t &p)
 {
     uint1024_t r;
@@ -58,9 +60,10 @@ TEST_CASE("Fermat Tests", "[LLC]")
     uint64_t nonce = uint64_t(5190024797402611181);
 
     uint1024_t bn1 = hashNumber + nonce;
-    LLC::CBigNum bn2(bn1); 
+    LLC::CBigNum bn2(bn1);
 
     REQUIRE(FermatTest(bn1).GetHex() == FermatTest2(bn2).getuint1024().GetHex());
+    REQUIRE(LLC::FermatTest(bn1) == FermatTest2(bn2).getuint1024());
 
     for(uint32_t i = 0; i < 1000; ++i)
     {
@@ -78,7 +81,147 @@ TEST_CASE("Fermat Tests", "[LLC]")
 
         REQUIRE(FermatTest(bn1).GetHex() == FermatTest2(bn2).getuint1024().GetHex());
     }
+}
+
+
+TEST_CASE("Fermat Batch Tests", "[LLC]")
+{
+    //odd numbers of every size, with the top bit set, primes, and even numbers
+    std::vector<uint1024_t> vTest;
+    for(uint32_t i = 0; i < 1024; ++i)
+    {
+        uint1024_t hashTest = LLC::GetRand1024() >> i;
+        hashTest |= 1;
+
+        vTest.push_back(hashTest);
+    }
+
+    for(uint32_t i = 0; i < 100; ++i)
+    {
+        uint1024_t hashTest = LLC::GetRand1024();
+        hashTest |= (uint1024_t(0x80000000) << 992);
+        hashTest |= 1;
+
+        vTest.push_back(hashTest);
+    }
+
+    for(uint32_t i = 0; i < 100; ++i)
+        vTest.push_back(LLC::GetRand1024() << 1);
+
+    for(uint64_t n : { 0, 1, 2, 3, 4, 5, 7, 561, 65537 })
+        vTest.push_back(uint1024_t(n));
+
+    //test in one batch and each on its own, against the big number library
+    std::vector<uint1024_t> vRemainders(vTest.size());
+    LLC::FermatTest(&vTest[0], vTest.size(), &vRemainders[0]);
+
+    for(uint32_t i = 0; i < vTest.size(); ++i)
+    {
+        const uint1024_t hashExpected = FermatTest2(LLC::CBigNum(vTest[i])).getuint1024();
+
+        REQUIRE(vRemainders[i] == hashExpected);
+        REQUIRE(LLC::FermatTest(vTest[i]) == hashExpected);
+    }
+}
+
+
+TEST_CASE("Fermat Top Word Tests", "[LLC]")
+{
+    //odd numbers with the top word all ones, and with runs of leading ones either side of it
+    std::vector<uint1024_t> vTest;
+    for(uint32_t i = 0; i < 160; ++i)
+    {
+        uint1024_t hashTest = LLC::GetRand1024();
+        hashTest |= (uint1024_t(0xffffffff) << 992);
+        hashTest |= 1;
+
+        vTest.push_back(hashTest);
+    }
 
+    for(uint32_t nOnes = 24; nOnes <= 96; ++nOnes)
+    {
+        uint1024_t hashTest = LLC::GetRand1024() >> nOnes;
+        hashTest |= (~uint1024_t(0)) << (1024 - nOnes);
+        hashTest |= 1;
 
+        vTest.push_back(hashTest);
+    }
+
+    //every odd 2^1024 - k up to 2000
+    for(uint32_t k = 1; k < 2000; k += 2)
+        vTest.push_back(uint1024_t(0) - uint1024_t(k));
+
+    std::vector<uint1024_t> vRemainders(vTest.size());
+    LLC::FermatTest(&vTest[0], vTest.size(), &vRemainders[0]);
+
+    for(uint32_t i = 0; i < vTest.size(); ++i)
+    {
+        const uint1024_t hashExpected = FermatTest2(LLC::CBigNum(vTest[i])).getuint1024();
+
+        REQUIRE(vRemainders[i] == hashExpected);
+        REQUIRE(LLC::FermatTest(vTest[i]) == hashExpected);
+    }
+
+    //clusters starting just below 2^1024
+    std::vector<uint8_t> vOffsets(100, 2);
+    for(uint32_t k = 1; k < 2000; k += 200)
+    {
+        const uint1024_t hashBase = uint1024_t(0) - uint1024_t(k + 200);
+
+        bool fPrimes[100];
+        uint32_t nPrimes = LLC::FermatCluster(hashBase, &vOffsets[0], vOffsets.size(), fPrimes);
+
+        uint32_t nExpected = 0;
+        uint1024_t hashNext = hashBase;
+        for(uint32_t i = 0; i < vOffsets.size(); ++i)
+        {
+            hashNext += vOffsets[i];
+
+            bool fPrime = (FermatTest2(LLC::CBigNum(hashNext)) == LLC::CBigNum(1));
+            for(uint16_t nPrime : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31 })
+                if(hashNext % nPrime == 0)
+                    fPrime = false;
+
+            REQUIRE(fPrimes[i] == fPrime);
+            nExpected += fPrime ? 1 : 0;
+        }
+
+        REQUIRE(nPrimes == nExpected);
+    }
+}
+
+
+TEST_CASE("Fermat Cluster Tests", "[LLC]")
+{
+    //find a prime to start our cluster from
+    uint1024_t hashBase = LLC::GetRand1024() >> 1;
+    hashBase |= 1;
+
+    while(LLC::FermatTest(hashBase) != 1)
+        hashBase += 2;
+
+    //check each number in our cluster against the single tests
+    std::vector<uint8_t> vOffsets;
+    for(uint32_t i = 0; i < 1000; ++i)
+        vOffsets.push_back(2 * (1 + LLC::GetRand(6)));
+
+    bool fPrimes[1000];
+    uint32_t nPrimes = LLC::FermatCluster(hashBase, &vOffsets[0], vOffsets.size(), fPrimes);
+
+    uint32_t nExpected = 0;
+    uint1024_t hashNext = hashBase;
+    for(uint32_t i = 0; i < vOffsets.size(); ++i)
+    {
+        hashNext += vOffsets[i];
+
+        bool fPrime = (FermatTest2(LLC::CBigNum(hashNext)) == LLC::CBigNum(1));
+        for(uint16_t nPrime : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31 })
+            if(hashNext % nPrime == 0)
+                fPrime = false;
+
+        REQUIRE(fPrimes[i] == fPrime);
+        nExpected += fPrime ? 1 : 0;
+    }
 
+    REQUIRE(nPrimes == nExpected);
 }
@@ -0,0 +1,54 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/hash/SK.h>
+
+#include <unit/catch2/catch.hpp>
+
+TEST_CASE( "SK512x4 matches SK512", "[LLC]")
+{
+    //lengths around the skein block and keccak rate boundaries, including merkle node pairs
+    const std::vector<uint64_t> vLengths = { 0, 1, 8, 63, 64, 65, 71, 72, 73, 127, 128, 129, 200, 1024 };
+    for(const auto& nLength : vLengths)
+    {
+        //fill four different messages with fixed bytes
+        std::vector<uint8_t> vData[4];
+        for(uint32_t j = 0; j < 4; ++j)
+        {
+            vData[j].resize(nLength + 1);
+            for(uint64_t i = 0; i < vData[j].size(); ++i)
+                vData[j][i] = static_cast<uint8_t>((i * 7) + (j * 31) + nLength);
+        }
+
+        const uint8_t* pData[4] = { &vData[0][0], &vData[1][0], &vData[2][0], &vData[3][0] };
+
+        //check each lane against hashing one at a time
+        uint512_t vHashes[4];
+        LLC::SK512x4(pData, nLength, vHashes);
+
+        for(uint32_t j = 0; j < 4; ++j)
+            REQUIRE(vHashes[j] == LLC::SK512(vData[j].begin(), vData[j].begin() + nLength));
+    }
+
+    //the same message in every lane gives the same hash in every lane
+    {
+        std::vector<uint8_t> vData(128, 0x5a);
+        const uint8_t* pData[4] = { &vData[0], &vData[0], &vData[0], &vData[0] };
+
+        uint512_t vHashes[4];
+        LLC::SK512x4(pData, vData.size(), vHashes);
+
+        for(uint32_t j = 0; j < 4; ++j)
+            REQUIRE(vHashes[j] == LLC::SK512(vData));
+    }
+}
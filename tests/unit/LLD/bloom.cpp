@@ -0,0 +1,119 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/templates/bloom.h>
+#include <LLD/templates/key.h>
+#include <LLD/keychain/hashmap.h>
+#include <LLD/keychain/mappedmap.h>
+#include <LLD/include/enum.h>
+
+#include <Util/include/args.h>
+#include <Util/include/filesystem.h>
+
+#include <unit/catch2/catch.hpp>
+
+/* Get a key of the given fill byte that is unique for each index. */
+std::vector<uint8_t> bloom_key(const uint32_t nIndex, const uint8_t nFill)
+{
+    std::vector<uint8_t> vKey(24, nFill);
+    std::copy((uint8_t*)&nIndex, (uint8_t*)&nIndex + 4, vKey.begin());
+
+    return vKey;
+}
+
+
+/* Check that a keychain never misses keys written while its saved filter wasn't being kept up to date. */
+template<typename KeychainType>
+void bloom_stale_filter(const std::string& strName)
+{
+    /* Clear out any data from a previous run. */
+    const std::string strPath = config::GetDataDir() + strName + "/";
+    if(filesystem::exists(strPath))
+        REQUIRE(filesystem::remove_directories(strPath));
+
+    const uint8_t nFlags = LLD::FLAGS::CREATE | LLD::FLAGS::FORCE;
+
+    /* Write our first keys with the filter, which is saved on close. */
+    {
+        KeychainType map(strPath, nFlags | LLD::FLAGS::BLOOM, 7777);
+        for(uint32_t n = 0; n < 1000; ++n)
+            REQUIRE(map.Put(LLD::SectorKey(LLD::STATE::READY, bloom_key(n, 1), 0, n, 10)));
+    }
+    REQUIRE(filesystem::exists(strPath + "_bloom.filter"));
+
+    /* Write more keys without the filter, leaving the saved filter behind. */
+    {
+        KeychainType map(strPath, nFlags, 7777);
+        for(uint32_t n = 1000; n < 1100; ++n)
+            REQUIRE(map.Put(LLD::SectorKey(LLD::STATE::READY, bloom_key(n, 1), 0, n, 10)));
+    }
+
+    /* Our saved filter no longer matches the keychain, so it must be rebuilt rather than trusted. */
+    {
+        KeychainType map(strPath, nFlags | LLD::FLAGS::BLOOM, 7777);
+        for(uint32_t n = 0; n < 1100; ++n)
+        {
+            LLD::SectorKey cKey;
+            REQUIRE(map.Get(bloom_key(n, 1), cKey));
+            REQUIRE(cKey.nSectorStart == n);
+        }
+    }
+
+    /* A cleanly saved filter is loaded and removed until the next close. */
+    {
+        KeychainType map(strPath, nFlags | LLD::FLAGS::BLOOM, 7777);
+        REQUIRE_FALSE(filesystem::exists(strPath + "_bloom.filter"));
+
+        LLD::SectorKey cKey;
+        REQUIRE(map.Get(bloom_key(1099, 1), cKey));
+        REQUIRE_FALSE(map.Get(bloom_key(1099, 2), cKey));
+    }
+}
+
+
+TEST_CASE("BloomFilter grows past its capacity", "[LLD]")
+{
+    LLD::BloomFilter filter(0);
+
+    /* Insert far more keys than our first stage holds. */
+    for(uint32_t n = 0; n < 100000; ++n)
+    {
+        const std::vector<uint8_t> vKey = bloom_key(n, 1);
+        filter.Insert(vKey.data(), vKey.size());
+    }
+
+    /* Every key must be found. */
+    for(uint32_t n = 0; n < 100000; ++n)
+    {
+        const std::vector<uint8_t> vKey = bloom_key(n, 1);
+        REQUIRE(filter.Has(vKey.data(), vKey.size()));
+    }
+
+    /* Keys we never inserted should rarely be found. */
+    uint32_t nFalse = 0;
+    for(uint32_t n = 0; n < 100000; ++n)
+    {
+        const std::vector<uint8_t> vKey = bloom_key(n, 2);
+        if(filter.Has(vKey.data(), vKey.size()))
+            ++nFalse;
+    }
+
+    REQUIRE(nFalse < 1000);
+}
+
+
+TEST_CASE("BloomFilter is rebuilt when stale", "[LLD]")
+{
+    bloom_stale_filter<LLD::BinaryHashMap>("_BLOOM_HASHMAP");
+    bloom_stale_filter<LLD::BinaryMappedMap>("_BLOOM_MAPPEDMAP");
+}
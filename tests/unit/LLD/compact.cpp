@@ -0,0 +1,117 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/templates/sector.h>
+#include <LLD/keychain/hashmap.h>
+#include <LLD/keychain/mappedmap.h>
+#include <LLD/cache/binary_lru.h>
+
+#include <Util/include/args.h>
+#include <Util/include/filesystem.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <fstream>
+
+/* Sector database to test compaction with. */
+template<typename KeychainType>
+class CompactDB : public LLD::SectorDatabase<KeychainType, LLD::BinaryLRU>
+{
+public:
+
+    CompactDB(const std::string& strName)
+    : LLD::SectorDatabase<KeychainType, LLD::BinaryLRU>(strName, LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 77773, 1024 * 4)
+    {
+    }
+
+    bool WriteRecord(const uint64_t nRecord, const std::string& strValue)
+    {
+        return this->Write(std::make_pair(std::string("record"), nRecord), strValue);
+    }
+
+    bool ReadRecord(const uint64_t nRecord, std::string& strValue)
+    {
+        return this->Read(std::make_pair(std::string("record"), nRecord), strValue);
+    }
+};
+
+
+/* Get a record value of varied length. */
+std::string compact_value(const uint64_t nRecord)
+{
+    return std::string(20 + (nRecord % 50), 'a' + (nRecord % 26));
+}
+
+
+/* Compact sector file zero while a keychain only key sits at its start. */
+template<typename KeychainType>
+void compact_keychain_only(const std::string& strName)
+{
+    config::mapArgs["-lldcompactrate"] = "0";
+
+    /* Clear out any data from a previous run. */
+    const std::string strPath = config::GetDataDir() + strName;
+    if(filesystem::exists(strPath))
+        REQUIRE(filesystem::remove_directories(strPath));
+
+    /* Write a key with no record, then records from the start of file zero. */
+    CompactDB<KeychainType>* pDB = new CompactDB<KeychainType>(strName);
+    REQUIRE(pDB->Write(std::string("reindexed")));
+
+    for(uint64_t n = 0; n < 1000; ++n)
+        REQUIRE(pDB->WriteRecord(n, compact_value(n)));
+
+    delete pDB;
+
+    /* Seal file zero by starting the next sector file. */
+    {
+        std::ofstream stream(strPath + "/datachain/_block.00001");
+    }
+
+    /* Compact file zero, which moves the record that starts at the same position as our key. */
+    pDB = new CompactDB<KeychainType>(strName);
+    REQUIRE(pDB->Compact(0));
+
+    /* Erasing our key must not touch the moved record. */
+    REQUIRE(pDB->Exists(std::string("reindexed")));
+    REQUIRE(pDB->Erase(std::string("reindexed")));
+
+    for(uint64_t n = 0; n < 1000; ++n)
+    {
+        std::string strValue;
+        REQUIRE(pDB->ReadRecord(n, strValue));
+        REQUIRE(strValue == compact_value(n));
+    }
+
+    delete pDB;
+
+    /* Check again from disk. */
+    pDB = new CompactDB<KeychainType>(strName);
+    REQUIRE_FALSE(pDB->Exists(std::string("reindexed")));
+
+    for(uint64_t n = 0; n < 1000; ++n)
+    {
+        std::string strValue;
+        REQUIRE(pDB->ReadRecord(n, strValue));
+        REQUIRE(strValue == compact_value(n));
+    }
+
+    delete pDB;
+}
+
+
+TEST_CASE("Compact with keychain only keys", "[LLD]")
+{
+    compact_keychain_only<LLD::BinaryHashMap>("_COMPACT_HASHMAP");
+    compact_keychain_only<LLD::BinaryMappedMap>("_COMPACT_MAPPEDMAP");
+}
@@ -0,0 +1,201 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/templates/sector.h>
+#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/binary_lru.h>
+
+#include <Util/include/args.h>
+#include <Util/include/filesystem.h>
+
+#include <unit/catch2/catch.hpp>
+
+/* Sector database that orders its proof keys when asked to. */
+class OrderedDB : public LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>
+{
+public:
+
+    OrderedDB(const bool fOrder)
+    : LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>("_ORDERED", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 77773, 1024 * 4)
+    {
+        if(fOrder)
+            Order(std::string("proof"));
+    }
+
+    bool WriteProof(const uint32_t nOwner, const uint32_t nIndex)
+    {
+        return Write(std::make_tuple(std::string("proof"), nOwner, nIndex));
+    }
+
+    bool WriteIndex(const uint32_t nOwner, const uint32_t nSequence, const uint32_t nIndex)
+    {
+        return Write(std::make_tuple(std::string("index"), nSequence, nOwner), nIndex);
+    }
+
+    bool EraseProof(const uint32_t nOwner, const uint32_t nIndex)
+    {
+        return Erase(std::make_tuple(std::string("proof"), nOwner, nIndex));
+    }
+
+    bool BackfillProof(const uint32_t nOwner, const uint32_t nIndex)
+    {
+        return Backfill(std::make_tuple(std::string("proof"), nOwner, nIndex));
+    }
+
+    bool SetOrdered()
+    {
+        return LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>::SetOrdered();
+    }
+
+    /* List the proof indexes of an owner, or return false if they aren't ordered. */
+    bool ListProofs(const uint32_t nOwner, std::vector<uint32_t> &vIndexes)
+    {
+        LLD::KeyCursor cursor;
+        if(!Seek(std::make_pair(std::string("proof"), nOwner), cursor))
+            return false;
+
+        while(cursor.Next())
+        {
+            std::tuple<std::string, uint32_t, uint32_t> tProof;
+            REQUIRE(cursor.Get(tProof));
+
+            vIndexes.push_back(std::get<2>(tProof));
+        }
+
+        return true;
+    }
+};
+
+
+TEST_CASE("Ordered keys include keys of an open transaction", "[LLD]")
+{
+    /* Clear out any data from a previous run. */
+    const std::string strPath = config::GetDataDir() + "_ORDERED";
+    if(filesystem::exists(strPath))
+        REQUIRE(filesystem::remove_directories(strPath));
+
+    OrderedDB db(true);
+    REQUIRE(db.WriteProof(1, 2));
+    REQUIRE(db.WriteProof(1, 4));
+    REQUIRE(db.WriteProof(2, 1));
+
+    /* Write and erase proofs in a transaction, which must be listed before they are committed. */
+    db.TxnBegin();
+    REQUIRE(db.WriteProof(1, 3));
+    REQUIRE(db.WriteProof(1, 5));
+    REQUIRE(db.EraseProof(1, 4));
+
+    std::vector<uint32_t> vIndexes;
+    REQUIRE(db.ListProofs(1, vIndexes));
+    REQUIRE(vIndexes == std::vector<uint32_t>({2, 3, 5}));
+
+    /* The same keys are listed once committed. */
+    REQUIRE(db.TxnCommit());
+    db.TxnRelease();
+
+    vIndexes.clear();
+    REQUIRE(db.ListProofs(1, vIndexes));
+    REQUIRE(vIndexes == std::vector<uint32_t>({2, 3, 5}));
+}
+
+
+TEST_CASE("Ordered keys are backfilled once", "[LLD]")
+{
+    /* Clear out any data from a previous run. */
+    const std::string strPath = config::GetDataDir() + "_ORDERED";
+    if(filesystem::exists(strPath))
+        REQUIRE(filesystem::remove_directories(strPath));
+
+    /* Write proofs and their index records before they are ordered. */
+    {
+        OrderedDB db(false);
+        REQUIRE(db.WriteIndex(1, 0, 2));
+        REQUIRE(db.WriteProof(1, 2));
+        REQUIRE(db.WriteIndex(1, 1, 1));
+        REQUIRE(db.WriteProof(1, 1));
+    }
+
+    /* Our tree doesn't know about the older proofs until they are backfilled. */
+    {
+        OrderedDB db(true);
+
+        std::vector<uint32_t> vIndexes;
+        REQUIRE_FALSE(db.ListProofs(1, vIndexes));
+
+        REQUIRE(db.BackfillProof(1, 2));
+        REQUIRE(db.BackfillProof(1, 1));
+        REQUIRE(db.SetOrdered());
+
+        REQUIRE(db.ListProofs(1, vIndexes));
+        REQUIRE(vIndexes == std::vector<uint32_t>({1, 2}));
+    }
+
+    /* Our marker persists, so the backfill isn't needed again. */
+    {
+        OrderedDB db(true);
+        REQUIRE(db.WriteProof(1, 0));
+
+        std::vector<uint32_t> vIndexes;
+        REQUIRE(db.ListProofs(1, vIndexes));
+        REQUIRE(vIndexes == std::vector<uint32_t>({0, 1, 2}));
+    }
+}
+
+
+TEST_CASE("Ordered keys are discarded after an unclean shutdown", "[LLD]")
+{
+    /* Clear out any data from a previous run. */
+    const std::string strPath  = config::GetDataDir() + "_HASHTREE/";
+    const std::string strCrash = config::GetDataDir() + "_HASHTREE_CRASH/";
+    for(const std::string& strDir : {strPath, strCrash})
+        if(filesystem::exists(strDir))
+            REQUIRE(filesystem::remove_directories(strDir));
+
+    {
+        LLD::BinaryHashTree tree(strPath, true);
+        REQUIRE(tree.Put(std::vector<uint8_t>({1, 2})));
+        REQUIRE(tree.Flush());
+
+        /* Take a copy of our log while it is still open, as a crash would leave it. */
+        REQUIRE(filesystem::create_directories(strCrash));
+        REQUIRE(filesystem::copy_file(strPath + "_hashtree.log", strCrash + "_hashtree.log"));
+    }
+
+    /* A cleanly closed tree keeps its keys and is still complete. */
+    {
+        LLD::BinaryHashTree tree(strPath, false);
+        REQUIRE(tree.Complete());
+
+        std::vector<uint8_t> vKey;
+        REQUIRE(tree.Next(std::vector<uint8_t>({1}), std::vector<uint8_t>({1}), true, vKey));
+        REQUIRE(vKey == std::vector<uint8_t>({1, 2}));
+    }
+
+    /* A tree that wasn't closed can't be trusted, so it starts over and waits for a backfill. */
+    {
+        LLD::BinaryHashTree tree(strCrash, false);
+        REQUIRE_FALSE(tree.Complete());
+
+        std::vector<uint8_t> vKey;
+        REQUIRE_FALSE(tree.Next(std::vector<uint8_t>({1}), std::vector<uint8_t>({1}), true, vKey));
+
+        REQUIRE(tree.Put(std::vector<uint8_t>({1, 2})));
+        REQUIRE(tree.SetComplete());
+    }
+
+    /* Once backfilled and closed, it is trusted again. */
+    {
+        LLD::BinaryHashTree tree(strCrash, false);
+        REQUIRE(tree.Complete());
+    }
+}
@@ -0,0 +1,157 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLP/include/header_sync.h>
+
+#include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/process.h>
+#include <TAO/Ledger/include/timelocks.h>
+#include <TAO/Ledger/types/client.h>
+#include <TAO/Ledger/types/state.h>
+
+#include <Util/include/args.h>
+#include <Util/include/runtime.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+TEST_CASE( "Header sync windows", "[header_sync]")
+{
+    //small windows and a short timeout, read once on first use
+    config::mapArgs["-syncwindow"]  = "4";
+    config::mapArgs["-synctimeout"] = "1";
+
+    //keep our chain state to restore it after the test
+    const uint32_t nBestHeight  = TAO::Ledger::ChainState::nBestHeight.load();
+    const uint64_t nSyncSession = TAO::Ledger::nSyncSession.load();
+
+    //session 1 is our sync node
+    TAO::Ledger::nSyncSession.store(1);
+
+    //start from our best chain
+    LLP::HeaderSync::Stop();
+    LLP::HeaderSync::Start();
+    REQUIRE(LLP::HeaderSync::Active());
+
+    const TAO::Ledger::BlockState stateBest = TAO::Ledger::ChainState::tStateBest.load();
+    REQUIRE(LLP::HeaderSync::LastHeader() == stateBest.GetHash());
+
+    //add four windows of private headers, which don't need any proof of work
+    std::vector<uint1024_t> vHashes;
+    {
+        uint1024_t hashPrev = stateBest.GetHash();
+        uint64_t nTime      = std::max(stateBest.GetBlockTime(), runtime::unifiedtimestamp() - 1000);
+
+        for(uint32_t n = 1; n <= 16; ++n)
+        {
+            TAO::Ledger::ClientBlock block;
+            block.nVersion      = TAO::Ledger::CurrentBlockVersion();
+            block.hashPrevBlock = hashPrev;
+            block.nChannel      = 3;
+            block.nHeight       = stateBest.nHeight + n;
+            block.nTime         = ++nTime;
+
+            REQUIRE(LLP::HeaderSync::Header(block));
+
+            hashPrev = block.GetHash();
+            vHashes.push_back(hashPrev);
+        }
+    }
+    REQUIRE(LLP::HeaderSync::LastHeader() == vHashes.back());
+
+    //headers that don't connect to our last one are rejected
+    {
+        TAO::Ledger::ClientBlock block;
+        block.nVersion      = TAO::Ledger::CurrentBlockVersion();
+        block.hashPrevBlock = vHashes[3];
+        block.nChannel      = 3;
+        block.nHeight       = stateBest.nHeight + 5;
+        block.nTime         = runtime::unifiedtimestamp();
+
+        REQUIRE_FALSE(LLP::HeaderSync::Header(block));
+    }
+
+    uint1024_t hashStart, hashStop;
+
+    //our sync node is given the first window
+    REQUIRE(LLP::HeaderSync::Request(1, 0, hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[0]);
+    REQUIRE(hashStop  == vHashes[3]);
+    REQUIRE(LLP::HeaderSync::Requested(1));
+
+    //a node can't take another window while one is outstanding
+    REQUIRE_FALSE(LLP::HeaderSync::Request(1, 0, hashStart, hashStop));
+
+    //other nodes must announce one of our headers
+    REQUIRE_FALSE(LLP::HeaderSync::Request(2, 0, hashStart, hashStop));
+    REQUIRE_FALSE(LLP::HeaderSync::Requested(2));
+
+    //other nodes are only given windows up to their best chain
+    REQUIRE_FALSE(LLP::HeaderSync::Request(2, vHashes[6], hashStart, hashStop));
+    REQUIRE(LLP::HeaderSync::Request(2, vHashes[7], hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[4]);
+    REQUIRE(hashStop  == vHashes[7]);
+
+    //the next node gets the next window
+    REQUIRE(LLP::HeaderSync::Request(3, vHashes[15], hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[8]);
+    REQUIRE(hashStop  == vHashes[11]);
+
+    //the window advances once our best chain connects the first window
+    REQUIRE_FALSE(LLP::HeaderSync::Request(1, 0, hashStart, hashStop));
+    TAO::Ledger::ChainState::nBestHeight.store(stateBest.nHeight + 4);
+
+    REQUIRE(LLP::HeaderSync::Request(1, 0, hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[12]);
+    REQUIRE(hashStop  == vHashes[15]);
+
+    //every window is outstanding
+    REQUIRE_FALSE(LLP::HeaderSync::Request(4, vHashes[15], hashStart, hashStop));
+
+    //windows released on disconnect are given to the next node that asks
+    LLP::HeaderSync::Release(2);
+    REQUIRE_FALSE(LLP::HeaderSync::Requested(2));
+
+    REQUIRE(LLP::HeaderSync::Request(4, vHashes[15], hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[4]);
+    REQUIRE(hashStop  == vHashes[7]);
+
+    //windows that weren't received in time are requested again from another node
+    REQUIRE_FALSE(LLP::HeaderSync::Request(5, vHashes[15], hashStart, hashStop));
+    runtime::sleep(2100);
+
+    REQUIRE(LLP::HeaderSync::Request(5, vHashes[15], hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[4]);
+    REQUIRE(hashStop  == vHashes[7]);
+
+    REQUIRE(LLP::HeaderSync::Request(6, vHashes[15], hashStart, hashStop));
+    REQUIRE(hashStart == vHashes[8]);
+    REQUIRE(hashStop  == vHashes[11]);
+
+    //we aren't finished until our best chain reaches our last header
+    LLP::HeaderSync::SetComplete();
+    REQUIRE(LLP::HeaderSync::Complete());
+    REQUIRE_FALSE(LLP::HeaderSync::Finished());
+
+    //stopping clears our windows
+    REQUIRE(LLP::HeaderSync::Stop());
+    REQUIRE_FALSE(LLP::HeaderSync::Active());
+    REQUIRE_FALSE(LLP::HeaderSync::Requested(5));
+    REQUIRE_FALSE(LLP::HeaderSync::Request(1, 0, hashStart, hashStop));
+
+    //restore our chain state
+    TAO::Ledger::ChainState::nBestHeight.store(nBestHeight);
+    TAO::Ledger::nSyncSession.store(nSyncSession);
+}
@@ -0,0 +1,155 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/types/httpnode.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* HTTP node with no events, to test reading and writing packets. */
+class TestHTTPNode : public LLP::HTTPNode
+{
+public:
+
+    TestHTTPNode(const int32_t nSocket)
+    : LLP::HTTPNode(LLP::Socket(nSocket, LLP::BaseAddress()), nullptr, false)
+    {
+        fCONNECTED.store(true);
+    }
+
+    void Event(uint8_t EVENT, uint32_t LENGTH = 0) override
+    {
+    }
+
+    bool ProcessPacket() override
+    {
+        return true;
+    }
+};
+
+
+/* Read packets on a node until its packet is complete or nothing more arrives. */
+void read_packet(TestHTTPNode& node)
+{
+    for(uint32_t n = 0; n < 1000 && !node.INCOMING.Complete() && node.Connected(); ++n)
+    {
+        node.ReadPacket();
+        if(node.Available() == 0)
+            usleep(1000);
+    }
+}
+
+
+TEST_CASE( "LLP::HTTPNode chunked round trip", "[httpnode]")
+{
+    int32_t vSockets[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, vSockets) == 0);
+
+    TestHTTPNode tWriter(vSockets[0]);
+    TestHTTPNode tReader(vSockets[1]);
+
+    /* Write our header followed by chunks of varied sizes, including one with every byte value. */
+    LLP::HTTPPacket RESPONSE(200);
+    RESPONSE.fChunked = true;
+    tWriter.WritePacket(RESPONSE);
+
+    std::string strBinary;
+    for(uint32_t n = 0; n < 256; ++n)
+        strBinary += static_cast<char>(n);
+
+    const std::vector<std::string> vChunks =
+    {
+        "{\"result\":[",
+        std::string(1, 'a'),
+        strBinary,
+        std::string(70000, 'b'),
+        "]}"
+    };
+
+    std::string strContent;
+    for(const auto& strChunk : vChunks)
+    {
+        tWriter.WriteChunk(strChunk);
+        strContent += strChunk;
+    }
+    tWriter.WriteChunk("");
+
+    /* Read it all back as one packet. */
+    read_packet(tReader);
+
+    REQUIRE(tReader.Connected());
+    REQUIRE(tReader.INCOMING.Complete());
+    REQUIRE(tReader.INCOMING.strContent == strContent);
+    REQUIRE(tReader.INCOMING.nContentLength == strContent.size());
+
+    tWriter.Disconnect();
+    tReader.Disconnect();
+}
+
+
+TEST_CASE( "LLP::HTTPNode chunk size limits", "[httpnode]")
+{
+    /* Sizes that are too large, overflow, or aren't hex must disconnect without reading any content. */
+    const std::vector<std::string> vSizes =
+    {
+        "FFFFFFFFFFFFFFFF",
+        "10000000000000000",
+        "1000001",
+        "zz",
+        ""
+    };
+
+    for(const auto& strSize : vSizes)
+    {
+        int32_t vSockets[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, vSockets) == 0);
+
+        TestHTTPNode tReader(vSockets[1]);
+
+        /* Write a header and a chunk with our bad size. */
+        const std::string strPacket =
+            "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + strSize + "\r\nabc\r\n0\r\n\r\n";
+
+        REQUIRE(write(vSockets[0], strPacket.data(), strPacket.size()) == int64_t(strPacket.size()));
+
+        read_packet(tReader);
+
+        REQUIRE_FALSE(tReader.Connected());
+        REQUIRE(tReader.INCOMING.strContent.empty());
+
+        close(vSockets[0]);
+    }
+}
+
+
+TEST_CASE( "LLP::HTTPNode chunks are refused once the send buffer is full", "[httpnode]")
+{
+    int32_t vSockets[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, vSockets) == 0);
+
+    TestHTTPNode tWriter(vSockets[0]);
+
+    /* Write chunks to a client that never reads, until our send buffer can't take another. */
+    const std::string strChunk(1024 * 1024, 'c');
+
+    bool fRefused = false;
+    for(uint32_t n = 0; n < 64 && !fRefused; ++n)
+        fRefused = !tWriter.WriteChunk(strChunk);
+
+    REQUIRE(fRefused);
+
+    tWriter.Disconnect();
+    close(vSockets[1]);
+}
@@ -11,12 +11,38 @@
 
 ____________________________________________________________________________________________*/
 
+#include <LLC/hash/macro.h>
+#include <LLC/hash/SK.h>
+
 #include <TAO/Ledger/types/block.h>
 #include <TAO/Ledger/types/tritium.h>
 #include <TAO/Ledger/types/state.h>
 
 #include <unit/catch2/catch.hpp>
 
+
+/* Build a merkle tree one pair at a time with SK512, to check the block against. */
+std::vector<uint512_t> merkle_reference(const std::vector<uint512_t>& vtx)
+{
+    std::vector<uint512_t> vMerkleTree = vtx;
+
+    uint32_t j = 0;
+    for(uint32_t nSize = static_cast<uint32_t>(vtx.size()); nSize > 1; nSize = (nSize + 1) >> 1)
+    {
+        for(uint32_t i = 0; i < nSize; i += 2)
+        {
+            const uint512_t hashLeft  = vMerkleTree[j + i];
+            const uint512_t hashRight = vMerkleTree[j + std::min(i + 1, nSize - 1)];
+
+            vMerkleTree.push_back(LLC::SK512(BEGIN(hashLeft), END(hashLeft), BEGIN(hashRight), END(hashRight)));
+        }
+
+        j += nSize;
+    }
+
+    return vMerkleTree;
+}
+
 TEST_CASE( "Block primitive values", "[ledger]")
 {
     TAO::Ledger::Block block;
@@ -117,3 +143,52 @@ TEST_CASE( "Block primitive values", "[ledger]")
 
 
 }
+
+
+TEST_CASE( "Block merkle tree matches pairwise SK512", "[ledger]")
+{
+    //odd and even leaf counts around multiples of the four pairs we hash at once
+    const std::vector<uint32_t> vCounts = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 100, 255, 257, 1023 };
+    for(const auto& nCount : vCounts)
+    {
+        //build our leaves from fixed values
+        std::vector<uint512_t> vtx;
+        for(uint32_t n = 0; n < nCount; ++n)
+            vtx.push_back(LLC::SK512(BEGIN(n), END(n)));
+
+        //check the merkle root
+        const std::vector<uint512_t> vReference = merkle_reference(vtx);
+
+        TAO::Ledger::Block block;
+        REQUIRE(block.BuildMerkleTree(vtx) == (vReference.empty() ? 0 : vReference.back()));
+
+        //check the same root from leaves paired with their types
+        std::vector<std::pair<uint8_t, uint512_t>> vPairs;
+        for(const auto& hash : vtx)
+            vPairs.push_back(std::make_pair(uint8_t(0), hash));
+
+        TAO::Ledger::Block block2;
+        REQUIRE(block2.BuildMerkleTree(vPairs) == (vReference.empty() ? 0 : vReference.back()));
+
+        //check the merkle branch of the first and last leaves, which come from the tree we built
+        for(const auto& nIndex : { uint32_t(0), nCount - 1 })
+        {
+            if(nCount == 0)
+                break;
+
+            std::vector<uint512_t> vBranch;
+
+            uint32_t j = 0;
+            uint32_t nLeaf = nIndex;
+            for(uint32_t nSize = nCount; nSize > 1; nSize = (nSize + 1) / 2)
+            {
+                vBranch.push_back(vReference[j + std::min(nLeaf ^ 1, nSize - 1)]);
+
+                nLeaf >>= 1;
+                j += nSize;
+            }
+
+            REQUIRE(block.GetMerkleBranch(vtx, nIndex) == vBranch);
+        }
+    }
+}
@@ -25,6 +25,7 @@ ________________________________________________________________________________
 #include <TAO/Register/include/verify.h>
 #include <TAO/Register/types/address.h>
 
+#include <TAO/Ledger/include/chainstate.h>
 #include <TAO/Ledger/types/mempool.h>
 #include <TAO/Ledger/include/enum.h>
 #include <TAO/Ledger/types/credentials.h>
@@ -1686,3 +1687,333 @@ TEST_CASE( "Mempool and memory sequencing tests", "[mempool]")
         TAO::Ledger::mempool.Check();
     }
 }
+
+
+TEST_CASE( "Mempool checks sigchains by proof and recipient", "[mempool]")
+{
+    using namespace TAO::Register;
+    using namespace TAO::Operation;
+
+    //clear the mempool so only our transactions are checked
+    std::vector<uint512_t> vExistingHashes;
+    TAO::Ledger::mempool.List(vExistingHashes);
+    for(auto& hash : vExistingHashes)
+    {
+        REQUIRE(TAO::Ledger::mempool.Remove(hash));
+    }
+
+    //pending debit is checked again when its recipient leaves the pool
+    {
+        uint256_t hashSender    = TAO::Ledger::Credentials::Genesis("dirtysender");
+        uint256_t hashReceiver  = TAO::Ledger::Credentials::Genesis("dirtyreceiver");
+
+        uint512_t hashSenderKey1   = LLC::GetRand512();
+        uint512_t hashSenderKey2   = LLC::GetRand512();
+        uint512_t hashReceiverKey1 = LLC::GetRand512();
+        uint512_t hashReceiverKey2 = LLC::GetRand512();
+
+        TAO::Register::Address hashToken   = TAO::Register::Address(TAO::Register::Address::TOKEN);
+        TAO::Register::Address hashAccount = TAO::Register::Address(TAO::Register::Address::ACCOUNT);
+
+        uint512_t hashSenderPrev;
+        uint512_t hashReceiverPrev;
+
+        //create the token on disk
+        {
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashSender;
+            tx.nSequence   = 0;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashSenderKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::CREATE) << hashToken << uint8_t(REGISTER::OBJECT) << CreateToken(hashToken, 1000, 100).GetState();
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashSenderKey1);
+
+            //commit to disk
+            hashSenderPrev = tx.GetHash();
+            REQUIRE(LLD::Ledger->WriteTx(hashSenderPrev, tx));
+            REQUIRE(LLD::Ledger->WriteLast(hashSender, hashSenderPrev));
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+        }
+
+        //start the receiving sigchain on disk
+        {
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashReceiver;
+            tx.nSequence   = 0;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashReceiverKey2);
+
+            //payload
+            TAO::Register::Address hashFirst = TAO::Register::Address(TAO::Register::Address::ACCOUNT);
+            tx[0] << uint8_t(OP::CREATE) << hashFirst << uint8_t(REGISTER::OBJECT) << CreateAccount(hashToken).GetState();
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashReceiverKey1);
+
+            //commit to disk
+            hashReceiverPrev = tx.GetHash();
+            REQUIRE(LLD::Ledger->WriteTx(hashReceiverPrev, tx));
+            REQUIRE(LLD::Ledger->WriteLast(hashReceiver, hashReceiverPrev));
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+        }
+
+        //create the receiving account in the pool
+        uint512_t hashCreate;
+        {
+            hashReceiverKey1 = hashReceiverKey2;
+            hashReceiverKey2 = LLC::GetRand512();
+
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashReceiver;
+            tx.nSequence   = 1;
+            tx.hashPrevTx  = hashReceiverPrev;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashReceiverKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::CREATE) << hashAccount << uint8_t(REGISTER::OBJECT) << CreateAccount(hashToken).GetState();
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashReceiverKey1);
+
+            //add to the pool
+            REQUIRE(TAO::Ledger::mempool.Accept(tx));
+
+            hashCreate = tx.GetHash();
+        }
+
+        //debit to the pending account in the pool
+        uint512_t hashDebit;
+        {
+            hashSenderKey1 = hashSenderKey2;
+            hashSenderKey2 = LLC::GetRand512();
+
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashSender;
+            tx.nSequence   = 1;
+            tx.hashPrevTx  = hashSenderPrev;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashSenderKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::DEBIT) << hashToken << hashAccount << uint64_t(100) << uint64_t(0);
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashSenderKey1);
+
+            //add to the pool
+            REQUIRE(TAO::Ledger::mempool.Accept(tx));
+
+            hashDebit = tx.GetHash();
+        }
+
+        //both sigchains follow from the disk, so nothing is checked again yet
+        TAO::Ledger::mempool.Check();
+        REQUIRE(TAO::Ledger::mempool.Has(hashCreate));
+        REQUIRE(TAO::Ledger::mempool.Has(hashDebit));
+
+        //the receiving sigchain moves on without our account
+        REQUIRE(LLD::Ledger->WriteLast(hashReceiver, LLC::GetRand512()));
+        TAO::Ledger::mempool.Check();
+
+        //the account is disconnected, which marks the sigchain debiting to it
+        REQUIRE_FALSE(TAO::Ledger::mempool.Has(hashCreate));
+        REQUIRE_FALSE(TAO::Ledger::mempool.Has(hashDebit));
+    }
+
+
+    //pending credit is checked again when a block claims the same debit
+    {
+        uint256_t hashSender    = TAO::Ledger::Credentials::Genesis("voidsender");
+        uint256_t hashReceiver  = TAO::Ledger::Credentials::Genesis("voidreceiver");
+
+        uint512_t hashSenderKey1   = LLC::GetRand512();
+        uint512_t hashSenderKey2   = LLC::GetRand512();
+        uint512_t hashReceiverKey1 = LLC::GetRand512();
+        uint512_t hashReceiverKey2 = LLC::GetRand512();
+
+        TAO::Register::Address hashToken   = TAO::Register::Address(TAO::Register::Address::TOKEN);
+        TAO::Register::Address hashAccount = TAO::Register::Address(TAO::Register::Address::ACCOUNT);
+
+        uint512_t hashSenderPrev;
+        uint512_t hashReceiverPrev;
+
+        //create the token on disk
+        {
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashSender;
+            tx.nSequence   = 0;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashSenderKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::CREATE) << hashToken << uint8_t(REGISTER::OBJECT) << CreateToken(hashToken, 1000, 100).GetState();
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashSenderKey1);
+
+            //commit to disk
+            hashSenderPrev = tx.GetHash();
+            REQUIRE(LLD::Ledger->WriteTx(hashSenderPrev, tx));
+            REQUIRE(LLD::Ledger->WriteLast(hashSender, hashSenderPrev));
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+        }
+
+        //create the receiving account on disk
+        {
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashReceiver;
+            tx.nSequence   = 0;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashReceiverKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::CREATE) << hashAccount << uint8_t(REGISTER::OBJECT) << CreateAccount(hashToken).GetState();
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashReceiverKey1);
+
+            //commit to disk
+            hashReceiverPrev = tx.GetHash();
+            REQUIRE(LLD::Ledger->WriteTx(hashReceiverPrev, tx));
+            REQUIRE(LLD::Ledger->WriteLast(hashReceiver, hashReceiverPrev));
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+        }
+
+        //debit to the receiving account on disk
+        uint512_t hashDebit;
+        {
+            hashSenderKey1 = hashSenderKey2;
+            hashSenderKey2 = LLC::GetRand512();
+
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashSender;
+            tx.nSequence   = 1;
+            tx.hashPrevTx  = hashSenderPrev;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashSenderKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::DEBIT) << hashToken << hashAccount << uint64_t(100) << uint64_t(0);
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashSenderKey1);
+
+            //commit to disk
+            hashDebit      = tx.GetHash();
+            hashSenderPrev = hashDebit;
+            REQUIRE(LLD::Ledger->WriteTx(hashDebit, tx));
+            REQUIRE(LLD::Ledger->WriteLast(hashSender, hashDebit));
+            REQUIRE(LLD::Ledger->IndexBlock(hashDebit, TAO::Ledger::ChainState::tStateGenesis.GetHash()));
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+        }
+
+        //credit of the debit in the pool
+        uint512_t hashCredit;
+        {
+            hashReceiverKey1 = hashReceiverKey2;
+            hashReceiverKey2 = LLC::GetRand512();
+
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashReceiver;
+            tx.nSequence   = 1;
+            tx.hashPrevTx  = hashReceiverPrev;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashReceiverKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::CREDIT) << hashDebit << uint32_t(0) << hashAccount << hashToken << uint64_t(100);
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashReceiverKey1);
+
+            //add to the pool
+            REQUIRE(TAO::Ledger::mempool.Accept(tx));
+
+            hashCredit = tx.GetHash();
+        }
+
+        //the sender credits the debit back to the token in a block, outside of our pool
+        {
+            hashSenderKey1 = hashSenderKey2;
+            hashSenderKey2 = LLC::GetRand512();
+
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashSender;
+            tx.nSequence   = 2;
+            tx.hashPrevTx  = hashSenderPrev;
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashSenderKey2);
+
+            //payload
+            tx[0] << uint8_t(OP::CREDIT) << hashDebit << uint32_t(0) << hashToken << hashToken << uint64_t(100);
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //sign
+            tx.Sign(hashSenderKey1);
+
+            //commit to disk
+            const uint512_t hashVoid = tx.GetHash();
+            REQUIRE(LLD::Ledger->WriteTx(hashVoid, tx));
+            REQUIRE(LLD::Ledger->WriteLast(hashSender, hashVoid));
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+
+            //connected transactions that were never in our pool are tracked for the next check
+            REQUIRE_FALSE(TAO::Ledger::mempool.Remove(hashVoid));
+        }
+
+        //the receiver's sigchain still follows from the disk, only the shared proof marks it
+        TAO::Ledger::mempool.Check();
+
+        //the credit proves against a debit that was already claimed
+        REQUIRE_FALSE(TAO::Ledger::mempool.Has(hashCredit));
+    }
+}
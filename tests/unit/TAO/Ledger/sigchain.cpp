@@ -41,6 +41,45 @@ TEST_CASE( "Signature Chain Generation", "[ledger]")
 }
 
 
+TEST_CASE( "Signature Chain Key Cache", "[ledger]")
+{
+    TAO::Ledger::Credentials user = TAO::Ledger::Credentials("cacheuser", "password");
+
+    //keys from the cache match keys derived without it
+    const uint512_t hashKey = user.Generate(0, "1234");
+    REQUIRE(hashKey == user.Generate(0, "1234", false));
+    REQUIRE(hashKey == user.Generate(0, "1234"));
+
+    //the next key was derived in the background
+    REQUIRE(user.Generate(1, "1234") == user.Generate(1, "1234", false));
+
+    //a different pin misses the cache
+    REQUIRE(user.Generate(0, "4321") != hashKey);
+    REQUIRE(user.Generate(0, "1234") == hashKey);
+
+    //typed keys are cached apart from the sequence
+    const uint512_t hashAuth = user.Generate("auth", 0, "1234");
+    REQUIRE(hashAuth != hashKey);
+    REQUIRE(hashAuth == user.Generate("auth", 0, "1234"));
+
+    //a new password clears the cache
+    user.Update("password2");
+    REQUIRE(user.Generate(0, "1234") != hashKey);
+    REQUIRE(user.Generate(0, "1234") == user.Generate(0, SecureString("password2"), SecureString("1234")));
+
+    //prefilled keys match keys derived without the cache
+    user.Prefill(5, "1234");
+    REQUIRE(user.Generate(5, "1234") == user.Generate(5, "1234", false));
+    REQUIRE(user.Generate(6, "1234") == user.Generate(6, "1234", false));
+
+    //once the background thread is stopped, keys are derived when they are needed
+    TAO::Ledger::Credentials::Shutdown();
+    user.Prefill(8, "1234");
+    REQUIRE(user.Generate(8, "1234") == user.Generate(8, "1234", false));
+    REQUIRE(user.Generate(9, "1234") == user.Generate(9, "1234", false));
+}
+
+
 TEST_CASE( "Signature Chain Genesis Transaction checks", "[sigchain]")
 {
     using namespace TAO::Register;
@@ -0,0 +1,174 @@
+/*__________________________________________________________________________________________
+
+            Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014]++
+
+            (c) Copyright The Nexus Developers 2014 - 2026
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/hash/SK.h>
+#include <LLC/include/random.h>
+
+#include <LLP/include/version.h>
+
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/include/verifier.h>
+#include <TAO/Ledger/types/transaction.h>
+
+#include <Util/include/args.h>
+#include <Util/templates/datastream.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <vector>
+
+/* Get the hash of the public key and signature that a transaction is cached by. */
+uint256_t verifier_keys(const TAO::Ledger::Transaction& tx)
+{
+    std::vector<uint8_t> vKeys = tx.vchPubKey;
+    vKeys.insert(vKeys.end(), tx.vchSig.begin(), tx.vchSig.end());
+
+    return LLC::SK256(vKeys);
+}
+
+
+/* Create a list of signed transactions, with bad signatures at the given indexes. */
+std::vector<TAO::Ledger::Transaction> verifier_batch(const uint32_t nSize, const std::vector<uint32_t>& vBad)
+{
+    std::vector<TAO::Ledger::Transaction> vtx(nSize);
+    for(auto& tx : vtx)
+    {
+        tx.nKeyType    = TAO::Ledger::SIGNATURE::FALCON;
+        tx.hashGenesis = LLC::GetRand256();
+
+        REQUIRE(tx.Sign(LLC::GetRand512()));
+    }
+
+    //flip a bit in the signature, which isn't part of the txid
+    for(const auto& nIndex : vBad)
+        vtx[nIndex].vchSig[5] ^= 1;
+
+    return vtx;
+}
+
+
+TEST_CASE( "Verifier batch tests", "[verifier]")
+{
+    //check on the calling thread before our workers are started
+    {
+        std::vector<TAO::Ledger::Transaction> vtx = verifier_batch(8, {3});
+
+        std::vector<const TAO::Ledger::Transaction*> vVerify;
+        for(const auto& tx : vtx)
+            vVerify.push_back(&tx);
+
+        REQUIRE(TAO::Ledger::Verifier::Verify(vVerify) == 7);
+    }
+
+    //check in parallel with our workers
+    config::mapArgs["-verifythreads"] = "3";
+    TAO::Ledger::Verifier::Initialize();
+    {
+        std::vector<TAO::Ledger::Transaction> vtx = verifier_batch(32, {0, 13, 31});
+
+        std::vector<const TAO::Ledger::Transaction*> vVerify;
+        for(const auto& tx : vtx)
+            vVerify.push_back(&tx);
+
+        REQUIRE(TAO::Ledger::Verifier::Verify(vVerify) == 29);
+
+        //bad signatures are still rejected on their own
+        REQUIRE_FALSE(vtx[0].VerifySignature());
+        REQUIRE_FALSE(vtx[13].VerifySignature());
+        REQUIRE_FALSE(vtx[31].VerifySignature());
+        REQUIRE(vtx[1].VerifySignature());
+
+        //verifying again gives the same count
+        REQUIRE(TAO::Ledger::Verifier::Verify(vVerify) == 29);
+
+        //batches of one and empty batches
+        REQUIRE(TAO::Ledger::Verifier::Verify({&vtx[1]}) == 1);
+        REQUIRE(TAO::Ledger::Verifier::Verify({&vtx[0]}) == 0);
+        REQUIRE(TAO::Ledger::Verifier::Verify({}) == 0);
+    }
+
+    //check on the calling thread once our workers are stopped
+    TAO::Ledger::Verifier::Shutdown();
+    {
+        std::vector<TAO::Ledger::Transaction> vtx = verifier_batch(4, {1, 2});
+
+        std::vector<const TAO::Ledger::Transaction*> vVerify;
+        for(const auto& tx : vtx)
+            vVerify.push_back(&tx);
+
+        REQUIRE(TAO::Ledger::Verifier::Verify(vVerify) == 2);
+    }
+
+    //shutdown twice is harmless
+    TAO::Ledger::Verifier::Shutdown();
+}
+
+
+TEST_CASE( "Verifier cache tests", "[verifier]")
+{
+    std::vector<TAO::Ledger::Transaction> vtx = verifier_batch(2, {1});
+
+    const uint512_t hashTx    = vtx[0].GetHash();
+    const uint256_t hashKeys  = verifier_keys(vtx[0]);
+
+    //cache miss before the signature is verified
+    REQUIRE_FALSE(TAO::Ledger::Verifier::Cached(hashTx, hashKeys));
+    REQUIRE(vtx[0].VerifySignature());
+
+    //cache hit once it was verified
+    REQUIRE(TAO::Ledger::Verifier::Cached(hashTx, hashKeys));
+
+    //cache miss for the same txid with other keys
+    REQUIRE_FALSE(TAO::Ledger::Verifier::Cached(hashTx, LLC::GetRand256()));
+    REQUIRE_FALSE(TAO::Ledger::Verifier::Cached(LLC::GetRand512(), hashKeys));
+
+    //bad signatures are never cached
+    REQUIRE_FALSE(vtx[1].VerifySignature());
+    REQUIRE_FALSE(TAO::Ledger::Verifier::Cached(vtx[1].GetHash(), verifier_keys(vtx[1])));
+
+    //a copy received over the network is verified from the cache
+    {
+        DataStream ssTx(SER_NETWORK, LLP::PROTOCOL_VERSION);
+        ssTx << vtx[0];
+
+        TAO::Ledger::Transaction tx;
+        ssTx >> tx;
+
+        REQUIRE(tx.VerifySignature());
+    }
+
+    //a copy with a tampered signature misses the cache and fails
+    {
+        DataStream ssTx(SER_NETWORK, LLP::PROTOCOL_VERSION);
+        ssTx << vtx[0];
+
+        TAO::Ledger::Transaction tx;
+        ssTx >> tx;
+
+        tx.vchSig[5] ^= 1;
+
+        REQUIRE(tx.GetHash() == hashTx);
+        REQUIRE_FALSE(TAO::Ledger::Verifier::Cached(hashTx, verifier_keys(tx)));
+        REQUIRE_FALSE(tx.VerifySignature());
+    }
+
+    //the oldest entry is evicted once -sigcachesize entries were added after it
+    const uint64_t nMaxSize = config::GetArg("-sigcachesize", 50000);
+    for(uint64_t n = 1; n < nMaxSize; ++n)
+        TAO::Ledger::Verifier::Cache(LLC::GetRand512(), LLC::GetRand256());
+
+    REQUIRE(TAO::Ledger::Verifier::Cached(hashTx, hashKeys));
+
+    TAO::Ledger::Verifier::Cache(LLC::GetRand512(), LLC::GetRand256());
+    REQUIRE_FALSE(TAO::Ledger::Verifier::Cached(hashTx, hashKeys));
+}
@@ -164,6 +164,52 @@ TEST_CASE( "Object Register Tests", "[register]")
     }
 
 
+    {
+        Object object;
+        object << std::string("balance") << uint8_t(TYPES::MUTABLE) << uint8_t(TYPES::UINT64_T) << uint64_t(55)
+               << std::string("token") << uint8_t(TYPES::UINT256_T) << uint256_t(0)
+               << std::string("supply") << uint8_t(TYPES::UINT64_T) << uint64_t(888888)
+               << std::string("decimals") << uint8_t(TYPES::UINT8_T) << uint8_t(100);
+
+        //checks fail until the object has been parsed or read
+        REQUIRE_FALSE(object.Check("balance"));
+
+        //read parses on demand up to the field read
+        uint64_t nBalance;
+        REQUIRE(object.Read("balance", nBalance));
+
+        //check
+        REQUIRE(nBalance == 55);
+
+        //fields later in the object are parsed when we look for them
+        REQUIRE(object.Check("decimals", TYPES::UINT8_T, false));
+        REQUIRE(object.get<uint64_t>("supply") == 888888);
+        REQUIRE_FALSE(object.Check("missing"));
+
+        //parse fails once the object was read, the same as parsing twice
+        REQUIRE_FALSE(object.Parse());
+
+        //check standards
+        REQUIRE(object.Standard() == OBJECTS::TOKEN);
+        REQUIRE(object.Members() == std::vector<std::string>({"balance", "decimals", "supply", "token"}));
+
+        //reset to parse again
+        object.Reset();
+        REQUIRE(object.Parse());
+        REQUIRE(object.Standard() == OBJECTS::TOKEN);
+    }
+
+
+    {
+        Object object;
+        object << std::string("balance") << uint8_t(TYPES::UINT64_T) << uint64_t(55)
+               << std::string("balance") << uint8_t(TYPES::UINT64_T) << uint64_t(56);
+
+        //parse object.  This should fail as the field names are duplicated
+        REQUIRE_FALSE(object.Parse());
+    }
+
+
     {
         Object object;
         object << std::string("balance") << uint8_t(TYPES::MUTABLE) << uint8_t(TYPES::UINT64_T) << uint64_t(55)